@@ -0,0 +1,131 @@
+/* DECODE LOG.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 18:36:02
+ * Last edited:
+ *   16/10/2026, 18:39:20
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Small tool that turns a binary log, as written by the debugger when
+ *   HELLOVIKINGROOM_LOG or --log is given, back into the messages the
+ *   debugger would have printed, or into a CSV-file with one message per
+ *   line.
+ *
+ *   Usage: decode_log FILE [--csv]
+**/
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include "Debug/BinaryLog.hpp"
+
+using namespace std;
+using namespace Debug;
+
+
+/***** HELPER FUNCTIONS *****/
+/* Returns the name of the given severity as used in the CSV-output. */
+static const char* severity_name(Severity severity) {
+    switch (severity) {
+        case Severity::auxillary: return "auxillary";
+        case Severity::info: return "info";
+        case Severity::warning: return "warning";
+        case Severity::nonfatal: return "nonfatal";
+        case Severity::fatal: return "fatal";
+        case Severity::vulkan_warning: return "vulkan_warning";
+        case Severity::vulkan_error: return "vulkan_error";
+        default: return "unknown";
+    }
+}
+
+/* Writes the given value to the given stream as a CSV-field, quoting it if it needs to be. */
+static void write_csv_field(ostream& os, const string& value) {
+    if (value.find_first_of(",\"\n") == string::npos) {
+        os << value;
+        return;
+    }
+    os << '"';
+    for (size_t i = 0; i < value.size(); i++) {
+        if (value[i] == '"') { os << '"'; }
+        os << value[i];
+    }
+    os << '"';
+}
+
+/* Writes the given entry as a single CSV-line, with the innermost function as where it was logged. */
+static void write_csv_line(ostream& os, const LogEntry& entry) {
+    os << entry.time << ',' << entry.tid << ',';
+    write_csv_field(os, entry.thread_name);
+    os << ',' << severity_name(entry.severity) << ',';
+    if (!entry.frames.empty()) {
+        write_csv_field(os, entry.frames[0].func_name);
+        os << ',';
+        write_csv_field(os, entry.frames[0].file_name);
+        os << ',' << entry.frames[0].line_number << ',';
+    } else {
+        os << ",,,";
+    }
+    write_csv_field(os, entry.message);
+    os << endl;
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+int main(int argc, const char** argv) {
+    // Parse the arguments
+    bool csv = false;
+    string path;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--csv") {
+            csv = true;
+        } else if (path.empty()) {
+            path = arg;
+        } else {
+            path = "";
+            break;
+        }
+    }
+    if (path.empty()) {
+        cerr << "Usage: " << argv[0] << " FILE [--csv]" << endl;
+        return EXIT_FAILURE;
+    }
+
+    // Open the log
+    BinaryLogReader reader;
+    if (!reader.open(path)) {
+        cerr << "Could not open '" << path << "' as a binary log." << endl;
+        return EXIT_FAILURE;
+    }
+
+    // Print each message in the chosen format
+    if (csv) { cout << "time_ns,thread,thread_name,severity,function,file,line,message" << endl; }
+    LogEntry entry;
+    while (reader.next(entry)) {
+        if (csv) {
+            // Format the message ourselves, since it doesn't go through the debugger
+            if (entry.format != nullptr) {
+                string message;
+                format_encoded(message, entry.format, entry.message.data(), entry.message.size());
+                entry.message.swap(message);
+                entry.format = nullptr;
+            }
+            write_csv_line(cout, entry);
+        } else {
+            debugger.print(cout, entry);
+        }
+    }
+
+    // Let the user know if the log was cut off
+    if (reader.is_corrupt()) {
+        cerr << "Warning: '" << path << "' ends in a partial or unknown chunk; everything before it was decoded." << endl;
+    }
+    return EXIT_SUCCESS;
+}
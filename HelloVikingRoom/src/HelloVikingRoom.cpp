@@ -4,7 +4,7 @@
  * Created:
  *   19/12/2020, 16:23:17
  * Last edited:
- *   1/14/2021, 12:49:38 PM
+ *   16/10/2026, 23:31:45
  * Auto updated?
  *   Yes
  *
@@ -18,9 +18,14 @@
 
 #include <vulkan/vulkan.h>
 #include <iostream>
+#include <fstream>
 #include <exception>
 #include <algorithm>
 #include <chrono>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
 
 #define GLM_FORCE_RADIANS
 #include "glm/gtc/matrix_transform.hpp"
@@ -31,16 +36,26 @@
 #include "Vulkan/Swapchain.hpp"
 #include "Vulkan/Framebuffer.hpp"
 #include "Vulkan/CommandPool.hpp"
+#include "Vulkan/MemoryAllocator.hpp"
+#include "Vulkan/DeletionQueue.hpp"
+#include "Vulkan/GpuProfiler.hpp"
+#include "Vulkan/UploadManager.hpp"
 #include "Vulkan/Buffer.hpp"
+#include "Vulkan/UniformRing.hpp"
 #include "Vulkan/Image.hpp"
 #include "Vulkan/DescriptorSetLayout.hpp"
 #include "Vulkan/DescriptorPool.hpp"
 #include "Vulkan/Semaphore.hpp"
 #include "Vulkan/Fence.hpp"
+#include "Vulkan/FrameCommandAllocator.hpp"
+#include "Vulkan/RecordedPass.hpp"
 #include "Vulkan/RenderPasses/SquarePass.hpp"
 #include "Vulkan/GraphicsPipelines/SquarePipeline.hpp"
 #include "Application/MainWindow.hpp"
 #include "Tools/Array.hpp"
+#include "Tools/SpscRing.hpp"
+#include "Tools/TripleBuffer.hpp"
+#include "Tools/JobSystem.hpp"
 #include "Debug/Debug.hpp"
 
 using namespace std;
@@ -60,17 +75,43 @@ struct UniformBufferObject {
     alignas(16) glm::mat4 proj;
 };
 
+/* A single draw in the scene, as a range of the index buffer. */
+struct DrawCall {
+    /* The number of indices to draw. */
+    uint32_t index_count;
+    /* The first index to draw. */
+    uint32_t first_index;
+};
+
+/* The state the simulation thread hands to the render thread every tick. */
+struct Snapshot {
+    /* How far the model has rotated, in quarter turns. */
+    float rotation;
+    /* The width of the window's framebuffer, which is 0 while it's minimized. */
+    int framebuffer_width;
+    /* The height of the window's framebuffer, which is 0 while it's minimized. */
+    int framebuffer_height;
+};
+
+/* An event the simulation thread sends the render thread when the window was resized. Unlike a snapshot, it may not be replaced by a newer one before the render thread saw it, so these are queued instead. */
+struct ResizeEvent {
+    /* The width of the window's framebuffer right after the resize. */
+    int framebuffer_width;
+    /* The height of the window's framebuffer right after the resize. */
+    int framebuffer_height;
+};
+
 
 
 
 
 /***** CONSTANTS *****/
 /* List of device extensions that we want to be enabled. */
-const Array<const char*> device_extensions = {
+const Vulkan::NameList device_extensions = {
     VK_KHR_SWAPCHAIN_EXTENSION_NAME
 };
 /* List of validation layers that we want to be enabled. */
-const Array<const char*> required_layers = {
+const Vulkan::NameList required_layers = {
     "VK_LAYER_KHRONOS_validation"
 };
 
@@ -85,14 +126,32 @@ const Array<Vertex> vertices = {
 const Array<uint16_t> indices = {
     0, 1, 2, 2, 3, 0
 };
+/* The draws that make up the scene, which for now is only the square. */
+const Array<DrawCall> draw_calls = {
+    { static_cast<uint32_t>(indices.size()), 0 }
+};
+/* The number of draws from which on they're recorded in parallel, in several secondary command buffers. Below that, they're recorded in a single one on the render thread, since splitting them costs more than it saves. */
+const size_t parallel_draw_threshold = 256;
+/* The number of draws recorded in each secondary command buffer. */
+const size_t draws_per_secondary = 128;
+/* The number of frames that may be in flight at the same time, each with its own command buffers, queries and region in the uniform ring. */
+const uint32_t frames_in_flight = 3;
+/* The time between two ticks of the simulation, which runs at a fixed rate of 120 ticks per second regardless of how fast frames are rendered. */
+const std::chrono::nanoseconds simulation_tick(1000000000 / 120);
+/* The number of resize events that may wait for the render thread at the same time. If it's full, the simulation thread tries again the next tick. */
+const size_t resize_event_capacity = 16;
+/* The environment variable that, if set, enables the CPU profiler and names the file to write its Chrome trace to. */
+const char* trace_variable = "HELLOVIKINGROOM_TRACE";
+/* The environment variable that, if set, names the file to write the log to as a binary log (see decode_log) instead of printing it. */
+const char* log_variable = "HELLOVIKINGROOM_LOG";
 
 
 
 
 
 /***** HELPER FUNCTIONS *****/
-/* Gets all global extensions as an Array. */
-Array<const char*> get_global_extensions() {
+/* Gets all global extensions as a list. */
+Vulkan::NameList get_global_extensions() {
     DENTER("get_global_extensions");
     DLOG(info, "Getting global extensions...");
 
@@ -102,7 +161,7 @@ Array<const char*> get_global_extensions() {
     glfw_extensions = glfwGetRequiredInstanceExtensions(&n_glfw_extensions);
 
     // Put them in an array
-    Array<const char*> result(glfw_extensions, n_glfw_extensions);
+    Vulkan::NameList result(glfw_extensions, n_glfw_extensions);
 
     #ifndef NDEBUG
     // We'll add the extension for the debugger
@@ -114,7 +173,7 @@ Array<const char*> get_global_extensions() {
 }
 
 /* Checks if the given array of global extensions are supported by the current Vulkan installation. */
-void verify_global_extensions(const Array<const char*>& to_verify) {
+void verify_global_extensions(const Vulkan::NameList& to_verify) {
     DENTER("verify_global_extensions");
     DLOG(info, "Verifying if global extensions are supported...");
 
@@ -156,7 +215,7 @@ void verify_global_extensions(const Array<const char*>& to_verify) {
 }
 
 /* Checks if all the desired layers are present, and returns a list with layers that are. */
-Array<const char*> trim_layers(const Array<const char*>& to_trim) {
+Vulkan::NameList trim_layers(const Vulkan::NameList& to_trim) {
     DENTER("trim_layers");
     DLOG(info, "Verifying if desired validation layers are supported...");
 
@@ -171,7 +230,7 @@ Array<const char*> trim_layers(const Array<const char*>& to_trim) {
     }
 
     // Loop to find any missing extensions
-    Array<const char*> supported_layers(n_existing_layers);
+    Vulkan::NameList supported_layers;
     DINDENT;
     for (size_t i = 0; i < to_trim.size(); i++) {
         // Check if this extension is in the list
@@ -190,14 +249,64 @@ Array<const char*> trim_layers(const Array<const char*>& to_trim) {
     }
     DDEDENT;
 
-    // Decrease the size of the supported layers
-    supported_layers.reserve(supported_layers.size());
-
     // Done
     DRETURN supported_layers;
 }
 
-/* Records the command buffer for a single framebuffer. */
+/* Records the given range of the scene's draws in a secondary command buffer, together with everything they need bound, since secondaries inherit no state. */
+void record_draws(
+    VkCommandBuffer command_buffer,
+    const Vulkan::GraphicsPipeline& graphics_pipeline,
+    const Vulkan::Swapchain& swapchain,
+    const Vulkan::Buffer& vertex_buffer,
+    const Vulkan::Buffer& index_buffer,
+    const Vulkan::DescriptorSetRef& descriptor_set,
+    uint32_t uniform_offset,
+    size_t start_index,
+    size_t stop_index
+) {
+    // Next, register the pipeline to use
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline);
+
+    // The viewport and scissor are dynamic, so set them to cover the entire swapchain image here
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = (float) swapchain.extent().width;
+    viewport.height = (float) swapchain.extent().height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+    VkRect2D scissor{};
+    scissor.offset = { 0, 0 };
+    scissor.extent = swapchain.extent();
+    vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+
+    // Now we'll bind the buffers so the GPU knows to use them
+    VkBuffer vertex_buffers[] = { vertex_buffer };
+    VkDeviceSize offsets[] = { 0 };
+    // Note that the command can be used to bind more buffers at once, but we won't do that
+    vkCmdBindVertexBuffers(command_buffer, 0, 1, vertex_buffers, offsets);
+    // Also bind the index buffer, specifying its type
+    vkCmdBindIndexBuffer(command_buffer, index_buffer, 0, VK_INDEX_TYPE_UINT16);
+
+    // Before we draw, bind the uniform ring via its descriptor, passing where this frame's data lives in it as dynamic offset
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline.pipeline_layout(), 0, 1, &descriptor_set.descriptor_set(), 1, &uniform_offset);
+
+    // We have told it how to start and how to render - all we have to tell it is what to render
+    // Here, we pass the following information for each draw:
+    //   - The command buffer that should start drawing
+    //   - How many indices we'll draw
+    //   - We don't do instance rendering (whatever that may be), so we pass 1
+    //   - The first index in the index buffer
+    //   - The offset added to each index before it's looked up in the vertex buffer
+    //   - The first index of the instance buffer, i.e., the lowest value of gl_InstanceIndex in the shaders (not used)
+    for (size_t i = start_index; i < stop_index; i++) {
+        vkCmdDrawIndexed(command_buffer, draw_calls[i].index_count, 1, draw_calls[i].first_index, 0, 0);
+    }
+}
+
+/* Records the command buffer of the given frame in flight, which renders to the given framebuffer. The draws are executed from the scene's pass, which only records them again if it's dirty. */
 void record_command_buffer(
     Vulkan::CommandBuffer& command_buffer,
     const Vulkan::GraphicsPipeline& graphics_pipeline,
@@ -206,13 +315,19 @@ void record_command_buffer(
     const Vulkan::Framebuffer& framebuffer,
     const Vulkan::Buffer& vertex_buffer,
     const Vulkan::Buffer& index_buffer,
-    const Vulkan::DescriptorSetRef& descriptor_set
+    const Vulkan::DescriptorSetRef& descriptor_set,
+    uint32_t uniform_offset,
+    Vulkan::RecordedPass& scene_pass,
+    Vulkan::GpuProfiler& gpu_profiler,
+    uint32_t frame
 ) {
     DENTER("record_command_buffer");
-    DLOG(info, "Recording command buffer...");
 
-    // Begin recording
-    command_buffer.begin();
+    // Begin recording. It's recorded anew every frame, so it's only submitted once
+    command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    // Reset the profiler's queries for this frame before we use them
+    gpu_profiler.begin_frame(command_buffer, frame);
+    uint32_t render_pass_scope = gpu_profiler.begin_scope(command_buffer, frame, "render pass");
 
     // First, we'll start a render pass
     VkRenderPassBeginInfo render_pass_info{};
@@ -228,34 +343,18 @@ void record_command_buffer(
     VkClearValue clear_color = { 0.0f, 0.0f, 0.0f, 1.0f };
     render_pass_info.clearValueCount = 1;
     render_pass_info.pClearValues = &clear_color;
-    // Time to start recording it with these configs. The final parameter decides if we execute the parameters in the primary buffer itself (INLINE) or in a secondary buffer.
-    vkCmdBeginRenderPass(command_buffer, &render_pass_info, VK_SUBPASS_CONTENTS_INLINE);
-
-    // Next, register the pipeline to use
-    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline);
-
-    // Now we'll bind the buffers so the GPU knows to use them
-    VkBuffer vertex_buffers[] = { vertex_buffer };
-    VkDeviceSize offsets[] = { 0 };
-    // Note that the command can be used to bind more buffers at once, but we won't do that
-    vkCmdBindVertexBuffers(command_buffer, 0, 1, vertex_buffers, offsets);
-    // Also bind the index buffer, specifying its type
-    vkCmdBindIndexBuffer(command_buffer, index_buffer, 0, VK_INDEX_TYPE_UINT16);
+    // Time to start recording it with these configs. The draws live in secondary command buffers, so that they can be kept between frames
+    vkCmdBeginRenderPass(command_buffer, &render_pass_info, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
 
-    // Before we draw, bind the uniform buffers via their descriptors
-    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline.pipeline_layout(), 0, 1, &descriptor_set.descriptor_set(), 0, nullptr);
-
-    // We have told it how to start and how to render - all we have to tell it is what to render
-    // Here, we pass the following information:
-    //   - The command buffer that should start drawing
-    //   - How many vertices we'll draw (the size of the global buffer, of course)
-    //   - We don't do instance rendering (whatever that may be), so we pass 1
-    //   - The first index in the vertex buffer, i.e., the lowest value of gl_VertexIndex in the shaders
-    //   - The first index of the instance buffer, i.e., the lowest value of gl_InstanceIndex in the shaders (not used)
-    vkCmdDrawIndexed(command_buffer, static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
+    // Execute the scene's draws, recording them first if they changed. Long lists are split over the job system's workers. The draws aren't profiled separately, since a subpass that executes secondaries may not contain any other commands
+    size_t grain_size = draw_calls.size() >= parallel_draw_threshold ? draws_per_secondary : draw_calls.size();
+    scene_pass.execute(command_buffer, frame, render_pass, 0, draw_calls.size(), grain_size, [&](VkCommandBuffer secondary, size_t start_index, size_t stop_index) {
+        record_draws(secondary, graphics_pipeline, swapchain, vertex_buffer, index_buffer, descriptor_set, uniform_offset, start_index, stop_index);
+    });
 
     // Once it has been drawn, we can end the render pass
     vkCmdEndRenderPass(command_buffer);
+    gpu_profiler.end_scope(command_buffer, frame, render_pass_scope);
 
     // End recording
     command_buffer.end();
@@ -263,120 +362,119 @@ void record_command_buffer(
     DRETURN;
 }
 
-/* Helper function that resizes the swapchain and classes that (indirectly) use it. */
+/* Helper function that resizes the swapchain and classes that (indirectly) use it, and marks the scene's pass dirty so that its draws are recorded again. Doesn't wait for the device; everything that frames in flight may still use is retired through the deletion queue instead. */
 void resize_swapchain(
-    MainWindow& window,
+    const MainWindow& window,
+    TripleBuffer<Snapshot>& snapshots,
+    const std::atomic<bool>& running,
     Vulkan::Device& device,
     Vulkan::Swapchain& swapchain,
     Vulkan::RenderPass& render_pass,
     Vulkan::GraphicsPipeline& graphics_pipeline,
     Array<Vulkan::Framebuffer>& framebuffers,
-    Vulkan::CommandPool& command_pool,
-    Array<Vulkan::CommandBuffer>& command_buffers,
-    const Vulkan::Buffer& vertex_buffer,
-    const Vulkan::Buffer& index_buffer,
-    Array<Vulkan::Buffer>& uniform_buffers,
-    Vulkan::DescriptorPool& descriptor_pool,
-    const Vulkan::DescriptorSetLayout& descriptor_layout,
-    Array<Vulkan::DescriptorSetRef>& descriptor_sets
+    Vulkan::RecordedPass& scene_pass
 ) {
     DENTER("resize_swapchain");
 
-    // Wait until we're not minimized, i.e., the size is something other than 0x0
-    int window_width = 0, window_height = 0;
-    glfwGetFramebufferSize(window, &window_width, &window_height);
-    while (window_width == 0 || window_height == 0) {
-        // Simply wait until the next event
-        window.do_events();
-        glfwGetFramebufferSize(window, &window_width, &window_height);
+    // Wait until we're not minimized, i.e., the size the simulation thread last saw is something other than 0x0. Stop waiting if the application is closed in the meantime
+    const Snapshot* snapshot = &snapshots.latest();
+    while (snapshot->framebuffer_width == 0 || snapshot->framebuffer_height == 0) {
+        if (!running.load()) { DRETURN; }
+        // Simply wait until the next tick
+        std::this_thread::sleep_for(simulation_tick);
+        snapshot = &snapshots.latest();
     }
 
-    // Next, wait until the device is idle before we re-create half of it
-    device.wait_idle();
-
-    // Now, re-create the swapchain, render pass and graphics pipeline
-    device.refresh_info(window);
-    swapchain.resize(window);
+    // Re-create the swapchain, handing it the old one so that it can keep presenting in the meantime. The size comes from the snapshot, since only the main thread may ask GLFW for it. The render pass and graphics pipeline only change if the swapchain's format did, since the viewport is dynamic
+    device.refresh_info(window.surface());
+    swapchain.resize({ static_cast<uint32_t>(snapshot->framebuffer_width), static_cast<uint32_t>(snapshot->framebuffer_height) });
     render_pass.resize(swapchain);
     graphics_pipeline.resize(swapchain, render_pass);
 
-    // Re-create the unchanged part of the framebuffers and the command buffers
+    // Re-create the unchanged part of the framebuffers. The old ones are retired through the deletion queue
     framebuffers.reserve(swapchain.imageviews().size());
-    command_buffers.reserve(swapchain.imageviews().size());
     size_t to_resize = std::min(framebuffers.size(), swapchain.imageviews().size());
     for (size_t i = 0; i < to_resize; i++) {
         framebuffers[i].resize(swapchain.imageviews()[i], swapchain, render_pass);
     }
-
-    // Create new framebuffers, command buffers & uniform buffers if the new swapchain size is larger than before
+    // Create new framebuffers if the new swapchain size is larger than before
     for (size_t i = framebuffers.size(); i < swapchain.imageviews().size(); i++) {
         framebuffers.push_back(
             Vulkan::Framebuffer(device, swapchain.imageviews()[i], swapchain, render_pass)
         );
-        command_buffers.push_back(
-            command_pool.get_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY)
-        );
-        uniform_buffers.push_back(Vulkan::Buffer(
-            device,
-            sizeof(UniformBufferObject),
-            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        ));
     }
 
-    // Also update all the descriptor pool and all its sets
-    descriptor_pool.resize(static_cast<uint32_t>(swapchain.images().size()), static_cast<uint32_t>(swapchain.images().size()));
-    descriptor_sets = descriptor_pool.get_descriptor(static_cast<uint32_t>(swapchain.images().size()), descriptor_layout);
-    for (size_t i = 0; i < descriptor_sets.size(); i++) {
-        descriptor_sets[i].set(uniform_buffers[i]);
-    }
+    // The command buffers are recorded every frame, so they pick up the new structures by themselves. Only the scene's draws are kept between frames, and those depend on the pipeline and the extent
+    scene_pass.mark_dirty();
 
-    // Next, record all command buffers again with all the re-done structures
-    for (size_t i = 0; i < command_buffers.size(); i++) {
-        record_command_buffer(
-            command_buffers[i],
-            graphics_pipeline,
-            render_pass,
-            swapchain,
-            framebuffers[i],
-            vertex_buffer,
-            index_buffer,
-            descriptor_sets[i]
-        );
+    DRETURN;
+}
+
+/* Runs the simulation on this thread until the window is closed or rendering stops. Every tick, it handles the window's events, rotates the model if left or right is held and hands a snapshot of the result to the render thread. Resizes of the window are sent to the render thread as events. */
+void simulate(MainWindow& window, TripleBuffer<Snapshot>& snapshots, SpscRing<ResizeEvent>& resize_events, std::atomic<bool>& running) {
+    DENTER("simulate");
+
+    // Keep track of how far we rotated and whether there's a resize the render thread doesn't know about yet
+    float rotation = 0.0f;
+    bool resize_pending = false;
+    const float tick_seconds = std::chrono::duration<float>(simulation_tick).count();
+
+    std::chrono::steady_clock::time_point next_tick = std::chrono::steady_clock::now();
+    while (running.load() && !window.done()) {
+        // Profile each tick as a single zone, so they stand out in the trace
+        DZONE("tick");
+
+        // Handle any window events (like resizing, ending, etc). GLFW only allows this on the main thread, which is why the simulation runs here
+        window.do_events();
+        if (window.resized()) {
+            resize_pending = true;
+            window.reset_resized();
+        }
+
+        // Rotate a quarter turn per second in whichever direction is held
+        if (window.left_pressed()) {
+            rotation += tick_seconds;
+        } else if (window.right_pressed()) {
+            rotation -= tick_seconds;
+        }
+
+        // Hand the new state to the render thread. If it hasn't picked up the previous one yet, this one replaces it, so it always renders the newest state
+        Snapshot& snapshot = snapshots.write_buffer();
+        snapshot.rotation = rotation;
+        glfwGetFramebufferSize(window, &snapshot.framebuffer_width, &snapshot.framebuffer_height);
+        int framebuffer_width = snapshot.framebuffer_width;
+        int framebuffer_height = snapshot.framebuffer_height;
+        snapshots.publish();
+
+        // Tell the render thread about a resize separately, since it may not miss one. If its queue is full, it still has resizes to handle anyway, so we simply try again next tick
+        if (resize_pending && resize_events.push(ResizeEvent{ framebuffer_width, framebuffer_height })) {
+            resize_pending = false;
+        }
+
+        // Wait for the next tick. If we fell behind (e.g., while the window was being dragged), don't try to catch up
+        next_tick += simulation_tick;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (next_tick < now) {
+            next_tick = now;
+        } else {
+            std::this_thread::sleep_until(next_tick);
+        }
     }
 
-    // Finally, reset the window resize state and we're done
-    window.reset_resized();
+    // Let the render thread know we're done
+    running.store(false);
     DRETURN;
 }
 
-/* Helper function that computes the new transformation matrices s.t. the image will nicely rotate. */
-void update_uniform_buffer(const MainWindow& window, Array<Vulkan::Buffer>& uniform_buffers, const Vulkan::Swapchain& swapchain, uint32_t image_index) {
+/* Helper function that computes the transformation matrices for the given snapshot and writes them to the given frame's region in the uniform ring. Returns the dynamic offset to bind them with. */
+uint32_t update_uniform_buffer(const Snapshot& snapshot, Vulkan::UniformRing& uniform_ring, const Vulkan::Swapchain& swapchain, uint32_t frame) {
     DENTER("update_uniform_buffer");
 
-    // Use a static variable to keep track of the last time the function was called
-    static std::chrono::high_resolution_clock::time_point last_update = std::chrono::high_resolution_clock::now();
-    // Use another static to keep track of how far we rotated
-    static float rotation_state = 0;
-
-    // Mod that by the amount move
-    if (window.left_pressed()) {
-        // Compute the time that has passed since last call
-        std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
-        // Add that to the rotation state
-        rotation_state += std::chrono::duration_cast<std::chrono::duration<float>>(now - last_update).count();
-    } else if (window.right_pressed()) {
-        // Compute the time that has passed since last call
-        std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
-        // Add that to the rotation state (inverted since we got the other way)
-        rotation_state -= std::chrono::duration_cast<std::chrono::duration<float>>(now - last_update).count();
-    }
-
     // Define the translation matrices
     UniformBufferObject translations{};
-    // First we translate the model to world space; in this case, we rotate it over the Z-axis (last vec) by 90 degrees, depending on the amount of time passed
+    // First we translate the model to world space; in this case, we rotate it over the Z-axis (last vec) by 90 degrees per quarter turn the simulation says we rotated
     // Since it's the first translation, we start with the unit matrix
-    translations.model = glm::rotate(glm::mat4(1.0f), rotation_state * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    translations.model = glm::rotate(glm::mat4(1.0f), snapshot.rotation * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
     // Next, we add the view matrix. It will be lookup straight at the square, but then above and away (2, 2, 2) from 45 degrees down. The up axis is here defined to be the Z-axis.
     translations.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
     // Finally, the projection matrix, which has a field-of-view of 45 degrees and uses the swapchain to keep the aspect ratio equal to the window size.
@@ -385,13 +483,36 @@ void update_uniform_buffer(const MainWindow& window, Array<Vulkan::Buffer>& unif
     // Don't forget to flip the Y-axis of the translation matrix (we flip the Y-scalar), though, as this library is for OpenGL and that uses an inverted Y-axis
     translations.proj[1][1] *= -1;
 
-    // Next, we update all the uniform buffer for the current image
-    uniform_buffers[image_index].set((void*) &translations, sizeof(UniformBufferObject));
+    // Next, start this frame's region in the uniform ring, and write the matrices in one go to where they are allocated in it. The ring marks them dirty, so they're flushed together with everything else this frame.
+    uniform_ring.begin_frame(frame);
+    uint32_t uniform_offset;
+    *uniform_ring.allocate<UniformBufferObject>(uniform_offset) = translations;
+    // The scene's draws are only re-recorded when they're dirty, so they keep whatever offset they were recorded with. That only works as long as it's the first allocation in the region, which always lands at the start of it
+    if (uniform_offset != uniform_ring.frame_offset(frame)) {
+        DLOGF(fatal, "Uniform buffer object for frame {} was allocated at offset {} instead of at the start of its region ({}).", frame, uniform_offset, uniform_ring.frame_offset(frame));
+    }
 
-    // Note that we updated this the last time
-    last_update = std::chrono::high_resolution_clock::now();
+    DRETURN uniform_offset;
+}
 
-    DRETURN;
+
+
+
+
+/* Stops the CPU profiler and writes what it recorded to the given file as a Chrome trace. Does nothing if the path is nullptr. */
+void write_trace(const char* trace_path) {
+    if (trace_path == nullptr) { return; }
+
+    // Stop first, so nothing is written to the buffers while we read them
+    Debug::profiler.stop();
+
+    // Write the trace
+    std::ofstream file(trace_path);
+    if (!file.is_open()) {
+        std::cerr << "Could not open '" << trace_path << "' for writing the trace." << std::endl;
+        return;
+    }
+    Debug::profiler.write_chrome_trace(file);
 }
 
 
@@ -400,6 +521,15 @@ void update_uniform_buffer(const MainWindow& window, Array<Vulkan::Buffer>& unif
 
 /***** ENTRY POINT *****/
 int main() {
+    // If the user wants a trace, start the profiler before anything else so that startup is in it as well
+    const char* trace_path = std::getenv(trace_variable);
+    if (trace_path != nullptr) { Debug::profiler.start(); }
+    // Likewise, if the user wants a binary log, open it before anything is logged
+    const char* log_path = std::getenv(log_variable);
+    if (log_path != nullptr && !Debug::debugger.open_binary(log_path)) {
+        std::cerr << "Could not open '" << log_path << "' for writing the log; printing it instead." << std::endl;
+    }
+
     DSTART("main thread"); DENTER("main");
     DLOG(auxillary, "");
     DLOG(auxillary, "<<<<< HELLO VIKINGROOM >>>>>");
@@ -411,15 +541,20 @@ int main() {
     // Wrap all code in a try/catch to neatly handle the errors that our DEBUGGER may throw
     try {
         /***** STEP 1: Initialization *****/
+        Debug::profiler.begin("startup");
+
+        // Start the job system's workers, one per core
+        JobSystem job_system;
+
         // Get all the extensions for our window library
-        Array<const char*> global_extensions = get_global_extensions();
+        Vulkan::NameList global_extensions = get_global_extensions();
         // Check if we can use them
         verify_global_extensions(global_extensions);
 
         // Create a vulkan instance
         #ifndef NDEBUG
         // If debug is defined, then also check if the layers are supported
-        Array<const char*> trimmed_layers = trim_layers(required_layers);
+        Vulkan::NameList trimmed_layers = trim_layers(required_layers);
         Vulkan::Instance instance(global_extensions, trimmed_layers);
         #else
         // Just add the extensions, no validation layers
@@ -437,8 +572,8 @@ int main() {
         // Create the swapchain for that device
         Vulkan::Swapchain swapchain(window, device);
 
-        // Create the descriptor layout to bind the uniform buffer for the transformation matrices
-        Vulkan::DescriptorSetLayout descriptor_set_layout(device, VK_SHADER_STAGE_VERTEX_BIT);
+        // Create the descriptor layout to bind the uniform ring for the transformation matrices, with a dynamic offset per frame
+        Vulkan::DescriptorSetLayout descriptor_set_layout(device, VK_SHADER_STAGE_VERTEX_BIT, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC);
         Array<VkDescriptorSetLayout> descriptor_set_layouts({ descriptor_set_layout });
 
         // Create our only render pass (for now), and use that to create a graphics pipeline
@@ -453,216 +588,287 @@ int main() {
             );
         }
 
-        // Create the command pool for all graphics queues
-        Vulkan::CommandPool command_pool(device, device.get_queue_info().graphics(), VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+        // Create the allocator for the command buffers of each frame in flight, whose pools are reset as a whole once the frame is done
+        Vulkan::FrameCommandAllocator frame_commands(device, device.get_queue_info().graphics(), frames_in_flight);
+        // Create the pass that keeps the scene's draws recorded for each frame in flight, recording long lists of them on the job system's workers
+        Vulkan::RecordedPass scene_pass(device, job_system, device.get_queue_info().graphics(), frames_in_flight, "scene");
+
+        // Create the allocator that all buffers and images get their device memory from
+        Vulkan::MemoryAllocator memory_allocator(device);
+        // Create the deletion queue that destroys dropped buffers, images and framebuffers only once the frames in flight are done with them
+        Vulkan::DeletionQueue deletion_queue(device);
+        // Create the profiler that measures the render pass of each frame in flight on the device
+        Vulkan::GpuProfiler gpu_profiler(device, device.get_queue_info().graphics(), frames_in_flight);
+        // Create the profiler that measures each upload batch on the device. It's separate, since batches are submitted to the transfer family and don't follow the frames in flight
+        Vulkan::GpuProfiler upload_profiler(device, device.get_queue_info().transfer(), static_cast<uint32_t>(Vulkan::UploadManager::n_batches));
+        // Create the upload manager that batches all staging copies to device-local memory
+        Vulkan::UploadManager upload_manager(memory_allocator);
+        upload_manager.set_profiler(&upload_profiler);
 
         // Create the vertex buffer
-        Vulkan::Buffer vertex_buffer(device, sizeof(Vertex) * vertices.size(), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-        vertex_buffer.set_staging((void*) vertices.rdata(), sizeof(Vertex) * vertices.size(), command_pool);
+        Vulkan::Buffer vertex_buffer(memory_allocator, sizeof(Vertex) * vertices.size(), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        vertex_buffer.set_staging((void*) vertices.rdata(), sizeof(Vertex) * vertices.size(), upload_manager);
         // Create the index buffer
-        Vulkan::Buffer index_buffer(device, sizeof(uint16_t) * indices.size(), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-        index_buffer.set_staging((void*) indices.rdata(), sizeof(uint16_t) * indices.size(), command_pool);
-        // Create the uniform buffers for the transformation matrices, one per frame in the framebuffers
-        Array<Vulkan::Buffer> uniform_buffers(swapchain.imageviews().size());
-        for (size_t i = 0; i < swapchain.imageviews().size(); i++) {
-            uniform_buffers.push_back(Vulkan::Buffer(
-                device,
-                sizeof(UniformBufferObject),
-                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-            ));
-        }
+        Vulkan::Buffer index_buffer(memory_allocator, sizeof(uint16_t) * indices.size(), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        index_buffer.set_staging((void*) indices.rdata(), sizeof(uint16_t) * indices.size(), upload_manager);
+        // Create the uniform ring for the transformation matrices, with a region of 64 KiB per frame in flight
+        Vulkan::UniformRing uniform_ring(memory_allocator, 64 * 1024, frames_in_flight);
 
         // Load the texture image
-        Vulkan::Image texture(device, command_pool, "textures/texture.jpg", VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        Vulkan::Image texture(memory_allocator, upload_manager, "textures/texture.jpg", VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-        // Create the descriptor pool for the uniform buffers and get the sets from that
-        Vulkan::DescriptorPool descriptor_pool(device, static_cast<uint32_t>(swapchain.images().size()), static_cast<uint32_t>(swapchain.images().size()));
-        Array<Vulkan::DescriptorSetRef> descriptor_sets = descriptor_pool.get_descriptor(static_cast<uint32_t>(swapchain.images().size()), descriptor_set_layout);
-        for (size_t i = 0; i < descriptor_sets.size(); i++) {
-            descriptor_sets[i].set(uniform_buffers[i]);
-        }
+        // Submit all asset uploads in one go. There's no need to wait for them, since the frames are submitted to the graphics queue after the batch (or its acquire barriers, if it runs on a dedicated transfer queue), which ends with a barrier
+        upload_manager.submit();
 
-        // Create the command buffers for each frame in the swapchain
-        Array<Vulkan::CommandBuffer> command_buffers = command_pool.get_buffer(framebuffers.size(), VK_COMMAND_BUFFER_LEVEL_PRIMARY);
-        for (size_t i = 0; i < command_buffers.size(); i++) {
-            // Call the helper function to actually record it
-            record_command_buffer(
-                command_buffers[i],
-                pipeline,
-                render_pass,
-                swapchain,
-                framebuffers[i],
-                vertex_buffer,
-                index_buffer,
-                descriptor_sets[i]
-            );
-        }
+        // Create the descriptor pool for the uniform ring and get its only set from that. The set binds a single object's worth of the ring; which object is chosen with the dynamic offset when binding it
+        Vulkan::DescriptorPool descriptor_pool(device, 1, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC);
+        Array<Vulkan::DescriptorSetRef> descriptor_sets = descriptor_pool.get_descriptor(1, descriptor_set_layout);
+        descriptor_sets[0].set(uniform_ring.buffer(), 0, sizeof(UniformBufferObject));
 
         // Finally, prepare the synchronization objects
         // Signals if an image is ready for drawing
-        Array<Vulkan::Semaphore> image_ready_semaphores(framebuffers.size());
+        Array<Vulkan::Semaphore> image_ready_semaphores(frames_in_flight);
         // Signals if an image is done with being rendered to
-        Array<Vulkan::Semaphore> image_rendered_semaphores(framebuffers.size());
-        // Fence that determines if a swapchain framebuffer is available or not
-        Array<std::shared_ptr<Vulkan::Fence>> frame_in_flight_fences(framebuffers.size());
-        // Fence that determines if a swapchain image is available or not. Is the exact copy of a frame_in_flight_fence.
-        Array<std::shared_ptr<Vulkan::Fence>> image_in_flight_fences(framebuffers.size());
-        for (size_t i = 0; i < framebuffers.size(); i++) {
+        Array<Vulkan::Semaphore> image_rendered_semaphores(frames_in_flight);
+        // Fence that determines if a frame in flight, and with it its command buffers, is available or not
+        Array<std::shared_ptr<Vulkan::Fence>> frame_in_flight_fences(frames_in_flight);
+        for (uint32_t i = 0; i < frames_in_flight; i++) {
             image_ready_semaphores.push_back(Vulkan::Semaphore(device));
             image_rendered_semaphores.push_back(Vulkan::Semaphore(device));
             frame_in_flight_fences.push_back(std::shared_ptr<Vulkan::Fence>(new Vulkan::Fence(device)));
+        }
+        // Fence that determines if a swapchain image is available or not. Is the exact copy of a frame_in_flight_fence.
+        Array<std::shared_ptr<Vulkan::Fence>> image_in_flight_fences(framebuffers.size());
+        for (size_t i = 0; i < framebuffers.size(); i++) {
             image_in_flight_fences.push_back(nullptr);
         }
 
 
 
-        /***** STEP 2: MAIN LOOP *****/
-        DLOG(info, "Running main loop...");
-        size_t current_frame = 0;
-        while (!window.done()) {
-            // Handle any window events (like resizing, ending, etc)
-            window.do_events();
-
-
-
-            /***** STEP 1: GETTING AN IMAGE *****/
-
-            // Wait until our current frame is done with the previous render pass
-            frame_in_flight_fences[current_frame]->wait();
-
-            // Next, we'll get a "new" image from the swapchain. We pass it an image_ready semaphore to keep track of when it's ready, and this is also where we handle window resizes
-            uint32_t image_index;
-            VkResult get_image_result = vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, image_ready_semaphores[current_frame], VK_NULL_HANDLE, &image_index);
-            if (get_image_result == VK_ERROR_OUT_OF_DATE_KHR || get_image_result == VK_SUBOPTIMAL_KHR || window.resized()) {
-                // The window changed size
-                resize_swapchain(
-                    window,
-                    device,
-                    swapchain,
-                    render_pass,
-                    pipeline,
-                    framebuffers,
-                    command_pool,
-                    command_buffers,
-                    vertex_buffer,
-                    index_buffer,
-                    uniform_buffers,
-                    descriptor_pool,
-                    descriptor_set_layout,
-                    descriptor_sets
-                );
-                image_ready_semaphores[current_frame].reset();
-                continue;
-            } else if (get_image_result != VK_SUCCESS) {
-                // We failed getting an image
-                DLOG(fatal, "Failed to get image from swapchain.");
-            }
-
-
+        Debug::profiler.end();
 
-            /***** STEP 2: UPDATING THE TRANSFORMATION MATRICES *****/
-
-            // Wait until the image is not in use either, and not just the frame. Note that this will be skipped if the image isn't retrieved at least once yet
-            if (image_in_flight_fences[image_index] != nullptr) {
-                vkWaitForFences(device, 1, &image_in_flight_fences[image_index]->fence(), VK_TRUE, UINT64_MAX);
-            }
-            // Update the fence to the equivalent frame fence
-            image_in_flight_fences[image_index] = frame_in_flight_fences[current_frame];
-
-            // Call our update function
-            update_uniform_buffer(window, uniform_buffers, swapchain, image_index);
-
-
-
-            /***** STEP 3: SUBMITTING THE RENDER COMMAND BUFFER *****/
-
-            // Next, we'll submit the correct command buffer to draw the triangle
-            VkSubmitInfo submit_info{};
-            submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            // Pass it the semaphores to wait for before starting the command buffer, telling it at which stage in the pipeline to do the waiting
-            VkSemaphore wait_semaphores[] = { image_ready_semaphores[current_frame] };
-            VkPipelineStageFlags wait_stages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-            submit_info.waitSemaphoreCount = 1;
-            submit_info.pWaitSemaphores = wait_semaphores;
-            submit_info.pWaitDstStageMask = wait_stages;
-            // Next, define the command buffer to use
-            submit_info.commandBufferCount = 1;
-            submit_info.pCommandBuffers = &(command_buffers[image_index].command_buffer());
-            // Now we tell it which semaphore to signal once the command buffer is actually done processing
-            VkSemaphore signal_semaphores[] = { image_rendered_semaphores[current_frame] };
-            submit_info.signalSemaphoreCount = 1;
-            submit_info.pSignalSemaphores = signal_semaphores;
-            // Reset this frame's fence, so that we signal it's in use again
-            vkResetFences(device, 1, &frame_in_flight_fences[current_frame]->fence());
-
-            // Now that's done, submit the command buffer to the queue!
-            // Note that we use the fence to be able to say if this frame was done or not, and that we may schedule more than one command buffers at once
-            if (vkQueueSubmit(device.graphics_queue(), 1, &submit_info, *frame_in_flight_fences[current_frame]) != VK_SUCCESS) {
-                DLOG(fatal, "Could not submit command buffer to the graphics queue.");
-            }
 
 
+        /***** STEP 2: MAIN LOOP *****/
+        DLOG(info, "Running main loop...");
 
-            /***** STEP 4: PRESENTING THE FRAME *****/
-
-            // With the rendering process scheduled, it's now time to define what happens when that's done
-            VkPresentInfoKHR present_info{};
-            present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-            // Let it specify which semaphore to wait for until beginning
-            present_info.waitSemaphoreCount = 1;
-            present_info.pWaitSemaphores = signal_semaphores;
-            // Next, define which swapchain we'll present which image to
-            VkSwapchainKHR swap_chains[] = { swapchain };
-            present_info.swapchainCount = 1;
-            present_info.pSwapchains = swap_chains;
-            present_info.pImageIndices = &image_index;
-            // If we're writing to multiple swapchains, we can use this pointer to let us get a list of results for each of them
-            present_info.pResults = nullptr;
-
-            // Let's present it!
-            VkResult present_result = vkQueuePresentKHR(device.presentation_queue(), &present_info);
-            if (present_result == VK_ERROR_OUT_OF_DATE_KHR || present_result == VK_SUBOPTIMAL_KHR || window.resized()) {
-                // The window changed size
-                resize_swapchain(
-                    window,
-                    device,
-                    swapchain,
-                    render_pass,
-                    pipeline,
-                    framebuffers,
-                    command_pool,
-                    command_buffers,
-                    vertex_buffer,
-                    index_buffer,
-                    uniform_buffers,
-                    descriptor_pool,
-                    descriptor_set_layout,
-                    descriptor_sets
-                );
-                image_ready_semaphores[current_frame].reset();
-                continue;
-            } else if (present_result != VK_SUCCESS) {
-                // We failed
-                DLOG(info, "Could not submit resulting image to the presentation queue");
+        // Exchange the simulation's state through a triple buffer, so that neither thread ever waits for the other. Resizes go through a queue next to it, so that none of them get lost
+        Snapshot first_snapshot{};
+        glfwGetFramebufferSize(window, &first_snapshot.framebuffer_width, &first_snapshot.framebuffer_height);
+        TripleBuffer<Snapshot> snapshots(first_snapshot);
+        SpscRing<ResizeEvent> resize_events(resize_event_capacity);
+        // Set to false by whichever thread stops first, which tells the other to stop too
+        std::atomic<bool> running(true);
+
+        // Render on a thread of its own, which owns everything Vulkan from here on and renders as fast as the device allows. Any error it throws is passed on to this thread
+        std::exception_ptr render_error;
+        std::thread render_thread([&]() {
+            DSTART("render thread"); DENTER("render_loop");
+
+            try {
+                uint32_t current_frame = 0;
+                while (running.load()) {
+                    // Profile each iteration as a single zone, so the frames stand out in the trace
+                    DZONE("frame");
+
+                    // Get the newest state from the simulation thread. It's copied, since resizing may need to fetch a newer one
+                    Snapshot snapshot = snapshots.latest();
+                    // Handle all resizes that happened since the last frame at once, since only the newest size matters
+                    bool resized = false;
+                    ResizeEvent resize_event;
+                    while (resize_events.pop(resize_event)) {
+                        DLOGF(info, "Window resized to {}x{}", resize_event.framebuffer_width, resize_event.framebuffer_height);
+                        resized = true;
+                    }
+
+
+
+                    /***** STEP 1: GETTING AN IMAGE *****/
+
+                    // Wait until our current frame is done with the previous render pass
+                    frame_in_flight_fences[current_frame]->wait();
+                    // Destroy whatever was dropped in frames that are done by now
+                    deletion_queue.collect();
+                    // The frame's previous queries are done, so its profiling results can be read back without waiting
+                    gpu_profiler.collect(current_frame);
+
+                    // Next, we'll get a "new" image from the swapchain. We pass it an image_ready semaphore to keep track of when it's ready, and this is also where we handle window resizes
+                    uint32_t image_index;
+                    VkResult get_image_result = vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, image_ready_semaphores[current_frame], VK_NULL_HANDLE, &image_index);
+                    if (get_image_result == VK_ERROR_OUT_OF_DATE_KHR || get_image_result == VK_SUBOPTIMAL_KHR || resized) {
+                        // The window changed size
+                        resize_swapchain(
+                            window,
+                            snapshots,
+                            running,
+                            device,
+                            swapchain,
+                            render_pass,
+                            pipeline,
+                            framebuffers,
+                            scene_pass
+                        );
+                        image_ready_semaphores[current_frame].reset();
+                        continue;
+                    } else if (get_image_result != VK_SUCCESS) {
+                        // We failed getting an image
+                        DLOG(fatal, "Failed to get image from swapchain.");
+                    }
+
+
+
+                    /***** STEP 2: UPDATING THE TRANSFORMATION MATRICES *****/
+
+                    // Wait until the image is not in use either, and not just the frame. Note that this will be skipped if the image isn't retrieved at least once yet
+                    if (image_in_flight_fences[image_index] != nullptr) {
+                        vkWaitForFences(device, 1, &image_in_flight_fences[image_index]->fence(), VK_TRUE, UINT64_MAX);
+                    }
+                    // Update the fence to the equivalent frame fence
+                    image_in_flight_fences[image_index] = frame_in_flight_fences[current_frame];
+
+                    // Call our update function
+                    uint32_t uniform_offset = update_uniform_buffer(snapshot, uniform_ring, swapchain, current_frame);
+                    // Flush all host writes of this frame to the device in one go (a no-op on coherent memory)
+                    memory_allocator.flush();
+
+
+
+                    /***** STEP 3: RECORDING AND SUBMITTING THE RENDER COMMAND BUFFER *****/
+
+                    // The frame is done, so reset its command pool and record a fresh command buffer for the image we got. The scene's draws are only recorded again if they changed
+                    frame_commands.begin_frame(current_frame);
+                    Vulkan::CommandBuffer& command_buffer = frame_commands.allocate();
+                    record_command_buffer(
+                        command_buffer,
+                        pipeline,
+                        render_pass,
+                        swapchain,
+                        framebuffers[image_index],
+                        vertex_buffer,
+                        index_buffer,
+                        descriptor_sets[0],
+                        uniform_offset,
+                        scene_pass,
+                        gpu_profiler,
+                        current_frame
+                    );
+
+                    // Next, we'll submit the command buffer to draw the triangle
+                    VkSubmitInfo submit_info{};
+                    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+                    // Pass it the semaphores to wait for before starting the command buffer, telling it at which stage in the pipeline to do the waiting
+                    VkSemaphore wait_semaphores[] = { image_ready_semaphores[current_frame] };
+                    VkPipelineStageFlags wait_stages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+                    submit_info.waitSemaphoreCount = 1;
+                    submit_info.pWaitSemaphores = wait_semaphores;
+                    submit_info.pWaitDstStageMask = wait_stages;
+                    // Next, define the command buffer to use
+                    submit_info.commandBufferCount = 1;
+                    submit_info.pCommandBuffers = &command_buffer.command_buffer();
+                    // Now we tell it which semaphore to signal once the command buffer is actually done processing
+                    VkSemaphore signal_semaphores[] = { image_rendered_semaphores[current_frame] };
+                    submit_info.signalSemaphoreCount = 1;
+                    submit_info.pSignalSemaphores = signal_semaphores;
+                    // Reset this frame's fence, so that we signal it's in use again
+                    vkResetFences(device, 1, &frame_in_flight_fences[current_frame]->fence());
+
+                    // Now that's done, submit the command buffer to the queue!
+                    // Note that we use the fence to be able to say if this frame was done or not, and that we may schedule more than one command buffers at once
+                    if (vkQueueSubmit(device.graphics_queue(), 1, &submit_info, *frame_in_flight_fences[current_frame]) != VK_SUCCESS) {
+                        DLOG(fatal, "Could not submit command buffer to the graphics queue.");
+                    }
+                    // Anything dropped up to now may be used by this frame, so it's destroyed once its fence is signalled
+                    deletion_queue.end_frame(*frame_in_flight_fences[current_frame]);
+                    // Let the profiler know this frame's queries are in flight again
+                    gpu_profiler.submitted(current_frame);
+
+
+
+                    /***** STEP 4: PRESENTING THE FRAME *****/
+
+                    // With the rendering process scheduled, it's now time to define what happens when that's done
+                    VkPresentInfoKHR present_info{};
+                    present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+                    // Let it specify which semaphore to wait for until beginning
+                    present_info.waitSemaphoreCount = 1;
+                    present_info.pWaitSemaphores = signal_semaphores;
+                    // Next, define which swapchain we'll present which image to
+                    VkSwapchainKHR swap_chains[] = { swapchain };
+                    present_info.swapchainCount = 1;
+                    present_info.pSwapchains = swap_chains;
+                    present_info.pImageIndices = &image_index;
+                    // If we're writing to multiple swapchains, we can use this pointer to let us get a list of results for each of them
+                    present_info.pResults = nullptr;
+
+                    // Let's present it!
+                    VkResult present_result = vkQueuePresentKHR(device.presentation_queue(), &present_info);
+                    if (present_result == VK_ERROR_OUT_OF_DATE_KHR || present_result == VK_SUBOPTIMAL_KHR) {
+                        // The window changed size
+                        resize_swapchain(
+                            window,
+                            snapshots,
+                            running,
+                            device,
+                            swapchain,
+                            render_pass,
+                            pipeline,
+                            framebuffers,
+                            scene_pass
+                        );
+                        image_ready_semaphores[current_frame].reset();
+                        continue;
+                    } else if (present_result != VK_SUCCESS) {
+                        // We failed
+                        DLOG(info, "Could not submit resulting image to the presentation queue");
+                    }
+
+
+
+                    /***** STEP 5: MOVE TO NEXT FRAME *****/
+
+                    // Once done, update the frame to the next loop
+                    if (++current_frame >= frames_in_flight) { current_frame = 0; }
+                }
+            } catch (std::exception&) {
+                render_error = std::current_exception();
+                running.store(false);
             }
 
+            DLEAVE;
+        });
 
-
-            /***** STEP 5: MOVE TO NEXT FRAME *****/
-
-            // Once done, update the frame to the next loop
-            if (++current_frame >= 3) { current_frame = 0; }
+        // Meanwhile, run the simulation on this thread at a fixed tick until the window closes
+        try {
+            simulate(window, snapshots, resize_events, running);
+        } catch (std::exception&) {
+            running.store(false);
+            render_thread.join();
+            throw;
         }
+        render_thread.join();
+        if (render_error != nullptr) { std::rethrow_exception(render_error); }
 
         // Once done with the main loop, be sure to wait until the device is ready as well
         device.wait_idle();
 
+        // Report where the device spent its time, averaged over the most recent frames
+        for (size_t i = 0; i < gpu_profiler.latest().size(); i++) {
+            const std::string& scope_name = gpu_profiler.latest()[i].name;
+            DLOGF(auxillary, "GPU time of '{}': {} ms", scope_name, gpu_profiler.average(scope_name));
+        }
+        // Do the same for the uploads, whose timings are only read back once their batches are retired
+        upload_manager.wait_all();
+        if (upload_profiler.enabled()) {
+            DLOGF(auxillary, "GPU time of 'upload': {} ms", upload_profiler.average("upload"));
+        }
+
     } catch (std::exception&) {
         // Destroy the GLFW library
         glfwTerminate();
 
-        DRETURN EXIT_FAILURE;
+        DLEAVE;
+        write_trace(trace_path);
+        return EXIT_FAILURE;
     }
 
     // Destroy the GLFW library
@@ -672,5 +878,7 @@ int main() {
     DLOG(auxillary, "Done.");
     DLOG(auxillary, "");
 
-    DRETURN EXIT_SUCCESS;
+    DLEAVE;
+    write_trace(trace_path);
+    return EXIT_SUCCESS;
 }
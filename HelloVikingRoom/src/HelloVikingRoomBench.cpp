@@ -0,0 +1,768 @@
+/* HELLO VIKING ROOM BENCH.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 17:41:49
+ * Last edited:
+ *   16/10/2026, 23:31:45
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Headless version of HelloVikingRoom, which renders the same scene a
+ *   fixed number of frames into offscreen images instead of a swapchain.
+ *   It needs no window, surface or presentation support, so it can run on
+ *   a software driver (e.g., lavapipe via VK_ICD_FILENAMES). Reports the
+ *   CPU- and GPU frame time percentiles and the throughput as JSON, and
+ *   can optionally write the last frame to a PPM-file for image
+ *   comparison and the GPU profiler's scopes to a CSV-file.
+ *
+ *   The scene can be made to consist of any number of draws, and the
+ *   command buffers can be recorded once up front ('static'), every frame
+ *   ('always') or every frame with the draws only recorded again once
+ *   they're dirty ('dirty'), which is what the windowed version does. To
+ *   compare them on a large scene, run it with, e.g., '--draws 10000' and
+ *   each of the three '--record' modes. To check that a pass that loses
+ *   all of its draws stops executing them, run it with, e.g., '--record
+ *   dirty --shrink-at 100', which empties the scene from that frame on.
+ *
+ *   Usage: hellovikingroom_bench [--frames N] [--warmup N] [--width W]
+ *          [--height H] [--draws N] [--record static|always|dirty]
+ *          [--dirty-every N] [--shrink-at N] [--json FILE]
+ *          [--readback FILE] [--gpu-profile FILE] [--trace FILE]
+ *          [--flame FILE] [--log FILE]
+**/
+
+#include <vulkan/vulkan.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <exception>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <cmath>
+#include <string>
+#include <map>
+#include <cstring>
+#include <cstdlib>
+
+#define GLM_FORCE_RADIANS
+#include "glm/gtc/matrix_transform.hpp"
+#include "Vertices/Vertex.hpp"
+#include "Vulkan/Instance.hpp"
+#include "Vulkan/Device.hpp"
+#include "Vulkan/Framebuffer.hpp"
+#include "Vulkan/CommandPool.hpp"
+#include "Vulkan/FrameCommandAllocator.hpp"
+#include "Vulkan/RecordedPass.hpp"
+#include "Vulkan/MemoryAllocator.hpp"
+#include "Vulkan/DeletionQueue.hpp"
+#include "Vulkan/GpuProfiler.hpp"
+#include "Vulkan/UploadManager.hpp"
+#include "Vulkan/Buffer.hpp"
+#include "Vulkan/UniformRing.hpp"
+#include "Vulkan/Image.hpp"
+#include "Vulkan/DescriptorSetLayout.hpp"
+#include "Vulkan/DescriptorPool.hpp"
+#include "Vulkan/Fence.hpp"
+#include "Vulkan/RenderPasses/SquarePass.hpp"
+#include "Vulkan/GraphicsPipelines/SquarePipeline.hpp"
+#include "Tools/Array.hpp"
+#include "Tools/JobSystem.hpp"
+#include "Debug/Debug.hpp"
+
+using namespace std;
+using namespace HelloVikingRoom;
+using namespace Tools;
+using namespace Debug::SeverityValues;
+
+
+/***** STRUCTS *****/
+/* The UniformBufferObject is used to pass transformation matrices to shaders. Must match the one in HelloVikingRoom.cpp. */
+struct UniformBufferObject {
+    /* The model matrix, which moves an object from model space to world space. */
+    alignas(16) glm::mat4 model;
+    /* The view matrix, which moves everything from world space to camera space. */
+    alignas(16) glm::mat4 view;
+    /* The projection matrix, which moves everything from camera space to homogeneous space. */
+    alignas(16) glm::mat4 proj;
+};
+
+/* Enum that defines how the bench records its command buffers. */
+namespace BenchRecordModes {
+    enum type {
+        /* Records a command buffer per frame in flight once, and submits those every frame. */
+        static_buffers = 0,
+        /* Records a command buffer every frame, including all of its draws. */
+        always = 1,
+        /* Records a command buffer every frame, but only records its draws again once they're marked dirty. */
+        dirty = 2
+    };
+}
+using BenchRecordMode = BenchRecordModes::type;
+
+/* Struct that collects the options given on the command line. */
+struct BenchOptions {
+    /* The number of frames to measure. */
+    size_t n_frames;
+    /* The number of frames to render before measuring. */
+    size_t n_warmup;
+    /* The size of the offscreen images. */
+    VkExtent2D extent;
+    /* The number of draws in the scene, which all draw the same square. */
+    size_t n_draws;
+    /* How the command buffers are recorded. */
+    BenchRecordMode record_mode;
+    /* In the dirty mode, marks the draws dirty every this many frames. 0 to only record them once per frame in flight. */
+    size_t dirty_every;
+    /* In the per-frame modes, removes all draws from the scene from this frame on. 0 to keep them. */
+    size_t shrink_at;
+    /* The file to write the JSON results to. Empty to write them to stdout. */
+    std::string json_path;
+    /* The file to write the last frame to as PPM. Empty to not read it back. */
+    std::string readback_path;
+    /* The file to write the GPU profiler's results to as CSV. Empty to not write them. */
+    std::string profile_path;
+    /* The file to write the CPU profiler's zones to as a Chrome trace. Empty to not write them. */
+    std::string trace_path;
+    /* The file to write the CPU profiler's zones to as folded stacks. Empty to not write them. */
+    std::string flame_path;
+    /* The file to write the log to as a binary log. Empty to print it. */
+    std::string log_path;
+};
+
+
+
+
+
+/***** CONSTANTS *****/
+/* The number of frames that may be in flight at the same time, each with its own offscreen image. */
+static const uint32_t frames_in_flight = 3;
+/* The format of the offscreen images. Plain RGBA so it's supported everywhere and can be written to a PPM as-is. */
+static const VkFormat offscreen_format = VK_FORMAT_R8G8B8A8_UNORM;
+/* The simulated time between two frames, in seconds. Fixed so that the rendered frames only depend on their index. */
+static const float frame_step = 1.0f / 60.0f;
+/* The number of draws from which on they're recorded in parallel, in several secondary command buffers. Must match the one in HelloVikingRoom.cpp. */
+static const size_t parallel_draw_threshold = 256;
+/* The number of draws recorded in each secondary command buffer. Must match the one in HelloVikingRoom.cpp. */
+static const size_t draws_per_secondary = 128;
+
+/* List of the vertices used for drawing the square. */
+const Array<Vertex> vertices = {
+    Vertex(glm::vec2(-0.5f, -0.5f), glm::vec3(1.0f, 0.0f, 0.0f)),
+    Vertex(glm::vec2(0.5f, -0.5f), glm::vec3(0.0f, 1.0f, 0.0f)),
+    Vertex(glm::vec2(0.5f, 0.5f), glm::vec3(0.0f, 0.0f, 1.0f)),
+    Vertex(glm::vec2(-0.5f, 0.5f), glm::vec3(1.0f, 1.0f, 1.0f))
+};
+/* Index buffer for the vertices. */
+const Array<uint16_t> indices = {
+    0, 1, 2, 2, 3, 0
+};
+
+
+
+
+
+/***** HELPER FUNCTIONS *****/
+/* Parses the command line into the given options struct. Returns false if it was malformed. */
+static bool parse_options(int argc, const char** argv, BenchOptions& options) {
+    // Set the defaults
+    options.n_frames = 1000;
+    options.n_warmup = 10;
+    options.extent = { 800, 600 };
+    options.n_draws = 1;
+    options.record_mode = BenchRecordModes::static_buffers;
+    options.dirty_every = 0;
+    options.shrink_at = 0;
+    options.json_path = "";
+    options.readback_path = "";
+    options.profile_path = "";
+    options.trace_path = "";
+    options.flame_path = "";
+    options.log_path = "";
+
+    // Go through the arguments in pairs
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Missing value for option '" << arg << "'" << endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        // Match the option
+        if (arg == "--frames") {
+            options.n_frames = (size_t) std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--warmup") {
+            options.n_warmup = (size_t) std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--width") {
+            options.extent.width = (uint32_t) std::strtoul(value.c_str(), nullptr, 10);
+        } else if (arg == "--height") {
+            options.extent.height = (uint32_t) std::strtoul(value.c_str(), nullptr, 10);
+        } else if (arg == "--draws") {
+            options.n_draws = (size_t) std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--record") {
+            if (value == "static") {
+                options.record_mode = BenchRecordModes::static_buffers;
+            } else if (value == "always") {
+                options.record_mode = BenchRecordModes::always;
+            } else if (value == "dirty") {
+                options.record_mode = BenchRecordModes::dirty;
+            } else {
+                cerr << "Unknown record mode '" << value << "'; expected 'static', 'always' or 'dirty'" << endl;
+                return false;
+            }
+        } else if (arg == "--dirty-every") {
+            options.dirty_every = (size_t) std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--shrink-at") {
+            options.shrink_at = (size_t) std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--json") {
+            options.json_path = value;
+        } else if (arg == "--readback") {
+            options.readback_path = value;
+        } else if (arg == "--gpu-profile") {
+            options.profile_path = value;
+        } else if (arg == "--trace") {
+            options.trace_path = value;
+        } else if (arg == "--flame") {
+            options.flame_path = value;
+        } else if (arg == "--log") {
+            options.log_path = value;
+        } else {
+            cerr << "Unknown option '" << arg << "'" << endl;
+            return false;
+        }
+    }
+
+    // Make sure we render something
+    if (options.n_frames == 0 || options.n_draws == 0 || options.extent.width == 0 || options.extent.height == 0) {
+        cerr << "The number of frames, the number of draws, the width and the height must be larger than 0" << endl;
+        return false;
+    }
+    // The static mode never records its draws again, so it can't lose them either
+    if (options.shrink_at > 0 && options.record_mode == BenchRecordModes::static_buffers) {
+        cerr << "The scene can only be shrunk in the 'always' and 'dirty' record modes" << endl;
+        return false;
+    }
+    return true;
+}
+
+/* Records the first n_draws of the scene's draws, which all draw the square, together with everything they need bound. Used for both primary and secondary command buffers, since the latter inherit no state. */
+static void record_draws(
+    VkCommandBuffer command_buffer,
+    const Vulkan::GraphicsPipeline& graphics_pipeline,
+    const VkExtent2D& extent,
+    const Vulkan::Buffer& vertex_buffer,
+    const Vulkan::Buffer& index_buffer,
+    const Vulkan::DescriptorSetRef& descriptor_set,
+    uint32_t uniform_offset,
+    size_t n_draws
+) {
+    // Bind the pipeline and set the dynamic viewport and scissor to cover the entire image
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline);
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = (float) extent.width;
+    viewport.height = (float) extent.height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+    VkRect2D scissor{};
+    scissor.offset = { 0, 0 };
+    scissor.extent = extent;
+    vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+
+    // Bind the geometry and this frame's region of the uniform ring
+    VkBuffer vertex_buffers[] = { vertex_buffer };
+    VkDeviceSize offsets[] = { 0 };
+    vkCmdBindVertexBuffers(command_buffer, 0, 1, vertex_buffers, offsets);
+    vkCmdBindIndexBuffer(command_buffer, index_buffer, 0, VK_INDEX_TYPE_UINT16);
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline.pipeline_layout(), 0, 1, &descriptor_set.descriptor_set(), 1, &uniform_offset);
+
+    // Draw the square as often as asked
+    for (size_t i = 0; i < n_draws; i++) {
+        vkCmdDrawIndexed(command_buffer, static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
+    }
+}
+
+/* Records the command buffer for a single offscreen frame, with the entire frame and the render pass as profiled scopes. If a pass is given, the draws are executed from that, which only records them if they're dirty. Otherwise, they're recorded inline and profiled as a scope of their own. */
+static void record_command_buffer(
+    Vulkan::CommandBuffer& command_buffer,
+    const Vulkan::GraphicsPipeline& graphics_pipeline,
+    const Vulkan::RenderPass& render_pass,
+    const VkExtent2D& extent,
+    const Vulkan::Framebuffer& framebuffer,
+    const Vulkan::Buffer& vertex_buffer,
+    const Vulkan::Buffer& index_buffer,
+    const Vulkan::DescriptorSetRef& descriptor_set,
+    uint32_t uniform_offset,
+    size_t n_draws,
+    Vulkan::RecordedPass* scene_pass,
+    Vulkan::GpuProfiler& gpu_profiler,
+    uint32_t profiler_slot
+) {
+    DENTER("record_command_buffer");
+    DLOG(info, "Recording command buffer...");
+
+    // Begin recording. If it's recorded every frame, it's only submitted once
+    command_buffer.begin(scene_pass != nullptr ? VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT : 0);
+
+    // Reset this slot's queries and start the scope that spans the entire frame
+    gpu_profiler.begin_frame(command_buffer, profiler_slot);
+    uint32_t frame_scope = gpu_profiler.begin_scope(command_buffer, profiler_slot, "frame");
+    uint32_t render_pass_scope = gpu_profiler.begin_scope(command_buffer, profiler_slot, "render pass");
+
+    // Start the render pass on the offscreen framebuffer, clearing it to black. The draws live in secondaries if they're kept in a pass
+    VkRenderPassBeginInfo render_pass_info{};
+    render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    render_pass_info.renderPass = render_pass;
+    render_pass_info.framebuffer = framebuffer;
+    render_pass_info.renderArea.offset = { 0, 0 };
+    render_pass_info.renderArea.extent = extent;
+    VkClearValue clear_color = { 0.0f, 0.0f, 0.0f, 1.0f };
+    render_pass_info.clearValueCount = 1;
+    render_pass_info.pClearValues = &clear_color;
+    vkCmdBeginRenderPass(command_buffer, &render_pass_info, scene_pass != nullptr ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+
+    if (scene_pass != nullptr) {
+        // Execute the draws from the pass, recording them first (in parallel, if there are enough) if they're dirty
+        size_t grain_size = n_draws >= parallel_draw_threshold ? draws_per_secondary : n_draws;
+        scene_pass->execute(command_buffer, profiler_slot, render_pass, 0, n_draws, grain_size, [&](VkCommandBuffer secondary, size_t start_index, size_t stop_index) {
+            record_draws(secondary, graphics_pipeline, extent, vertex_buffer, index_buffer, descriptor_set, uniform_offset, stop_index - start_index);
+        });
+    } else {
+        // Record the draws right here, profiling them including how many vertices and fragments they produced
+        uint32_t draw_scope = gpu_profiler.begin_scope(command_buffer, profiler_slot, "draw", true);
+        record_draws(command_buffer, graphics_pipeline, extent, vertex_buffer, index_buffer, descriptor_set, uniform_offset, n_draws);
+        gpu_profiler.end_scope(command_buffer, profiler_slot, draw_scope);
+    }
+
+    // End the pass, which leaves the image ready to be copied from
+    vkCmdEndRenderPass(command_buffer);
+    gpu_profiler.end_scope(command_buffer, profiler_slot, render_pass_scope);
+
+    // End the frame's scope once all of its work is done
+    gpu_profiler.end_scope(command_buffer, profiler_slot, frame_scope);
+
+    // End recording
+    command_buffer.end();
+
+    DRETURN;
+}
+
+/* Writes the transformation matrices for the given frame to the uniform ring. The rotation only depends on the frame index, so that runs are reproducible. */
+static void update_uniform_buffer(Vulkan::UniformRing& uniform_ring, const VkExtent2D& extent, uint32_t slot, size_t frame_index) {
+    DENTER("update_uniform_buffer");
+
+    // Compute the same matrices as the windowed version does, but with a fixed time step
+    UniformBufferObject translations{};
+    translations.model = glm::rotate(glm::mat4(1.0f), (float) frame_index * frame_step * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    translations.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    translations.proj = glm::perspective(glm::radians(45.0f), (float) extent.width / (float) extent.height, 0.1f, 10.0f);
+    translations.proj[1][1] *= -1;
+
+    // Write them to this slot's region, whose dynamic offset is the one the command buffers were recorded with. Check that, since the static buffers are never recorded again
+    uniform_ring.begin_frame(slot);
+    uint32_t uniform_offset;
+    *uniform_ring.allocate<UniformBufferObject>(uniform_offset) = translations;
+    if (uniform_offset != uniform_ring.frame_offset(slot)) {
+        DLOGF(fatal, "Uniform buffer object for slot {} was allocated at offset {} instead of at the start of its region ({}).", slot, uniform_offset, uniform_ring.frame_offset(slot));
+    }
+
+    DRETURN;
+}
+
+/* Returns the given percentile (0-100) of the given list of samples, using the nearest-rank method. Sorts the list in the process. */
+static double percentile(Array<double>& samples, double p) {
+    if (samples.size() == 0) { return 0.0; }
+    std::sort(&samples[0], &samples[0] + samples.size());
+    size_t rank = (size_t) std::ceil((p / 100.0) * (double) samples.size());
+    return samples[rank > 0 ? rank - 1 : 0];
+}
+
+/* Adds the times of the GPU profiler's most recently collected scopes to the samples of their name, unless they were measured during the warmup. */
+static void add_gpu_samples(const Vulkan::GpuProfiler& gpu_profiler, size_t n_warmup, std::map<std::string, Array<double>>& samples) {
+    for (size_t i = 0; i < gpu_profiler.latest().size(); i++) {
+        const Vulkan::GpuScopeResult& result = gpu_profiler.latest()[i];
+        if (result.frame >= n_warmup) {
+            samples[result.name].push_back(result.ms);
+        }
+    }
+}
+
+/* Writes a JSON object with the mean and the percentiles of the given samples to the given stream, indented by the given string. */
+static void write_stats(std::ostream& os, const std::string& name, Array<double>& samples, const std::string& indent = "  ") {
+    double sum = 0.0;
+    for (size_t i = 0; i < samples.size(); i++) {
+        sum += samples[i];
+    }
+    os << indent << "\"" << name << "\": {";
+    os << " \"samples\": " << samples.size();
+    os << ", \"mean\": " << (samples.size() > 0 ? sum / (double) samples.size() : 0.0);
+    os << ", \"p50\": " << percentile(samples, 50.0);
+    os << ", \"p90\": " << percentile(samples, 90.0);
+    os << ", \"p99\": " << percentile(samples, 99.0);
+    os << ", \"max\": " << percentile(samples, 100.0);
+    os << " }";
+}
+
+/* Writes the given tightly packed RGBA pixels as a binary PPM-file to the given path. */
+static void write_ppm(const std::string& path, const uint8_t* pixels, const VkExtent2D& extent) {
+    DENTER("write_ppm");
+    DLOG(info, "Writing last frame to '" + path + "'...");
+
+    // Open the file
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        DLOG(fatal, "Could not open '" + path + "' for writing.");
+    }
+
+    // Write the header, then all pixels without their alpha
+    file << "P6\n" << extent.width << " " << extent.height << "\n255\n";
+    for (size_t i = 0; i < (size_t) extent.width * extent.height; i++) {
+        file.write((const char*) pixels + i * 4, 3);
+    }
+
+    DRETURN;
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+int main(int argc, const char** argv) {
+    DSTART("main thread"); DENTER("main");
+
+    // Parse the command line first
+    BenchOptions options;
+    if (!parse_options(argc, argv, options)) {
+        cerr << "Usage: " << argv[0] << " [--frames N] [--warmup N] [--width W] [--height H] [--draws N] [--record static|always|dirty] [--dirty-every N] [--shrink-at N] [--json FILE] [--readback FILE] [--gpu-profile FILE] [--trace FILE] [--flame FILE] [--log FILE]" << endl;
+        DRETURN EXIT_FAILURE;
+    }
+
+    // Write the log to a binary log from here on if the user wants that
+    if (!options.log_path.empty() && !Debug::debugger.open_binary(options.log_path)) {
+        cerr << "Could not open '" << options.log_path << "' for writing the log." << endl;
+        DRETURN EXIT_FAILURE;
+    }
+
+    // Record the CPU zones from here on if the user wants them
+    if (!options.trace_path.empty() || !options.flame_path.empty()) {
+        Debug::profiler.start();
+    }
+
+    // Wrap all code in a try/catch to neatly handle the errors that our DEBUGGER may throw
+    try {
+        /***** STEP 1: Initialization *****/
+        Debug::profiler.begin("startup");
+
+        // Start the job system's workers, which record long lists of draws in the per-frame modes
+        JobSystem job_system;
+
+        // Create an instance and a device without any window or surface, so we need no extensions either. Validation layers are left out, since they'd dominate the timings
+        Vulkan::NameList no_extensions;
+        Vulkan::Instance instance(no_extensions);
+        Vulkan::Device device(instance, VK_NULL_HANDLE, no_extensions);
+
+        // Create the descriptor layout to bind the uniform ring, with a dynamic offset per frame
+        Vulkan::DescriptorSetLayout descriptor_set_layout(device, VK_SHADER_STAGE_VERTEX_BIT, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC);
+        Array<VkDescriptorSetLayout> descriptor_set_layouts({ descriptor_set_layout });
+
+        // Create the render pass and the pipeline for offscreen images, which are left ready to be copied from
+        Vulkan::RenderPasses::SquarePass render_pass(device, offscreen_format, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        Vulkan::GraphicsPipelines::SquarePipeline pipeline(device, options.extent, render_pass, descriptor_set_layouts);
+
+        // Create the command pool for the graphics queue, the allocator, the deletion queue and the upload manager, just like the windowed version
+        Vulkan::CommandPool command_pool(device, device.get_queue_info().graphics());
+        // Also create the per-frame command buffers and the pass that keeps the draws, which only the per-frame modes use. A pass that records always never keeps its draws
+        Vulkan::FrameCommandAllocator frame_commands(device, device.get_queue_info().graphics(), frames_in_flight);
+        Vulkan::RecordedPass scene_pass(device, job_system, device.get_queue_info().graphics(), frames_in_flight, "scene", options.record_mode == BenchRecordModes::always ? Vulkan::RecordModes::always : Vulkan::RecordModes::dirty);
+        Vulkan::MemoryAllocator memory_allocator(device);
+        Vulkan::DeletionQueue deletion_queue(device);
+        Vulkan::UploadManager upload_manager(memory_allocator);
+
+        // Create one offscreen image and framebuffer per frame in flight, which take the place of the swapchain images
+        Array<Vulkan::Image> targets(frames_in_flight);
+        Array<Vulkan::Framebuffer> framebuffers(frames_in_flight);
+        for (uint32_t i = 0; i < frames_in_flight; i++) {
+            targets.push_back(Vulkan::Image(memory_allocator, options.extent, offscreen_format, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT));
+            framebuffers.push_back(Vulkan::Framebuffer(device, targets[i].image_view(), options.extent, render_pass));
+        }
+
+        // Upload the geometry and wait for it, so that it doesn't end up in the first frame's timings
+        Vulkan::Buffer vertex_buffer(memory_allocator, sizeof(Vertex) * vertices.size(), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        vertex_buffer.set_staging((void*) vertices.rdata(), sizeof(Vertex) * vertices.size(), upload_manager);
+        Vulkan::Buffer index_buffer(memory_allocator, sizeof(uint16_t) * indices.size(), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        index_buffer.set_staging((void*) indices.rdata(), sizeof(uint16_t) * indices.size(), upload_manager);
+        upload_manager.wait(upload_manager.submit());
+
+        // Create the uniform ring with a region per frame in flight, and the only descriptor set that binds it
+        Vulkan::UniformRing uniform_ring(memory_allocator, 64 * 1024, frames_in_flight);
+        Vulkan::DescriptorPool descriptor_pool(device, 1, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC);
+        Array<Vulkan::DescriptorSetRef> descriptor_sets = descriptor_pool.get_descriptor(1, descriptor_set_layout);
+        descriptor_sets[0].set(uniform_ring.buffer(), 0, sizeof(UniformBufferObject));
+
+        // Create the profiler with queries for each frame in flight
+        Vulkan::GpuProfiler gpu_profiler(device, device.get_queue_info().graphics(), frames_in_flight);
+
+        // In the static mode, record the command buffers once, one per frame in flight
+        Array<Vulkan::CommandBuffer> command_buffers;
+        if (options.record_mode == BenchRecordModes::static_buffers) {
+            command_buffers = command_pool.get_buffer(frames_in_flight, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+            for (uint32_t i = 0; i < frames_in_flight; i++) {
+                record_command_buffer(
+                    command_buffers[i],
+                    pipeline,
+                    render_pass,
+                    options.extent,
+                    framebuffers[i],
+                    vertex_buffer,
+                    index_buffer,
+                    descriptor_sets[0],
+                    uniform_ring.frame_offset(i),
+                    options.n_draws,
+                    nullptr,
+                    gpu_profiler,
+                    i
+                );
+            }
+        }
+
+        // Prepare a fence per frame in flight
+        Array<std::shared_ptr<Vulkan::Fence>> frame_in_flight_fences(frames_in_flight);
+        for (uint32_t i = 0; i < frames_in_flight; i++) {
+            frame_in_flight_fences.push_back(std::shared_ptr<Vulkan::Fence>(new Vulkan::Fence(device)));
+        }
+
+
+
+        Debug::profiler.end();
+
+
+
+        /***** STEP 2: RENDER LOOP *****/
+        // Don't flood the output with messages for every frame
+        DMUTE("Vulkan::Fence::wait");
+        DMUTE("Vulkan::Fence::signalled");
+        DMUTE("Vulkan::DeletionQueue::collect");
+        DMUTE("Vulkan::DeletionQueue::end_frame");
+        DMUTE("Vulkan::UniformRing::begin_frame");
+        DMUTE("Vulkan::UniformRing::allocate");
+        DMUTE("Vulkan::MemoryAllocator::flush");
+        DMUTE("Vulkan::GpuProfiler::collect");
+        DMUTE("Vulkan::GpuProfiler::submitted");
+        DMUTE("update_uniform_buffer");
+        DMUTE("record_command_buffer");
+        DMUTE("Vulkan::RecordedPass::execute");
+        DLOGF(info, "Rendering {} + {} frames of {}x{} with {} draws on '{}'...", options.n_warmup, options.n_frames, options.extent.width, options.extent.height, options.n_draws, device.name());
+
+        // Prepare the sample lists, all in milliseconds
+        Array<double> cpu_times(options.n_frames);
+        Array<double> frame_times(options.n_frames);
+        std::map<std::string, Array<double>> gpu_times;
+
+        size_t n_total = options.n_warmup + options.n_frames;
+        size_t n_draws = options.n_draws;
+        std::chrono::high_resolution_clock::time_point run_start = std::chrono::high_resolution_clock::now();
+        std::chrono::high_resolution_clock::time_point last_frame = run_start;
+        for (size_t f = 0; f < n_total; f++) {
+            DZONE("frame");
+            uint32_t slot = (uint32_t) (f % frames_in_flight);
+            std::chrono::high_resolution_clock::time_point frame_start = std::chrono::high_resolution_clock::now();
+            // The warmup frames don't count, so restart the clock for the throughput once they're done
+            if (f == options.n_warmup) { run_start = frame_start; }
+
+            // Wait until this slot's previous frame is done, and clean whatever was dropped in frames that are done by now
+            frame_in_flight_fences[slot]->wait();
+            deletion_queue.collect();
+            std::chrono::high_resolution_clock::time_point cpu_start = std::chrono::high_resolution_clock::now();
+
+            // The slot's previous frame is done, so its scopes can be read back without stalling
+            if (gpu_profiler.collect(slot)) {
+                add_gpu_samples(gpu_profiler, options.n_warmup, gpu_times);
+            }
+
+            // Update the matrices for this frame and flush them
+            update_uniform_buffer(uniform_ring, options.extent, slot, f);
+            memory_allocator.flush();
+
+            // In the per-frame modes, the slot is done, so reset its command pool and record a fresh command buffer. The draws are only recorded again if they're dirty, which the dirty mode forces every so often if asked
+            VkCommandBuffer command_buffer;
+            if (options.record_mode == BenchRecordModes::static_buffers) {
+                command_buffer = command_buffers[slot];
+            } else {
+                if (options.dirty_every > 0 && f % options.dirty_every == 0) { scene_pass.mark_dirty(); }
+                // Empty the scene if asked, which changes the draws and so makes them dirty too
+                if (options.shrink_at > 0 && f == options.shrink_at) {
+                    n_draws = 0;
+                    scene_pass.mark_dirty();
+                }
+                frame_commands.begin_frame(slot);
+                Vulkan::CommandBuffer& frame_command_buffer = frame_commands.allocate();
+                record_command_buffer(
+                    frame_command_buffer,
+                    pipeline,
+                    render_pass,
+                    options.extent,
+                    framebuffers[slot],
+                    vertex_buffer,
+                    index_buffer,
+                    descriptor_sets[0],
+                    uniform_ring.frame_offset(slot),
+                    n_draws,
+                    &scene_pass,
+                    gpu_profiler,
+                    slot
+                );
+                command_buffer = frame_command_buffer;
+            }
+
+            // Submit this slot's command buffer, signalling its fence when it's done
+            VkSubmitInfo submit_info{};
+            submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submit_info.commandBufferCount = 1;
+            submit_info.pCommandBuffers = &command_buffer;
+            vkResetFences(device, 1, &frame_in_flight_fences[slot]->fence());
+            if (vkQueueSubmit(device.graphics_queue(), 1, &submit_info, *frame_in_flight_fences[slot]) != VK_SUCCESS) {
+                DLOG(fatal, "Could not submit command buffer to the graphics queue.");
+            }
+            deletion_queue.end_frame(*frame_in_flight_fences[slot]);
+            gpu_profiler.submitted(slot);
+
+            // Note the times, if this frame counts
+            std::chrono::high_resolution_clock::time_point cpu_end = std::chrono::high_resolution_clock::now();
+            if (f >= options.n_warmup) {
+                cpu_times.push_back(std::chrono::duration<double, std::milli>(cpu_end - cpu_start).count());
+                if (f > options.n_warmup) {
+                    frame_times.push_back(std::chrono::duration<double, std::milli>(frame_start - last_frame).count());
+                }
+            }
+            last_frame = frame_start;
+        }
+
+        // Wait until everything is done, and collect the scopes of the frames that were still in flight
+        device.wait_idle();
+        std::chrono::high_resolution_clock::time_point run_end = std::chrono::high_resolution_clock::now();
+        for (uint32_t i = 0; i < frames_in_flight; i++) {
+            if (gpu_profiler.collect((uint32_t) ((n_total + i) % frames_in_flight))) {
+                add_gpu_samples(gpu_profiler, options.n_warmup, gpu_times);
+            }
+        }
+        double run_seconds = std::chrono::duration<double>(run_end - run_start).count();
+
+        // If the scene was emptied in time for every frame to record it again, none of them may still execute the draws it had before
+        if (options.shrink_at > 0 && options.shrink_at + frames_in_flight <= n_total) {
+            for (uint32_t i = 0; i < frames_in_flight; i++) {
+                if (scene_pass.secondaries(i) > 0) {
+                    DLOG(fatal, "Frame " + std::to_string(i) + " still executes " + std::to_string(scene_pass.secondaries(i)) + " secondaries after the scene was emptied.");
+                }
+            }
+        }
+
+
+
+        /***** STEP 3: READBACK *****/
+        if (!options.readback_path.empty()) {
+            // Copy the image of the last frame to a host-visible buffer
+            const Vulkan::Image& last_target = targets[(n_total - 1) % frames_in_flight];
+            VkDeviceSize n_bytes = (VkDeviceSize) options.extent.width * options.extent.height * 4;
+            Vulkan::Buffer readback(memory_allocator, n_bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            Vulkan::CommandBuffer copy_buffer = command_pool.get_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+            copy_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+            Vulkan::Image::copy(readback, 0, last_target, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, copy_buffer);
+            copy_buffer.end(device.graphics_queue());
+
+            // Get the pixels to the host and write them
+            Array<uint8_t> pixels((size_t) n_bytes);
+            readback.get((void*) pixels.wdata((size_t) n_bytes));
+            write_ppm(options.readback_path, pixels.rdata(), options.extent);
+        }
+
+
+
+        /***** STEP 4: REPORTING *****/
+        // Write the results as a single JSON object
+        std::stringstream sstr;
+        sstr << std::fixed << std::setprecision(4);
+        sstr << "{" << endl;
+        sstr << "  \"device\": \"" << device.name() << "\"," << endl;
+        sstr << "  \"width\": " << options.extent.width << "," << endl;
+        sstr << "  \"height\": " << options.extent.height << "," << endl;
+        sstr << "  \"frames\": " << options.n_frames << "," << endl;
+        sstr << "  \"warmup\": " << options.n_warmup << "," << endl;
+        sstr << "  \"frames_in_flight\": " << frames_in_flight << "," << endl;
+        sstr << "  \"draws\": " << options.n_draws << "," << endl;
+        sstr << "  \"record_mode\": \"" << (options.record_mode == BenchRecordModes::static_buffers ? "static" : options.record_mode == BenchRecordModes::always ? "always" : "dirty") << "\"," << endl;
+        sstr << "  \"dirty_every\": " << options.dirty_every << "," << endl;
+        sstr << "  \"shrink_at\": " << options.shrink_at << "," << endl;
+        sstr << "  \"pass_recordings\": " << (options.record_mode == BenchRecordModes::static_buffers ? frames_in_flight : scene_pass.recordings()) << "," << endl;
+        sstr << "  \"seconds\": " << run_seconds << "," << endl;
+        sstr << "  \"fps\": " << (double) options.n_frames / run_seconds << "," << endl;
+        write_stats(sstr, "cpu_ms", cpu_times); sstr << "," << endl;
+        write_stats(sstr, "frame_ms", frame_times); sstr << "," << endl;
+        if (gpu_profiler.enabled()) {
+            write_stats(sstr, "gpu_ms", gpu_times["frame"]); sstr << "," << endl;
+            // Also write the other scopes, one object each
+            sstr << "  \"gpu_scopes_ms\": {" << endl;
+            bool first = true;
+            for (std::map<std::string, Array<double>>::iterator iter = gpu_times.begin(); iter != gpu_times.end(); ++iter) {
+                if (iter->first == "frame") { continue; }
+                if (!first) { sstr << "," << endl; }
+                write_stats(sstr, iter->first, iter->second, "    ");
+                first = false;
+            }
+            sstr << endl << "  }" << endl;
+        } else {
+            sstr << "  \"gpu_ms\": null," << endl;
+            sstr << "  \"gpu_scopes_ms\": null" << endl;
+        }
+        sstr << "}" << endl;
+
+        // Write it to where the user wants it, making sure it doesn't end up between the log messages
+        if (options.json_path.empty()) {
+            DFLUSH;
+            cout << sstr.str();
+        } else {
+            std::ofstream file(options.json_path);
+            if (!file.is_open()) {
+                DLOG(fatal, "Could not open '" + options.json_path + "' for writing.");
+            }
+            file << sstr.str();
+        }
+
+        // Write the profiler's rolling history too, if the user wants it
+        if (!options.profile_path.empty()) {
+            std::ofstream file(options.profile_path);
+            if (!file.is_open()) {
+                DLOG(fatal, "Could not open '" + options.profile_path + "' for writing.");
+            }
+            gpu_profiler.write_csv(file);
+        }
+
+        // Write the CPU zones too, if the user wants them
+        Debug::profiler.stop();
+        if (!options.trace_path.empty()) {
+            std::ofstream file(options.trace_path);
+            if (!file.is_open()) {
+                DLOG(fatal, "Could not open '" + options.trace_path + "' for writing.");
+            }
+            Debug::profiler.write_chrome_trace(file);
+        }
+        if (!options.flame_path.empty()) {
+            std::ofstream file(options.flame_path);
+            if (!file.is_open()) {
+                DLOG(fatal, "Could not open '" + options.flame_path + "' for writing.");
+            }
+            Debug::profiler.write_flame_summary(file);
+        }
+
+    } catch (std::exception&) {
+        DRETURN EXIT_FAILURE;
+    }
+
+    DRETURN EXIT_SUCCESS;
+}
@@ -0,0 +1,308 @@
+/* BINARY LOG.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 18:31:12
+ * Last edited:
+ *   16/10/2026, 18:39:20
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the classes that write and read binary logs, which the
+ *   debugger can write its messages to instead of printing them. A log
+ *   starts with a short header, followed by chunks that each start with a
+ *   BinaryChunkType byte: strings and threads are defined once and then
+ *   referred to by id, and messages store their arguments unformatted.
+ *   Plain messages that repeat are defined once as well. All numbers are
+ *   varints, so that most messages only take a few bytes.
+**/
+
+#include <cstring>
+
+#include "BinaryLog.hpp"
+
+using namespace Debug;
+
+
+/***** BINARYLOGWRITER CLASS *****/
+/* Default constructor for the BinaryLogWriter class. */
+BinaryLogWriter::BinaryLogWriter() :
+    n_strings(0),
+    last_time(0)
+{}
+
+/* Destructor for the BinaryLogWriter class, which writes what's left to the file. */
+BinaryLogWriter::~BinaryLogWriter() {
+    if (this->file.is_open()) {
+        this->file.close();
+    }
+}
+
+
+
+/* Writes the definition of a new string and returns its id. */
+uint32_t BinaryLogWriter::define(const char* data, size_t size) {
+    // Ids start at one, since zero means 'no string'
+    uint32_t id = ++this->n_strings;
+    this->chunk.clear();
+    this->chunk.push_back((char) BinaryChunkTypes::string);
+    encode_varint(this->chunk, id);
+    encode_varint(this->chunk, size);
+    this->chunk.append(data, size);
+    this->file.write(this->chunk.data(), this->chunk.size());
+    return id;
+}
+
+/* Returns the id of the given string literal, writing its definition first if it's new. */
+uint32_t BinaryLogWriter::intern(const char* value) {
+    // Most of the time, we've seen it before
+    std::unordered_map<const char*, uint32_t>::iterator iter = this->strings.find(value);
+    if (iter != this->strings.end()) { return iter->second; }
+
+    // Otherwise, define it
+    uint32_t id = this->define(value, std::strlen(value));
+    this->strings.insert({ value, id });
+    return id;
+}
+
+/* Returns the id of the given plain message, writing its definition first if it's new. Returns 0 if it isn't interned, in which case it has to be written in full. */
+uint32_t BinaryLogWriter::intern_message(const std::string& message) {
+    // Long messages are usually unique, so don't bother with those
+    if (message.size() > BinaryLogWriter::max_message_size) { return 0; }
+
+    // Most of the time, we've seen it before
+    std::unordered_map<std::string, uint32_t>::iterator iter = this->messages.find(message);
+    if (iter != this->messages.end()) { return iter->second; }
+
+    // Otherwise, define it if there's still room
+    if (this->messages.size() >= BinaryLogWriter::max_messages) { return 0; }
+    uint32_t id = this->define(message.data(), message.size());
+    this->messages.insert({ message, id });
+    return id;
+}
+
+/* Returns the id of the given thread, writing its definition first if it's new or if it was renamed. */
+uint32_t BinaryLogWriter::intern_thread(uint64_t tid, const std::string& name) {
+    // Most of the time, we've seen it before under the same name
+    std::unordered_map<uint64_t, std::pair<uint32_t, std::string>>::iterator iter = this->threads.find(tid);
+    if (iter != this->threads.end() && iter->second.second == name) { return iter->second.first; }
+
+    // Otherwise, (re)define it
+    uint32_t id;
+    if (iter == this->threads.end()) {
+        id = (uint32_t) this->threads.size();
+        this->threads.insert({ tid, { id, name } });
+    } else {
+        id = iter->second.first;
+        iter->second.second = name;
+    }
+    this->chunk.clear();
+    this->chunk.push_back((char) BinaryChunkTypes::thread);
+    encode_varint(this->chunk, id);
+    encode_varint(this->chunk, tid);
+    encode_varint(this->chunk, name.size());
+    this->chunk.append(name);
+    this->file.write(this->chunk.data(), this->chunk.size());
+    return id;
+}
+
+
+
+/* Creates the log at the given path, overwriting it if it exists. Returns false if it could not be opened. */
+bool BinaryLogWriter::open(const std::string& path) {
+    this->file.open(path, std::ios::binary | std::ios::trunc);
+    if (!this->file.is_open()) { return false; }
+
+    // Write the header
+    this->file.write(binary_log_magic, sizeof(binary_log_magic));
+    this->file.put((char) binary_log_version);
+    return this->file.good();
+}
+
+/* Writes the given entry to the log. */
+void BinaryLogWriter::write(const LogEntry& entry) {
+    // Define what the message refers to first, since that's written right away. Formatted messages refer to their format string, plain ones to themselves
+    uint32_t thread = this->intern_thread(entry.tid, entry.thread_name);
+    uint32_t site = entry.format != nullptr ? this->intern(entry.format) : this->intern_message(entry.message);
+    this->frame_ids.resize(2 * entry.frames.size());
+    for (size_t i = 0; i < entry.frames.size(); i++) {
+        this->frame_ids[2 * i] = this->intern(entry.frames[i].func_name);
+        this->frame_ids[2 * i + 1] = this->intern(entry.frames[i].file_name);
+    }
+
+    // Only write the fields we need
+    bool has_indent = entry.indent_level > 0 || entry.extra_indent > 0;
+    bool has_payload = entry.format != nullptr ? !entry.message.empty() : site == 0;
+    uint8_t flags = BinaryChunkTypes::message | (uint8_t) entry.severity;
+    if (entry.has_stack) { flags |= BinaryMessageFlags::has_stack; }
+    if (has_indent) { flags |= BinaryMessageFlags::has_indent; }
+    if (!entry.frames.empty()) { flags |= BinaryMessageFlags::has_frames; }
+    if (has_payload) { flags |= BinaryMessageFlags::has_payload; }
+
+    // Then write the message itself
+    this->chunk.clear();
+    this->chunk.push_back((char) flags);
+    encode_varint(this->chunk, zigzag(entry.time - this->last_time));
+    encode_varint(this->chunk, thread);
+    encode_varint(this->chunk, site);
+    if (has_indent) {
+        encode_varint(this->chunk, entry.indent_level);
+        encode_varint(this->chunk, entry.extra_indent);
+    }
+    if (!entry.frames.empty()) {
+        encode_varint(this->chunk, entry.frames.size());
+        for (size_t i = 0; i < entry.frames.size(); i++) {
+            encode_varint(this->chunk, this->frame_ids[2 * i]);
+            encode_varint(this->chunk, this->frame_ids[2 * i + 1]);
+            encode_varint(this->chunk, entry.frames[i].line_number);
+        }
+    }
+    if (has_payload) {
+        encode_varint(this->chunk, entry.message.size());
+        this->chunk.append(entry.message);
+    }
+    this->file.write(this->chunk.data(), this->chunk.size());
+    this->last_time = entry.time;
+}
+
+/* Makes sure everything written so far is in the file. */
+void BinaryLogWriter::flush() {
+    this->file.flush();
+}
+
+
+
+
+
+/***** BINARYLOGREADER CLASS *****/
+/* Default constructor for the BinaryLogReader class. */
+BinaryLogReader::BinaryLogReader() :
+    strings({ nullptr }),
+    last_time(0),
+    n_messages(0),
+    corrupt(false)
+{}
+
+
+
+/* Reads a varint from the file. Returns false if the file ended. */
+bool BinaryLogReader::read_varint(uint64_t& value) {
+    value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7) {
+        int byte = this->file.get();
+        if (byte == EOF) { return false; }
+        value |= (uint64_t) (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) { return true; }
+    }
+    return false;
+}
+
+/* Reads a size and that many bytes from the file into the given string. Returns false if the file ended. */
+bool BinaryLogReader::read_string(std::string& value) {
+    uint64_t size;
+    if (!this->read_varint(size) || size > BinaryLogReader::max_string_size) { return false; }
+    value.resize(size);
+    this->file.read(&value[0], size);
+    return (uint64_t) this->file.gcount() == size;
+}
+
+/* Reads the given string id, translating it to the string itself. Returns false if the file ended or the id is unknown. */
+bool BinaryLogReader::read_string_id(const char*& value) {
+    uint64_t id;
+    if (!this->read_varint(id) || id == 0 || id >= this->strings.size()) { return false; }
+    value = this->strings[id];
+    return true;
+}
+
+
+
+/* Opens the log at the given path. Returns false if it could not be opened or isn't a binary log we can read. */
+bool BinaryLogReader::open(const std::string& path) {
+    this->file.open(path, std::ios::binary);
+    if (!this->file.is_open()) { return false; }
+
+    // Check the header
+    char magic[sizeof(binary_log_magic)];
+    this->file.read(magic, sizeof(magic));
+    if (this->file.gcount() != sizeof(magic) || std::memcmp(magic, binary_log_magic, sizeof(magic)) != 0) { return false; }
+    return this->file.get() == binary_log_version;
+}
+
+/* Reads the next message into the given entry. The strings it points to live as long as the reader. Returns false if there are no more messages. */
+bool BinaryLogReader::next(LogEntry& entry) {
+    while (!this->corrupt) {
+        // Stop cleanly if the file ends between chunks
+        int type = this->file.get();
+        if (type == EOF) { return false; }
+
+        // Any chunk that ends early is the end of the log as well, but then it's corrupt
+        this->corrupt = true;
+        uint64_t id;
+        switch (type & BinaryChunkTypes::message ? (int) BinaryChunkTypes::message : type) {
+            case BinaryChunkTypes::string:
+                {
+                    // Ids are handed out in order, so the new string should be the next one
+                    std::string value;
+                    if (!this->read_varint(id) || id != this->strings.size() || !this->read_string(value)) { return false; }
+                    this->string_storage.push_back(value);
+                    this->strings.push_back(this->string_storage.back().c_str());
+                    break;
+                }
+
+            case BinaryChunkTypes::thread:
+                {
+                    // Threads may be renamed, so they're either new or overwrite an existing one
+                    uint64_t tid;
+                    std::string name;
+                    if (!this->read_varint(id) || id > this->threads.size() || !this->read_varint(tid) || !this->read_string(name)) { return false; }
+                    if (id == this->threads.size()) { this->threads.push_back({ tid, name }); }
+                    else { this->threads[id] = { tid, name }; }
+                    break;
+                }
+
+            case BinaryChunkTypes::message:
+                {
+                    // Read the header; the flags are in the byte we already read
+                    int flags = type;
+                    uint64_t time, thread, indent_level = 0, extra_indent = 0, n_frames = 0;
+                    if ((flags & BinaryMessageFlags::severity) > SeverityValues::vulkan_error) { return false; }
+                    if (!this->read_varint(time) || !this->read_varint(thread) || thread >= this->threads.size() || !this->read_varint(id) || id >= this->strings.size()) { return false; }
+                    if ((flags & BinaryMessageFlags::has_indent) && (!this->read_varint(indent_level) || !this->read_varint(extra_indent))) { return false; }
+                    if ((flags & BinaryMessageFlags::has_frames) && (!this->read_varint(n_frames) || n_frames > CallStack::capacity)) { return false; }
+                    entry.severity = (Severity) (flags & BinaryMessageFlags::severity);
+                    entry.has_stack = (flags & BinaryMessageFlags::has_stack) != 0;
+                    entry.sequence = this->n_messages;
+                    entry.time = this->last_time + unzigzag(time);
+                    entry.tid = this->threads[thread].first;
+                    entry.thread_name = this->threads[thread].second;
+                    entry.format = this->strings[id];
+                    entry.indent_level = indent_level;
+                    entry.extra_indent = extra_indent;
+
+                    // Read the frames
+                    entry.frames.resize(n_frames);
+                    for (size_t i = 0; i < n_frames; i++) {
+                        uint64_t line_number;
+                        if (!this->read_string_id(entry.frames[i].func_name) || !this->read_string_id(entry.frames[i].file_name) || !this->read_varint(line_number)) { return false; }
+                        entry.frames[i].line_number = line_number;
+                    }
+
+                    // Read the message or its arguments. Interned plain messages have neither, and are formatted as a format string without arguments
+                    entry.message.clear();
+                    if ((flags & BinaryMessageFlags::has_payload) && !this->read_string(entry.message)) { return false; }
+
+                    // Done
+                    this->last_time = entry.time;
+                    ++this->n_messages;
+                    this->corrupt = false;
+                    return true;
+                }
+
+            default:
+                return false;
+        }
+        this->corrupt = false;
+    }
+    return false;
+}
@@ -0,0 +1,173 @@
+/* BINARY LOG.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 18:31:12
+ * Last edited:
+ *   16/10/2026, 18:39:20
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the classes that write and read binary logs, which the
+ *   debugger can write its messages to instead of printing them. A log
+ *   starts with a short header, followed by chunks that each start with a
+ *   BinaryChunkType byte: strings and threads are defined once and then
+ *   referred to by id, and messages store their arguments unformatted.
+ *   Plain messages that repeat are defined once as well. All numbers are
+ *   varints, so that most messages only take a few bytes.
+**/
+
+#ifndef DEBUG_BINARY_LOG_HPP
+#define DEBUG_BINARY_LOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+
+#include "Debug.hpp"
+
+/***** BINARY LOG NAMESPACE *****/
+namespace Debug {
+    /* The bytes every binary log starts with. */
+    static constexpr char binary_log_magic[6] = { 'H', 'V', 'R', 'L', 'O', 'G' };
+    /* The version of the format, which follows the magic bytes. */
+    static constexpr uint8_t binary_log_version = 1;
+
+    /* Enum that defines the kinds of chunks in a binary log. */
+    namespace BinaryChunkTypes {
+        enum type : uint8_t {
+            /* Defines a string: its id, then its size and its bytes. */
+            string = 1,
+            /* Defines (or renames) a thread: its id, the number it's printed as, and its name as a size plus bytes. */
+            thread = 2,
+            /* A message, which is any byte with this bit set; the other bits are its severity and BinaryMessageFlags. It's followed by its time relative to the previous message, the thread id and the id of its format string (or of the message itself, or 0 if it isn't interned). Then, depending on the flags, the indent level and the extra indent, the number of frames followed by a function id, file id and line for each, and the size and bytes of the message or of its encoded arguments. */
+            message = 0x80
+        };
+    }
+    using BinaryChunkType = BinaryChunkTypes::type;
+
+    /* Enum that defines the bits in the first byte of a message chunk, next to BinaryChunkTypes::message. */
+    namespace BinaryMessageFlags {
+        enum type : uint8_t {
+            /* The bits that hold the severity. */
+            severity = 0x07,
+            /* Set if the thread was in any function. */
+            has_stack = 0x08,
+            /* Set if the message is indented, in which case the indent level and the extra indent follow. */
+            has_indent = 0x10,
+            /* Set if the message has frames. */
+            has_frames = 0x20,
+            /* Set if the message is followed by its text or by its encoded arguments. */
+            has_payload = 0x40
+        };
+    }
+    using BinaryMessageFlag = BinaryMessageFlags::type;
+
+
+
+    /* The BinaryLogWriter class, which writes log entries to a binary log. Not thread-safe; the debugger only uses it with its drain_lock held. */
+    class BinaryLogWriter {
+    public:
+        /* The number of different plain messages that are interned, so that logs with many unique messages don't keep growing our memory. Messages after that are written in full every time. */
+        static constexpr size_t max_messages = 4096;
+        /* The longest plain message that is interned. */
+        static constexpr size_t max_message_size = 256;
+
+    private:
+        /* The file we write to. */
+        std::ofstream file;
+        /* The chunk that's being written, which keeps its memory between chunks. */
+        std::string chunk;
+
+        /* The number of strings defined so far. */
+        uint32_t n_strings;
+        /* The ids of the string literals written so far, by address. */
+        std::unordered_map<const char*, uint32_t> strings;
+        /* The ids of the plain messages written so far, by their text. */
+        std::unordered_map<std::string, uint32_t> messages;
+        /* The ids of the strings of the frames of the current message, kept to save allocations. */
+        std::vector<uint32_t> frame_ids;
+        /* The ids of the threads written so far, by the number they're printed as, together with the name they were written with. */
+        std::unordered_map<uint64_t, std::pair<uint32_t, std::string>> threads;
+        /* The time of the previous message. */
+        int64_t last_time;
+
+        /* Writes the definition of a new string and returns its id. */
+        uint32_t define(const char* data, size_t size);
+        /* Returns the id of the given string literal, writing its definition first if it's new. */
+        uint32_t intern(const char* value);
+        /* Returns the id of the given plain message, writing its definition first if it's new. Returns 0 if it isn't interned, in which case it has to be written in full. */
+        uint32_t intern_message(const std::string& message);
+        /* Returns the id of the given thread, writing its definition first if it's new or if it was renamed. */
+        uint32_t intern_thread(uint64_t tid, const std::string& name);
+
+    public:
+        /* Default constructor for the BinaryLogWriter class. */
+        BinaryLogWriter();
+        /* Copy constructor for the BinaryLogWriter class, which is deleted. */
+        BinaryLogWriter(const BinaryLogWriter& other) = delete;
+        /* Destructor for the BinaryLogWriter class, which writes what's left to the file. */
+        ~BinaryLogWriter();
+
+        /* Creates the log at the given path, overwriting it if it exists. Returns false if it could not be opened. */
+        bool open(const std::string& path);
+        /* Writes the given entry to the log. */
+        void write(const LogEntry& entry);
+        /* Makes sure everything written so far is in the file. */
+        void flush();
+
+    };
+
+
+
+    /* The BinaryLogReader class, which reads the entries back from a binary log. */
+    class BinaryLogReader {
+    public:
+        /* The largest string we accept, so that a corrupt size doesn't make us allocate all memory. */
+        static constexpr uint64_t max_string_size = 64 * 1024 * 1024;
+
+    private:
+        /* The file we read from. */
+        std::ifstream file;
+
+        /* The strings defined so far. A deque, so that the entries can point to them. */
+        std::deque<std::string> string_storage;
+        /* The strings defined so far by id, pointing into the storage. */
+        std::vector<const char*> strings;
+        /* The threads defined so far by id, as the number they're printed as and their name. */
+        std::vector<std::pair<uint64_t, std::string>> threads;
+        /* The time of the previous message. */
+        int64_t last_time;
+        /* The number of messages read so far. */
+        uint64_t n_messages;
+        /* Whether the log ended in the middle of a chunk, or had one we didn't understand. */
+        bool corrupt;
+
+        /* Reads a varint from the file. Returns false if the file ended. */
+        bool read_varint(uint64_t& value);
+        /* Reads a size and that many bytes from the file into the given string. Returns false if the file ended. */
+        bool read_string(std::string& value);
+        /* Reads the given string id, translating it to the string itself. Returns false if the file ended or the id is unknown. */
+        bool read_string_id(const char*& value);
+
+    public:
+        /* Default constructor for the BinaryLogReader class. */
+        BinaryLogReader();
+
+        /* Opens the log at the given path. Returns false if it could not be opened or isn't a binary log we can read. */
+        bool open(const std::string& path);
+        /* Reads the next message into the given entry. The strings it points to live as long as the reader. Returns false if there are no more messages. */
+        bool next(LogEntry& entry);
+
+        /* Returns whether the log ended in the middle of a chunk or contained one we didn't understand, e.g., because the program crashed while writing it. */
+        inline bool is_corrupt() const { return this->corrupt; }
+
+    };
+}
+
+#endif
@@ -4,7 +4,7 @@
  * Created:
  *   19/12/2020, 16:32:34
  * Last edited:
- *   19/12/2020, 16:32:34
+ *   16/10/2026, 20:56:05
  * Auto updated?
  *   Yes
  *
@@ -13,25 +13,39 @@
  *   specify the debugging type and where its timestamp is noted.
  *   Aditionally, lines are automatically linewrapped (with correct
  *   indents), and extra indentation levels can be given based on functions
- *   entered or left.
+ *   entered or left. Messages are copied to a ring per thread and printed
+ *   in batches by a background thread, except for fatal ones. Instead of
+ *   printing them, the writer can also store them in a binary log.
 **/
 
 #include <algorithm>
 #include <stdexcept>
+#include <sstream>
+#include <cstring>
+#include <chrono>
 #ifdef _WIN32
 #include "windows.h"
 #endif
 
+#include "BinaryLog.hpp"
 #include "Debug.hpp"
 
 using namespace Debug;
 
 
 /***** GLOBALS *****/
-#ifndef NDEBUG
 /* Global instance of the debug class, used for debugging. */
 Debugger Debug::debugger;
-#endif
+/* The ring of the current thread, or nullptr if it didn't log anything yet. */
+thread_local LogRing* Debugger::local_ring = nullptr;
+/* The programmer-readable name of the current thread. */
+thread_local std::string Debugger::thread_name;
+/* The stack of frames the current thread is in. */
+thread_local CallStack Debugger::stack;
+/* The functions muted on the current thread, with how often they were muted. */
+thread_local std::unordered_map<std::string_view, size_t> Debugger::muted;
+/* The buffer DLOGF formats its messages in, which keeps its memory between messages. */
+thread_local std::string Debugger::format_buffer;
 
 
 
@@ -52,6 +66,25 @@ static bool terminal_supports_colours() {
     #endif
 }
 
+/* Returns the id of the current thread as a number, which is how it's printed. */
+static uint64_t current_thread_number() {
+    // Thread ids can only be printed, so do that once per thread and remember the result
+    static thread_local uint64_t number = 0;
+    static thread_local bool known = false;
+    if (!known) {
+        std::stringstream sstr;
+        sstr << std::this_thread::get_id();
+        sstr >> number;
+        known = true;
+    }
+    return number;
+}
+
+/* Returns the given size rounded up to a multiple of eight bytes, which keeps the records in a ring aligned. */
+static inline size_t align_record(size_t size) {
+    return (size + 7) & ~((size_t) 7);
+}
+
 
 
 
@@ -68,15 +101,46 @@ Debugger::Debugger() :
     vulkan_warning_msg(this->colour_enabled ? "[" YELLOW "VK WARN" RESET "] " : "[VK WARN] "),
     vulkan_error_msg(this->colour_enabled ? "[" RED "VKERROR" RESET "] " : "[VKERROR] "),
     reset_msg(this->colour_enabled ? RESET : ""),
-    main_tid(std::this_thread::get_id())
+    indent_level(0),
+    main_tid(std::this_thread::get_id()),
+    n_records(0),
+    writer_stop(false),
+    binary(nullptr)
 {}
 
+/* Destructor for the Debugger class, which prints whatever is left and stops the writer thread. */
+Debugger::~Debugger() {
+    // Stop the writer first, so that anything logged from now on is printed right away
+    {
+        std::unique_lock<std::mutex> _stop_lock(this->writer_lock);
+        this->writer_stop = true;
+    }
+    this->writer_wakeup.notify_one();
+    if (this->writer.joinable()) {
+        this->writer.join();
+    }
+
+    // Print what the writer didn't get to, then close the binary log if there is one
+    {
+        std::unique_lock<std::mutex> _drain_lock(this->drain_lock);
+        this->drain();
+        delete this->binary;
+        this->binary = nullptr;
+    }
+
+    // Free the rings
+    for (size_t i = 0; i < this->rings.size(); i++) {
+        delete[] this->rings[i]->data;
+        delete this->rings[i];
+    }
+}
+
 
 
 /* Prints a given string over multiple lines, pasting n spaces in front of each one and linewrapping on the target width. Optionally, a starting x can be specified. */
-void Debugger::print_linewrapped(std::ostream& os, size_t& x, size_t width, const std::string& message) {
+void Debugger::print_linewrapped(std::ostream& os, size_t& x, size_t width, size_t indent_level, const std::string& message) {
     // Get the string to be pasted in front of every new line
-    std::string prefix = std::string(Debugger::prefix_size + this->indent_level * Debugger::indent_size, ' ');
+    std::string prefix = std::string(Debugger::prefix_size + indent_level * Debugger::indent_size, ' ');
     // Loop to print each character
     bool ignoring = false;
     for (size_t i = 0; i < message.size(); i++) {
@@ -95,41 +159,26 @@ void Debugger::print_linewrapped(std::ostream& os, size_t& x, size_t width, cons
     }
 }
 
-/* Actually prints the message to the given output stream. */
-void Debugger::_log(std::ostream& os, Severity severity, const std::string& message, size_t extra_indent) {
+/* Actually prints the given log entry to the given output stream. */
+void Debugger::_log(std::ostream& os, const LogEntry& entry) {
     using namespace SeverityValues;
 
-    // Acquire the lock for this function
-    std::unique_lock<std::mutex> _log_lock(this->lock);
-
-    // Get the thread ID and, optionally, its name if defined
-    std::thread::id tid = std::this_thread::get_id();
-    std::string thread_name;
-    std::unordered_map<std::thread::id, std::string>::const_iterator iter = this->thread_names.find(tid);
-    if (iter != this->thread_names.end()) {
-        thread_name = (*iter).second;
-    }
+    // Get the parts of the entry we use everywhere
+    const std::string& message = entry.message;
+    uint64_t tid = entry.tid;
+    const std::string& thread_name = entry.thread_name;
+    size_t indent_level = entry.indent_level;
 
     // Determine the type of message to preprend to signify how it went
-    switch(severity) {
+    switch(entry.severity) {
         case auxillary:
             // Print as a prefix; i.e., a plain message with correct indents
             {
-                // If this function is actually muted and we have a stack (so we know of this function), do not display the message
-                if (this->stack.size() > 0) {
-                    for (size_t i = 0; i < this->muted.size(); i++) {
-                        if (this->muted[tid][i] == this->stack[tid][this->stack[tid].size() - 1].func_name) {
-                            // Do not do anything
-                            return;
-                        }
-                    }
-                }
-
-                // Otherwise, we're clear to print the message
+                // Muted messages never make it here, so we're clear to print the message
                 size_t x = 0;
-                size_t width = max_line_width - Debugger::prefix_size - this->indent_level * Debugger::indent_size;
-                os << std::string(this->indent_level * Debugger::indent_size, ' ') << auxillary_msg;
-                this->print_linewrapped(os, x, width, message);
+                size_t width = max_line_width - Debugger::prefix_size - indent_level * Debugger::indent_size;
+                os << std::string(indent_level * Debugger::indent_size, ' ') << auxillary_msg;
+                this->print_linewrapped(os, x, width, indent_level, message);
                 os << reset_msg << std::endl;
                 return;
             }
@@ -137,21 +186,11 @@ void Debugger::_log(std::ostream& os, Severity severity, const std::string& mess
         case info:
             // Print as info; pretty much the same, except that we now prepent with the info message
             {
-                // If this function is actually muted and we have a stack, do not display the message
-                if (this->stack.size() > 0) {
-                    for (size_t i = 0; i < this->muted.size(); i++) {
-                        if (this->muted[tid][i] == this->stack[tid][this->stack[tid].size() - 1].func_name) {
-                            // Do not do anything
-                            return;
-                        }
-                    }
-                }
-
-                // Otherwise, we're clear to print the message
+                // Muted messages never make it here, so we're clear to print the message
                 size_t x = 0;
-                size_t width = max_line_width - Debugger::prefix_size - this->indent_level * Debugger::indent_size;
-                os << std::string(this->indent_level * Debugger::indent_size, ' ') << info_msg;
-                this->print_linewrapped(os, x, width, message);
+                size_t width = max_line_width - Debugger::prefix_size - indent_level * Debugger::indent_size;
+                os << std::string(indent_level * Debugger::indent_size, ' ') << info_msg;
+                this->print_linewrapped(os, x, width, indent_level, message);
                 os << reset_msg << std::endl;
                 return;
             }
@@ -159,30 +198,20 @@ void Debugger::_log(std::ostream& os, Severity severity, const std::string& mess
         case warning:
             // Print as warning; the same as info with a different prexif, plus we print the origin of the line
             {
-                // If this function is actually muted and we have a stack, do not display the message
-                if (this->stack.size() > 0) {
-                    for (size_t i = 0; i < this->muted.size(); i++) {
-                        if (this->muted[tid][i] == this->stack[tid][this->stack[tid].size() - 1].func_name) {
-                            // Do not do anything
-                            return;
-                        }
-                    }
-                }
-
                 // Print the new message as normal
                 size_t x = 0;
-                size_t width = max_line_width - Debugger::prefix_size - this->indent_level * Debugger::indent_size;
-                os << std::string(this->indent_level * Debugger::indent_size, ' ') << warning_msg;
-                this->print_linewrapped(os, x, width, message);
+                size_t width = max_line_width - Debugger::prefix_size - indent_level * Debugger::indent_size;
+                os << std::string(indent_level * Debugger::indent_size, ' ') << warning_msg;
+                this->print_linewrapped(os, x, width, indent_level, message);
                 os << reset_msg << std::endl;
 
                 // If there is a stack, display the stack message
-                if (this->stack.size() > 0) {
-                    Frame f = this->stack[tid][this->stack[tid].size() - 1];
-                    std::string to_print = "[in function '\033[1m" + f.func_name + "\033[0m' at \033[1m" + f.file_name + ':' + std::to_string(f.line_number) + "\033[0m]";
-                    os << std::string(Debugger::prefix_size + this->indent_level * Debugger::indent_size, ' ');
+                if (entry.frames.size() > 0) {
+                    const Frame& f = entry.frames[0];
+                    std::string to_print = std::string("[in function '\033[1m") + f.func_name + "\033[0m' at \033[1m" + f.file_name + ':' + std::to_string(f.line_number) + "\033[0m]";
+                    os << std::string(Debugger::prefix_size + indent_level * Debugger::indent_size, ' ');
                     x = 0;
-                    this->print_linewrapped(os, x, width, to_print);
+                    this->print_linewrapped(os, x, width, indent_level, to_print);
                     os << reset_msg << std::endl;
                 }
 
@@ -195,18 +224,18 @@ void Debugger::_log(std::ostream& os, Severity severity, const std::string& mess
                 size_t x = 0;
                 size_t width = max_line_width - Debugger::prefix_size;
                 os << nonfatal_msg;
-                this->print_linewrapped(os, x, width, message);
+                this->print_linewrapped(os, x, width, indent_level, message);
                 os << reset_msg << std::endl;
 
                 // Print a stacktrace, if any
                 std::string prefix_indent = std::string(Debugger::prefix_size, ' ');
-                if (this->stack.size() > 0) {
+                if (entry.has_stack) {
                     os << prefix_indent << "\033[1mStacktrace:\033[0m" << std::endl;
-                    for (size_t i = 0; i < this->stack.size(); i++) {
+                    for (size_t i = 0; i < entry.frames.size(); i++) {
                         x = 0;
-                        Frame f = this->stack[tid][this->stack[tid].size() - 1 - i];
+                        const Frame& f = entry.frames[i];
                         std::string prefix = i == 0 ? "in" : "from";
-                        this->print_linewrapped(os, x, width, prefix_indent + prefix + " function '\033[1m" + f.func_name + "\033[0m' at \033[1m" + f.file_name + ':' + std::to_string(f.line_number) + "\033[0m");
+                        this->print_linewrapped(os, x, width, indent_level, prefix_indent + prefix + " function '\033[1m" + f.func_name + "\033[0m' at \033[1m" + f.file_name + ':' + std::to_string(f.line_number) + "\033[0m");
                         os << reset_msg << std::endl;
                     }
                     os << prefix_indent << "from thread \033[1m" << tid << "\033[0m" << (thread_name.empty() ? "" : " (" + thread_name + ")") << std::endl;
@@ -222,55 +251,45 @@ void Debugger::_log(std::ostream& os, Severity severity, const std::string& mess
                 size_t x = 0;
                 size_t width = max_line_width - Debugger::prefix_size;
                 os << fatal_msg;
-                this->print_linewrapped(os, x, width, message);
+                this->print_linewrapped(os, x, width, indent_level, message);
                 os << reset_msg << std::endl;
 
                 // Print a stacktrace, if any
                 std::string prefix_indent = std::string(Debugger::prefix_size, ' ');
-                if (this->stack.size() > 0) {
+                if (entry.has_stack) {
                     os << prefix_indent << "\033[1mStacktrace:\033[0m" << std::endl;
-                    for (size_t i = 0; i < this->stack.size(); i++) {
+                    for (size_t i = 0; i < entry.frames.size(); i++) {
                         x = 0;
-                        Frame f = this->stack[tid][this->stack[tid].size() - 1 - i];
+                        const Frame& f = entry.frames[i];
                         std::string prefix = i == 0 ? "in" : "from";
-                        this->print_linewrapped(os, x, width, prefix_indent + prefix + " function '\033[1m" + f.func_name + "\033[0m' at \033[1m" + f.file_name + ':' + std::to_string(f.line_number) + "\033[0m");
+                        this->print_linewrapped(os, x, width, indent_level, prefix_indent + prefix + " function '\033[1m" + f.func_name + "\033[0m' at \033[1m" + f.file_name + ':' + std::to_string(f.line_number) + "\033[0m");
                         os << reset_msg << std::endl;
                     }
                     os << prefix_indent << "from thread \033[1m" << tid << "\033[0m" << (thread_name.empty() ? "" : " (" + thread_name + ")") << std::endl;
                     os << std::endl;
                 }
 
-                // Return by throwing
-                throw std::runtime_error(message);
+                // The caller throws, once this has been written
+                return;
             }
         
         case vulkan_warning:
             // Print as vulkan warning message
             {
-                // If this function is actually muted and we have a stack, do not display the message
-                if (this->stack.size() > 0) {
-                    for (size_t i = 0; i < this->muted.size(); i++) {
-                        if (this->muted[tid][i] == this->stack[tid][this->stack[tid].size() - 1].func_name) {
-                            // Do not do anything
-                            return;
-                        }
-                    }
-                }
-
                 // Print the new message as normal
                 size_t x = 0;
-                size_t width = max_line_width - Debugger::prefix_size - this->indent_level * Debugger::indent_size;
-                os << std::string(this->indent_level * Debugger::indent_size, ' ') << vulkan_warning_msg;
-                this->print_linewrapped(os, x, width, message);
+                size_t width = max_line_width - Debugger::prefix_size - indent_level * Debugger::indent_size;
+                os << std::string(indent_level * Debugger::indent_size, ' ') << vulkan_warning_msg;
+                this->print_linewrapped(os, x, width, indent_level, message);
                 os << reset_msg << std::endl;
 
                 // If there is a stack, display the stack message
-                if (this->stack.size() > 0) {
-                    Frame f = this->stack[tid][this->stack[tid].size() - 1];
-                    std::string to_print = "[in function '\033[1m" + f.func_name + "\033[0m' at \033[1m" + f.file_name + ':' + std::to_string(f.line_number) + "\033[0m]";
-                    os << std::string(Debugger::prefix_size + this->indent_level * Debugger::indent_size, ' ');
+                if (entry.frames.size() > 0) {
+                    const Frame& f = entry.frames[0];
+                    std::string to_print = std::string("[in function '\033[1m") + f.func_name + "\033[0m' at \033[1m" + f.file_name + ':' + std::to_string(f.line_number) + "\033[0m]";
+                    os << std::string(Debugger::prefix_size + indent_level * Debugger::indent_size, ' ');
                     x = 0;
-                    this->print_linewrapped(os, x, width, to_print);
+                    this->print_linewrapped(os, x, width, indent_level, to_print);
                     os << reset_msg << std::endl;
                 }
 
@@ -283,18 +302,18 @@ void Debugger::_log(std::ostream& os, Severity severity, const std::string& mess
                 size_t x = 0;
                 size_t width = max_line_width - Debugger::prefix_size;
                 os << vulkan_error_msg;
-                this->print_linewrapped(os, x, width, message);
+                this->print_linewrapped(os, x, width, indent_level, message);
                 os << reset_msg << std::endl;
 
                 // Print a stacktrace, if any
                 std::string prefix_indent = std::string(Debugger::prefix_size, ' ');
-                if (this->stack.size() > 0) {
+                if (entry.has_stack) {
                     os << prefix_indent << "\033[1mStacktrace:\033[0m" << std::endl;
-                    for (size_t i = 0; i < this->stack.size(); i++) {
+                    for (size_t i = 0; i < entry.frames.size(); i++) {
                         x = 0;
-                        Frame f = this->stack[tid][this->stack[tid].size() - 1 - i];
+                        const Frame& f = entry.frames[i];
                         std::string prefix = i == 0 ? "in" : "from";
-                        this->print_linewrapped(os, x, width, prefix_indent + prefix + " function '\033[1m" + f.func_name + "\033[0m' at \033[1m" + f.file_name + ':' + std::to_string(f.line_number) + "\033[0m");
+                        this->print_linewrapped(os, x, width, indent_level, prefix_indent + prefix + " function '\033[1m" + f.func_name + "\033[0m' at \033[1m" + f.file_name + ':' + std::to_string(f.line_number) + "\033[0m");
                         os << reset_msg << std::endl;
                     }
                     os << prefix_indent << "from thread \033[1m" << tid << "\033[0m" << (thread_name.empty() ? "" : " (" + thread_name + ")") << std::endl;
@@ -306,66 +325,309 @@ void Debugger::_log(std::ostream& os, Severity severity, const std::string& mess
 
         default:
             // Let's re-do as auxillary
-            this->_log(os, auxillary, message, extra_indent);
+            {
+                LogEntry auxillary_entry = entry;
+                auxillary_entry.severity = auxillary;
+                this->_log(os, auxillary_entry);
+            }
     }
 }
 
 
 
-/* Registers a new name for the current thread. */
-void Debugger::start(const std::string& thread_name) {
-    // Check if it already exists
-    std::unordered_map<std::thread::id, std::string>::iterator iter = this->thread_names.find(std::this_thread::get_id());
-    if (iter != this->thread_names.end()) {
-        // It already does; simply replace the name
-        (*iter).second = thread_name;
-    } else {
-        // It doesn't; insert it
-        this->thread_names.insert(std::make_pair(std::this_thread::get_id(), thread_name));
+/* Fills in the given entry with what needs to be printed for a message with the given severity logged from the current thread. Returns false if the message is muted instead. */
+bool Debugger::capture(LogEntry& entry, Severity severity, const char* format, std::string_view message, size_t extra_indent) {
+    using namespace SeverityValues;
+
+    // Only the plain messages and the warnings may be muted
+    if (!this->accepts(severity)) {
+        return false;
+    }
+
+    // Copy the message and where it came from. The strings keep their memory between calls, so this rarely allocates
+    entry.severity = severity;
+    entry.time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    entry.indent_level = this->indent_level;
+    entry.extra_indent = extra_indent;
+    entry.format = format;
+    entry.message.assign(message.data(), message.size());
+    entry.tid = current_thread_number();
+    entry.thread_name = Debugger::thread_name;
+
+    // Copy the part of the stack that is printed with the message: only the current function for warnings, and the trace for errors. Frames that didn't fit in the stack are left out
+    entry.has_stack = Debugger::stack.depth > 0;
+    size_t n_stored = std::min(Debugger::stack.depth, CallStack::capacity);
+    size_t n_frames = 0;
+    if (severity == warning || severity == vulkan_warning) {
+        n_frames = entry.has_stack && Debugger::stack.depth <= CallStack::capacity ? 1 : 0;
+    } else if (severity == nonfatal || severity == fatal || severity == vulkan_error) {
+        n_frames = n_stored;
+    }
+    entry.frames.resize(n_frames);
+    for (size_t i = 0; i < n_frames; i++) {
+        entry.frames[i] = Debugger::stack.frames[n_stored - 1 - i];
+    }
+
+    // Done
+    return true;
+}
+
+/* Returns the ring of the current thread, creating it (and starting the writer) if it doesn't have one yet. */
+LogRing* Debugger::get_ring() {
+    // Most of the time, we already have one
+    if (Debugger::local_ring != nullptr) { return Debugger::local_ring; }
+
+    // Make sure someone prints what we're about to write
+    std::call_once(this->writer_started, [this]() {
+        this->writer = std::thread(&Debugger::writer_main, this);
+    });
+
+    // Create the ring and register it so the writer finds it
+    LogRing* ring = new LogRing();
+    ring->data = new char[LogRing::capacity];
+    ring->head.store(0);
+    ring->tail.store(0);
+    {
+        std::unique_lock<std::mutex> _ring_lock(this->lock);
+        this->rings.push_back(ring);
+    }
+    Debugger::local_ring = ring;
+    return ring;
+}
+
+/* Copies the given entry to the current thread's ring, waiting for room if it's full. Returns false if it doesn't fit in a ring at all, or if the writer has been stopped. */
+bool Debugger::enqueue(const LogEntry& entry) {
+    // Compute how much room the record needs
+    size_t size = align_record(sizeof(LogRecord) + entry.message.size() + entry.thread_name.size() + entry.frames.size() * sizeof(Frame));
+    // Anything bigger than half a ring is simply printed right away, so we never have to wait for an entirely empty ring
+    if (size > LogRing::capacity / 2 || this->writer_stop) { return false; }
+
+    // Find where it goes. If it doesn't fit before the end of the ring, it's put at the start and the rest is skipped
+    LogRing* ring = this->get_ring();
+    size_t head = ring->head.load(std::memory_order_relaxed);
+    size_t offset = head % LogRing::capacity;
+    size_t skip = LogRing::capacity - offset < size ? LogRing::capacity - offset : 0;
+
+    // Wait until the writer made enough room
+    while (LogRing::capacity - (head - ring->tail.load(std::memory_order_acquire)) < skip + size) {
+        if (this->writer_stop) { return false; }
+        this->writer_wakeup.notify_one();
+        std::this_thread::yield();
+    }
+
+    // Mark the skipped part, if any
+    if (skip > 0) {
+        uint32_t zero = 0;
+        std::memcpy(ring->data + offset, &zero, sizeof(uint32_t));
+        offset = 0;
+    }
+
+    // Write the header
+    LogRecord record;
+    record.size = (uint32_t) size;
+    record.severity = (uint32_t) entry.severity;
+    record.sequence = this->n_records.fetch_add(1, std::memory_order_relaxed);
+    record.time = entry.time;
+    record.format = entry.format;
+    record.indent_level = (uint32_t) entry.indent_level;
+    record.extra_indent = (uint32_t) entry.extra_indent;
+    record.message_size = (uint32_t) entry.message.size();
+    record.thread_name_size = (uint32_t) entry.thread_name.size();
+    record.has_stack = entry.has_stack ? 1 : 0;
+    record.n_frames = (uint32_t) entry.frames.size();
+    record.tid = entry.tid;
+    char* data = ring->data + offset;
+    std::memcpy(data, &record, sizeof(LogRecord));
+    data += sizeof(LogRecord);
+
+    // Write the strings and the frames behind it
+    std::memcpy(data, entry.message.data(), entry.message.size());
+    data += entry.message.size();
+    std::memcpy(data, entry.thread_name.data(), entry.thread_name.size());
+    data += entry.thread_name.size();
+    if (!entry.frames.empty()) { std::memcpy(data, entry.frames.data(), entry.frames.size() * sizeof(Frame)); }
+
+    // Publish it, and wake the writer early if the ring is filling up
+    ring->head.store(head + skip + size, std::memory_order_release);
+    if (head + skip + size - ring->tail.load(std::memory_order_relaxed) > LogRing::capacity / 2) {
+        this->writer_wakeup.notify_one();
     }
+    return true;
 }
 
+/* Prints the given entry right away, after everything that was logged before it. */
+void Debugger::print_now(LogEntry& entry) {
+    std::unique_lock<std::mutex> _drain_lock(this->drain_lock);
 
+    // Print the older messages first
+    this->drain();
 
-/* Enters a new function, popping it's value on the stack. */
-void Debugger::push(const std::string& function_name, const std::string& file_name, size_t line_number) {
-    // Create a new stack frame
-    Frame frame({ function_name, file_name, line_number });
+    // If there is a binary log, the entry goes there; only fatal messages are printed as well, since they stop the program
+    if (this->binary != nullptr) {
+        this->binary->write(entry);
+        this->binary->flush();
+        if (entry.severity != Severity::fatal) { return; }
+    }
 
-    // Push it on the stack
-    this->stack[std::this_thread::get_id()].push_back(frame);
+    // Print the entry itself, in one go
+    this->expand(entry);
+    std::ostream& os = entry.severity == Severity::info || entry.severity == Severity::auxillary ? std::cout : std::cerr;
+    std::ostringstream sstr;
+    this->_log(sstr, entry);
+    os << sstr.str();
+    os.flush();
 }
 
-/* pops the top function name of the stack. */
-void Debugger::pop() {
-    // Only pop if there are elements left
-    if (this->stack[std::this_thread::get_id()].size() > 0) {
-        // Pop the vector
-        this->stack[std::this_thread::get_id()].pop_back();
+/* Reads the oldest record in the given ring into the given entry, if there is any. Doesn't remove it from the ring yet. Returns its size in bytes, or 0 if the ring is empty. */
+size_t Debugger::peek(LogRing* ring, LogEntry& entry) {
+    size_t tail = ring->tail.load(std::memory_order_relaxed);
+    size_t head = ring->head.load(std::memory_order_acquire);
+    if (tail == head) { return 0; }
+
+    // If the rest of the ring was skipped, the record is at the start
+    size_t offset = tail % LogRing::capacity;
+    uint32_t size;
+    std::memcpy(&size, ring->data + offset, sizeof(uint32_t));
+    size_t skip = 0;
+    if (size == 0) {
+        skip = LogRing::capacity - offset;
+        offset = 0;
     }
+
+    // Read the header
+    const char* data = ring->data + offset;
+    LogRecord record;
+    std::memcpy(&record, data, sizeof(LogRecord));
+    data += sizeof(LogRecord);
+    entry.severity = (Severity) record.severity;
+    entry.sequence = record.sequence;
+    entry.time = record.time;
+    entry.format = record.format;
+    entry.indent_level = record.indent_level;
+    entry.extra_indent = record.extra_indent;
+    entry.tid = record.tid;
+    entry.has_stack = record.has_stack != 0;
+
+    // Read the strings and the frames
+    entry.message.assign(data, record.message_size);
+    data += record.message_size;
+    entry.thread_name.assign(data, record.thread_name_size);
+    data += record.thread_name_size;
+    entry.frames.resize(record.n_frames);
+    if (record.n_frames > 0) { std::memcpy(entry.frames.data(), data, record.n_frames * sizeof(Frame)); }
+
+    // Done
+    return skip + record.size;
 }
 
+/* Prints (or writes to the binary log) everything in the rings, in the order it was logged. Only called with the drain_lock held. */
+void Debugger::drain() {
+    // Get the rings that exist right now; any added later are drained next time
+    std::vector<LogRing*> rings;
+    {
+        std::unique_lock<std::mutex> _ring_lock(this->lock);
+        rings = this->rings;
+    }
 
+    // Read the oldest record of each ring
+    std::vector<LogEntry> entries(rings.size());
+    std::vector<size_t> sizes(rings.size());
+    for (size_t i = 0; i < rings.size(); i++) {
+        sizes[i] = this->peek(rings[i], entries[i]);
+    }
+
+    // Keep printing the oldest of those, collecting the output per stream and only writing it once we switch streams or are done
+    std::ostringstream batch;
+    std::ostream* batch_os = nullptr;
+    while (true) {
+        size_t oldest = rings.size();
+        for (size_t i = 0; i < rings.size(); i++) {
+            if (sizes[i] > 0 && (oldest == rings.size() || entries[i].sequence < entries[oldest].sequence)) {
+                oldest = i;
+            }
+        }
+        if (oldest == rings.size()) { break; }
+
+        LogEntry& entry = entries[oldest];
+        if (this->binary != nullptr) {
+            // Store it as-is in the binary log
+            this->binary->write(entry);
+        } else {
+            // Switch streams if needed, so that stdout and stderr stay interleaved as they were logged
+            std::ostream* os = entry.severity == Severity::info || entry.severity == Severity::auxillary ? &std::cout : &std::cerr;
+            if (batch_os != nullptr && os != batch_os) {
+                (*batch_os) << batch.str();
+                batch_os->flush();
+                batch.str("");
+            }
+            batch_os = os;
+
+            // Print it
+            this->expand(entry);
+            this->_log(batch, entry);
+        }
+
+        // Free its room in the ring and read the next one
+        rings[oldest]->tail.store(rings[oldest]->tail.load(std::memory_order_relaxed) + sizes[oldest], std::memory_order_release);
+        sizes[oldest] = this->peek(rings[oldest], entries[oldest]);
+    }
 
-/* Mutes a given function. All info-level severity messages that are called from it or from children functions are ignored. */
-void Debugger::mute(const std::string& function_name) {
-    // Add the given function to the vector of muted functions
-    this->muted[std::this_thread::get_id()].push_back(function_name);
+    // Write what's left
+    if (batch_os != nullptr) {
+        (*batch_os) << batch.str();
+        batch_os->flush();
+    }
+    if (this->binary != nullptr) {
+        this->binary->flush();
+    }
 }
 
-/* Unmutes a given function. All info-level severity messages that are called from it or from children functions are ignored. */
-void Debugger::unmute(const std::string& function_name) {
-    // Try to find the function name
-    for (std::vector<std::string>::iterator iter = this->muted[std::this_thread::get_id()].begin(); iter != this->muted[std::this_thread::get_id()].end(); ++iter) {
-        if (*iter == function_name) {
-            // Found it; remove it and we're done
-            this->muted[std::this_thread::get_id()].erase(iter);
-            return;
+/* The function that runs on the writer thread. */
+void Debugger::writer_main() {
+    std::unique_lock<std::mutex> _writer_lock(this->writer_lock);
+    while (!this->writer_stop) {
+        // Sleep until a ring fills up or a little time has passed
+        this->writer_wakeup.wait_for(_writer_lock, std::chrono::milliseconds(10));
+
+        // Print everything that's there in one go
+        _writer_lock.unlock();
+        {
+            std::unique_lock<std::mutex> _drain_lock(this->drain_lock);
+            this->drain();
         }
+        _writer_lock.lock();
     }
+}
 
-    // Not found, so nothing to remove
-    return;
+
+
+/* Registers a new name for the current thread. */
+void Debugger::start(const std::string& thread_name) {
+    // Threads only ever name themselves, so there's nothing to synchronize
+    Debugger::thread_name = thread_name;
+}
+
+
+
+/* Mutes a given function on the current thread, which has to be a string literal. All info-level severity messages that are called from it are ignored. */
+void Debugger::mute(const char* function_name) {
+    // Count it, so it's only unmuted once it's been unmuted as often
+    ++Debugger::muted[function_name];
+}
+
+/* Unmutes a given function on the current thread. */
+void Debugger::unmute(const char* function_name) {
+    // Try to find the function name
+    std::unordered_map<std::string_view, size_t>::iterator iter = Debugger::muted.find(function_name);
+    if (iter == Debugger::muted.end()) {
+        // Not found, so nothing to remove
+        return;
+    }
+
+    // Found it; remove it if this was the last time it was muted
+    if (--iter->second == 0) {
+        Debugger::muted.erase(iter);
+    }
 }
 
 
@@ -385,11 +647,79 @@ void Debugger::dedent() {
 
 
 /* Logs a message to the debugger. The type of message must be specified, which also determines how the message will be printed. If the the severity is fatal, also throws a std::runtime_error with the same text. To disable that, use Severity::nonfatal otherwise. Finally, one can optionally specify extra levels of indentation to use for this message. */
-void Debugger::log(Severity severity, const std::string& message, size_t extra_indent) {
-    // Write to the correct stream based on the severity
-    if (severity == Severity::info || severity == Severity::auxillary) {
-        this->_log(std::cout, severity, message, extra_indent);
-    } else {
-        this->_log(std::cerr, severity, message, extra_indent);
+void Debugger::log(Severity severity, std::string_view message, size_t extra_indent) {
+    // Copy what we need to print into this thread's scratch entry, unless the message is muted
+    static thread_local LogEntry entry;
+    if (!this->capture(entry, severity, nullptr, message, extra_indent)) { return; }
+
+    // Fatal messages are printed before we throw, and so is anything that doesn't fit in the ring. Everything else is left to the writer
+    if (severity == Severity::fatal) {
+        this->print_now(entry);
+        throw std::runtime_error(std::string(message));
+    } else if (!this->enqueue(entry)) {
+        this->print_now(entry);
     }
 }
+
+/* Logs a message that still has to be formatted, i.e., the given format string with the given encoded arguments. Never used for fatal messages. */
+void Debugger::log_encoded(Severity severity, const char* format, std::string_view args) {
+    // Same as log(), except that the writer formats the message
+    static thread_local LogEntry entry;
+    if (!this->capture(entry, severity, format, args, 0)) { return; }
+    if (!this->enqueue(entry)) {
+        this->print_now(entry);
+    }
+}
+
+/* Turns the encoded arguments of the given entry into its message, if it has any. Only called with the drain_lock held. */
+void Debugger::expand(LogEntry& entry) {
+    if (entry.format == nullptr) { return; }
+
+    // Format in our own buffer, then swap it with the arguments so both keep their memory
+    this->expand_buffer.clear();
+    format_encoded(this->expand_buffer, entry.format, entry.message.data(), entry.message.size());
+    entry.message.swap(this->expand_buffer);
+    entry.format = nullptr;
+}
+
+/* Prints everything that has been logged so far before returning. */
+void Debugger::flush() {
+    std::unique_lock<std::mutex> _drain_lock(this->drain_lock);
+    this->drain();
+}
+
+
+
+/* Writes all messages logged from now on to a binary log at the given path instead of printing them. Fatal messages are printed as well. Returns false if the file could not be opened. */
+bool Debugger::open_binary(const std::string& path) {
+    // Open the file first, so that nothing changes if we can't
+    BinaryLogWriter* writer = new BinaryLogWriter();
+    if (!writer->open(path)) {
+        delete writer;
+        return false;
+    }
+
+    // Print what was logged before, then swap the logs
+    std::unique_lock<std::mutex> _drain_lock(this->drain_lock);
+    this->drain();
+    delete this->binary;
+    this->binary = writer;
+    return true;
+}
+
+/* Stops writing to the binary log, if any, and prints messages again. */
+void Debugger::close_binary() {
+    std::unique_lock<std::mutex> _drain_lock(this->drain_lock);
+
+    // Write what's left to the log before closing it
+    this->drain();
+    delete this->binary;
+    this->binary = nullptr;
+}
+
+/* Prints the given entry to the given stream the way the debugger would, formatting its arguments first if needed. Used to decode binary logs. */
+void Debugger::print(std::ostream& os, LogEntry& entry) {
+    std::unique_lock<std::mutex> _drain_lock(this->drain_lock);
+    this->expand(entry);
+    this->_log(os, entry);
+}
@@ -4,7 +4,7 @@
  * Created:
  *   19/12/2020, 16:32:58
  * Last edited:
- *   12/24/2020, 1:01:28 PM
+ *   16/10/2026, 23:14:52
  * Auto updated?
  *   Yes
  *
@@ -13,21 +13,32 @@
  *   specify the debugging type and where its timestamp is noted.
  *   Aditionally, lines are automatically linewrapped (with correct
  *   indents), and extra indentation levels can be given based on functions
- *   entered or left.
+ *   entered or left. Messages are copied to a ring per thread and printed
+ *   in batches by a background thread, except for fatal ones. Messages
+ *   below DEBUG_MIN_SEVERITY are left out at compile time, and DLOGF only
+ *   formats its message once it's known that it will be printed.
+ *   Instead of printing them, the messages can also be written to a
+ *   compact binary log, which can be decoded later.
 **/
 
 #ifndef DEBUG_HPP
 #define DEBUG_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
 #include <thread>
 
+#include "Profiler.hpp"
+#include "Format.hpp"
+
 /***** COLOUR CONSTANTS *****/
 /* Foreground colours */
 #define RED "\033[31;1m"
@@ -41,21 +52,35 @@
 /* Reset colour */
 #define RESET "\033[0m"
 
+/***** SEVERITY FILTER *****/
+/* The least important severity that is compiled in: 0 for everything (auxillary), 1 for info, 2 for warnings, 3 for errors and 4 for fatal errors only. Fatal errors are always kept, since they change the control flow. Defaults to everything when debugging, and to errors only otherwise. */
+#ifndef DEBUG_MIN_SEVERITY
+#ifndef NDEBUG
+#define DEBUG_MIN_SEVERITY 0
+#else
+#define DEBUG_MIN_SEVERITY 3
+#endif
+#endif
+
 #ifndef NDEBUG
 /***** MACROS WHEN DEBUGGING IS ENABLED *****/
 
 /* Registers a given thread to the debugger. Should therefore be called before DENTER() in the first function of a thread. */
 #define DSTART(THREAD_NAME) \
-    Debug::debugger.start((THREAD_NAME));
+    Debug::debugger.start((THREAD_NAME)); \
+    Debug::profiler.name_thread((THREAD_NAME));
 
-/* Registers given function on the debugger's stacktrace. */
+/* Registers given function on the debugger's stacktrace, and enters it as a zone on the profiler. */
 #define DENTER(FUNC_NAME) \
-    Debug::debugger.push((FUNC_NAME), (__FILE__), (__LINE__) - 1);
+    Debug::debugger.push((FUNC_NAME), (__FILE__), (__LINE__) - 1); \
+    Debug::profiler.begin((FUNC_NAME));
 /* Pops the current frame from the stack only, but does not call return. */
 #define DLEAVE \
+    Debug::profiler.end(); \
     Debug::debugger.pop();
 /* Wraps the return statement, first popping the current value from the stack. */
 #define DRETURN \
+    Debug::profiler.end(); \
     Debug::debugger.pop(); \
     return
 
@@ -64,7 +89,7 @@
     Debug::debugger.mute((FUNC_NAME));
 /* Unmutes function with the given name. */
 #define DUNMUTE(FUNC_NAME) \
-    Debug::debugger.mute((FUNC_NAME));
+    Debug::debugger.unmute((FUNC_NAME));
 
 /* Increase the indent of the logger by N steps. */
 #define DINDENT \
@@ -73,28 +98,22 @@
 #define DDEDENT \
     Debug::debugger.dedent();
 
-/* Logs using the debugger. */
-#define DLOG(SEVERITY, MESSAGE) \
-    Debug::debugger.log((SEVERITY), (MESSAGE));
-/* Logs using the debugger with extra indent. */
-#define DLOGi(SEVERITY, MESSAGE, INDENT) \
-    Debug::debugger.log((SEVERITY), (MESSAGE), (INDENT));
-
-
-/* Increases the indent in the debug levels. */
-
 #else
 /***** MACROS WHEN DEBUGGING IS DISABLED *****/
 
-/* Registers a given thread to the debugger. Should therefore be called before DENTER() in the first function of a thread. */
-#define DSTART(THREAD_NAME)
+/* Registers a given thread to the debugger. Should therefore be called before DENTER() in the first function of a thread. Only names the thread on the profiler. */
+#define DSTART(THREAD_NAME) \
+    Debug::profiler.name_thread((THREAD_NAME));
 
-/* Registers given function on the debugger's stacktrace. */
-#define DENTER(FUNC_NAME)
+/* Registers given function on the debugger's stacktrace. Only enters it as a zone on the profiler, which is cheap enough to keep in release builds. */
+#define DENTER(FUNC_NAME) \
+    Debug::profiler.begin((FUNC_NAME));
 /* Pops the current frame from the stack only, but does not call return. */
-#define DLEAVE
+#define DLEAVE \
+    Debug::profiler.end();
 /* Wraps the return statement, first popping the current value from the stack. */
 #define DRETURN \
+    Debug::profiler.end(); \
     return
 
 /* Mutes function with the given name. */
@@ -107,16 +126,21 @@
 /* Decrease the indent of the logger by N steps. */
 #define DDEDENT
 
-/* Logs using the debugger. */
+#endif
+
+/***** LOGGING MACROS *****/
+/* Logs using the debugger. Compiles to nothing if the severity is below DEBUG_MIN_SEVERITY; string literals are logged without allocating. Fatal messages throw a std::runtime_error in release builds too, so every thread has to catch it at its entry point. */
 #define DLOG(SEVERITY, MESSAGE) \
-    if ((SEVERITY) == Severity::nonfatal) { std::cerr << (MESSAGE) << std::endl; } \
-    else if ((SEVERITY) == Severity::fatal) { std::cerr << (MESSAGE) << std::endl; exit(EXIT_FAILURE); }
+    if constexpr (Debug::severity_enabled((SEVERITY))) { Debug::debugger.log((SEVERITY), (MESSAGE)); }
 /* Logs using the debugger with extra indent. */
 #define DLOGi(SEVERITY, MESSAGE, INDENT) \
-    if ((SEVERITY) == Severity::nonfatal) { std::cerr << (MESSAGE) << std::endl; } \
-    else if ((SEVERITY) == Severity::fatal) { std::cerr << (MESSAGE) << std::endl; exit(EXIT_FAILURE); }
-
-#endif
+    if constexpr (Debug::severity_enabled((SEVERITY))) { Debug::debugger.log((SEVERITY), (MESSAGE), (INDENT)); }
+/* Logs using the debugger, replacing each '{}' in the format string with the next argument. The message is only built if it's going to be printed, i.e., if its severity is compiled in and it isn't muted. */
+#define DLOGF(SEVERITY, ...) \
+    if constexpr (Debug::severity_enabled((SEVERITY))) { Debug::debugger.logf((SEVERITY), __VA_ARGS__); }
+/* Waits until everything logged so far is printed. Use before writing to stdout or stderr directly, so that it ends up after the log messages. */
+#define DFLUSH \
+    Debug::debugger.flush();
 
 
 /***** DEBUG NAMESPACE *****/
@@ -142,19 +166,117 @@ namespace Debug {
     }
     using Severity = SeverityValues::type;
 
-    /* Struct used to refer to a stack frame. */
+    /* Returns how important messages of the given severity are, on the same scale as DEBUG_MIN_SEVERITY. */
+    constexpr int severity_level(Severity severity) {
+        switch (severity) {
+            case SeverityValues::auxillary: return 0;
+            case SeverityValues::info: return 1;
+            case SeverityValues::warning: case SeverityValues::vulkan_warning: return 2;
+            case SeverityValues::nonfatal: case SeverityValues::vulkan_error: return 3;
+            default: return 4;
+        }
+    }
+    /* Returns whether messages of the given severity are compiled in. */
+    constexpr bool severity_enabled(Severity severity) {
+        return severity == SeverityValues::fatal || severity_level(severity) >= DEBUG_MIN_SEVERITY;
+    }
+
+    /* Struct used to refer to a stack frame. The names are string literals (from DENTER and __FILE__), so they're never copied. */
     struct Frame {
         /* The name of the function we entered. */
-        std::string func_name;
+        const char* func_name;
         /* The file where the function resides. */
-        std::string file_name;
+        const char* file_name;
         /* The line number where the function is defined (i.e., the line above DENTER). */
         size_t line_number;
     };
 
+    /* Struct with the fixed-size stack of frames of a single thread. */
+    struct CallStack {
+        /* The maximum number of frames kept. Deeper calls are still counted, but not shown in stacktraces. */
+        static constexpr size_t capacity = 128;
 
+        /* The frames, outermost first. */
+        Frame frames[capacity];
+        /* The number of functions we're in, which may be larger than the capacity. */
+        size_t depth;
+    };
+
+    /* Struct that forms the start of a log record in a LogRing. It's followed by the message, the thread name and n_frames Frames, padded to a multiple of eight bytes. */
+    struct LogRecord {
+        /* The size of the entire record in bytes, including this header and the padding. Zero marks that the rest of the ring is unused and the next record is at its start. */
+        uint32_t size;
+        /* The severity of the message. */
+        uint32_t severity;
+        /* The number of the record over all threads, which is used to print them in the order they were logged. */
+        uint64_t sequence;
+        /* The time the message was logged, in nanoseconds since the Unix epoch. */
+        int64_t time;
+        /* The format string of a DLOGF message, in which case the message holds its encoded arguments. nullptr for other messages. */
+        const char* format;
+        /* The indent level of the debugger when the message was logged. */
+        uint32_t indent_level;
+        /* The extra indent given with the message. */
+        uint32_t extra_indent;
+        /* The number of bytes in the message. */
+        uint32_t message_size;
+        /* The number of bytes in the thread's name. */
+        uint32_t thread_name_size;
+        /* Whether or not the thread was in any function when the message was logged, which decides whether a stacktrace is printed at all. */
+        uint32_t has_stack;
+        /* The number of stack frames that follow, innermost first. */
+        uint32_t n_frames;
+        /* The id of the logging thread. */
+        uint64_t tid;
+    };
+
+    /* Struct with a single-producer, single-consumer ring of LogRecords. Every thread that logs has its own, which only it writes and only the writer thread reads. */
+    struct LogRing {
+        /* The number of bytes in each ring. */
+        static constexpr size_t capacity = 64 * 1024;
+
+        /* The memory of the ring. */
+        char* data;
+        /* The total number of bytes ever written. Only the owning thread changes it. */
+        std::atomic<size_t> head;
+        /* The total number of bytes ever read. Only the thread draining the rings changes it. */
+        std::atomic<size_t> tail;
+    };
 
-    /* The main debug class, which is used to keep track of where we are and whether or not prints are accepted etc. It should be thread-safe, albeit probably quite slow. */
+    /* Struct that holds a log record after it has been read from its ring, ready to be printed. */
+    struct LogEntry {
+        /* The severity of the message. */
+        Severity severity;
+        /* The number of the record over all threads. */
+        uint64_t sequence;
+        /* The time the message was logged, in nanoseconds since the Unix epoch. */
+        int64_t time;
+        /* The indent level of the debugger when the message was logged. */
+        size_t indent_level;
+        /* The extra indent given with the message. */
+        size_t extra_indent;
+        /* The format string of a DLOGF message, which has to be a string literal. nullptr for other messages. */
+        const char* format;
+        /* The message itself, or the encoded arguments if there is a format string. */
+        std::string message;
+        /* The id of the logging thread, as it's printed. */
+        uint64_t tid;
+        /* The name of the logging thread, if any. */
+        std::string thread_name;
+        /* Whether or not the thread was in any function when the message was logged. */
+        bool has_stack;
+        /* The stack frames to print with the message, innermost first. */
+        std::vector<Frame> frames;
+    };
+
+
+
+    /* Forward declaration of the class that writes binary logs. */
+    class BinaryLogWriter;
+
+
+
+    /* The main debug class, which is used to keep track of where we are and whether or not prints are accepted etc. Messages are copied to a per-thread ring and printed by a background thread, except for fatal ones, which are printed before log() throws. */
     class Debugger {
     public:
         /* The maximum linewidth before the debugger breaks lines. */
@@ -165,12 +287,14 @@ namespace Debug {
         static constexpr size_t prefix_size = 10;
 
     private:
-        /* Maps thread ids to programmer-readable names. */
-        std::unordered_map<std::thread::id, std::string> thread_names;
-        /* The stack of frames we're currently in. */
-        std::unordered_map<std::thread::id, std::vector<Frame>> stack;
-        /* List of currently muted functions. */
-        std::unordered_map<std::thread::id, std::vector<std::string>> muted;
+        /* The programmer-readable name of the current thread. */
+        static thread_local std::string thread_name;
+        /* The stack of frames the current thread is in. */
+        static thread_local CallStack stack;
+        /* The functions muted on the current thread, with how often they were muted. */
+        static thread_local std::unordered_map<std::string_view, size_t> muted;
+        /* The buffer DLOGF formats its messages in, which keeps its memory between messages. */
+        static thread_local std::string format_buffer;
 
         /* Flags if the current terminal supports color codes. */
         bool colour_enabled;
@@ -194,49 +318,140 @@ namespace Debug {
         /* The current number of indents specified. */
         std::atomic<size_t> indent_level;
 
-        /* Lock used to make the Debugger thread-safe. */
+        /* Lock used to register new rings. */
         std::mutex lock;
         /* Used to identify the 'main' thread. */
         std::thread::id main_tid;
 
+        /* The ring of the current thread, or nullptr if it didn't log anything yet. */
+        static thread_local LogRing* local_ring;
+        /* The rings of all threads that logged something. */
+        std::vector<LogRing*> rings;
+        /* The number of records logged so far, over all threads. */
+        std::atomic<uint64_t> n_records;
+
+        /* Lock that makes sure only one thread drains the rings at a time. */
+        std::mutex drain_lock;
+        /* The background thread that prints the records. */
+        std::thread writer;
+        /* Makes sure the writer is only started once. */
+        std::once_flag writer_started;
+        /* Lock for the condition variable below. */
+        std::mutex writer_lock;
+        /* Wakes up the writer, either because a ring is filling up or because the debugger is destroyed. */
+        std::condition_variable writer_wakeup;
+        /* Tells the writer to stop, after which everything is printed right away. */
+        std::atomic<bool> writer_stop;
+
+        /* The binary log that messages are written to instead of being printed, or nullptr to print them. Only used with the drain_lock held. */
+        BinaryLogWriter* binary;
+        /* The buffer that the writer formats the arguments of DLOGF messages in. Only used with the drain_lock held. */
+        std::string expand_buffer;
+
         /* Prints a given string over multiple lines, pasting n spaces in front of each one and linewrapping on the target width. Optionally, a starting x can be specified. */
-        void print_linewrapped(std::ostream& os, size_t& x, size_t width, const std::string& message);
-        /* Actually prints the message to a given stream. */
-        void _log(std::ostream& os, Severity severity, const std::string& message, size_t extra_indent);
+        void print_linewrapped(std::ostream& os, size_t& x, size_t width, size_t indent_level, const std::string& message);
+        /* Actually prints the given log entry to a given stream. */
+        void _log(std::ostream& os, const LogEntry& entry);
+
+        /* Returns whether or not messages logged by the current thread are muted, because the function it's in is. */
+        inline bool is_muted() {
+            // We only know which function we're in if there is a stack
+            if (Debugger::stack.depth == 0 || Debugger::stack.depth > CallStack::capacity || Debugger::muted.size() == 0) { return false; }
+
+            // Look the current function up by name
+            return Debugger::muted.find(Debugger::stack.frames[Debugger::stack.depth - 1].func_name) != Debugger::muted.end();
+        }
+        /* Fills in the given entry with what needs to be printed for a message with the given severity logged from the current thread. Returns false if the message is muted instead. */
+        bool capture(LogEntry& entry, Severity severity, const char* format, std::string_view message, size_t extra_indent);
+        /* Logs a message that still has to be formatted, i.e., the given format string with the given encoded arguments. Never used for fatal messages. */
+        void log_encoded(Severity severity, const char* format, std::string_view args);
+        /* Turns the encoded arguments of the given entry into its message, if it has any. Only called with the drain_lock held. */
+        void expand(LogEntry& entry);
+        /* Returns the ring of the current thread, creating it (and starting the writer) if it doesn't have one yet. */
+        LogRing* get_ring();
+        /* Copies the given entry to the current thread's ring, waiting for room if it's full. Returns false if it doesn't fit in a ring at all, or if the writer has been stopped. */
+        bool enqueue(const LogEntry& entry);
+        /* Prints the given entry right away, after everything that was logged before it. */
+        void print_now(LogEntry& entry);
+        /* Reads the oldest record in the given ring into the given entry, if there is any. Doesn't remove it from the ring yet. Returns its size in bytes, or 0 if the ring is empty. */
+        size_t peek(LogRing* ring, LogEntry& entry);
+        /* Prints (or writes to the binary log) everything in the rings, in the order it was logged. Only called with the drain_lock held. */
+        void drain();
+        /* The function that runs on the writer thread. */
+        void writer_main();
 
     public:
         /* Default constructor for the Debugger class. */
         Debugger();
+        /* Copy constructor for the Debugger class, which is deleted. */
+        Debugger(const Debugger& other) = delete;
+        /* Destructor for the Debugger class, which prints whatever is left and stops the writer thread. */
+        ~Debugger();
 
         /* Registers a new name for the current thread. */
         void start(const std::string& thread_name);
         
-        /* Enters a new function, popping it's value on the stack. */
-        void push(const std::string& function_name, const std::string& file_name, size_t line_number);
+        /* Enters a new function, pushing it on the current thread's stack. Both names have to be string literals. */
+        inline void push(const char* function_name, const char* file_name, size_t line_number) {
+            if (Debugger::stack.depth < CallStack::capacity) {
+                Debugger::stack.frames[Debugger::stack.depth] = { function_name, file_name, line_number };
+            }
+            ++Debugger::stack.depth;
+        }
         /* pops the top function name of the stack. */
-        void pop();
+        inline void pop() {
+            if (Debugger::stack.depth > 0) { --Debugger::stack.depth; }
+        }
 
-        /* Mutes a given function. All info-level severity messages that are called from it or from children functions are ignored. */
-        void mute(const std::string& function_name);
-        /* Unmutes a given function. All info-level severity messages that are called from it or from children functions are ignored. */
-        void unmute(const std::string& function_name);
+        /* Mutes a given function on the current thread, which has to be a string literal. All info-level severity messages that are called from it are ignored. */
+        void mute(const char* function_name);
+        /* Unmutes a given function on the current thread. */
+        void unmute(const char* function_name);
 
         /* Increases indents. Useful for when a helper function is called, for example. */
         void indent();
         /* Decreases indents. */
         void dedent();
 
+        /* Returns whether a message with the given severity, logged from the current thread, would be printed. Only the plain messages and the warnings may be muted. */
+        inline bool accepts(Severity severity) {
+            return !(severity == Severity::auxillary || severity == Severity::info || severity == Severity::warning || severity == Severity::vulkan_warning) || !this->is_muted();
+        }
+
         /* Logs a message to stdout. The type of message must be specified, which also determines how the message will be printed. If the the severity is fatal, also throws a std::runtime_error with the same text. To disable that, use Severity::nonfatal otherwise. Finally, one can optionally specify extra levels of indentation to use for this message. */
-        void log(Severity severity, const std::string& message, size_t extra_indent = 0);
+        void log(Severity severity, std::string_view message, size_t extra_indent = 0);
+        /* Logs a message like log(), but builds it from the given format string (which has to be a string literal) by replacing each '{}' with the next argument. Nothing is formatted if the message is muted, and other than fatal messages, the formatting is left to the writer thread. */
+        template <typename... Ts>
+        inline void logf(Severity severity, const char* format, const Ts&... values) {
+            // Don't build messages nobody will see
+            if (!this->accepts(severity)) { return; }
+
+            // Fatal messages are thrown too, so they're formatted right away; everything else only copies its arguments to this thread's buffer, which almost never allocates
+            Debugger::format_buffer.clear();
+            if (severity == Severity::fatal) {
+                format_to(Debugger::format_buffer, format, values...);
+                this->log(severity, Debugger::format_buffer);
+            } else {
+                encode_values(Debugger::format_buffer, values...);
+                this->log_encoded(severity, format, Debugger::format_buffer);
+            }
+        }
+        /* Prints everything that has been logged so far before returning. */
+        void flush();
+
+        /* Writes all messages logged from now on to a binary log at the given path instead of printing them. Fatal messages are printed as well. Returns false if the file could not be opened. */
+        bool open_binary(const std::string& path);
+        /* Stops writing to the binary log, if any, and prints messages again. */
+        void close_binary();
+        /* Prints the given entry to the given stream the way the debugger would, formatting its arguments first if needed. Used to decode binary logs. */
+        void print(std::ostream& os, LogEntry& entry);
 
     };
 
 
 
-    #ifndef NDEBUG
-    /* Tell the compiler that there is an global debugger instance. */
+    /* Tell the compiler that there is an global debugger instance. It's there in release builds too, since messages of at least DEBUG_MIN_SEVERITY are still printed. */
     extern Debugger debugger;
-    #endif
 };
 
 #endif
@@ -0,0 +1,252 @@
+/* FORMAT.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 18:15:38
+ * Last edited:
+ *   16/10/2026, 18:39:20
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains a small formatter used by DLOGF, which replaces each '{}' in
+ *   a format string with the next argument. It appends to an existing
+ *   string, so that a buffer that is reused between messages doesn't need
+ *   to allocate once it's large enough. The arguments can also be encoded
+ *   in a compact binary form first and formatted later, which is what the
+ *   log writer and the binary logs do.
+**/
+
+#ifndef DEBUG_FORMAT_HPP
+#define DEBUG_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <charconv>
+#include <type_traits>
+
+/***** FORMAT NAMESPACE *****/
+namespace Debug {
+    /* Appends a string to the given output. */
+    inline void format_value(std::string& out, std::string_view value) { out.append(value.data(), value.size()); }
+    /* Appends a C-string to the given output. */
+    inline void format_value(std::string& out, const char* value) { out.append(value); }
+    /* Appends a std::string to the given output. */
+    inline void format_value(std::string& out, const std::string& value) { out.append(value); }
+    /* Appends a single character to the given output. */
+    inline void format_value(std::string& out, char value) { out.push_back(value); }
+    /* Appends a boolean to the given output, as 'true' or 'false'. */
+    inline void format_value(std::string& out, bool value) { out.append(value ? "true" : "false"); }
+
+    /* Appends any other value to the given output: integers and enums as a number, floating-point values the same way std::to_string does, non-string pointers as an address and everything else through its operator<<. */
+    template <typename T>
+    void format_value(std::string& out, const T& value) {
+        if constexpr (std::is_enum<T>::value) {
+            format_value(out, static_cast<std::underlying_type_t<T>>(value));
+        } else if constexpr (std::is_integral<T>::value) {
+            char buffer[24];
+            std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, result.ptr - buffer);
+        } else if constexpr (std::is_floating_point<T>::value) {
+            char buffer[64];
+            int length = std::snprintf(buffer, sizeof(buffer), "%f", (double) value);
+            if (length >= 0 && (size_t) length < sizeof(buffer)) { out.append(buffer, length); }
+            else { out.append(std::to_string(value)); }
+        } else if constexpr (std::is_same<T, char*>::value) {
+            out.append(value);
+        } else if constexpr (std::is_pointer<T>::value) {
+            char buffer[24];
+            int length = std::snprintf(buffer, sizeof(buffer), "%p", (const void*) value);
+            out.append(buffer, length);
+        } else {
+            std::ostringstream sstr;
+            sstr << value;
+            out.append(sstr.str());
+        }
+    }
+
+
+
+    /* Appends the given format string to the given output, up to where it ends. Used once all arguments have been formatted. */
+    inline void format_to(std::string& out, const char* format) {
+        out.append(format);
+    }
+
+    /* Appends the given format string to the given output, replacing each '{}' with the next argument. Placeholders without an argument are copied as-is. */
+    template <typename T, typename... Ts>
+    void format_to(std::string& out, const char* format, const T& value, const Ts&... values) {
+        // Copy everything up to the next placeholder
+        const char* start = format;
+        while (*format != '\0' && !(format[0] == '{' && format[1] == '}')) { ++format; }
+        out.append(start, format - start);
+
+        // If there is none, the remaining arguments are ignored
+        if (*format == '\0') { return; }
+
+        // Otherwise, fill it in and continue with the rest
+        format_value(out, value);
+        format_to(out, format + 2, values...);
+    }
+
+
+
+    /* Enum that defines the tags that precede each encoded argument. */
+    namespace ArgTypes {
+        enum type : char {
+            /* A signed integer, stored as a zigzagged varint. */
+            signed_integer = 'i',
+            /* An unsigned integer, stored as a varint. */
+            unsigned_integer = 'u',
+            /* A double, stored as its eight bytes. */
+            floating_point = 'd',
+            /* A boolean, stored as a single byte. */
+            boolean = 'b',
+            /* A character, stored as a single byte. */
+            character = 'c',
+            /* A string, stored as a varint with its size followed by its bytes. Also used for everything that's formatted with operator<<. */
+            string = 's'
+        };
+    }
+    using ArgType = ArgTypes::type;
+
+    /* Appends the given unsigned integer to the given output as a varint, i.e., seven bits per byte with the highest bit set on all but the last. */
+    inline void encode_varint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back((char) ((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back((char) value);
+    }
+    /* Reads a varint from the given data, moving it past the varint. Returns false if it runs past the given end. */
+    inline bool decode_varint(const char*& data, const char* end, uint64_t& value) {
+        value = 0;
+        for (unsigned int shift = 0; data < end && shift < 64; shift += 7) {
+            uint8_t byte = (uint8_t) *(data++);
+            value |= (uint64_t) (byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) { return true; }
+        }
+        return false;
+    }
+    /* Maps a signed integer to an unsigned one such that small negative numbers stay small (0, -1, 1, -2, ... become 0, 1, 2, 3, ...). */
+    inline uint64_t zigzag(int64_t value) { return ((uint64_t) value << 1) ^ (uint64_t) (value >> 63); }
+    /* Undoes zigzag(). */
+    inline int64_t unzigzag(uint64_t value) { return (int64_t) (value >> 1) ^ -(int64_t) (value & 1); }
+
+    /* Encodes a string. */
+    inline void encode_value(std::string& out, std::string_view value) {
+        out.push_back(ArgTypes::string);
+        encode_varint(out, value.size());
+        out.append(value.data(), value.size());
+    }
+    /* Encodes a C-string. */
+    inline void encode_value(std::string& out, const char* value) { encode_value(out, std::string_view(value)); }
+    /* Encodes a std::string. */
+    inline void encode_value(std::string& out, const std::string& value) { encode_value(out, std::string_view(value)); }
+    /* Encodes a single character. */
+    inline void encode_value(std::string& out, char value) { out.push_back(ArgTypes::character); out.push_back(value); }
+    /* Encodes a boolean. */
+    inline void encode_value(std::string& out, bool value) { out.push_back(ArgTypes::boolean); out.push_back(value ? 1 : 0); }
+
+    /* Encodes any other value: integers, enums and floating-point values as themselves, and everything else as the string format_value() makes of it. */
+    template <typename T>
+    void encode_value(std::string& out, const T& value) {
+        if constexpr (std::is_enum<T>::value) {
+            encode_value(out, static_cast<std::underlying_type_t<T>>(value));
+        } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+            out.push_back(ArgTypes::signed_integer);
+            encode_varint(out, zigzag((int64_t) value));
+        } else if constexpr (std::is_integral<T>::value) {
+            out.push_back(ArgTypes::unsigned_integer);
+            encode_varint(out, (uint64_t) value);
+        } else if constexpr (std::is_floating_point<T>::value) {
+            double d = (double) value;
+            out.push_back(ArgTypes::floating_point);
+            out.append((const char*) &d, sizeof(double));
+        } else {
+            std::string text;
+            format_value(text, value);
+            encode_value(out, std::string_view(text));
+        }
+    }
+
+    /* Encodes nothing, which ends the recursion of encode_values(). */
+    inline void encode_values(std::string&) {}
+    /* Encodes all of the given values after each other. */
+    template <typename T, typename... Ts>
+    void encode_values(std::string& out, const T& value, const Ts&... values) {
+        encode_value(out, value);
+        encode_values(out, values...);
+    }
+
+    /* Formats a single encoded argument, moving the data past it. Returns false if the data is malformed. */
+    inline bool format_encoded_value(std::string& out, const char*& data, const char* end) {
+        if (data >= end) { return false; }
+        ArgType type = (ArgType) *(data++);
+        uint64_t value;
+        switch (type) {
+            case ArgTypes::signed_integer:
+                if (!decode_varint(data, end, value)) { return false; }
+                format_value(out, unzigzag(value));
+                return true;
+
+            case ArgTypes::unsigned_integer:
+                if (!decode_varint(data, end, value)) { return false; }
+                format_value(out, value);
+                return true;
+
+            case ArgTypes::floating_point:
+                {
+                    if (end - data < (ptrdiff_t) sizeof(double)) { return false; }
+                    double d;
+                    std::memcpy(&d, data, sizeof(double));
+                    data += sizeof(double);
+                    format_value(out, d);
+                    return true;
+                }
+
+            case ArgTypes::boolean:
+                if (data >= end) { return false; }
+                format_value(out, *(data++) != 0);
+                return true;
+
+            case ArgTypes::character:
+                if (data >= end) { return false; }
+                format_value(out, *(data++));
+                return true;
+
+            case ArgTypes::string:
+                if (!decode_varint(data, end, value) || (uint64_t) (end - data) < value) { return false; }
+                out.append(data, value);
+                data += value;
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    /* Appends the given format string to the given output like format_to(), but takes the arguments from the given encoded data. Returns false if the data is malformed, in which case the rest of the format string is copied as-is. */
+    inline bool format_encoded(std::string& out, const char* format, const char* data, size_t size) {
+        const char* end = data + size;
+        while (*format != '\0') {
+            // Fill in placeholders as long as there are arguments left
+            if (format[0] == '{' && format[1] == '}' && data < end) {
+                if (!format_encoded_value(out, data, end)) {
+                    out.append(format);
+                    return false;
+                }
+                format += 2;
+                continue;
+            }
+            out.push_back(*(format++));
+        }
+        return true;
+    }
+}
+
+#endif
@@ -0,0 +1,305 @@
+/* PROFILER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 17:58:10
+ * Last edited:
+ *   16/10/2026, 18:03:29
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the Profiler class, which records when named zones (usually
+ *   the functions marked with DENTER / DLEAVE) are entered and left. Each
+ *   thread appends to its own buffer without taking any locks, so that
+ *   recording is cheap enough to leave in release builds. The recorded
+ *   zones can be written as a Chrome trace or as folded stacks for flame
+ *   graphs.
+**/
+
+#include <map>
+#include <iomanip>
+
+#include "Profiler.hpp"
+
+using namespace Debug;
+
+
+/***** GLOBALS *****/
+/* Global instance of the profiler class, used by DENTER, DLEAVE and DZONE. */
+Profiler Debug::profiler;
+/* The buffer of the current thread, or nullptr if it didn't record anything yet. */
+thread_local ZoneThread* Profiler::local = nullptr;
+
+
+
+
+
+/***** HELPER FUNCTIONS *****/
+/* Writes the given zone name to the given stream as a JSON string, escaping what needs to be escaped. */
+static void write_json_string(std::ostream& os, const std::string& value) {
+    os << '"';
+    for (size_t i = 0; i < value.size(); i++) {
+        if (value[i] == '"' || value[i] == '\\') { os << '\\'; }
+        os << value[i];
+    }
+    os << '"';
+}
+
+/* Returns the name of the given thread as used in the output, falling back to its index if it has none. */
+static std::string thread_label(const ZoneThread* thread) {
+    return thread->name.empty() ? "thread " + std::to_string(thread->index) : thread->name;
+}
+
+
+
+
+
+/***** PROFILER CLASS *****/
+/* Default constructor for the Profiler class. */
+Profiler::Profiler() :
+    recording(false),
+    epoch(Profiler::now()),
+    epoch_time(std::chrono::steady_clock::now())
+{}
+
+/* Destructor for the Profiler class. */
+Profiler::~Profiler() {
+    // Make sure nothing writes to the buffers anymore
+    this->recording.store(false);
+
+    // Free the chunks of all threads, then the threads themselves
+    for (size_t i = 0; i < this->threads.size(); i++) {
+        ZoneChunk* chunk = this->threads[i]->first;
+        while (chunk != nullptr) {
+            ZoneChunk* next = chunk->next;
+            delete chunk;
+            chunk = next;
+        }
+        delete this->threads[i];
+    }
+}
+
+
+
+/* Returns the buffer of the current thread with room for at least one event, registering the thread or adding a chunk if needed. */
+ZoneThread* Profiler::grow() {
+    std::unique_lock<std::mutex> _grow_lock(this->lock);
+
+    // If this thread is new, register it with an empty first chunk
+    ZoneThread* thread = Profiler::local;
+    if (thread == nullptr) {
+        ZoneChunk* chunk = new ZoneChunk;
+        chunk->size.store(0, std::memory_order_relaxed);
+        chunk->next = nullptr;
+
+        thread = new ZoneThread({ std::this_thread::get_id(), (uint32_t) this->threads.size(), "", chunk, chunk });
+        this->threads.push_back(thread);
+        Profiler::local = thread;
+    }
+
+    // If the current chunk is full, link a new one after it
+    if (thread->last->size.load(std::memory_order_relaxed) == ZoneChunk::capacity) {
+        ZoneChunk* chunk = new ZoneChunk;
+        chunk->size.store(0, std::memory_order_relaxed);
+        chunk->next = nullptr;
+
+        thread->last->next = chunk;
+        thread->last = chunk;
+    }
+
+    // Done
+    return thread;
+}
+
+
+
+/* Starts recording zones. */
+void Profiler::start() {
+    this->recording.store(true);
+}
+
+/* Stops recording zones. Anything recorded so far is kept. */
+void Profiler::stop() {
+    this->recording.store(false);
+}
+
+/* Throws away everything that was recorded. Only safe while no thread is recording, i.e., after stop(). */
+void Profiler::clear() {
+    std::unique_lock<std::mutex> _clear_lock(this->lock);
+
+    // Keep the threads and their first chunk, since the threads still refer to those; only free the rest
+    for (size_t i = 0; i < this->threads.size(); i++) {
+        ZoneThread* thread = this->threads[i];
+        ZoneChunk* chunk = thread->first->next;
+        while (chunk != nullptr) {
+            ZoneChunk* next = chunk->next;
+            delete chunk;
+            chunk = next;
+        }
+        thread->first->next = nullptr;
+        thread->first->size.store(0, std::memory_order_relaxed);
+        thread->last = thread->first;
+    }
+
+    // Restart the clock too
+    this->epoch = Profiler::now();
+    this->epoch_time = std::chrono::steady_clock::now();
+}
+
+
+
+/* Returns the number of nanoseconds per tick, measured against the steady clock since the epoch. */
+double Profiler::ns_per_tick() const {
+    // Make sure enough time has passed to get a precise measurement
+    std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+    while (time - this->epoch_time < std::chrono::milliseconds(10)) {
+        time = std::chrono::steady_clock::now();
+    }
+    int64_t ticks = Profiler::now();
+
+    // Divide the elapsed time by the elapsed ticks
+    return std::chrono::duration<double, std::nano>(time - this->epoch_time).count() / (double) (ticks - this->epoch);
+}
+
+
+
+/* Registers a name for the current thread, which is used in the output. */
+void Profiler::name_thread(const std::string& thread_name) {
+    // Make sure the thread has a buffer to put the name in
+    ZoneThread* thread = this->grow();
+
+    // Set the name under the lock, since the writers may read it
+    std::unique_lock<std::mutex> _name_lock(this->lock);
+    thread->name = thread_name;
+}
+
+
+
+/* Writes everything recorded so far to the given stream as a Chrome trace (the JSON format read by chrome://tracing and Perfetto). */
+void Profiler::write_chrome_trace(std::ostream& os) const {
+    std::unique_lock<std::mutex> _write_lock(this->lock);
+
+    // Write the header, remembering how the stream formats numbers so we can restore it afterwards
+    std::ios_base::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" << std::endl;
+    os << std::fixed << std::setprecision(3);
+    double ns_per_tick = this->ns_per_tick();
+
+    // Name each thread with a metadata event first
+    bool first = true;
+    for (size_t i = 0; i < this->threads.size(); i++) {
+        const ZoneThread* thread = this->threads[i];
+        if (!first) { os << "," << std::endl; }
+        os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread->index << ",\"args\":{\"name\":";
+        write_json_string(os, thread_label(thread));
+        os << "}}";
+        first = false;
+    }
+
+    // Write the events of each thread as begin / end pairs, in microseconds
+    for (size_t i = 0; i < this->threads.size(); i++) {
+        const ZoneThread* thread = this->threads[i];
+        size_t depth = 0;
+        for (const ZoneChunk* chunk = thread->first; chunk != nullptr; chunk = chunk->next) {
+            size_t size = chunk->size.load(std::memory_order_acquire);
+            for (size_t j = 0; j < size; j++) {
+                const ZoneEvent& event = chunk->events[j];
+                double us = (double) (event.ticks - this->epoch) * ns_per_tick / 1000.0;
+
+                // Skip ends of zones that were entered before recording started
+                if (event.name == nullptr && depth == 0) { continue; }
+
+                if (!first) { os << "," << std::endl; }
+                if (event.name != nullptr) {
+                    os << "{\"name\":";
+                    write_json_string(os, event.name);
+                    os << ",\"ph\":\"B\",\"pid\":0,\"tid\":" << thread->index << ",\"ts\":" << us << "}";
+                    ++depth;
+                } else {
+                    os << "{\"ph\":\"E\",\"pid\":0,\"tid\":" << thread->index << ",\"ts\":" << us << "}";
+                    --depth;
+                }
+                first = false;
+            }
+        }
+    }
+
+    // Done
+    os << std::endl << "]}" << std::endl;
+    os.flags(flags);
+    os.precision(precision);
+}
+
+/* Writes everything recorded so far to the given stream as folded stacks (one 'thread;zone;zone nanoseconds' line per unique stack, with the time spent in that zone itself), which can be fed to flamegraph.pl. */
+void Profiler::write_flame_summary(std::ostream& os) const {
+    std::unique_lock<std::mutex> _write_lock(this->lock);
+
+    // Struct that describes a zone we're in while replaying the events
+    struct OpenZone {
+        /* The stack up to and including this zone, separated by semicolons. */
+        std::string path;
+        /* The tick at which the zone was entered. */
+        int64_t start;
+        /* The ticks spent in zones nested in this one. */
+        int64_t children;
+    };
+
+    // Replay the events of each thread, accumulating the time spent in each unique stack itself
+    std::map<std::string, int64_t> self_ticks;
+    for (size_t i = 0; i < this->threads.size(); i++) {
+        const ZoneThread* thread = this->threads[i];
+        std::string root = thread_label(thread);
+        std::vector<OpenZone> stack;
+        int64_t last_ticks = 0;
+        for (const ZoneChunk* chunk = thread->first; chunk != nullptr; chunk = chunk->next) {
+            size_t size = chunk->size.load(std::memory_order_acquire);
+            for (size_t j = 0; j < size; j++) {
+                const ZoneEvent& event = chunk->events[j];
+                last_ticks = event.ticks;
+
+                if (event.name != nullptr) {
+                    // Entered a new zone; its path extends that of its parent
+                    stack.push_back({ (stack.empty() ? root : stack.back().path) + ";" + event.name, event.ticks, 0 });
+                } else if (!stack.empty()) {
+                    // Left the innermost zone; whatever its children didn't take was spent in the zone itself
+                    int64_t total = event.ticks - stack.back().start;
+                    self_ticks[stack.back().path] += total - stack.back().children;
+                    stack.pop_back();
+                    if (!stack.empty()) { stack.back().children += total; }
+                }
+            }
+        }
+
+        // Close the zones that were still open when recording stopped at the last event we saw
+        while (!stack.empty()) {
+            int64_t total = last_ticks - stack.back().start;
+            self_ticks[stack.back().path] += total - stack.back().children;
+            stack.pop_back();
+            if (!stack.empty()) { stack.back().children += total; }
+        }
+    }
+
+    // Write one line per stack
+    double ns_per_tick = this->ns_per_tick();
+    for (std::map<std::string, int64_t>::const_iterator iter = self_ticks.begin(); iter != self_ticks.end(); ++iter) {
+        os << iter->first << ' ' << (uint64_t) ((double) iter->second * ns_per_tick) << std::endl;
+    }
+}
+
+
+
+/* Returns the total number of events recorded. */
+size_t Profiler::size() const {
+    std::unique_lock<std::mutex> _size_lock(this->lock);
+
+    // Sum the sizes of all chunks
+    size_t result = 0;
+    for (size_t i = 0; i < this->threads.size(); i++) {
+        for (const ZoneChunk* chunk = this->threads[i]->first; chunk != nullptr; chunk = chunk->next) {
+            result += chunk->size.load(std::memory_order_acquire);
+        }
+    }
+    return result;
+}
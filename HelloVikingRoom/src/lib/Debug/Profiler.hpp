@@ -0,0 +1,201 @@
+/* PROFILER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 17:58:10
+ * Last edited:
+ *   16/10/2026, 18:03:29
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the Profiler class, which records when named zones (usually
+ *   the functions marked with DENTER / DLEAVE) are entered and left. Each
+ *   thread appends to its own buffer without taking any locks, so that
+ *   recording is cheap enough to leave in release builds. The recorded
+ *   zones can be written as a Chrome trace or as folded stacks for flame
+ *   graphs.
+**/
+
+#ifndef DEBUG_PROFILER_HPP
+#define DEBUG_PROFILER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define DEBUG_PROFILER_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define DEBUG_PROFILER_TSC
+#endif
+
+/***** MACROS *****/
+/* Helpers to paste the line number to the name of a zone variable. */
+#define DZONE_CONCAT_(A, B) A ## B
+#define DZONE_CONCAT(A, B) DZONE_CONCAT_(A, B)
+
+/* Profiles the rest of the current scope as a zone with the given name, which has to be a string literal. Works in release builds too. */
+#define DZONE(ZONE_NAME) \
+    Debug::Zone DZONE_CONCAT(_dzone_, __LINE__)((ZONE_NAME));
+
+
+/***** PROFILER NAMESPACE *****/
+namespace Debug {
+    /* Struct that describes a single recorded event: either the start of a zone, or the end of the most recently started one. */
+    struct ZoneEvent {
+        /* The name of the zone that was entered, or nullptr if this event leaves a zone. */
+        const char* name;
+        /* The time of the event, in ticks of the profiler's clock. */
+        int64_t ticks;
+    };
+
+    /* Struct that holds a fixed-size block of events of a single thread. */
+    struct ZoneChunk {
+        /* The number of events in a single chunk. */
+        static constexpr size_t capacity = 8192;
+
+        /* The events themselves. */
+        ZoneEvent events[capacity];
+        /* The number of events written. Only the owning thread writes it; readers see every event before it. */
+        std::atomic<size_t> size;
+        /* The next chunk of the same thread, if this one is full. */
+        ZoneChunk* next;
+    };
+
+    /* Struct that keeps track of the events of a single thread. */
+    struct ZoneThread {
+        /* The id of the thread. */
+        std::thread::id tid;
+        /* The number of the thread in the order they first recorded something, which is used as its id in the trace. */
+        uint32_t index;
+        /* The name of the thread, if it was given one with DSTART. */
+        std::string name;
+        /* The first chunk of events. */
+        ZoneChunk* first;
+        /* The chunk that is currently written to. */
+        ZoneChunk* last;
+    };
+
+
+
+    /* The Profiler class, which records entered and left zones in per-thread buffers. There is one global instance, which is disabled until start() is called. */
+    class Profiler {
+    private:
+        /* The buffer of the current thread, or nullptr if it didn't record anything yet. */
+        static thread_local ZoneThread* local;
+
+        /* Whether or not zones are currently recorded. */
+        std::atomic<bool> recording;
+        /* The tick at which the profiler was created (or cleared), which is used as time zero in the output. */
+        int64_t epoch;
+        /* The time of the steady clock at the epoch, which is used to find out how long a tick is. */
+        std::chrono::steady_clock::time_point epoch_time;
+
+        /* Lock that guards the list of threads and the linking of new chunks. */
+        mutable std::mutex lock;
+        /* The buffers of all threads that recorded something. */
+        std::vector<ZoneThread*> threads;
+
+        /* Returns the buffer of the current thread with room for at least one event, registering the thread or adding a chunk if needed. */
+        ZoneThread* grow();
+
+        /* Returns the number of nanoseconds per tick, measured against the steady clock since the epoch. */
+        double ns_per_tick() const;
+
+        /* Returns the current time in ticks of the profiler's clock. That's the CPU's timestamp counter where there is one, since reading the steady clock can take longer than the entire zone should. */
+        static inline int64_t now() {
+            #ifdef DEBUG_PROFILER_TSC
+            return (int64_t) __rdtsc();
+            #else
+            return std::chrono::steady_clock::now().time_since_epoch().count();
+            #endif
+        }
+        /* Appends an event with the given name (nullptr to leave) to the current thread's buffer. */
+        inline void record(const char* name) {
+            // Take the time first, so that the bookkeeping below isn't counted
+            int64_t ticks = Profiler::now();
+
+            // Get a chunk with room, which is almost always the one we wrote to last time
+            ZoneThread* thread = Profiler::local;
+            if (thread == nullptr || thread->last->size.load(std::memory_order_relaxed) == ZoneChunk::capacity) {
+                thread = this->grow();
+            }
+            ZoneChunk* chunk = thread->last;
+
+            // Write the event, then publish it
+            size_t index = chunk->size.load(std::memory_order_relaxed);
+            chunk->events[index].name = name;
+            chunk->events[index].ticks = ticks;
+            chunk->size.store(index + 1, std::memory_order_release);
+        }
+
+    public:
+        /* Default constructor for the Profiler class. */
+        Profiler();
+        /* Copy constructor for the Profiler class, which is deleted. */
+        Profiler(const Profiler& other) = delete;
+        /* Move constructor for the Profiler class, which is deleted since threads keep pointers to their buffers. */
+        Profiler(Profiler&& other) = delete;
+        /* Destructor for the Profiler class. */
+        ~Profiler();
+
+        /* Starts recording zones. */
+        void start();
+        /* Stops recording zones. Anything recorded so far is kept. */
+        void stop();
+        /* Throws away everything that was recorded. Only safe while no thread is recording, i.e., after stop(). */
+        void clear();
+
+        /* Registers a name for the current thread, which is used in the output. */
+        void name_thread(const std::string& thread_name);
+
+        /* Enters the zone with the given name, which has to outlive the profiler (i.e., be a string literal). Does nothing if the profiler isn't recording. */
+        inline void begin(const char* name) { if (this->recording.load(std::memory_order_relaxed)) { this->record(name); } }
+        /* Leaves the most recently entered zone. Does nothing if the profiler isn't recording. */
+        inline void end() { if (this->recording.load(std::memory_order_relaxed)) { this->record(nullptr); } }
+
+        /* Writes everything recorded so far to the given stream as a Chrome trace (the JSON format read by chrome://tracing and Perfetto). */
+        void write_chrome_trace(std::ostream& os) const;
+        /* Writes everything recorded so far to the given stream as folded stacks (one 'thread;zone;zone nanoseconds' line per unique stack, with the time spent in that zone itself), which can be fed to flamegraph.pl. */
+        void write_flame_summary(std::ostream& os) const;
+
+        /* Returns whether or not the profiler is currently recording. */
+        inline bool enabled() const { return this->recording.load(std::memory_order_relaxed); }
+        /* Returns the total number of events recorded. */
+        size_t size() const;
+
+    };
+
+
+
+    /* Tell the compiler that there is a global profiler instance. */
+    extern Profiler profiler;
+
+
+
+    /* The Zone class, which enters a zone on the global profiler when it's created and leaves it when it goes out of scope. Used by DZONE. */
+    class Zone {
+    private:
+        /* Whether or not the zone was entered, so that it's only left if it was. */
+        bool entered;
+
+    public:
+        /* Constructor for the Zone class, which enters the zone with the given name. */
+        inline Zone(const char* name) : entered(profiler.enabled()) { if (this->entered) { profiler.begin(name); } }
+        /* Copy constructor for the Zone class, which is deleted. */
+        Zone(const Zone& other) = delete;
+        /* Destructor for the Zone class, which leaves the zone again. */
+        inline ~Zone() { if (this->entered) { profiler.end(); } }
+
+    };
+}
+
+#endif
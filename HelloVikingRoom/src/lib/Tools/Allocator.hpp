@@ -0,0 +1,77 @@
+/* ALLOCATOR.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:05:53
+ * Last edited:
+ *   16/10/2026, 21:00:21
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the default allocator used by the Array, which simply uses
+ *   malloc(), realloc() and free(). Other allocators (see Arena.hpp and
+ *   Pool.hpp) implement the same three functions:
+ *     void* allocate(size_t n_bytes, size_t alignment);
+ *     void* reallocate(void* data, size_t old_n_bytes, size_t new_n_bytes, size_t alignment);
+ *     void deallocate(void* data, size_t n_bytes);
+ *   where reallocate() may move the bytes of the data (so it's only used
+ *   for relocatable types) and deallocate() accepts nullptrs. Allocators
+ *   that can only hand out a limited number of bytes at once also
+ *   implement:
+ *     size_t max_size() const;
+ *   which the Array uses to not grow past it.
+**/
+
+#ifndef ALLOCATOR_HPP
+#define ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace Tools {
+    /* The default allocator, which allocates everything separately on the heap. Since malloc() only aligns to std::max_align_t, larger alignments aren't supported. */
+    class MallocAllocator {
+    public:
+        /* Allocates memory for the given number of bytes. Throws std::bad_alloc if that failed. */
+        inline void* allocate(size_t n_bytes, size_t) {
+            void* result = malloc(n_bytes);
+            if (result == nullptr && n_bytes > 0) { throw std::bad_alloc(); }
+            return result;
+        }
+        /* Resizes the given memory to the given number of bytes, moving it if it can't grow in-place. Throws std::bad_alloc if that failed. */
+        inline void* reallocate(void* data, size_t, size_t new_n_bytes, size_t) {
+            void* result = realloc(data, new_n_bytes);
+            if (result == nullptr && new_n_bytes > 0) { throw std::bad_alloc(); }
+            return result;
+        }
+        /* Frees the given memory. */
+        inline void deallocate(void* data, size_t) { free(data); }
+
+    };
+
+
+
+    /* Tells whether the given allocator has a max_size() function. */
+    template <class A, class = void>
+    struct has_max_size : std::false_type {};
+    /* Tells whether the given allocator has a max_size() function. */
+    template <class A>
+    struct has_max_size<A, std::void_t<decltype(std::declval<const A&>().max_size())>> : std::true_type {};
+
+    /* Returns the largest number of bytes the given allocator can hand out at once, which is unlimited for allocators without a max_size(). */
+    template <class A>
+    inline size_t allocator_max_size(const A& allocator) {
+        if constexpr (has_max_size<A>::value) {
+            return allocator.max_size();
+        } else {
+            return std::numeric_limits<size_t>::max();
+        }
+    }
+}
+
+#endif
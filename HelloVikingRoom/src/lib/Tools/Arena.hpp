@@ -0,0 +1,205 @@
+/* ARENA.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:05:53
+ * Last edited:
+ *   16/10/2026, 19:17:14
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the Arena class, a linear (bump) allocator that hands out
+ *   memory from large chunks and frees it all at once when it's reset,
+ *   e.g., at the start of every frame. Also contains the ArenaAllocator,
+ *   which lets an Array allocate from an Arena.
+**/
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace Tools {
+    /* The Arena class, which hands out memory by simply bumping an offset into a chunk. Individual allocations are never freed; instead, reset() frees everything at once. Not thread-safe, so use one per thread. */
+    class Arena {
+    public:
+        /* The default size of a chunk in bytes. */
+        static constexpr size_t default_chunk_size = 64 * 1024;
+
+    private:
+        /* A single block of memory that the arena allocates from. */
+        struct Chunk {
+            /* The memory of the chunk. */
+            char* data;
+            /* The size of the chunk in bytes. */
+            size_t size;
+        };
+
+        /* The chunks allocated so far. */
+        std::vector<Chunk> chunks;
+        /* The index of the chunk we're currently allocating from. */
+        size_t chunk_index;
+        /* The offset of the first free byte in the current chunk. */
+        size_t offset;
+        /* The most recent allocation, which is the only one that can still grow or be freed. */
+        char* last;
+        /* The size of new chunks in bytes. */
+        size_t chunk_size;
+
+        /* Returns the given pointer rounded up to the given alignment, which must be a power of two. */
+        static inline char* align(char* data, size_t alignment) { return (char*) (((uintptr_t) data + alignment - 1) & ~(uintptr_t) (alignment - 1)); }
+
+        /* Moves on to the next chunk that fits the given allocation, adding a new one if needed, and allocates from there. */
+        void* allocate_slow(size_t n_bytes, size_t alignment) {
+            // Find a chunk after the current one that is large enough; the ones we skip stay unused until the next reset
+            size_t index = this->chunks.empty() ? 0 : this->chunk_index + 1;
+            while (index < this->chunks.size() && this->chunks[index].size < n_bytes + alignment) { ++index; }
+            this->chunk_index = index;
+            if (this->chunk_index == this->chunks.size()) {
+                size_t size = n_bytes + alignment > this->chunk_size ? n_bytes + alignment : this->chunk_size;
+                char* data = (char*) malloc(size);
+                if (data == nullptr) { throw std::bad_alloc(); }
+                this->chunks.push_back({ data, size });
+            }
+
+            // Allocate from the start of it
+            Chunk& chunk = this->chunks[this->chunk_index];
+            this->last = Arena::align(chunk.data, alignment);
+            this->offset = (this->last - chunk.data) + n_bytes;
+            return this->last;
+        }
+
+    public:
+        /* Constructor for the Arena class, which takes the size of the chunks it allocates. Doesn't allocate anything until it's first used. */
+        Arena(size_t chunk_size = Arena::default_chunk_size) :
+            chunk_index(0),
+            offset(0),
+            last(nullptr),
+            chunk_size(chunk_size)
+        {}
+        /* Copy constructor for the Arena class, which is deleted since it would hand out the same memory twice. */
+        Arena(const Arena& other) = delete;
+        /* Move constructor for the Arena class. */
+        Arena(Arena&& other) :
+            chunks(std::move(other.chunks)),
+            chunk_index(other.chunk_index),
+            offset(other.offset),
+            last(other.last),
+            chunk_size(other.chunk_size)
+        {
+            other.chunks.clear();
+            other.chunk_index = 0;
+            other.offset = 0;
+            other.last = nullptr;
+        }
+        /* Destructor for the Arena class, which frees all chunks. */
+        ~Arena() {
+            for (size_t i = 0; i < this->chunks.size(); i++) {
+                free(this->chunks[i].data);
+            }
+        }
+
+        /* Returns memory for the given number of bytes at the given alignment, which must be a power of two. The memory stays valid until reset() is called. */
+        inline void* allocate(size_t n_bytes, size_t alignment) {
+            // Most of the time, it simply fits in the current chunk
+            if (this->chunk_index < this->chunks.size()) {
+                Chunk& chunk = this->chunks[this->chunk_index];
+                char* result = Arena::align(chunk.data + this->offset, alignment);
+                if (result + n_bytes <= chunk.data + chunk.size) {
+                    this->offset = (result - chunk.data) + n_bytes;
+                    this->last = result;
+                    return result;
+                }
+            }
+            return this->allocate_slow(n_bytes, alignment);
+        }
+        /* Resizes the given memory to the given number of bytes. The most recent allocation grows or shrinks in-place if it fits, while anything else is copied to new memory. */
+        inline void* reallocate(void* data, size_t old_n_bytes, size_t new_n_bytes, size_t alignment) {
+            // The last allocation can simply move the offset
+            if (data != nullptr && data == this->last) {
+                Chunk& chunk = this->chunks[this->chunk_index];
+                if (this->last + new_n_bytes <= chunk.data + chunk.size) {
+                    this->offset = (this->last - chunk.data) + new_n_bytes;
+                    return data;
+                }
+            }
+
+            // Otherwise, copy it to new memory
+            void* result = this->allocate(new_n_bytes, alignment);
+            if (data != nullptr) { memcpy(result, data, old_n_bytes < new_n_bytes ? old_n_bytes : new_n_bytes); }
+            return result;
+        }
+        /* Frees the given memory, which only gives it back to the arena if it was the most recent allocation. Otherwise, it's freed on the next reset(). */
+        inline void deallocate(void* data, size_t) {
+            if (data != nullptr && data == this->last) {
+                this->offset = this->last - this->chunks[this->chunk_index].data;
+                this->last = nullptr;
+            }
+        }
+
+        /* Frees everything allocated from the arena at once, keeping the memory for the next round. If more than one chunk was used, they are replaced by a single one as large as all of them together, so that the next round fits in one chunk. */
+        void reset() {
+            if (this->chunks.size() > 1) {
+                size_t size = 0;
+                for (size_t i = 0; i < this->chunks.size(); i++) {
+                    size += this->chunks[i].size;
+                    free(this->chunks[i].data);
+                }
+                this->chunks.clear();
+                char* data = (char*) malloc(size);
+                if (data == nullptr) { throw std::bad_alloc(); }
+                this->chunks.push_back({ data, size });
+            }
+            this->chunk_index = 0;
+            this->offset = 0;
+            this->last = nullptr;
+        }
+
+        /* Returns the total number of bytes in the chunks of this arena. */
+        size_t capacity() const {
+            size_t result = 0;
+            for (size_t i = 0; i < this->chunks.size(); i++) {
+                result += this->chunks[i].size;
+            }
+            return result;
+        }
+
+        /* Copy assignment operator for the Arena class, which is deleted. */
+        Arena& operator=(const Arena& other) = delete;
+        /* Move assignment operator for the Arena class, which is deleted since arrays may still point to it. */
+        Arena& operator=(Arena&& other) = delete;
+
+    };
+
+
+
+    /* The ArenaAllocator class, which lets an Array allocate from the given Arena. Note that the Array should not outlive the next reset() of the arena. */
+    class ArenaAllocator {
+    private:
+        /* The arena we allocate from. */
+        Arena* arena;
+
+    public:
+        /* Constructor for the ArenaAllocator class, which takes the arena to allocate from. Implicit, so that an Arena can be passed wherever an ArenaAllocator is expected. */
+        ArenaAllocator(Arena& arena) : arena(&arena) {}
+
+        /* Allocates memory for the given number of bytes from the arena. */
+        inline void* allocate(size_t n_bytes, size_t alignment) { return this->arena->allocate(n_bytes, alignment); }
+        /* Resizes the given memory, in-place if it's the arena's most recent allocation. */
+        inline void* reallocate(void* data, size_t old_n_bytes, size_t new_n_bytes, size_t alignment) { return this->arena->reallocate(data, old_n_bytes, new_n_bytes, alignment); }
+        /* Frees the given memory, which usually happens only when the arena is reset. */
+        inline void deallocate(void* data, size_t n_bytes) { this->arena->deallocate(data, n_bytes); }
+
+        /* Returns the arena that this allocator allocates from. */
+        inline Arena& get_arena() const { return *this->arena; }
+
+    };
+}
+
+#endif
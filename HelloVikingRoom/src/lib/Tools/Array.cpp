@@ -4,7 +4,7 @@
  * Created:
  *   12/22/2020, 4:59:25 PM
  * Last edited:
- *   1/14/2021, 12:36:20 PM
+ *   16/10/2026, 21:00:21
  * Auto updated?
  *   Yes
  *
@@ -24,27 +24,77 @@ using namespace std;
 using namespace Tools;
 
 
+/***** HELPER FUNCTIONS *****/
+/* Moves n elements from the given source to the given destination, leaving the source uninitialized. Uses memmove for relocatable types and move construction (or copy construction) followed by destruction for all others. The ranges may only overlap if the destination comes first. */
+template <class T> void Tools::relocate_elements(T* destination, T* source, size_t n) {
+    // Nothing to do for empty ranges, which may come from empty arrays
+    if (n == 0) { return; }
+
+    if constexpr (is_relocatable<T>::value || !(std::is_move_constructible<T>::value || std::is_copy_constructible<T>::value)) {
+        // Simply copy the bytes; this is also the only way to move elements that can't be constructed from another
+        memmove((void*) destination, (const void*) source, sizeof(T) * n);
+    } else {
+        // Construct each element at its new place, then destroy the old one. Going front to back makes this safe if the destination comes first
+        for (size_t i = 0; i < n; i++) {
+            if constexpr (std::is_move_constructible<T>::value) {
+                new(destination + i) T(std::move(source[i]));
+            } else {
+                new(destination + i) T(source[i]);
+            }
+            if (std::is_destructible<T>::value) {
+                source[i].~T();
+            }
+        }
+    }
+}
+
+
+
+
+
 /***** ARRAY CLASS ****/
+/* Makes sure there is room for at least one more element, growing the capacity geometrically so that a series of push_back()'s only re-allocates a logarithmic number of times. */
+template<class T, class A, bool D, bool C, bool M> void Array<T, A, D, C, M>::grow() {
+    // Multiply the capacity, but start at a sensible size for empty arrays
+    size_t new_size = this->max_length * Array::growth_factor;
+    if (new_size < Array::min_growth) { new_size = Array::min_growth; }
+    if (new_size <= this->length) { new_size = this->length + 1; }
+    // Don't grow past what the allocator can hand out at once, as long as that still leaves room for another element
+    size_t max_size = allocator_max_size(this->allocator) / sizeof(T);
+    if (new_size > max_size && max_size > this->length) { new_size = max_size; }
+    this->reserve(new_size);
+}
+
+
+
 /* Default constructor for the Array class, which initializes it to zero. */
-template<class T, bool D, bool C, bool M> Array<T, D, C, M>::Array() :
+template<class T, class A, bool D, bool C, bool M> Array<T, A, D, C, M>::Array() :
     elements(nullptr),
     length(0),
     max_length(0)
 {}
 
-/* Constructor for the Array class, which takes an initial amount to size to. Each element will thus be uninitialized. */
-template<class T, bool D, bool C, bool M> Array<T, D, C, M>::Array(size_t initial_size) :
+/* Constructor for the Array class, which initializes it to zero and takes the allocator to allocate its elements with. */
+template<class T, class A, bool D, bool C, bool M> Array<T, A, D, C, M>::Array(const A& allocator) :
+    elements(nullptr),
+    length(0),
+    max_length(0),
+    allocator(allocator)
+{}
+
+/* Constructor for the Array class, which takes an initial amount to size to and optionally an allocator. Each element will thus be uninitialized. */
+template<class T, class A, bool D, bool C, bool M> Array<T, A, D, C, M>::Array(size_t initial_size, const A& allocator) :
     length(0),
-    max_length(initial_size)
+    max_length(initial_size),
+    allocator(allocator)
 {
     // Allocate enough space
-    this->elements = (T*) malloc(sizeof(T) * this->max_length);
-    if (this->elements == nullptr) { throw std::bad_alloc(); }
+    this->elements = (T*) this->allocator.allocate(sizeof(T) * this->max_length, alignof(T));
 }
 
-/* Constructor for the Array class, which takes an initializer_list to initialize the Array with. Makes use of the element's copy constructor. */
-template<class T, bool D, bool C, bool M> Array<T, D, C, M>::Array(const std::initializer_list<T>& list) :
-    Array(list.size())
+/* Constructor for the Array class, which takes an initializer_list to initialize the Array with and optionally an allocator. Makes use of the element's copy constructor. */
+template<class T, class A, bool D, bool C, bool M> Array<T, A, D, C, M>::Array(const std::initializer_list<T>& list, const A& allocator) :
+    Array(list.size(), allocator)
 {
     // Overwrite the length to the list's size
     this->length = list.size();
@@ -58,9 +108,9 @@ template<class T, bool D, bool C, bool M> Array<T, D, C, M>::Array(const std::in
     }
 }
 
-/* Constructor for the Array class, which takes a raw C-style vector to copy elements from and its size. Note that the Array's element type must have a copy custructor defined. */
-template<class T, bool D, bool C, bool M> Array<T, D, C, M>::Array(T* list, size_t list_size) :
-    Array(list_size)
+/* Constructor for the Array class, which takes a raw C-style vector to copy elements from, its size and optionally an allocator. Note that the Array's element type must have a copy custructor defined. */
+template<class T, class A, bool D, bool C, bool M> Array<T, A, D, C, M>::Array(T* list, size_t list_size, const A& allocator) :
+    Array(list_size, allocator)
 {
     // Overwrite the length to the list's size
     this->length = list_size;
@@ -72,9 +122,9 @@ template<class T, bool D, bool C, bool M> Array<T, D, C, M>::Array(T* list, size
     }
 }
 
-/* Constructor for the Array class, which takes a C++-style vector. Note that the Array's element type must have a copy custructor defined. */
-template<class T, bool D, bool C, bool M> Array<T, D, C, M>::Array(const std::vector<T>& list) :
-    Array(list.size())
+/* Constructor for the Array class, which takes a C++-style vector and optionally an allocator. Note that the Array's element type must have a copy custructor defined. */
+template<class T, class A, bool D, bool C, bool M> Array<T, A, D, C, M>::Array(const std::vector<T>& list, const A& allocator) :
+    Array(list.size(), allocator)
 {
     // Overwrite the length to the list's size
     this->length = list.size();
@@ -86,14 +136,14 @@ template<class T, bool D, bool C, bool M> Array<T, D, C, M>::Array(const std::ve
     }
 }
 
-/* Copy constructor for the Array class. Note that this only works if the Array's element has a copy constructor defined. */
-template<class T, bool D, bool C, bool M> Array<T, D, C, M>::Array(const Array& other) :
+/* Copy constructor for the Array class, which uses the same allocator as the other. Note that this only works if the Array's element has a copy constructor defined. */
+template<class T, class A, bool D, bool C, bool M> Array<T, A, D, C, M>::Array(const Array& other) :
     length(other.length),
-    max_length(other.max_length)
+    max_length(other.max_length),
+    allocator(other.allocator)
 {
     // Allocate a new list of T's
-    this->elements = (T*) malloc(sizeof(T) * other.max_length);
-    if (this->elements == nullptr) { throw std::bad_alloc(); }
+    this->elements = (T*) this->allocator.allocate(sizeof(T) * other.max_length, alignof(T));
 
     // Copy each element over
     for (size_t i = 0; i < other.length; i++) {
@@ -102,17 +152,20 @@ template<class T, bool D, bool C, bool M> Array<T, D, C, M>::Array(const Array&
 }
 
 /* Move constructor for the Array class. */
-template<class T, bool D, bool C, bool M> Array<T, D, C, M>::Array(Array&& other) :
+template<class T, class A, bool D, bool C, bool M> Array<T, A, D, C, M>::Array(Array&& other) :
     elements(other.elements),
     length(other.length),
-    max_length(other.max_length)
+    max_length(other.max_length),
+    allocator(other.allocator)
 {
     // Tell the other one that it's over
     other.elements = nullptr;
+    other.length = 0;
+    other.max_length = 0;
 }
 
 /* Destructor for the Array class. */
-template<class T, bool D, bool C, bool M> Array<T, D, C, M>::~Array() {
+template<class T, class A, bool D, bool C, bool M> Array<T, A, D, C, M>::~Array() {
     // Only deallocate everything if not a nullptr
     if (this->elements != nullptr) {
         // First deallocate all elements if the element needs that
@@ -122,17 +175,24 @@ template<class T, bool D, bool C, bool M> Array<T, D, C, M>::~Array() {
             }
         }
         // Now, free the list itself
-        free(this->elements);
+        this->allocator.deallocate(this->elements, sizeof(T) * this->max_length);
     }
 }
 
 
 
 /* Adds a new element of type T to the array, copying it. Note that this requires the element to be copy constructible. */
-template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::push_back(const T& elem) {
+template<class T, class A, bool D, bool C, bool M> void Array<T, A, D, C, M>::push_back(const T& elem) {
     // Make sure that the array has enough size
     if (this->length >= this->max_length) {
-        this->reserve(this->length + 1);
+        // If the element lives in this array, it moves along with it
+        if (&elem >= this->elements && &elem < this->elements + this->length) {
+            size_t index = &elem - this->elements;
+            this->grow();
+            new(this->elements + this->length++) T(this->elements[index]);
+            return;
+        }
+        this->grow();
     }
 
     // Add the element at the end of the array
@@ -140,10 +200,17 @@ template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::push_back(cons
 }
 
 /* Adds a new element of type T to the array, leaving it in an usused state (moving it). Note that this requires the element to be move constructible. */
-template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::push_back(T&& elem) {
+template<class T, class A, bool D, bool C, bool M> void Array<T, A, D, C, M>::push_back(T&& elem) {
     // Make sure that the array has enough size
     if (this->length >= this->max_length) {
-        this->reserve(this->length + 1);
+        // If the element lives in this array, it moves along with it
+        if (&elem >= this->elements && &elem < this->elements + this->length) {
+            size_t index = &elem - this->elements;
+            this->grow();
+            new(this->elements + this->length++) T(std::move(this->elements[index]));
+            return;
+        }
+        this->grow();
     }
 
     // Add the element at the end of the array
@@ -151,7 +218,7 @@ template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::push_back(T&&
 }
 
 /* Removes the last element from the array. */
-template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::pop_back() {
+template<class T, class A, bool D, bool C, bool M> void Array<T, A, D, C, M>::pop_back() {
     // Check if there are any elements
     if (this->length == 0) { return; }
 
@@ -167,7 +234,7 @@ template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::pop_back() {
 
 
 /* Erases an element with the given index from the array. Does nothing if the index is out-of-bounds. */
-template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::erase(size_t index) {
+template<class T, class A, bool D, bool C, bool M> void Array<T, A, D, C, M>::erase(size_t index) {
     // Check if in bounds
     if (index >= this->length) { return; }
 
@@ -177,14 +244,14 @@ template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::erase(size_t i
     }
 
     // Move all elements following it one back
-    memmove(this->elements + index, this->elements + index + 1, sizeof(T) * (this->length - 1 - index));
+    relocate_elements(this->elements + index, this->elements + index + 1, this->length - 1 - index);
 
     // Decrease the length
     --this->length;
 }
 
 /* Erases multiple elements in the given (inclusive) range from the array. Does nothing if the any index is out-of-bounds or if the start_index is larger than the stop_index. */
-template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::erase(size_t start_index, size_t stop_index) {
+template<class T, class A, bool D, bool C, bool M> void Array<T, A, D, C, M>::erase(size_t start_index, size_t stop_index) {
     // Check if in bounds
     if (start_index >= this->length || stop_index >= this->length || start_index > stop_index) { return; }
 
@@ -196,21 +263,21 @@ template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::erase(size_t s
     }
 
     // Move all elements following it back
-    memmove(this->elements + start_index, this->elements + stop_index + 1, sizeof(T) * (this->length - 1 - stop_index));
+    relocate_elements(this->elements + start_index, this->elements + stop_index + 1, this->length - 1 - stop_index);
 
     // Decrease the length
     this->length -= 1 + stop_index - start_index;
 }
 
 /* Erases everything from the array, even removing the internal allocated array. */
-template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::clear() {
+template<class T, class A, bool D, bool C, bool M> void Array<T, A, D, C, M>::clear() {
     // Delete everything currently in the array if needed
     if (std::is_destructible<T>::value) {
         for (size_t i = 0; i < this->length; i++) {
             this->elements[i].~T();
         }
     }
-    free(this->elements);
+    this->allocator.deallocate(this->elements, sizeof(T) * this->max_length);
 
     // Set the new values
     this->elements = nullptr;
@@ -221,20 +288,39 @@ template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::clear() {
 
 
 /* Re-allocates the internal array to the given size. Any leftover elements will be left unitialized, and elements that won't fit will be deallocated. */
-template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::reserve(size_t new_size) {
+template<class T, class A, bool D, bool C, bool M> void Array<T, A, D, C, M>::reserve(size_t new_size) {
     // Do only something if the size is different from what it is now
     if (new_size == this->max_length) {
         // Do nothing
         return;
     }
 
+    // Elements that may be moved as bytes can be given to the allocator's reallocate, which may grow the block in-place instead of always copying
+    if constexpr (is_relocatable<T>::value) {
+        // Deallocate any elements that won't fit anymore first (if needed)
+        if (std::is_destructible<T>::value) {
+            for (size_t i = new_size; i < this->length; i++) {
+                this->elements[i].~T();
+            }
+        }
+
+        if (new_size == 0) {
+            this->allocator.deallocate(this->elements, sizeof(T) * this->max_length);
+            this->elements = nullptr;
+        } else {
+            this->elements = (T*) this->allocator.reallocate(this->elements, sizeof(T) * this->max_length, sizeof(T) * new_size, alignof(T));
+        }
+        this->length = std::min(new_size, this->length);
+        this->max_length = new_size;
+        return;
+    }
+
     // Start by allocating space for a new array
-    T* new_elements = (T*) malloc(sizeof(T) * new_size);
-    if (new_elements == nullptr) { throw std::bad_alloc(); }
+    T* new_elements = (T*) this->allocator.allocate(sizeof(T) * new_size, alignof(T));
 
     // Determine how many elements to move over; either new_size or the length of the array, whichever is smaller
     size_t n_to_copy = std::min(new_size, this->length);
-    memmove(new_elements, this->elements, sizeof(T) * n_to_copy);
+    relocate_elements(new_elements, this->elements, n_to_copy);
     
     // Deallocate any elements that are leftover (if needed), then delete the old array
     if (std::is_destructible<T>::value) {
@@ -242,7 +328,7 @@ template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::reserve(size_t
             this->elements[i].~T();
         }
     }
-    free(this->elements);
+    this->allocator.deallocate(this->elements, sizeof(T) * this->max_length);
 
     // Re-populate the struct with the correct elements
     this->elements = new_elements;
@@ -251,7 +337,7 @@ template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::reserve(size_t
 }
 
 /* Resizes the array to the given size. Any leftover elements will be initialized with their default constructor, and elements that won't fit will be deallocated. If the same size is given as the vector, can be used to initialize a whole array to default constructor. */
-template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::resize(size_t new_size) {
+template<class T, class A, bool D, bool C, bool M> void Array<T, A, D, C, M>::resize(size_t new_size) {
     // Simply reserve the required space
     this->reserve(new_size);
 
@@ -267,13 +353,13 @@ template<class T, bool D, bool C, bool M> void Array<T, D, C, M>::resize(size_t
 
 
 /* Returns a muteable reference to the element at the given index. Performs in-of-bounds checks before accessing the element. */
-template<class T, bool D, bool C, bool M> T& Array<T, D, C, M>::at(size_t index) {
+template<class T, class A, bool D, bool C, bool M> T& Array<T, A, D, C, M>::at(size_t index) {
     if (index >= this->length) { throw std::out_of_range("Index " + std::to_string(index) + " is out-of-bounds for Array with size " + std::to_string(this->length)); }
     return this->elements[index];
 }
 
 /* Returns a constant reference to the element at the given index. Performs in-of-bounds checks before accessing the element. */
-template<class T, bool D, bool C, bool M> const T& Array<T, D, C, M>::at(size_t index) const {
+template<class T, class A, bool D, bool C, bool M> const T& Array<T, A, D, C, M>::at(size_t index) const {
     if (index >= this->length) { throw std::out_of_range("Index " + std::to_string(index) + " is out-of-bounds for Array with size " + std::to_string(this->length)); }
     return this->elements[index];
 }
@@ -281,7 +367,7 @@ template<class T, bool D, bool C, bool M> const T& Array<T, D, C, M>::at(size_t
 
 
 /* Returns a muteable pointer to the internal data struct. Use this to fill the array using C-libraries, but beware that the array needs to have enough space reserved. Also note that object put here will still be deallocated by the Array using ~T(). The optional new_size parameter is used to update the size() value of the array, so it knows what is initialized and what is not. Leave it at numeric_limits<size_t>::max() to leave the array size unchanged. */
-template<class T, bool D, bool C, bool M> T* const Array<T, D, C, M>::wdata(size_t new_size) {
+template<class T, class A, bool D, bool C, bool M> T* const Array<T, A, D, C, M>::wdata(size_t new_size) {
     // Update the size if it's not the max already
     if (new_size != std::numeric_limits<size_t>::max()) { this->length = new_size; }
     // Return the pointer
@@ -291,7 +377,7 @@ template<class T, bool D, bool C, bool M> T* const Array<T, D, C, M>::wdata(size
 
 
 /* Move assignment operator for the Array class. */
-template<class T, bool D, bool C, bool M> Array<T, D, C, M>& Array<T, D, C, M>::operator=(Array<T, D, C, M>&& other) {
+template<class T, class A, bool D, bool C, bool M> Array<T, A, D, C, M>& Array<T, A, D, C, M>::operator=(Array<T, A, D, C, M>&& other) {
     if (this != &other) { swap(*this, other); }
     return *this;
 }
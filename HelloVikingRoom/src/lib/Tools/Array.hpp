@@ -4,7 +4,7 @@
  * Created:
  *   12/22/2020, 5:00:01 PM
  * Last edited:
- *   1/14/2021, 3:11:16 PM
+ *   16/10/2026, 19:17:14
  * Auto updated?
  *   Yes
  *
@@ -22,10 +22,23 @@
 #include <initializer_list>
 #include <limits>
 #include <cstdio>
+#include <type_traits>
+
+#include "Tools/Allocator.hpp"
 
 namespace Tools {
-    /* The Array class, which can be used as a container for many things. It's optimized to work for containers that rarely (but still sometimes) have to resize. */
-    template <class T, bool D = std::is_default_constructible<T>::value, bool C = std::is_copy_constructible<T>::value, bool M = std::is_move_constructible<T>::value>
+    /* Tells the Array whether elements of type T may be moved to another address by copying their bytes, instead of by move constructing them there and destroying the original. This is true for trivially copyable types; other types that never point to themselves may opt in by specializing this as std::true_type. */
+    template <class T>
+    struct is_relocatable: public std::is_trivially_copyable<T> {};
+
+    /* Moves n elements from the given source to the given destination, leaving the source uninitialized. Uses memmove for relocatable types and move construction (or copy construction) followed by destruction for all others. The ranges may only overlap if the destination comes first. */
+    template <class T>
+    void relocate_elements(T* destination, T* source, size_t n);
+
+
+
+    /* The Array class, which can be used as a container for many things. It's optimized to work for containers that rarely (but still sometimes) have to resize. Its memory comes from the given allocator (see Allocator.hpp), which uses the heap by default. */
+    template <class T, class A = MallocAllocator, bool D = std::is_default_constructible<T>::value, bool C = std::is_copy_constructible<T>::value, bool M = std::is_move_constructible<T>::value>
     class Array {
     protected:
         /* The internal data. */
@@ -34,19 +47,31 @@ namespace Tools {
         size_t length;
         /* The maximum number of elements we allocated for. */
         size_t max_length;
+        /* The allocator that the elements are allocated with. */
+        A allocator;
+
+        /* Makes sure there is room for at least one more element, growing the capacity geometrically so that a series of push_back()'s only re-allocates a logarithmic number of times. */
+        void grow();
 
     public:
+        /* The capacity an empty Array grows to when the first element is pushed to it. */
+        static constexpr size_t min_growth = 4;
+        /* The factor by which the capacity is multiplied every time push_back() runs out of space. */
+        static constexpr size_t growth_factor = 2;
+
         /* Default constructor for the Array class, which initializes it to zero. */
         Array();
-        /* Constructor for the Array class, which takes an initial amount to size to. Each element will thus be uninitialized. */
-        Array(size_t initial_size);
-        /* Constructor for the Array class, which takes an initializer_list to initialize the Array with. Makes use of the element's copy constructor. */
-        Array(const std::initializer_list<T>& list);
-        /* Constructor for the Array class, which takes a raw C-style vector to copy elements from and its size. Note that the Array's element type must have a copy custructor defined. */
-        Array(T* list, size_t list_size);
-        /* Constructor for the Array class, which takes a C++-style vector. Note that the Array's element type must have a copy custructor defined. */
-        Array(const std::vector<T>& list);
-        /* Copy constructor for the Array class. Note that this only works if the Array's element has a copy constructor defined. */
+        /* Constructor for the Array class, which initializes it to zero and takes the allocator to allocate its elements with. */
+        explicit Array(const A& allocator);
+        /* Constructor for the Array class, which takes an initial amount to size to and optionally an allocator. Each element will thus be uninitialized. */
+        Array(size_t initial_size, const A& allocator = A());
+        /* Constructor for the Array class, which takes an initializer_list to initialize the Array with and optionally an allocator. Makes use of the element's copy constructor. */
+        Array(const std::initializer_list<T>& list, const A& allocator = A());
+        /* Constructor for the Array class, which takes a raw C-style vector to copy elements from, its size and optionally an allocator. Note that the Array's element type must have a copy custructor defined. */
+        Array(T* list, size_t list_size, const A& allocator = A());
+        /* Constructor for the Array class, which takes a C++-style vector and optionally an allocator. Note that the Array's element type must have a copy custructor defined. */
+        Array(const std::vector<T>& list, const A& allocator = A());
+        /* Copy constructor for the Array class, which uses the same allocator as the other. Note that this only works if the Array's element has a copy constructor defined. */
         Array(const Array& other);
         /* Move constructor for the Array class. */
         Array(Array&& other);
@@ -67,7 +92,7 @@ namespace Tools {
         /* Erases everything from the array, even removing the internal allocated array. */
         void clear();
 
-        /* Re-allocates the internal array to the given size. Any leftover elements will be left unitialized, and elements that won't fit will be deallocated. */
+        /* Re-allocates the internal array to exactly the given size, without any room to grow. Any leftover elements will be left unitialized, and elements that won't fit will be deallocated. Relocatable elements are re-allocated in-place if possible. */
         void reserve(size_t new_size);
         /* Resizes the array to the given size. Any leftover elements will be initialized with their default constructor, and elements that won't fit will be deallocated. */
         void resize(size_t new_size);
@@ -91,18 +116,21 @@ namespace Tools {
         inline size_t size() const { return this->length; }
         /* Returns the number of elements this Array can store before resizing. */
         inline size_t capacity() const { return this->max_length; }
+        /* Returns the allocator that the elements are allocated with. */
+        inline const A& get_allocator() const { return this->allocator; }
 
         /* Copy assignment operator for the Array class. Depends on Array's copy constructor, and therefore requires the Array's type to be copy constructible. */
-        inline Array<T, D, C, M>& operator=(const Array<T, D, C, M>& other) { return *this = Array<T, D, C, M>(other); }
+        inline Array<T, A, D, C, M>& operator=(const Array<T, A, D, C, M>& other) { return *this = Array<T, A, D, C, M>(other); }
         /* Move assignment operator for the Array class. */
-        Array<T, D, C, M>& operator=(Array<T, D, C, M>&& other);
+        Array<T, A, D, C, M>& operator=(Array<T, A, D, C, M>&& other);
         /* Swap operator for the Array class. */
-        friend void swap(Array<T, D, C, M>& a1, Array<T, D, C, M>& a2) {
+        friend void swap(Array<T, A, D, C, M>& a1, Array<T, A, D, C, M>& a2) {
             using std::swap;
 
             swap(a1.elements, a2.elements);
             swap(a1.length, a2.length);
             swap(a1.max_length, a2.max_length);
+            swap(a1.allocator, a2.allocator);
         }
     };
 
@@ -111,23 +139,25 @@ namespace Tools {
     /* The Array class, which can be used as a container for many things. It's optimized to work for containers that rarely (but still sometimes) have to resize.
      * This class specialization is for when the contained type is copy constructible and move constructible, but not default constructible.
      */
-    template <class T>
-    class Array<T, false, true, true>: public Array<T, true, true, true> {
+    template <class T, class A>
+    class Array<T, A, false, true, true>: public Array<T, A, true, true, true> {
     public:
         /* Default constructor for the Array class, which initializes it to zero. */
-        Array(): Array<T, true, true, true>() {}
-        /* Constructor for the Array class, which takes an initial amount to size to. Each element will thus be uninitialized. */
-        Array(size_t initial_size): Array<T, true, true, true>(initial_size) {}
-        /* Constructor for the Array class, which takes an initializer_list to initialize the Array with. Makes use of the element's copy constructor. */
-        Array(const std::initializer_list<T>& list): Array<T, true, true, true>(list) {}
-        /* Constructor for the Array class, which takes a raw C-style vector to copy elements from and its size. Note that the Array's element type must have a copy custructor defined. */
-        Array(T* list, size_t list_size): Array<T, true, true, true>(list, list_size) {}
-        /* Constructor for the Array class, which takes a C++-style vector. Note that the Array's element type must have a copy custructor defined. */
-        Array(const std::vector<T>& list): Array<T, true, true, true>(list) {}
+        Array(): Array<T, A, true, true, true>() {}
+        /* Constructor for the Array class, which initializes it to zero and takes the allocator to allocate its elements with. */
+        explicit Array(const A& allocator): Array<T, A, true, true, true>(allocator) {}
+        /* Constructor for the Array class, which takes an initial amount to size to and optionally an allocator. Each element will thus be uninitialized. */
+        Array(size_t initial_size, const A& allocator = A()): Array<T, A, true, true, true>(initial_size, allocator) {}
+        /* Constructor for the Array class, which takes an initializer_list to initialize the Array with and optionally an allocator. Makes use of the element's copy constructor. */
+        Array(const std::initializer_list<T>& list, const A& allocator = A()): Array<T, A, true, true, true>(list, allocator) {}
+        /* Constructor for the Array class, which takes a raw C-style vector to copy elements from, its size and optionally an allocator. Note that the Array's element type must have a copy custructor defined. */
+        Array(T* list, size_t list_size, const A& allocator = A()): Array<T, A, true, true, true>(list, list_size, allocator) {}
+        /* Constructor for the Array class, which takes a C++-style vector and optionally an allocator. Note that the Array's element type must have a copy custructor defined. */
+        Array(const std::vector<T>& list, const A& allocator = A()): Array<T, A, true, true, true>(list, allocator) {}
         /* Copy constructor for the Array class. Note that this only works if the Array's element has a copy constructor defined. */
-        Array(const Array& other): Array<T, true, true>(other) {}
+        Array(const Array& other): Array<T, A, true, true, true>(other) {}
         /* Move constructor for the Array class. */
-        Array(Array&& other): Array<T, true, true, true>(std::move(other)) {};
+        Array(Array&& other): Array<T, A, true, true, true>(std::move(other)) {};
         /* Destructor for the Array class. */
         ~Array() {}
 
@@ -139,64 +169,68 @@ namespace Tools {
         /* Move assignment operator for the Array class. */
         inline Array& operator=(Array&& other) { if (this != &other) { swap(*this, other); }; return *this; }
         /* Swap operator for the Array class. */
-        friend inline void swap(Array& a1, Array& a2) { return swap((Array<T, true, true, true>&) a1, (Array<T, true, true, true>&) a2); }
+        friend inline void swap(Array& a1, Array& a2) { return swap((Array<T, A, true, true, true>&) a1, (Array<T, A, true, true, true>&) a2); }
     };
     
     /* The Array class, which can be used as a container for many things. It's optimized to work for containers that rarely (but still sometimes) have to resize.
      * This class specialization is for when the contained type is default constructible and move constructible, but not copy constructible.
      */
-    template <class T>
-    class Array<T, true, false, true>: public Array<T, true, true, true> {
+    template <class T, class A>
+    class Array<T, A, true, false, true>: public Array<T, A, true, true, true> {
     public:
         /* Default constructor for the Array class, which initializes it to zero. */
-        Array(): Array<T, true, true, true>() {}
-        /* Constructor for the Array class, which takes an initial amount to size to. Each element will thus be uninitialized. */
-        Array(size_t initial_size): Array<T, true, true, true>(initial_size) {}
+        Array(): Array<T, A, true, true, true>() {}
+        /* Constructor for the Array class, which initializes it to zero and takes the allocator to allocate its elements with. */
+        explicit Array(const A& allocator): Array<T, A, true, true, true>(allocator) {}
+        /* Constructor for the Array class, which takes an initial amount to size to and optionally an allocator. Each element will thus be uninitialized. */
+        Array(size_t initial_size, const A& allocator = A()): Array<T, A, true, true, true>(initial_size, allocator) {}
         /* Copy constructor for the Array class. Deleted, since the chosen type does not support copy constructing. */
         Array(const Array& other) = delete;
         /* Move constructor for the Array class. */
-        Array(Array&& other): Array<T, true, true, true>(std::move(other)) {};
+        Array(Array&& other): Array<T, A, true, true, true>(std::move(other)) {};
         /* Destructor for the Array class. */
         ~Array() {}
         
         /* Adds a new element of type T to the array, copying it. Note that this requires the element to be copy constructible. */
         void push_back(const T& elem) = delete;
         /* Adds a new element of type T to the array, leaving it in an usused state (moving it). Note that this requires the element to be move constructible. */
-        void push_back(T&& elem) { return Array<T, true, true, true>::push_back(std::move(elem)); }
+        void push_back(T&& elem) { return Array<T, A, true, true, true>::push_back(std::move(elem)); }
 
         /* Copy assignment operator for the Array class. Depends on Array's copy constructor, and therefore requires the Array's type to be copy constructible. */
         inline Array& operator=(const Array& other) = delete;
         /* Move assignment operator for the Array class. */
         inline Array& operator=(Array&& other) { if (this != &other) { swap(*this, other); }; return *this; }
         /* Swap operator for the Array class. */
-        friend inline void swap(Array& a1, Array& a2) { swap((Array<T, true, true, true>&) a1, (Array<T, true, true, true>&) a2); }
+        friend inline void swap(Array& a1, Array& a2) { swap((Array<T, A, true, true, true>&) a1, (Array<T, A, true, true, true>&) a2); }
     };
     
     /* The Array class, which can be used as a container for many things. It's optimized to work for containers that rarely (but still sometimes) have to resize.
      * This class specialization is for when the contained type is default constructible and copy constructible, but not move constructible.
      */
-    template <class T>
-    class Array<T, true, true, false>: public Array<T, true, true, true> {
+    template <class T, class A>
+    class Array<T, A, true, true, false>: public Array<T, A, true, true, true> {
     public:
         /* Default constructor for the Array class, which initializes it to zero. */
-        Array(): Array<T, true, true, true>() {}
-        /* Constructor for the Array class, which takes an initial amount to size to. Each element will thus be uninitialized. */
-        Array(size_t initial_size): Array<T, true, true, true>(initial_size) {}
-        /* Constructor for the Array class, which takes an initializer_list to initialize the Array with. Makes use of the element's copy constructor. */
-        Array(const std::initializer_list<T>& list): Array<T, true, true, true>(list) {}
-        /* Constructor for the Array class, which takes a raw C-style vector to copy elements from and its size. Note that the Array's element type must have a copy custructor defined. */
-        Array(T* list, size_t list_size): Array<T, true, true, true>(list, list_size) {}
-        /* Constructor for the Array class, which takes a C++-style vector. Note that the Array's element type must have a copy custructor defined. */
-        Array(const std::vector<T>& list): Array<T, true, true, true>(list) {}
+        Array(): Array<T, A, true, true, true>() {}
+        /* Constructor for the Array class, which initializes it to zero and takes the allocator to allocate its elements with. */
+        explicit Array(const A& allocator): Array<T, A, true, true, true>(allocator) {}
+        /* Constructor for the Array class, which takes an initial amount to size to and optionally an allocator. Each element will thus be uninitialized. */
+        Array(size_t initial_size, const A& allocator = A()): Array<T, A, true, true, true>(initial_size, allocator) {}
+        /* Constructor for the Array class, which takes an initializer_list to initialize the Array with and optionally an allocator. Makes use of the element's copy constructor. */
+        Array(const std::initializer_list<T>& list, const A& allocator = A()): Array<T, A, true, true, true>(list, allocator) {}
+        /* Constructor for the Array class, which takes a raw C-style vector to copy elements from, its size and optionally an allocator. Note that the Array's element type must have a copy custructor defined. */
+        Array(T* list, size_t list_size, const A& allocator = A()): Array<T, A, true, true, true>(list, list_size, allocator) {}
+        /* Constructor for the Array class, which takes a C++-style vector and optionally an allocator. Note that the Array's element type must have a copy custructor defined. */
+        Array(const std::vector<T>& list, const A& allocator = A()): Array<T, A, true, true, true>(list, allocator) {}
         /* Copy constructor for the Array class. Note that this only works if the Array's element has a copy constructor defined. */
-        Array(const Array& other): Array<T, true, true>(other) {}
+        Array(const Array& other): Array<T, A, true, true, true>(other) {}
         /* Move constructor for the Array class. */
-        Array(Array&& other): Array<T, true, true, true>(std::move(other)) {};
+        Array(Array&& other): Array<T, A, true, true, true>(std::move(other)) {};
         /* Destructor for the Array class. */
         ~Array() {}
 
         /* Adds a new element of type T to the array, copying it. Note that this requires the element to be copy constructible. */
-        void push_back(const T& elem) { return Array<T, true, true, true>::push_back(elem); }
+        void push_back(const T& elem) { return Array<T, A, true, true, true>::push_back(elem); }
         /* Adds a new element of type T to the array, leaving it in an usused state (moving it). Note that this requires the element to be move constructible. */
         void push_back(T&& elem) = delete;
 
@@ -205,30 +239,32 @@ namespace Tools {
         /* Move assignment operator for the Array class. */
         inline Array& operator=(Array&& other) { if (this != &other) { swap(*this, other); }; return *this; }
         /* Swap operator for the Array class. */
-        friend inline void swap(Array& a1, Array& a2) { swap((Array<T, true, true, true>&) a1, (Array<T, true, true, true>&) a2); }
+        friend inline void swap(Array& a1, Array& a2) { swap((Array<T, A, true, true, true>&) a1, (Array<T, A, true, true, true>&) a2); }
     };
     
     /* The Array class, which can be used as a container for many things. It's optimized to work for containers that rarely (but still sometimes) have to resize.
      * This class specialization is for when the contained type is neither default constructible nor copy constructible, but is move constructible.
      */
-    template <class T>
-    class Array<T, false, false, true>: public Array<T, true, true, true> {
+    template <class T, class A>
+    class Array<T, A, false, false, true>: public Array<T, A, true, true, true> {
     public:
         /* Default constructor for the Array class, which initializes it to zero. */
-        Array(): Array<T, true, true, true>() {}
-        /* Constructor for the Array class, which takes an initial amount to size to. Each element will thus be uninitialized. */
-        Array(size_t initial_size): Array<T, true, true, true>(initial_size) {}
+        Array(): Array<T, A, true, true, true>() {}
+        /* Constructor for the Array class, which initializes it to zero and takes the allocator to allocate its elements with. */
+        explicit Array(const A& allocator): Array<T, A, true, true, true>(allocator) {}
+        /* Constructor for the Array class, which takes an initial amount to size to and optionally an allocator. Each element will thus be uninitialized. */
+        Array(size_t initial_size, const A& allocator = A()): Array<T, A, true, true, true>(initial_size, allocator) {}
         /* Copy constructor for the Array class. Note that this only works if the Array's element has a copy constructor defined. */
         Array(const Array& other) = delete;
         /* Move constructor for the Array class. */
-        Array(Array&& other): Array<T, true, true, true>(std::move(other)) {};
+        Array(Array&& other): Array<T, A, true, true, true>(std::move(other)) {};
         /* Destructor for the Array class. */
         ~Array() {}
 
         /* Adds a new element of type T to the array, copying it. Note that this requires the element to be copy constructible. */
         void push_back(const T& elem) = delete;
         /* Adds a new element of type T to the array, leaving it in an usused state (moving it). Note that this requires the element to be move constructible. */
-        void push_back(T&& elem) { return Array<T, true, true, true>::push_back(std::move(elem)); }
+        void push_back(T&& elem) { return Array<T, A, true, true, true>::push_back(std::move(elem)); }
 
         /* Resizes the array to the given size. Any leftover elements will be initialized with their default constructor, and elements that won't fit will be deallocated. */
         void resize(size_t new_size) = delete;
@@ -238,34 +274,36 @@ namespace Tools {
         /* Move assignment operator for the Array class. */
         inline Array& operator=(Array&& other) { if (this != &other) { swap(*this, other); }; return *this; }
         /* Swap operator for the Array class. */
-        friend inline void swap(Array& a1, Array& a2) { swap((Array<T, true, true, true>&) a1, (Array<T, true, true, true>&) a2); }
+        friend inline void swap(Array& a1, Array& a2) { swap((Array<T, A, true, true, true>&) a1, (Array<T, A, true, true, true>&) a2); }
     };
 
     /* The Array class, which can be used as a container for many things. It's optimized to work for containers that rarely (but still sometimes) have to resize.
      * This class specialization is for when the contained type is neither default constructible nor move constructible, but is copy constructible.
      */
-    template <class T>
-    class Array<T, false, true, false>: public Array<T, true, true, true> {
+    template <class T, class A>
+    class Array<T, A, false, true, false>: public Array<T, A, true, true, true> {
     public:
         /* Default constructor for the Array class, which initializes it to zero. */
-        Array(): Array<T, true, true, true>() {}
-        /* Constructor for the Array class, which takes an initial amount to size to. Each element will thus be uninitialized. */
-        Array(size_t initial_size): Array<T, true, true, true>(initial_size) {}
-        /* Constructor for the Array class, which takes an initializer_list to initialize the Array with. Makes use of the element's copy constructor. */
-        Array(const std::initializer_list<T>& list): Array<T, true, true, true>(list) {}
-        /* Constructor for the Array class, which takes a raw C-style vector to copy elements from and its size. Note that the Array's element type must have a copy custructor defined. */
-        Array(T* list, size_t list_size): Array<T, true, true, true>(list, list_size) {}
-        /* Constructor for the Array class, which takes a C++-style vector. Note that the Array's element type must have a copy custructor defined. */
-        Array(const std::vector<T>& list): Array<T, true, true, true>(list) {}
+        Array(): Array<T, A, true, true, true>() {}
+        /* Constructor for the Array class, which initializes it to zero and takes the allocator to allocate its elements with. */
+        explicit Array(const A& allocator): Array<T, A, true, true, true>(allocator) {}
+        /* Constructor for the Array class, which takes an initial amount to size to and optionally an allocator. Each element will thus be uninitialized. */
+        Array(size_t initial_size, const A& allocator = A()): Array<T, A, true, true, true>(initial_size, allocator) {}
+        /* Constructor for the Array class, which takes an initializer_list to initialize the Array with and optionally an allocator. Makes use of the element's copy constructor. */
+        Array(const std::initializer_list<T>& list, const A& allocator = A()): Array<T, A, true, true, true>(list, allocator) {}
+        /* Constructor for the Array class, which takes a raw C-style vector to copy elements from, its size and optionally an allocator. Note that the Array's element type must have a copy custructor defined. */
+        Array(T* list, size_t list_size, const A& allocator = A()): Array<T, A, true, true, true>(list, list_size, allocator) {}
+        /* Constructor for the Array class, which takes a C++-style vector and optionally an allocator. Note that the Array's element type must have a copy custructor defined. */
+        Array(const std::vector<T>& list, const A& allocator = A()): Array<T, A, true, true, true>(list, allocator) {}
         /* Copy constructor for the Array class. Note that this only works if the Array's element has a copy constructor defined. */
-        Array(const Array& other): Array<T, true, true>(other) {}
+        Array(const Array& other): Array<T, A, true, true, true>(other) {}
         /* Move constructor for the Array class. */
-        Array(Array&& other): Array<T, true, true, true>(std::move(other)) {};
+        Array(Array&& other): Array<T, A, true, true, true>(std::move(other)) {};
         /* Destructor for the Array class. */
         ~Array() {}
 
         /* Adds a new element of type T to the array, copying it. Note that this requires the element to be copy constructible. */
-        inline void push_back(const T& elem) { return Array<T, true, true, true>::push_back(elem); }
+        inline void push_back(const T& elem) { return Array<T, A, true, true, true>::push_back(elem); }
         /* Adds a new element of type T to the array, leaving it in an usused state (moving it). Note that this requires the element to be move constructible. */
         void push_back(T&& elem) = delete;
 
@@ -277,23 +315,25 @@ namespace Tools {
         /* Move assignment operator for the Array class. */
         inline Array& operator=(Array&& other) { if (this != &other) { swap(*this, other); }; return *this; }
         /* Swap operator for the Array class. */
-        friend inline void swap(Array& a1, Array& a2) { swap((Array<T, true, true, true>&) a1, (Array<T, true, true, true>&) a2); }
+        friend inline void swap(Array& a1, Array& a2) { swap((Array<T, A, true, true, true>&) a1, (Array<T, A, true, true, true>&) a2); }
     };
 
     /* The Array class, which can be used as a container for many things. It's optimized to work for containers that rarely (but still sometimes) have to resize.
      * This class specialization is for when the contained type is neither copy constructible nor move constructible, but is default constructible.
      */
-    template <class T>
-    class Array<T, true, false, false>: public Array<T, true, true, true> {
+    template <class T, class A>
+    class Array<T, A, true, false, false>: public Array<T, A, true, true, true> {
     public:
         /* Default constructor for the Array class, which initializes it to zero. */
-        Array(): Array<T, true, true, true>() {}
-        /* Constructor for the Array class, which takes an initial amount to size to. Each element will thus be uninitialized. */
-        Array(size_t initial_size): Array<T, true, true, true>(initial_size) {}
+        Array(): Array<T, A, true, true, true>() {}
+        /* Constructor for the Array class, which initializes it to zero and takes the allocator to allocate its elements with. */
+        explicit Array(const A& allocator): Array<T, A, true, true, true>(allocator) {}
+        /* Constructor for the Array class, which takes an initial amount to size to and optionally an allocator. Each element will thus be uninitialized. */
+        Array(size_t initial_size, const A& allocator = A()): Array<T, A, true, true, true>(initial_size, allocator) {}
         /* Copy constructor for the Array class. Note that this only works if the Array's element has a copy constructor defined. */
         Array(const Array& other) = delete;
         /* Move constructor for the Array class. */
-        Array(Array&& other): Array<T, true, true, true>(std::move(other)) {}
+        Array(Array&& other): Array<T, A, true, true, true>(std::move(other)) {}
         /* Destructor for the Array class. */
         ~Array() {}
 
@@ -307,23 +347,25 @@ namespace Tools {
         /* Move assignment operator for the Array class. */
         inline Array& operator=(Array&& other) { if (this != &other) { swap(*this, other); }; return *this; }
         /* Swap operator for the Array class. */
-        friend inline void swap(Array& a1, Array& a2) { swap((Array<T, true, true, true>&) a1, (Array<T, true, true, true>&) a2); }
+        friend inline void swap(Array& a1, Array& a2) { swap((Array<T, A, true, true, true>&) a1, (Array<T, A, true, true, true>&) a2); }
     };
 
     /* The Array class, which can be used as a container for many things. It's optimized to work for containers that rarely (but still sometimes) have to resize.
      * This class specialization is for when the contained type is neither default constructible, copy constructible nor move constructibl.
      */
-    template <class T>
-    class Array<T, false, false, false>: public Array<T, true, true, true> {
+    template <class T, class A>
+    class Array<T, A, false, false, false>: public Array<T, A, true, true, true> {
     public:
         /* Default constructor for the Array class, which initializes it to zero. */
-        Array(): Array<T, true, true, true>() {}
-        /* Constructor for the Array class, which takes an initial amount to size to. Each element will thus be uninitialized. */
-        Array(size_t initial_size): Array<T, true, true, true>(initial_size) {}
+        Array(): Array<T, A, true, true, true>() {}
+        /* Constructor for the Array class, which initializes it to zero and takes the allocator to allocate its elements with. */
+        explicit Array(const A& allocator): Array<T, A, true, true, true>(allocator) {}
+        /* Constructor for the Array class, which takes an initial amount to size to and optionally an allocator. Each element will thus be uninitialized. */
+        Array(size_t initial_size, const A& allocator = A()): Array<T, A, true, true, true>(initial_size, allocator) {}
         /* Copy constructor for the Array class. Note that this only works if the Array's element has a copy constructor defined. */
         Array(const Array& other) = delete;
         /* Move constructor for the Array class. */
-        Array(Array&& other): Array<T, true, true, true>(std::move(other)) {}
+        Array(Array&& other): Array<T, A, true, true, true>(std::move(other)) {}
         /* Destructor for the Array class. */
         ~Array() {}
 
@@ -340,7 +382,7 @@ namespace Tools {
         /* Move assignment operator for the Array class. */
         inline Array& operator=(Array&& other) { if (this != &other) { swap(*this, other); }; return *this; }
         /* Swap operator for the Array class. */
-        friend inline void swap(Array& a1, Array& a2) { swap((Array<T, true, true, true>&) a1, (Array<T, true, true, true>&) a2); }
+        friend inline void swap(Array& a1, Array& a2) { swap((Array<T, A, true, true, true>&) a1, (Array<T, A, true, true, true>&) a2); }
     };
 }
 
@@ -0,0 +1,363 @@
+/* JOB SYSTEM.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:31:10
+ * Last edited:
+ *   16/10/2026, 22:48:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the JobSystem class, which runs small jobs on a worker thread
+ *   per core. Each worker keeps the jobs it schedules in its own
+ *   Chase-Lev deque, from which it takes the newest job itself while idle
+ *   workers steal the oldest ones. Jobs count down a JobCounter once
+ *   they're done, which others can wait for; waiting threads run other
+ *   jobs in the meantime. Jobs that depend on others are scheduled as a
+ *   continuation of their counter instead, so no job has to block.
+**/
+
+#include <string>
+#include <limits>
+
+#include "Debug/Debug.hpp"
+#include "JobSystem.hpp"
+
+using namespace std;
+using namespace Tools;
+using namespace Debug::SeverityValues;
+
+
+/***** CONSTANTS *****/
+/* The number of times an idle worker looks for work before it goes to sleep. */
+static constexpr size_t n_idle_spins = 64;
+/* The worker index of threads that aren't workers. */
+static constexpr size_t no_worker = std::numeric_limits<size_t>::max();
+
+
+
+
+
+/***** JOBDEQUE CLASS *****/
+/* Default constructor for the JobDeque class, which initializes it empty. */
+JobDeque::JobDeque() :
+    top(0),
+    bottom(0)
+{
+    for (size_t i = 0; i < JobDeque::capacity; i++) {
+        this->jobs[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+
+
+/* Adds a job at the bottom. Returns false if the deque is full. Only the owner may call this. */
+bool JobDeque::push(Job* job) {
+    int64_t b = this->bottom.load(std::memory_order_relaxed);
+    int64_t t = this->top.load(std::memory_order_acquire);
+    if (b - t >= (int64_t) JobDeque::capacity) { return false; }
+
+    // Write the job before the thieves can see it
+    this->jobs[b % JobDeque::capacity].store(job, std::memory_order_relaxed);
+    this->bottom.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+/* Takes the newest job from the bottom. Returns nullptr if the deque is empty. Only the owner may call this. */
+Job* JobDeque::pop() {
+    // Claim the bottom job first, so that thieves stop before it
+    int64_t b = this->bottom.load(std::memory_order_relaxed) - 1;
+    this->bottom.store(b, std::memory_order_seq_cst);
+    int64_t t = this->top.load(std::memory_order_seq_cst);
+
+    // If it was empty, put the bottom back
+    if (t > b) {
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    // If it wasn't the last job, no thief can reach it
+    Job* job = this->jobs[b % JobDeque::capacity].load(std::memory_order_relaxed);
+    if (t < b) { return job; }
+
+    // Otherwise, race the thieves for it
+    if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        job = nullptr;
+    }
+    this->bottom.store(b + 1, std::memory_order_relaxed);
+    return job;
+}
+
+/* Takes the oldest job from the top. Returns nullptr if the deque is empty or if another thread took it first. Any thread may call this. */
+Job* JobDeque::steal() {
+    int64_t t = this->top.load(std::memory_order_seq_cst);
+    int64_t b = this->bottom.load(std::memory_order_seq_cst);
+    if (t >= b) { return nullptr; }
+
+    // Read the job before claiming it, since the owner may overwrite its slot as soon as we did
+    Job* job = this->jobs[t % JobDeque::capacity].load(std::memory_order_relaxed);
+    if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return job;
+}
+
+
+
+
+
+/***** JOBSYSTEM CLASS *****/
+/* The system the current thread is a worker of, or nullptr if it isn't one. */
+thread_local JobSystem* JobSystem::local_system = nullptr;
+/* The index of the current thread in its system's workers. */
+thread_local size_t JobSystem::local_index = no_worker;
+
+
+
+/* Constructor for the JobSystem class, which takes the number of worker threads to start. Defaults to one per core. */
+JobSystem::JobSystem(size_t n_workers) :
+    n_pending(0),
+    n_sleeping(0),
+    running(true)
+{
+    // Create all deques before any thread starts, since they steal from each other right away
+    if (n_workers == 0) { n_workers = 1; }
+    this->workers.reserve(n_workers);
+    for (size_t i = 0; i < n_workers; i++) {
+        this->workers.push_back(new Worker());
+    }
+    for (size_t i = 0; i < n_workers; i++) {
+        this->workers[i]->thread = std::thread(&JobSystem::work, this, i);
+    }
+}
+
+/* Destructor for the JobSystem class, which stops the workers. Jobs that haven't run yet by then never will, so wait for them first. */
+JobSystem::~JobSystem() {
+    // Wake everyone up and tell them to stop
+    {
+        std::unique_lock<std::mutex> guard(this->lock);
+        this->running.store(false);
+    }
+    this->wakeup.notify_all();
+    for (size_t i = 0; i < this->workers.size(); i++) {
+        this->workers[i]->thread.join();
+    }
+
+    // Free any jobs that were left behind, and the workers themselves
+    for (size_t i = 0; i < this->workers.size(); i++) {
+        Job* job;
+        while ((job = this->workers[i]->deque.pop()) != nullptr) { delete job; }
+        delete this->workers[i];
+    }
+    for (size_t i = 0; i < this->shared_jobs.size(); i++) {
+        delete this->shared_jobs[i];
+    }
+}
+
+
+
+/* Adds an already counted job to the deque of the current worker, or to the shared jobs if this isn't a worker, and wakes up a sleeping worker. */
+void JobSystem::schedule(Job* job) {
+    // Count it before it can be taken, so the number of pending jobs never drops below zero
+    this->n_pending.fetch_add(1, std::memory_order_seq_cst);
+
+    // Workers schedule on their own deque, unless it's full, in which case the job simply runs right away
+    if (JobSystem::local_system == this) {
+        if (!this->workers[JobSystem::local_index]->deque.push(job)) {
+            this->n_pending.fetch_sub(1, std::memory_order_relaxed);
+            this->execute(job);
+            return;
+        }
+    } else {
+        std::unique_lock<std::mutex> guard(this->lock);
+        this->shared_jobs.push_back(job);
+    }
+
+    // Wake up a worker if any is asleep. Sleeping workers count themselves before checking for jobs, so either they see this job or we see them
+    if (this->n_sleeping.load(std::memory_order_seq_cst) > 0) {
+        std::unique_lock<std::mutex> guard(this->lock);
+        this->wakeup.notify_one();
+    }
+}
+
+
+
+/* Takes a job for the worker with the given index (or for a thread that isn't a worker if it's SIZE_MAX): its own newest job first, then a shared one, then the oldest job of another worker. Returns nullptr if there is none. */
+Job* JobSystem::take(size_t index) {
+    // Nothing to do if nothing is pending
+    if (this->n_pending.load(std::memory_order_acquire) == 0) { return nullptr; }
+
+    // Try our own deque first, since its newest job is the most likely to still be in our cache
+    Job* job = nullptr;
+    if (index != no_worker) {
+        job = this->workers[index]->deque.pop();
+    }
+
+    // Then the jobs of threads that aren't workers
+    if (job == nullptr) {
+        std::unique_lock<std::mutex> guard(this->lock);
+        if (!this->shared_jobs.empty()) {
+            job = this->shared_jobs.front();
+            this->shared_jobs.pop_front();
+        }
+    }
+
+    // Finally, steal from the others, starting at our right-hand neighbour so not everyone robs the same worker
+    size_t n_workers = this->workers.size();
+    size_t first = index != no_worker ? index + 1 : 0;
+    for (size_t i = 0; job == nullptr && i < n_workers; i++) {
+        size_t victim = (first + i) % n_workers;
+        if (victim != index) { job = this->workers[victim]->deque.steal(); }
+    }
+
+    // Done
+    if (job != nullptr) { this->n_pending.fetch_sub(1, std::memory_order_relaxed); }
+    return job;
+}
+
+/* Runs the given job, counts it down and frees it. Schedules the continuations of its counter if it was the last job. If the job throws, the exception is kept on its counter instead. */
+void JobSystem::execute(Job* job) {
+    JobCounter* counter = job->counter;
+    try {
+        job->function();
+    } catch (...) {
+        // An exception may not leave a worker, so hand it to whoever waits for the counter. Without one, there's nobody to tell
+        if (counter != nullptr) {
+            std::unique_lock<std::mutex> guard(counter->lock);
+            if (counter->error == nullptr) { counter->error = std::current_exception(); }
+        } else {
+            DLOG(nonfatal, "Job without a counter threw an exception; ignoring it.");
+        }
+    }
+    delete job;
+    if (counter == nullptr) { return; }
+
+    // As long as we're not the last, simply count down; the counter may be gone as soon as it reaches zero, so we don't touch it after that
+    size_t count = counter->count.load(std::memory_order_relaxed);
+    while (count > 1) {
+        if (counter->count.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel, std::memory_order_relaxed)) { return; }
+    }
+
+    // Otherwise, release everything that waited for us. Count down under the lock, since run_after() checks the count with it held and wait() takes it before returning
+    std::vector<Job*> continuations;
+    {
+        std::unique_lock<std::mutex> guard(counter->lock);
+        if (counter->count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            continuations.swap(counter->continuations);
+        }
+    }
+    for (size_t i = 0; i < continuations.size(); i++) {
+        this->schedule(continuations[i]);
+    }
+}
+
+/* The main function of the worker with the given index. */
+void JobSystem::work(size_t index) {
+    DSTART("job worker " + std::to_string(index)); DENTER("Tools::JobSystem::work");
+    JobSystem::local_system = this;
+    JobSystem::local_index = index;
+
+    size_t n_spins = 0;
+    while (this->running.load(std::memory_order_relaxed)) {
+        // Run whatever we can find
+        Job* job = this->take(index);
+        if (job != nullptr) {
+            this->execute(job);
+            n_spins = 0;
+            continue;
+        }
+
+        // Look a few more times before going to sleep, since new jobs are often only moments away
+        if (++n_spins < n_idle_spins) {
+            std::this_thread::yield();
+            continue;
+        }
+        n_spins = 0;
+
+        // Sleep until a job is scheduled
+        std::unique_lock<std::mutex> guard(this->lock);
+        this->n_sleeping.fetch_add(1, std::memory_order_seq_cst);
+        this->wakeup.wait(guard, [this]() { return this->n_pending.load(std::memory_order_seq_cst) > 0 || !this->running.load(); });
+        this->n_sleeping.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    DLEAVE;
+}
+
+/* Runs the given function on the given (exclusive) range of indices. Ranges larger than the grain size are halved first, scheduling the second half as a job so that idle workers can steal it. */
+void JobSystem::split(size_t start_index, size_t stop_index, size_t grain_size, const std::function<void(size_t, size_t)>& function, JobCounter& counter) {
+    while (stop_index - start_index > grain_size) {
+        size_t middle_index = start_index + (stop_index - start_index) / 2;
+        this->run([this, middle_index, stop_index, grain_size, &function, &counter]() {
+            this->split(middle_index, stop_index, grain_size, function, counter);
+        }, &counter);
+        stop_index = middle_index;
+    }
+    function(start_index, stop_index);
+}
+
+
+
+/* Schedules the given function as a job. If a counter is given, it's incremented now and decremented once the job is done. */
+void JobSystem::run(std::function<void()> function, JobCounter* counter) {
+    Job* job = new Job({ std::move(function), counter });
+    if (counter != nullptr) { counter->count.fetch_add(1, std::memory_order_relaxed); }
+    this->schedule(job);
+}
+
+/* Schedules the given function as a job once all jobs of the given dependency are done, or right away if they already are. If a counter is given, it's incremented now and decremented once the job is done. */
+void JobSystem::run_after(JobCounter& dependency, std::function<void()> function, JobCounter* counter) {
+    Job* job = new Job({ std::move(function), counter });
+    if (counter != nullptr) { counter->count.fetch_add(1, std::memory_order_relaxed); }
+
+    // Park it on the dependency if that still has jobs running; the last of those schedules it
+    {
+        std::unique_lock<std::mutex> guard(dependency.lock);
+        if (!dependency.done()) {
+            dependency.continuations.push_back(job);
+            return;
+        }
+    }
+    this->schedule(job);
+}
+
+/* Waits until all jobs of the given counter are done, running other jobs in the meantime. Can be called from any thread, but jobs that wait may end up running the very job they wait for further down their own stack, so use run_after() for dependencies between jobs instead. Rethrows the first exception any of the counted jobs threw. */
+void JobSystem::wait(const JobCounter& counter) {
+    size_t index = JobSystem::local_system == this ? JobSystem::local_index : no_worker;
+    while (!counter.done()) {
+        Job* job = this->take(index);
+        if (job != nullptr) {
+            this->execute(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    // Whoever finished the last job may still hold the lock, so wait for them to let go before the counter can be destroyed
+    std::unique_lock<std::mutex> guard(counter.lock);
+    if (counter.error != nullptr) { std::rethrow_exception(counter.error); }
+}
+
+/* Calls the given function for consecutive ranges of at most grain_size indices in [0, n_indices) in parallel, as function(start_index, stop_index) with an exclusive stop_index. Returns once all ranges are done, and then rethrows the first exception any of them threw. */
+void JobSystem::parallel_for(size_t n_indices, size_t grain_size, const std::function<void(size_t, size_t)>& function) {
+    if (n_indices == 0) { return; }
+    if (grain_size == 0) { grain_size = 1; }
+
+    // Split the range, working on the first part ourselves. If our part throws, we may not leave before the rest is done either, since those jobs refer to the counter and the function
+    JobCounter counter;
+    std::exception_ptr error;
+    try {
+        this->split(0, n_indices, grain_size, function, counter);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    // Wait for the rest, and pass on whichever exception came first
+    try {
+        this->wait(counter);
+    } catch (...) {
+        if (error == nullptr) { error = std::current_exception(); }
+    }
+    if (error != nullptr) { std::rethrow_exception(error); }
+}
@@ -0,0 +1,179 @@
+/* JOB SYSTEM.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:31:10
+ * Last edited:
+ *   16/10/2026, 22:48:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the JobSystem class, which runs small jobs on a worker thread
+ *   per core. Each worker keeps the jobs it schedules in its own
+ *   Chase-Lev deque, from which it takes the newest job itself while idle
+ *   workers steal the oldest ones. Jobs count down a JobCounter once
+ *   they're done, which others can wait for; waiting threads run other
+ *   jobs in the meantime. Jobs that depend on others are scheduled as a
+ *   continuation of their counter instead, so no job has to block.
+**/
+
+#ifndef JOB_SYSTEM_HPP
+#define JOB_SYSTEM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+namespace Tools {
+    /* Forward declaration of the Job struct. */
+    struct Job;
+
+    /* The JobCounter class, which counts how many of the jobs it was given are still running. Jobs that depend on others can be scheduled to run once it reaches zero. */
+    class JobCounter {
+    private:
+        /* The number of jobs that are not done yet. */
+        std::atomic<size_t> count;
+        /* Lock that guards the continuations. Mutable, since waiting for the counter takes it too. */
+        mutable std::mutex lock;
+        /* Jobs that are scheduled once the count reaches zero. */
+        std::vector<Job*> continuations;
+        /* The first exception thrown by any of the counted jobs, or nullptr if none threw. Guarded by the lock. */
+        std::exception_ptr error;
+
+        /* Mark the JobSystem as friend, so it can count jobs. */
+        friend class JobSystem;
+
+    public:
+        /* Default constructor for the JobCounter class, which initializes it at zero. */
+        JobCounter() : count(0) {}
+        /* Copy constructor for the JobCounter class, which is deleted since jobs point to it. */
+        JobCounter(const JobCounter& other) = delete;
+
+        /* Returns whether all jobs counted by this counter are done. Use JobSystem::wait() before destroying it, though, since the last job may still be using it. */
+        inline bool done() const { return this->count.load(std::memory_order_acquire) == 0; }
+
+        /* Copy assignment operator for the JobCounter class, which is deleted since jobs point to it. */
+        JobCounter& operator=(const JobCounter& other) = delete;
+
+    };
+
+
+
+    /* Struct that holds a single job. */
+    struct Job {
+        /* The function the job runs. */
+        std::function<void()> function;
+        /* The counter that is decremented once the job is done, or nullptr if there is none. */
+        JobCounter* counter;
+    };
+
+
+
+    /* The JobDeque class, which is a fixed-size Chase-Lev work-stealing deque (as in Lê et al., 2013). Its owner pushes and pops at the bottom, while any other thread may steal from the top. */
+    class JobDeque {
+    public:
+        /* The number of jobs a deque can hold. */
+        static constexpr size_t capacity = 4096;
+
+    private:
+        /* The jobs, as a ring indexed by top and bottom. */
+        std::atomic<Job*> jobs[capacity];
+        /* The index of the oldest job, which thieves take. */
+        alignas(64) std::atomic<int64_t> top;
+        /* The index after the newest job, which only the owner changes. */
+        alignas(64) std::atomic<int64_t> bottom;
+
+    public:
+        /* Default constructor for the JobDeque class, which initializes it empty. */
+        JobDeque();
+
+        /* Adds a job at the bottom. Returns false if the deque is full. Only the owner may call this. */
+        bool push(Job* job);
+        /* Takes the newest job from the bottom. Returns nullptr if the deque is empty. Only the owner may call this. */
+        Job* pop();
+        /* Takes the oldest job from the top. Returns nullptr if the deque is empty or if another thread took it first. Any thread may call this. */
+        Job* steal();
+
+    };
+
+
+
+    /* The JobSystem class, which runs jobs on a pool of worker threads that steal work from each other. Jobs scheduled from a worker go to that worker's deque, while jobs scheduled from other threads go to a shared queue. */
+    class JobSystem {
+    private:
+        /* Struct that holds everything of a single worker. */
+        struct Worker {
+            /* The jobs scheduled on this worker. */
+            JobDeque deque;
+            /* The thread that runs the worker. */
+            std::thread thread;
+        };
+
+        /* The system the current thread is a worker of, or nullptr if it isn't one. */
+        static thread_local JobSystem* local_system;
+        /* The index of the current thread in its system's workers. */
+        static thread_local size_t local_index;
+
+        /* The workers. */
+        std::vector<Worker*> workers;
+        /* Jobs scheduled by threads that aren't workers. */
+        std::deque<Job*> shared_jobs;
+        /* Lock that guards the shared jobs and sleeping. */
+        std::mutex lock;
+        /* Wakes up sleeping workers. */
+        std::condition_variable wakeup;
+        /* The number of jobs scheduled but not yet taken by any thread. */
+        std::atomic<size_t> n_pending;
+        /* The number of workers that are (about to be) asleep. */
+        std::atomic<size_t> n_sleeping;
+        /* Whether or not the workers should keep running. */
+        std::atomic<bool> running;
+
+        /* Takes a job for the worker with the given index (or for a thread that isn't a worker if it's SIZE_MAX): its own newest job first, then a shared one, then the oldest job of another worker. Returns nullptr if there is none. */
+        Job* take(size_t index);
+        /* Adds an already counted job to the deque of the current worker, or to the shared jobs if this isn't a worker, and wakes up a sleeping worker. */
+        void schedule(Job* job);
+        /* Runs the given job, counts it down and frees it. Schedules the continuations of its counter if it was the last job. If the job throws, the exception is kept on its counter instead. */
+        void execute(Job* job);
+        /* The main function of the worker with the given index. */
+        void work(size_t index);
+        /* Runs the given function on the given (exclusive) range of indices. Ranges larger than the grain size are halved first, scheduling the second half as a job so that idle workers can steal it. */
+        void split(size_t start_index, size_t stop_index, size_t grain_size, const std::function<void(size_t, size_t)>& function, JobCounter& counter);
+
+    public:
+        /* Constructor for the JobSystem class, which takes the number of worker threads to start. Defaults to one per core. */
+        JobSystem(size_t n_workers = std::thread::hardware_concurrency());
+        /* Copy constructor for the JobSystem class, which is deleted. */
+        JobSystem(const JobSystem& other) = delete;
+        /* Destructor for the JobSystem class, which stops the workers. Jobs that haven't run yet by then never will, so wait for them first. */
+        ~JobSystem();
+
+        /* Schedules the given function as a job. If a counter is given, it's incremented now and decremented once the job is done. */
+        void run(std::function<void()> function, JobCounter* counter = nullptr);
+        /* Schedules the given function as a job once all jobs of the given dependency are done, or right away if they already are. If a counter is given, it's incremented now and decremented once the job is done. */
+        void run_after(JobCounter& dependency, std::function<void()> function, JobCounter* counter = nullptr);
+        /* Waits until all jobs of the given counter are done, running other jobs in the meantime. Can be called from any thread, but jobs that wait may end up running the very job they wait for further down their own stack, so use run_after() for dependencies between jobs instead. Rethrows the first exception any of the counted jobs threw. */
+        void wait(const JobCounter& counter);
+        /* Calls the given function for consecutive ranges of at most grain_size indices in [0, n_indices) in parallel, as function(start_index, stop_index) with an exclusive stop_index. Returns once all ranges are done, and then rethrows the first exception any of them threw. */
+        void parallel_for(size_t n_indices, size_t grain_size, const std::function<void(size_t, size_t)>& function);
+
+        /* Returns the index of the worker that calls this function, or size() if it isn't one of our workers. Useful to give each thread its own resources, e.g., size() + 1 command pools. */
+        inline size_t worker_index() const { return JobSystem::local_system == this ? JobSystem::local_index : this->workers.size(); }
+        /* Returns the number of worker threads. */
+        inline size_t size() const { return this->workers.size(); }
+
+        /* Copy assignment operator for the JobSystem class, which is deleted. */
+        JobSystem& operator=(const JobSystem& other) = delete;
+
+    };
+}
+
+#endif
@@ -0,0 +1,161 @@
+/* POOL.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:06:09
+ * Last edited:
+ *   16/10/2026, 21:00:21
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the Pool class, which hands out blocks of a single, fixed
+ *   size from larger chunks and keeps freed blocks in a list to hand them
+ *   out again. Made for node-like objects that are created and destroyed
+ *   often. Also contains the PoolAllocator, which lets an Array allocate
+ *   from a Pool as long as it doesn't need more than one block. The Array
+ *   grows up to exactly one block, but not past it.
+**/
+
+#ifndef POOL_HPP
+#define POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Tools {
+    /* The Pool class, which allocates blocks of a fixed size. Freed blocks are reused before new chunks are allocated, and chunks are only freed when the pool is destroyed. Not thread-safe, so use one per thread. */
+    class Pool {
+    public:
+        /* The default number of blocks allocated at once. */
+        static constexpr size_t default_blocks_per_chunk = 64;
+
+    private:
+        /* A free block, which points to the next free block. */
+        struct Block {
+            /* The next free block, or nullptr if this is the last one. */
+            Block* next;
+        };
+
+        /* The size of each block in bytes, rounded up so that every block is aligned. */
+        size_t block_size;
+        /* The alignment of each block. */
+        size_t block_alignment;
+        /* The number of blocks allocated at once. */
+        size_t blocks_per_chunk;
+        /* The chunks allocated so far, as returned by malloc(). */
+        std::vector<void*> chunks;
+        /* The first free block. */
+        Block* free_blocks;
+
+        /* Allocates a new chunk and adds its blocks to the free list. */
+        void add_chunk() {
+            // Allocate a bit more so we can align the first block
+            char* data = (char*) malloc(this->block_size * this->blocks_per_chunk + this->block_alignment);
+            if (data == nullptr) { throw std::bad_alloc(); }
+            this->chunks.push_back(data);
+            char* first = (char*) (((uintptr_t) data + this->block_alignment - 1) & ~(uintptr_t) (this->block_alignment - 1));
+
+            // Link the blocks back to front, so that they're handed out in order
+            for (size_t i = this->blocks_per_chunk; i-- > 0; ) {
+                Block* block = (Block*) (first + i * this->block_size);
+                block->next = this->free_blocks;
+                this->free_blocks = block;
+            }
+        }
+
+    public:
+        /* Constructor for the Pool class, which takes the size and alignment (a power of two) of the blocks and how many of them to allocate at once. Doesn't allocate anything until it's first used. */
+        Pool(size_t block_size, size_t block_alignment = alignof(std::max_align_t), size_t blocks_per_chunk = Pool::default_blocks_per_chunk) :
+            block_alignment(block_alignment < alignof(Block) ? alignof(Block) : block_alignment),
+            blocks_per_chunk(blocks_per_chunk > 0 ? blocks_per_chunk : 1),
+            free_blocks(nullptr)
+        {
+            // Every block must be able to hold the free list pointer, and be aligned
+            size_t size = block_size < sizeof(Block) ? sizeof(Block) : block_size;
+            this->block_size = (size + this->block_alignment - 1) & ~(this->block_alignment - 1);
+        }
+        /* Copy constructor for the Pool class, which is deleted. */
+        Pool(const Pool& other) = delete;
+        /* Destructor for the Pool class, which frees all chunks. Objects still alive in it are not destructed. */
+        ~Pool() {
+            for (size_t i = 0; i < this->chunks.size(); i++) {
+                free(this->chunks[i]);
+            }
+        }
+
+        /* Returns a free block, which must be large enough for the given number of bytes and alignment. Throws std::bad_alloc if it's too small. */
+        inline void* allocate(size_t n_bytes, size_t alignment) {
+            if (n_bytes > this->block_size || alignment > this->block_alignment) { throw std::bad_alloc(); }
+            if (this->free_blocks == nullptr) { this->add_chunk(); }
+            Block* result = this->free_blocks;
+            this->free_blocks = result->next;
+            return result;
+        }
+        /* Resizes the given memory, which stays in the same block as long as it fits. Throws std::bad_alloc if it doesn't. */
+        inline void* reallocate(void* data, size_t, size_t new_n_bytes, size_t alignment) {
+            if (data == nullptr) { return this->allocate(new_n_bytes, alignment); }
+            if (new_n_bytes > this->block_size || alignment > this->block_alignment) { throw std::bad_alloc(); }
+            return data;
+        }
+        /* Gives the given block back to the pool. */
+        inline void deallocate(void* data, size_t) {
+            if (data == nullptr) { return; }
+            Block* block = (Block*) data;
+            block->next = this->free_blocks;
+            this->free_blocks = block;
+        }
+
+        /* Constructs a new object of type T in a block of the pool, passing the given arguments to its constructor. */
+        template <class T, class... Args>
+        inline T* create(Args&&... args) { return new(this->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...); }
+        /* Destructs the given object, and gives its block back to the pool. */
+        template <class T>
+        inline void destroy(T* object) {
+            if (object == nullptr) { return; }
+            object->~T();
+            this->deallocate(object, sizeof(T));
+        }
+
+        /* Returns the size of each block in bytes. */
+        inline size_t size() const { return this->block_size; }
+        /* Returns the total number of blocks in this pool, both free and in use. */
+        inline size_t capacity() const { return this->chunks.size() * this->blocks_per_chunk; }
+
+        /* Copy assignment operator for the Pool class, which is deleted. */
+        Pool& operator=(const Pool& other) = delete;
+
+    };
+
+
+
+    /* The PoolAllocator class, which lets an Array allocate from the given Pool. Since an Array takes a single block, it may only hold as many elements as fit in one. */
+    class PoolAllocator {
+    private:
+        /* The pool we allocate from. */
+        Pool* pool;
+
+    public:
+        /* Constructor for the PoolAllocator class, which takes the pool to allocate from. Implicit, so that a Pool can be passed wherever a PoolAllocator is expected. */
+        PoolAllocator(Pool& pool) : pool(&pool) {}
+
+        /* Allocates a block from the pool. */
+        inline void* allocate(size_t n_bytes, size_t alignment) { return this->pool->allocate(n_bytes, alignment); }
+        /* Resizes the given block, which only works as long as it fits. */
+        inline void* reallocate(void* data, size_t old_n_bytes, size_t new_n_bytes, size_t alignment) { return this->pool->reallocate(data, old_n_bytes, new_n_bytes, alignment); }
+        /* Gives the given block back to the pool. */
+        inline void deallocate(void* data, size_t n_bytes) { this->pool->deallocate(data, n_bytes); }
+        /* Returns the largest number of bytes we can allocate at once, i.e., the size of a single block. */
+        inline size_t max_size() const { return this->pool->size(); }
+
+        /* Returns the pool that this allocator allocates from. */
+        inline Pool& get_pool() const { return *this->pool; }
+
+    };
+}
+
+#endif
@@ -0,0 +1,303 @@
+/* SMALL ARRAY.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 18:57:57
+ * Last edited:
+ *   16/10/2026, 20:57:52
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   A variation on the Array class that stores up to N elements inside
+ *   itself, and only allocates memory on the heap once it needs to hold
+ *   more. Useful for short-lived lists that are usually small, like the
+ *   extensions and layers passed to Vulkan.
+**/
+
+#include <stdexcept>
+#include <type_traits>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+
+#include "Tools/SmallArray.hpp"
+
+
+/***** SMALLARRAY CLASS *****/
+/* Default constructor for the SmallArray class, which initializes it to zero elements in the inline storage. */
+template <class T, size_t N> Tools::SmallArray<T, N>::SmallArray() :
+    elements(this->inline_elements()),
+    length(0),
+    max_length(N)
+{}
+
+/* Constructor for the SmallArray class, which takes an initial amount to reserve room for. Each element will thus be uninitialized. */
+template <class T, size_t N> Tools::SmallArray<T, N>::SmallArray(size_t initial_size) :
+    SmallArray()
+{
+    this->reserve(initial_size);
+}
+
+/* Constructor for the SmallArray class, which takes an initializer_list to initialize the SmallArray with. Makes use of the element's copy constructor. */
+template <class T, size_t N> Tools::SmallArray<T, N>::SmallArray(const std::initializer_list<T>& list) :
+    SmallArray(list.size())
+{
+    // Copy all the elements over
+    for (const T& elem : list) {
+        new(this->elements + this->length++) T(elem);
+    }
+}
+
+/* Constructor for the SmallArray class, which takes a raw C-style vector to copy elements from and its size. Note that the SmallArray's element type must have a copy custructor defined. */
+template <class T, size_t N> Tools::SmallArray<T, N>::SmallArray(const T* list, size_t list_size) :
+    SmallArray(list_size)
+{
+    // Copy all the elements over
+    for (size_t i = 0; i < list_size; i++) {
+        new(this->elements + this->length++) T(list[i]);
+    }
+}
+
+/* Constructor for the SmallArray class, which takes a C++-style vector. Note that the SmallArray's element type must have a copy custructor defined. */
+template <class T, size_t N> Tools::SmallArray<T, N>::SmallArray(const std::vector<T>& list) :
+    SmallArray(list.data(), list.size())
+{}
+
+/* Copy constructor for the SmallArray class. Note that this only works if the SmallArray's element has a copy constructor defined. */
+template <class T, size_t N> Tools::SmallArray<T, N>::SmallArray(const SmallArray& other) :
+    SmallArray(other.elements, other.length)
+{}
+
+/* Move constructor for the SmallArray class. Elements in the inline storage are moved one-by-one, while heap memory is simply taken over. */
+template <class T, size_t N> Tools::SmallArray<T, N>::SmallArray(SmallArray&& other) :
+    SmallArray()
+{
+    this->take(std::move(other));
+}
+
+/* Destructor for the SmallArray class. */
+template <class T, size_t N> Tools::SmallArray<T, N>::~SmallArray() {
+    // Deallocate all elements if the element needs that
+    if (std::is_destructible<T>::value) {
+        for (size_t i = 0; i < this->length; i++) {
+            this->elements[i].~T();
+        }
+    }
+    // Only free the memory if it's ours to free
+    if (!this->is_inline()) {
+        free(this->elements);
+    }
+}
+
+
+
+/* Takes the elements of the given SmallArray, which is empty afterwards. Assumes this SmallArray is empty and uses its inline storage. */
+template <class T, size_t N> void Tools::SmallArray<T, N>::take(SmallArray&& other) {
+    if (other.is_inline()) {
+        // The elements live inside the other, so they have to be moved over
+        relocate_elements(this->elements, other.elements, other.length);
+    } else {
+        // Simply steal the heap memory, and give the other its inline storage back
+        this->elements = other.elements;
+        this->max_length = other.max_length;
+        other.elements = other.inline_elements();
+        other.max_length = N;
+    }
+    this->length = other.length;
+    other.length = 0;
+}
+
+/* Makes sure there is room for at least one more element, growing the capacity geometrically. */
+template <class T, size_t N> void Tools::SmallArray<T, N>::grow() {
+    // The capacity is never less than N (and thus never zero), so we can simply multiply it
+    this->reserve(std::max(this->max_length * SmallArray::growth_factor, this->length + 1));
+}
+
+
+
+/* Adds a new element of type T to the array, copying it. Note that this requires the element to be copy constructible. */
+template <class T, size_t N> void Tools::SmallArray<T, N>::push_back(const T& elem) {
+    // Make sure that the array has enough size
+    if (this->length >= this->max_length) {
+        // If the element lives in this array, it moves along with it
+        if (&elem >= this->elements && &elem < this->elements + this->length) {
+            size_t index = &elem - this->elements;
+            this->grow();
+            new(this->elements + this->length++) T(this->elements[index]);
+            return;
+        }
+        this->grow();
+    }
+
+    // Add the element at the end of the array
+    new(this->elements + this->length++) T(elem);
+}
+
+/* Adds a new element of type T to the array, leaving it in an usused state (moving it). Note that this requires the element to be move constructible. */
+template <class T, size_t N> void Tools::SmallArray<T, N>::push_back(T&& elem) {
+    // Make sure that the array has enough size
+    if (this->length >= this->max_length) {
+        // If the element lives in this array, it moves along with it
+        if (&elem >= this->elements && &elem < this->elements + this->length) {
+            size_t index = &elem - this->elements;
+            this->grow();
+            new(this->elements + this->length++) T(std::move(this->elements[index]));
+            return;
+        }
+        this->grow();
+    }
+
+    // Add the element at the end of the array
+    new(this->elements + this->length++) T(std::move(elem));
+}
+
+/* Removes the last element from the array. */
+template <class T, size_t N> void Tools::SmallArray<T, N>::pop_back() {
+    // Check if there are any elements
+    if (this->length == 0) { return; }
+
+    // Delete the last element if needed
+    if (std::is_destructible<T>::value) {
+        this->elements[this->length - 1].~T();
+    }
+    --this->length;
+}
+
+
+
+/* Erases an element with the given index from the array. Does nothing if the index is out-of-bounds. */
+template <class T, size_t N> void Tools::SmallArray<T, N>::erase(size_t index) {
+    this->erase(index, index);
+}
+
+/* Erases multiple elements in the given (inclusive) range from the array. Does nothing if the any index is out-of-bounds or if the start_index is larger than the stop_index. */
+template <class T, size_t N> void Tools::SmallArray<T, N>::erase(size_t start_index, size_t stop_index) {
+    // Check if in bounds
+    if (start_index >= this->length || stop_index >= this->length || start_index > stop_index) { return; }
+
+    // Otherwise, delete the elements if needed
+    if (std::is_destructible<T>::value) {
+        for (size_t i = start_index; i <= stop_index; i++) {
+            this->elements[i].~T();
+        }
+    }
+
+    // Move all elements following it back
+    relocate_elements(this->elements + start_index, this->elements + stop_index + 1, this->length - 1 - stop_index);
+    this->length -= 1 + stop_index - start_index;
+}
+
+/* Erases everything from the array, returning any heap memory and going back to the inline storage. */
+template <class T, size_t N> void Tools::SmallArray<T, N>::clear() {
+    // Delete everything currently in the array if needed
+    if (std::is_destructible<T>::value) {
+        for (size_t i = 0; i < this->length; i++) {
+            this->elements[i].~T();
+        }
+    }
+    if (!this->is_inline()) {
+        free(this->elements);
+    }
+
+    // Set the new values
+    this->elements = this->inline_elements();
+    this->length = 0;
+    this->max_length = N;
+}
+
+
+
+/* Re-allocates the internal array to exactly the given size, or to the inline storage if that's large enough. Any leftover elements will be left unitialized, and elements that won't fit will be deallocated. */
+template <class T, size_t N> void Tools::SmallArray<T, N>::reserve(size_t new_size) {
+    // Deallocate any elements that won't fit anymore (if needed)
+    if (new_size < this->length) {
+        if (std::is_destructible<T>::value) {
+            for (size_t i = new_size; i < this->length; i++) {
+                this->elements[i].~T();
+            }
+        }
+        this->length = new_size;
+    }
+
+    // Do only something if the capacity changes
+    size_t new_capacity = std::max(new_size, N);
+    if (new_capacity == this->max_length) { return; }
+
+    // If the elements fit in the inline storage again, move them back there
+    if (new_capacity == N) {
+        relocate_elements(this->inline_elements(), this->elements, this->length);
+        free(this->elements);
+        this->elements = this->inline_elements();
+        this->max_length = N;
+        return;
+    }
+
+    // Elements on the heap that may be moved as bytes can be given to realloc, which may grow the block in-place
+    if constexpr (is_relocatable<T>::value) {
+        if (!this->is_inline()) {
+            T* new_elements = (T*) realloc(this->elements, sizeof(T) * new_capacity);
+            if (new_elements == nullptr) { throw std::bad_alloc(); }
+            this->elements = new_elements;
+            this->max_length = new_capacity;
+            return;
+        }
+    }
+
+    // Otherwise, allocate a new block and move the elements there
+    T* new_elements = (T*) malloc(sizeof(T) * new_capacity);
+    if (new_elements == nullptr) { throw std::bad_alloc(); }
+    relocate_elements(new_elements, this->elements, this->length);
+    if (!this->is_inline()) {
+        free(this->elements);
+    }
+    this->elements = new_elements;
+    this->max_length = new_capacity;
+}
+
+/* Resizes the array to the given size. Any new elements will be initialized with their default constructor, and elements that won't fit will be deallocated. */
+template <class T, size_t N> void Tools::SmallArray<T, N>::resize(size_t new_size) {
+    // Make sure there is room, which also takes care of any elements that won't fit
+    if (new_size > this->max_length || new_size < this->length) {
+        this->reserve(new_size);
+    }
+
+    // Initialize the new elements
+    for (size_t i = this->length; i < new_size; i++) {
+        new(this->elements + i) T();
+    }
+    this->length = new_size;
+}
+
+
+
+/* Returns a muteable reference to the element at the given index. Performs in-of-bounds checks before accessing the element. */
+template <class T, size_t N> T& Tools::SmallArray<T, N>::at(size_t index) {
+    if (index >= this->length) { throw std::out_of_range("Index " + std::to_string(index) + " is out-of-bounds for SmallArray with size " + std::to_string(this->length)); }
+    return this->elements[index];
+}
+
+/* Returns a constant reference to the element at the given index. Performs in-of-bounds checks before accessing the element. */
+template <class T, size_t N> const T& Tools::SmallArray<T, N>::at(size_t index) const {
+    if (index >= this->length) { throw std::out_of_range("Index " + std::to_string(index) + " is out-of-bounds for SmallArray with size " + std::to_string(this->length)); }
+    return this->elements[index];
+}
+
+
+
+/* Returns a muteable pointer to the internal data struct. Use this to fill the array using C-libraries, but beware that the array needs to have enough space reserved. The optional new_size parameter is used to update the size() value of the array, so it knows what is initialized and what is not. Leave it at numeric_limits<size_t>::max() to leave the array size unchanged. */
+template <class T, size_t N> T* Tools::SmallArray<T, N>::wdata(size_t new_size) {
+    if (new_size != std::numeric_limits<size_t>::max()) { this->length = new_size; }
+    return this->elements;
+}
+
+
+
+/* Move assignment operator for the SmallArray class. */
+template <class T, size_t N> Tools::SmallArray<T, N>& Tools::SmallArray<T, N>::operator=(SmallArray&& other) {
+    if (this != &other) {
+        this->clear();
+        this->take(std::move(other));
+    }
+    return *this;
+}
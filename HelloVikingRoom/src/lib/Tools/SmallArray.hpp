@@ -0,0 +1,138 @@
+/* SMALL ARRAY.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 18:57:57
+ * Last edited:
+ *   16/10/2026, 20:57:52
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   A variation on the Array class that stores up to N elements inside
+ *   itself, and only allocates memory on the heap once it needs to hold
+ *   more. Useful for short-lived lists that are usually small, like the
+ *   extensions and layers passed to Vulkan.
+**/
+
+#ifndef SMALL_ARRAY_HPP
+#define SMALL_ARRAY_HPP
+
+/***** HEADER *****/
+#include <cstddef>
+#include <vector>
+#include <initializer_list>
+#include <limits>
+#include <type_traits>
+
+#include "Tools/Array.hpp"
+
+namespace Tools {
+    /* The SmallArray class, which has the same interface as the Array but keeps up to N elements in inline storage, so that small arrays don't need to allocate at all. */
+    template <class T, size_t N>
+    class SmallArray {
+    public:
+        /* The number of elements that fit in the inline storage. */
+        static constexpr size_t inline_capacity = N;
+        /* The factor by which the capacity is multiplied every time push_back() runs out of space. */
+        static constexpr size_t growth_factor = 2;
+
+    private:
+        static_assert(N > 0, "SmallArray needs room for at least one inline element; use Array instead");
+
+        /* The internal data, which points either to the inline storage or to memory on the heap. */
+        T* elements;
+        /* The number of internal elements. */
+        size_t length;
+        /* The maximum number of elements we have room for, which is never less than N. */
+        size_t max_length;
+        /* The inline storage for the first N elements. */
+        alignas(T) unsigned char storage[sizeof(T) * N];
+
+        /* Returns a pointer to the inline storage. */
+        inline T* inline_elements() { return reinterpret_cast<T*>(this->storage); }
+        /* Takes the elements of the given SmallArray, which is empty afterwards. Assumes this SmallArray is empty and uses its inline storage. */
+        void take(SmallArray&& other);
+        /* Makes sure there is room for at least one more element, growing the capacity geometrically. */
+        void grow();
+
+    public:
+        /* Default constructor for the SmallArray class, which initializes it to zero elements in the inline storage. */
+        SmallArray();
+        /* Constructor for the SmallArray class, which takes an initial amount to reserve room for. Each element will thus be uninitialized. */
+        SmallArray(size_t initial_size);
+        /* Constructor for the SmallArray class, which takes an initializer_list to initialize the SmallArray with. Makes use of the element's copy constructor. */
+        SmallArray(const std::initializer_list<T>& list);
+        /* Constructor for the SmallArray class, which takes a raw C-style vector to copy elements from and its size. Note that the SmallArray's element type must have a copy custructor defined. */
+        SmallArray(const T* list, size_t list_size);
+        /* Constructor for the SmallArray class, which takes a C++-style vector. Note that the SmallArray's element type must have a copy custructor defined. */
+        SmallArray(const std::vector<T>& list);
+        /* Copy constructor for the SmallArray class. Note that this only works if the SmallArray's element has a copy constructor defined. */
+        SmallArray(const SmallArray& other);
+        /* Move constructor for the SmallArray class. Elements in the inline storage are moved one-by-one, while heap memory is simply taken over. */
+        SmallArray(SmallArray&& other);
+        /* Destructor for the SmallArray class. */
+        ~SmallArray();
+
+        /* Adds a new element of type T to the array, copying it. Note that this requires the element to be copy constructible. */
+        void push_back(const T& elem);
+        /* Adds a new element of type T to the array, leaving it in an usused state (moving it). Note that this requires the element to be move constructible. */
+        void push_back(T&& elem);
+        /* Removes the last element from the array. */
+        void pop_back();
+
+        /* Erases an element with the given index from the array. Does nothing if the index is out-of-bounds. */
+        void erase(size_t index);
+        /* Erases multiple elements in the given (inclusive) range from the array. Does nothing if the any index is out-of-bounds or if the start_index is larger than the stop_index. */
+        void erase(size_t start_index, size_t stop_index);
+        /* Erases everything from the array, returning any heap memory and going back to the inline storage. */
+        void clear();
+
+        /* Re-allocates the internal array to exactly the given size, or to the inline storage if that's large enough. Any leftover elements will be left unitialized, and elements that won't fit will be deallocated. */
+        void reserve(size_t new_size);
+        /* Resizes the array to the given size. Any new elements will be initialized with their default constructor, and elements that won't fit will be deallocated. */
+        void resize(size_t new_size);
+
+        /* Returns a muteable reference to the element at the given index. Does not perform any in-of-bounds checking. */
+        inline T& operator[](size_t index) { return this->elements[index]; }
+        /* Returns a constant reference to the element at the given index. Does not perform any in-of-bounds checking. */
+        inline const T& operator[](size_t index) const { return this->elements[index]; }
+        /* Returns a muteable reference to the element at the given index. Performs in-of-bounds checks before accessing the element. */
+        T& at(size_t index);
+        /* Returns a constant reference to the element at the given index. Performs in-of-bounds checks before accessing the element. */
+        const T& at(size_t index) const;
+
+        /* Returns a muteable pointer to the internal data struct. Use this to fill the array using C-libraries, but beware that the array needs to have enough space reserved. The optional new_size parameter is used to update the size() value of the array, so it knows what is initialized and what is not. Leave it at numeric_limits<size_t>::max() to leave the array size unchanged. */
+        T* wdata(size_t new_size = std::numeric_limits<size_t>::max());
+        /* Returns a constant pointer to the internal data struct. Use this to read from the array using C-libraries. */
+        inline const T* rdata() const { return this->elements; }
+        /* Returns true if there are no elements in this array, or false otherwise. */
+        inline bool empty() const { return this->length == 0; }
+        /* Returns the number of elements stored in this SmallArray. */
+        inline size_t size() const { return this->length; }
+        /* Returns the number of elements this SmallArray can store before resizing. */
+        inline size_t capacity() const { return this->max_length; }
+        /* Returns whether the elements are still stored in the inline storage, i.e., whether the SmallArray didn't need to allocate. */
+        inline bool is_inline() const { return this->elements == reinterpret_cast<const T*>(this->storage); }
+
+        /* Copy assignment operator for the SmallArray class. Depends on SmallArray's copy constructor, and therefore requires the SmallArray's type to be copy constructible. */
+        inline SmallArray& operator=(const SmallArray& other) { return *this = SmallArray(other); }
+        /* Move assignment operator for the SmallArray class. */
+        SmallArray& operator=(SmallArray&& other);
+        /* Swap operator for the SmallArray class. Since elements in the inline storage can't simply be swapped by pointer, this moves them. */
+        friend void swap(SmallArray& sa1, SmallArray& sa2) {
+            SmallArray temp(std::move(sa1));
+            sa1 = std::move(sa2);
+            sa2 = std::move(temp);
+        }
+    };
+}
+
+
+
+
+
+/***** IMPLEMENTATIONS *****/
+#include "Tools/SmallArray.cpp"
+
+#endif
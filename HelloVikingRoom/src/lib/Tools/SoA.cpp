@@ -0,0 +1,260 @@
+/* SOA.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:18:34
+ * Last edited:
+ *   16/10/2026, 19:23:15
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   A structure-of-arrays container, which stores each field of its
+ *   elements in its own contiguous array instead of storing the elements
+ *   one after another. Kernels that only need some of the fields (e.g.,
+ *   culling only needs the bounds) can then stream exactly those. Each
+ *   field is aligned to at least 32 bytes, so that it can be loaded with
+ *   aligned SIMD instructions. Otherwise, it grows and erases like the
+ *   Array does.
+**/
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include "Tools/SoA.hpp"
+
+
+/***** SOA CLASS *****/
+/* Default constructor for the SoA class, which initializes it to zero elements. */
+template <class... Ts> Tools::SoA<Ts...>::SoA() :
+    block(nullptr),
+    fields(),
+    length(0),
+    max_length(0)
+{}
+
+/* Constructor for the SoA class, which takes an initial amount to reserve room for. Each element will thus be uninitialized. */
+template <class... Ts> Tools::SoA<Ts...>::SoA(size_t initial_size) :
+    SoA()
+{
+    this->reserve(initial_size);
+}
+
+/* Copy constructor for the SoA class. Note that this only works if all fields have a copy constructor defined. */
+template <class... Ts> Tools::SoA<Ts...>::SoA(const SoA& other) :
+    SoA(other.length)
+{
+    // Copy each field to its own array
+    std::apply([this, &other](Ts*... copies) {
+        std::apply([this, &other, copies...](Ts*... originals) {
+            (std::uninitialized_copy(originals, originals + other.length, copies), ...);
+        }, other.fields);
+    }, this->fields);
+    this->length = other.length;
+}
+
+/* Move constructor for the SoA class. */
+template <class... Ts> Tools::SoA<Ts...>::SoA(SoA&& other) :
+    block(other.block),
+    fields(other.fields),
+    length(other.length),
+    max_length(other.max_length)
+{
+    // Leave the other empty
+    other.block = nullptr;
+    other.fields = std::tuple<Ts*...>();
+    other.length = 0;
+    other.max_length = 0;
+}
+
+/* Destructor for the SoA class. */
+template <class... Ts> Tools::SoA<Ts...>::~SoA() {
+    this->destroy(0, this->length);
+    free(this->block);
+}
+
+
+
+/* Allocates a block with room for the given number of elements in each field, returning where each field starts. The block itself is returned in the given pointer. */
+template <class... Ts> std::tuple<Ts*...> Tools::SoA<Ts...>::allocate(size_t capacity, void*& new_block) {
+    // Round each field's array up to the alignment, so that the next one starts aligned as well
+    auto round_up = [](size_t n_bytes) { return (n_bytes + SoA::alignment - 1) & ~(SoA::alignment - 1); };
+    size_t total = (round_up(sizeof(Ts) * capacity) + ...);
+
+    // malloc() only aligns to std::max_align_t, so allocate a bit more and align the start ourselves
+    new_block = malloc(total + SoA::alignment);
+    if (new_block == nullptr) { throw std::bad_alloc(); }
+    char* start = (char*) (((uintptr_t) new_block + SoA::alignment - 1) & ~(uintptr_t) (SoA::alignment - 1));
+
+    // Hand out the arrays in order
+    std::tuple<Ts*...> result;
+    size_t offset = 0;
+    std::apply([start, capacity, &offset, &round_up](Ts*&... fields) {
+        ((fields = (Ts*) (start + offset), offset += round_up(sizeof(Ts) * capacity)), ...);
+    }, result);
+    return result;
+}
+
+/* Moves the elements to the given block with the given fields, and frees the old block. */
+template <class... Ts> void Tools::SoA<Ts...>::replace(void* new_block, const std::tuple<Ts*...>& new_fields, size_t new_capacity) {
+    // Move each field to its new array
+    std::apply([this, &new_fields](Ts*... sources) {
+        std::apply([this, sources...](Ts*... destinations) {
+            (relocate_elements(destinations, sources, this->length), ...);
+        }, new_fields);
+    }, this->fields);
+
+    // Swap the blocks
+    free(this->block);
+    this->block = new_block;
+    this->fields = new_fields;
+    this->max_length = new_capacity;
+}
+
+/* Destroys the elements in the given (exclusive) range in each field. */
+template <class... Ts> void Tools::SoA<Ts...>::destroy(size_t start_index, size_t stop_index) {
+    std::apply([start_index, stop_index](Ts*... fields) {
+        (std::destroy(fields + start_index, fields + stop_index), ...);
+    }, this->fields);
+}
+
+/* Adds a new element constructed from the given values to the end of the SoA, growing the capacity geometrically if there is no room. */
+template <class... Ts> template <class... Us> void Tools::SoA<Ts...>::append(Us&&... values) {
+    // If there's room, simply construct the element at the end
+    if (this->length < this->max_length) {
+        std::apply([this, &values...](Ts*... fields) {
+            (new(fields + this->length) Ts(std::forward<Us>(values)), ...);
+        }, this->fields);
+        ++this->length;
+        return;
+    }
+
+    // Otherwise, construct it in the new arrays before moving the rest there, since the values may be elements of this SoA
+    void* new_block;
+    size_t new_capacity = std::max(SoA::min_growth, this->max_length * SoA::growth_factor);
+    std::tuple<Ts*...> new_fields = SoA::allocate(new_capacity, new_block);
+    std::apply([this, &values...](Ts*... fields) {
+        (new(fields + this->length) Ts(std::forward<Us>(values)), ...);
+    }, new_fields);
+    this->replace(new_block, new_fields, new_capacity);
+    ++this->length;
+}
+
+
+
+/* Adds a new element to the SoA, copying each of its fields. Note that this requires the fields to be copy constructible. */
+template <class... Ts> void Tools::SoA<Ts...>::push_back(const Ts&... values) {
+    this->append(values...);
+}
+
+/* Adds a new element to the SoA, leaving each of its fields in an unused state (moving them). Note that this requires the fields to be move constructible. */
+template <class... Ts> void Tools::SoA<Ts...>::push_back(Ts&&... values) {
+    this->append(std::move(values)...);
+}
+
+/* Removes the last element from the SoA. */
+template <class... Ts> void Tools::SoA<Ts...>::pop_back() {
+    // Check if there are any elements
+    if (this->length == 0) { return; }
+
+    // Delete the last element
+    this->destroy(this->length - 1, this->length);
+    --this->length;
+}
+
+
+
+/* Erases an element with the given index from the SoA. Does nothing if the index is out-of-bounds. */
+template <class... Ts> void Tools::SoA<Ts...>::erase(size_t index) {
+    this->erase(index, index);
+}
+
+/* Erases multiple elements in the given (inclusive) range from the SoA. Does nothing if the any index is out-of-bounds or if the start_index is larger than the stop_index. */
+template <class... Ts> void Tools::SoA<Ts...>::erase(size_t start_index, size_t stop_index) {
+    // Check if in bounds
+    if (start_index >= this->length || stop_index >= this->length || start_index > stop_index) { return; }
+
+    // Otherwise, delete the elements
+    this->destroy(start_index, stop_index + 1);
+
+    // Move all elements following it back, field by field
+    size_t n_following = this->length - 1 - stop_index;
+    std::apply([start_index, stop_index, n_following](Ts*... fields) {
+        (relocate_elements(fields + start_index, fields + stop_index + 1, n_following), ...);
+    }, this->fields);
+    this->length -= 1 + stop_index - start_index;
+}
+
+/* Erases everything from the SoA, even removing the internal allocated arrays. */
+template <class... Ts> void Tools::SoA<Ts...>::clear() {
+    // Delete everything currently in the SoA
+    this->destroy(0, this->length);
+    free(this->block);
+
+    // Set the new values
+    this->block = nullptr;
+    this->fields = std::tuple<Ts*...>();
+    this->length = 0;
+    this->max_length = 0;
+}
+
+
+
+/* Re-allocates the internal arrays to exactly the given size. Any leftover elements will be left unitialized, and elements that won't fit will be deallocated. */
+template <class... Ts> void Tools::SoA<Ts...>::reserve(size_t new_size) {
+    // Do only something if the size is different from what it is now
+    if (new_size == this->max_length) { return; }
+
+    // Deallocate any elements that won't fit anymore
+    if (new_size < this->length) {
+        this->destroy(new_size, this->length);
+        this->length = new_size;
+    }
+
+    // Without any room left, we don't need a block at all
+    if (new_size == 0) {
+        this->clear();
+        return;
+    }
+
+    // Otherwise, move everything to a block of the new size
+    void* new_block;
+    std::tuple<Ts*...> new_fields = SoA::allocate(new_size, new_block);
+    this->replace(new_block, new_fields, new_size);
+}
+
+/* Resizes the SoA to the given size. Any new elements will be initialized with their default constructors, and elements that won't fit will be deallocated. */
+template <class... Ts> void Tools::SoA<Ts...>::resize(size_t new_size) {
+    // Make sure there is room, which also takes care of any elements that won't fit
+    if (new_size > this->max_length || new_size < this->length) {
+        this->reserve(new_size);
+    }
+
+    // Initialize the new elements
+    std::apply([this, new_size](Ts*... fields) {
+        (std::uninitialized_value_construct(fields + this->length, fields + new_size), ...);
+    }, this->fields);
+    this->length = new_size;
+}
+
+/* Swaps the elements at the given indices in all fields, e.g., for sorting. Does not perform any in-of-bounds checking. */
+template <class... Ts> void Tools::SoA<Ts...>::swap_elements(size_t index1, size_t index2) {
+    using std::swap;
+
+    std::apply([index1, index2](Ts*... fields) {
+        (swap(fields[index1], fields[index2]), ...);
+    }, this->fields);
+}
+
+
+
+/* Move assignment operator for the SoA class. */
+template <class... Ts> Tools::SoA<Ts...>& Tools::SoA<Ts...>::operator=(SoA&& other) {
+    if (this != &other) {
+        this->clear();
+        swap(*this, other);
+    }
+    return *this;
+}
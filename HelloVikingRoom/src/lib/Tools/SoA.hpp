@@ -0,0 +1,151 @@
+/* SOA.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:18:34
+ * Last edited:
+ *   16/10/2026, 19:23:15
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   A structure-of-arrays container, which stores each field of its
+ *   elements in its own contiguous array instead of storing the elements
+ *   one after another. Kernels that only need some of the fields (e.g.,
+ *   culling only needs the bounds) can then stream exactly those. Each
+ *   field is aligned to at least 32 bytes, so that it can be loaded with
+ *   aligned SIMD instructions. Otherwise, it grows and erases like the
+ *   Array does.
+**/
+
+#ifndef SOA_HPP
+#define SOA_HPP
+
+/***** HEADER *****/
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include "Tools/Array.hpp"
+#include "Tools/Span.hpp"
+
+namespace Tools {
+    /* The SoA class, which stores elements consisting of one value of each of the given types in a separate, aligned array per type. All arrays live in a single allocation. */
+    template <class... Ts>
+    class SoA {
+    public:
+        /* The number of fields each element has. */
+        static constexpr size_t n_fields = sizeof...(Ts);
+        /* The alignment of each field's array, which is 32 bytes (enough for AVX) or more if one of the types needs it. */
+        static constexpr size_t alignment = std::max({ (size_t) 32, alignof(Ts)... });
+        /* The capacity an empty SoA grows to when the first element is pushed to it. */
+        static constexpr size_t min_growth = 4;
+        /* The factor by which the capacity is multiplied every time push_back() runs out of space. */
+        static constexpr size_t growth_factor = 2;
+
+        /* The type of the field with the given index. */
+        template <size_t I>
+        using field_t = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    private:
+        static_assert(sizeof...(Ts) > 0, "SoA needs at least one field");
+        static_assert((alignment & (alignment - 1)) == 0, "SoA alignment must be a power of two");
+
+        /* The block of memory all fields live in, as returned by malloc(). */
+        void* block;
+        /* The start of each field's array in the block. */
+        std::tuple<Ts*...> fields;
+        /* The number of elements. */
+        size_t length;
+        /* The maximum number of elements we allocated for. */
+        size_t max_length;
+
+        /* Allocates a block with room for the given number of elements in each field, returning where each field starts. The block itself is returned in the given pointer. */
+        static std::tuple<Ts*...> allocate(size_t capacity, void*& new_block);
+        /* Moves the elements to the given block with the given fields, and frees the old block. */
+        void replace(void* new_block, const std::tuple<Ts*...>& new_fields, size_t new_capacity);
+        /* Destroys the elements in the given (exclusive) range in each field. */
+        void destroy(size_t start_index, size_t stop_index);
+        /* Adds a new element constructed from the given values to the end of the SoA, growing the capacity geometrically if there is no room. */
+        template <class... Us>
+        void append(Us&&... values);
+
+    public:
+        /* Default constructor for the SoA class, which initializes it to zero elements. */
+        SoA();
+        /* Constructor for the SoA class, which takes an initial amount to reserve room for. Each element will thus be uninitialized. */
+        SoA(size_t initial_size);
+        /* Copy constructor for the SoA class. Note that this only works if all fields have a copy constructor defined. */
+        SoA(const SoA& other);
+        /* Move constructor for the SoA class. */
+        SoA(SoA&& other);
+        /* Destructor for the SoA class. */
+        ~SoA();
+
+        /* Adds a new element to the SoA, copying each of its fields. Note that this requires the fields to be copy constructible. */
+        void push_back(const Ts&... values);
+        /* Adds a new element to the SoA, leaving each of its fields in an unused state (moving them). Note that this requires the fields to be move constructible. */
+        void push_back(Ts&&... values);
+        /* Removes the last element from the SoA. */
+        void pop_back();
+
+        /* Erases an element with the given index from the SoA. Does nothing if the index is out-of-bounds. */
+        void erase(size_t index);
+        /* Erases multiple elements in the given (inclusive) range from the SoA. Does nothing if the any index is out-of-bounds or if the start_index is larger than the stop_index. */
+        void erase(size_t start_index, size_t stop_index);
+        /* Erases everything from the SoA, even removing the internal allocated arrays. */
+        void clear();
+
+        /* Re-allocates the internal arrays to exactly the given size. Any leftover elements will be left unitialized, and elements that won't fit will be deallocated. */
+        void reserve(size_t new_size);
+        /* Resizes the SoA to the given size. Any new elements will be initialized with their default constructors, and elements that won't fit will be deallocated. */
+        void resize(size_t new_size);
+        /* Swaps the elements at the given indices in all fields, e.g., for sorting. Does not perform any in-of-bounds checking. */
+        void swap_elements(size_t index1, size_t index2);
+
+        /* Returns a Span over all values of the field with the given index. It's valid until the SoA is re-allocated. */
+        template <size_t I>
+        inline Span<field_t<I>> field() { return Span<field_t<I>>(std::get<I>(this->fields), this->length); }
+        /* Returns a constant Span over all values of the field with the given index. It's valid until the SoA is re-allocated. */
+        template <size_t I>
+        inline Span<const field_t<I>> field() const { return Span<const field_t<I>>(std::get<I>(this->fields), this->length); }
+        /* Returns a muteable reference to the given field of the element at the given index. Does not perform any in-of-bounds checking. */
+        template <size_t I>
+        inline field_t<I>& get(size_t index) { return std::get<I>(this->fields)[index]; }
+        /* Returns a constant reference to the given field of the element at the given index. Does not perform any in-of-bounds checking. */
+        template <size_t I>
+        inline const field_t<I>& get(size_t index) const { return std::get<I>(this->fields)[index]; }
+
+        /* Returns true if there are no elements in this SoA, or false otherwise. */
+        inline bool empty() const { return this->length == 0; }
+        /* Returns the number of elements stored in this SoA. */
+        inline size_t size() const { return this->length; }
+        /* Returns the number of elements this SoA can store before resizing. */
+        inline size_t capacity() const { return this->max_length; }
+
+        /* Copy assignment operator for the SoA class. Depends on SoA's copy constructor, and therefore requires the fields to be copy constructible. */
+        inline SoA& operator=(const SoA& other) { return *this = SoA(other); }
+        /* Move assignment operator for the SoA class. */
+        SoA& operator=(SoA&& other);
+        /* Swap operator for the SoA class. */
+        friend void swap(SoA& s1, SoA& s2) {
+            using std::swap;
+
+            swap(s1.block, s2.block);
+            swap(s1.fields, s2.fields);
+            swap(s1.length, s2.length);
+            swap(s1.max_length, s2.max_length);
+        }
+    };
+}
+
+
+
+
+
+/***** IMPLEMENTATIONS *****/
+#include "Tools/SoA.cpp"
+
+#endif
@@ -0,0 +1,69 @@
+/* SPAN.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:18:34
+ * Last edited:
+ *   16/10/2026, 19:23:15
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   A small, non-owning view of a contiguous range of elements, since
+ *   std::span only arrived in C++20. Used to hand out the fields of a SoA
+ *   without copying them.
+**/
+
+#ifndef SPAN_HPP
+#define SPAN_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace Tools {
+    /* The Span class, which points to a range of elements owned by someone else. It's only valid as long as the owner doesn't re-allocate them. */
+    template <class T>
+    class Span {
+    private:
+        /* The first element in the range. */
+        T* elements;
+        /* The number of elements in the range. */
+        size_t length;
+
+    public:
+        /* Default constructor for the Span class, which initializes it to an empty range. */
+        constexpr Span() : elements(nullptr), length(0) {}
+        /* Constructor for the Span class, which takes the first element and the number of elements in the range. */
+        constexpr Span(T* elements, size_t length) : elements(elements), length(length) {}
+        /* Constructor for the Span class, which turns a Span of muteable elements into one of constant elements. */
+        template <class U, typename = std::enable_if_t<std::is_same<const U, T>::value>>
+        constexpr Span(const Span<U>& other) : elements(other.data()), length(other.size()) {}
+
+        /* Returns a reference to the element at the given index. Does not perform any in-of-bounds checking. */
+        constexpr T& operator[](size_t index) const { return this->elements[index]; }
+        /* Returns a reference to the element at the given index. Performs in-of-bounds checks before accessing the element. */
+        inline T& at(size_t index) const {
+            if (index >= this->length) { throw std::out_of_range("Index " + std::to_string(index) + " is out-of-bounds for Span with size " + std::to_string(this->length)); }
+            return this->elements[index];
+        }
+        /* Returns a Span over the given number of elements starting at the given index. Does not perform any in-of-bounds checking. */
+        constexpr Span subspan(size_t index, size_t n) const { return Span(this->elements + index, n); }
+
+        /* Returns a pointer to the first element, for use with C-libraries and SIMD loads. */
+        constexpr T* data() const { return this->elements; }
+        /* Returns true if there are no elements in this span, or false otherwise. */
+        constexpr bool empty() const { return this->length == 0; }
+        /* Returns the number of elements in this span. */
+        constexpr size_t size() const { return this->length; }
+
+        /* Returns a pointer to the first element, so the span can be used in range-based for-loops. */
+        constexpr T* begin() const { return this->elements; }
+        /* Returns a pointer past the last element, so the span can be used in range-based for-loops. */
+        constexpr T* end() const { return this->elements + this->length; }
+
+    };
+}
+
+#endif
@@ -0,0 +1,136 @@
+/* SPSC RING.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:24:26
+ * Last edited:
+ *   16/10/2026, 19:30:13
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the SpscRing class, a lock-free queue for exactly one thread
+ *   that pushes and one thread that pops. Each side only writes its own
+ *   index, and the two indices live on separate cache lines so that the
+ *   threads don't keep stealing the line from each other.
+**/
+
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <atomic>
+#include <new>
+#include <utility>
+
+namespace Tools {
+    /* The SpscRing class, which is a fixed-size, lock-free queue between a single producer thread and a single consumer thread. push() may only be called by the producer and pop() only by the consumer. */
+    template <class T>
+    class SpscRing {
+    public:
+        /* The size of a cache line, which the indices are padded to. */
+        static constexpr size_t cache_line_size = 64;
+
+    private:
+        /* The internal data, with room for a power of two elements. */
+        T* elements;
+        /* The number of elements minus one, used to wrap the indices. */
+        size_t mask;
+
+        /* The index of the next element to pop. Only written by the consumer. */
+        alignas(cache_line_size) std::atomic<size_t> head;
+        /* The consumer's copy of the tail, so that it only needs to read the producer's line once the ring looks empty. */
+        size_t cached_tail;
+
+        /* The index of the next element to push. Only written by the producer. */
+        alignas(cache_line_size) std::atomic<size_t> tail;
+        /* The producer's copy of the head, so that it only needs to read the consumer's line once the ring looks full. */
+        size_t cached_head;
+
+        /* Pads the producer's fields to a whole cache line, so whatever follows the ring doesn't share it. */
+        char padding[cache_line_size - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+
+        /* Gets the index for a new element. Returns false if the ring is full. Called by the producer. */
+        inline bool reserve_slot(size_t& index) {
+            index = this->tail.load(std::memory_order_relaxed);
+            if (index - this->cached_head > this->mask) {
+                // Looks full, so check where the consumer actually is
+                this->cached_head = this->head.load(std::memory_order_acquire);
+                if (index - this->cached_head > this->mask) { return false; }
+            }
+            return true;
+        }
+
+    public:
+        /* Constructor for the SpscRing class, which takes the number of elements it should have room for. This is rounded up to a power of two. */
+        SpscRing(size_t capacity) :
+            head(0),
+            cached_tail(0),
+            tail(0),
+            cached_head(0)
+        {
+            // Round the capacity up to a power of two, so the indices can be wrapped with a mask
+            size_t real_capacity = 1;
+            while (real_capacity < capacity) { real_capacity *= 2; }
+            this->mask = real_capacity - 1;
+
+            // Allocate the memory for the elements
+            this->elements = (T*) malloc(sizeof(T) * real_capacity);
+            if (this->elements == nullptr) { throw std::bad_alloc(); }
+        }
+        /* Copy constructor for the SpscRing class, which is deleted. */
+        SpscRing(const SpscRing& other) = delete;
+        /* Destructor for the SpscRing class, which destroys any elements that weren't popped. Neither thread may use the ring anymore. */
+        ~SpscRing() {
+            size_t stop = this->tail.load(std::memory_order_acquire);
+            for (size_t i = this->head.load(std::memory_order_relaxed); i != stop; i++) {
+                this->elements[i & this->mask].~T();
+            }
+            free(this->elements);
+        }
+
+        /* Adds a copy of the given element to the ring. Returns false if the ring is full, in which case nothing is added. Only the producer may call this. */
+        inline bool push(const T& elem) {
+            size_t index;
+            if (!this->reserve_slot(index)) { return false; }
+            new(this->elements + (index & this->mask)) T(elem);
+            this->tail.store(index + 1, std::memory_order_release);
+            return true;
+        }
+        /* Moves the given element into the ring. Returns false if the ring is full, in which case the element is left untouched. Only the producer may call this. */
+        inline bool push(T&& elem) {
+            size_t index;
+            if (!this->reserve_slot(index)) { return false; }
+            new(this->elements + (index & this->mask)) T(std::move(elem));
+            this->tail.store(index + 1, std::memory_order_release);
+            return true;
+        }
+
+        /* Moves the oldest element in the ring to the given one. Returns false if the ring is empty, in which case the given element is left untouched. Only the consumer may call this. */
+        inline bool pop(T& elem) {
+            size_t index = this->head.load(std::memory_order_relaxed);
+            if (index == this->cached_tail) {
+                // Looks empty, so check where the producer actually is
+                this->cached_tail = this->tail.load(std::memory_order_acquire);
+                if (index == this->cached_tail) { return false; }
+            }
+            T& slot = this->elements[index & this->mask];
+            elem = std::move(slot);
+            slot.~T();
+            this->head.store(index + 1, std::memory_order_release);
+            return true;
+        }
+
+        /* Returns true if there are no elements in the ring. Only reliable on the consumer, since the producer may push at any time. */
+        inline bool empty() const { return this->head.load(std::memory_order_relaxed) == this->tail.load(std::memory_order_acquire); }
+        /* Returns the number of elements the ring has room for. */
+        inline size_t capacity() const { return this->mask + 1; }
+
+        /* Copy assignment operator for the SpscRing class, which is deleted. */
+        SpscRing& operator=(const SpscRing& other) = delete;
+
+    };
+}
+
+#endif
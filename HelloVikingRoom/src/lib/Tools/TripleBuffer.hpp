@@ -0,0 +1,77 @@
+/* TRIPLE BUFFER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:24:45
+ * Last edited:
+ *   16/10/2026, 21:03:49
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the TripleBuffer class, which lets one thread hand snapshots
+ *   of its state to another without either of them waiting. There are
+ *   three copies of the state: one the producer writes, one the consumer
+ *   reads and one that is on its way between them. The copies are swapped
+ *   by index through a single atomic, which also carries a bit that tells
+ *   whether the one in between is newer than what the consumer has.
+**/
+
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <cstdint>
+#include <atomic>
+
+namespace Tools {
+    /* The TripleBuffer class, which passes snapshots of a T from a single producer thread to a single consumer thread. write_buffer() and publish() may only be called by the producer, and latest() only by the consumer. */
+    template <class T>
+    class TripleBuffer {
+    private:
+        /* Set in pending if the slot it refers to was published after the consumer last took one. */
+        static constexpr uint32_t fresh_bit = 0x4;
+
+        /* The three copies of the state. */
+        T slots[3];
+        /* The slot that is on its way between the threads, plus the fresh_bit if the consumer hasn't seen it yet. */
+        std::atomic<uint32_t> pending;
+        /* The slot the producer writes to. Only used by the producer. */
+        uint32_t write_slot;
+        /* The slot the consumer reads from. Only used by the consumer. */
+        uint32_t read_slot;
+
+    public:
+        /* Constructor for the TripleBuffer class, which takes the state the consumer sees until the first snapshot is published. */
+        TripleBuffer(const T& initial = T()) :
+            slots{ initial, initial, initial },
+            pending(1),
+            write_slot(0),
+            read_slot(2)
+        {}
+        /* Copy constructor for the TripleBuffer class, which is deleted. */
+        TripleBuffer(const TripleBuffer& other) = delete;
+
+        /* Returns the snapshot the producer should write to. It contains an older snapshot, so it has to be overwritten completely. */
+        inline T& write_buffer() { return this->slots[this->write_slot]; }
+        /* Hands the written snapshot to the consumer. If the consumer hasn't picked up the previous one yet, that one is replaced, so the consumer always gets the newest. */
+        inline void publish() {
+            // Releases our writes to the consumer, and acquires its reads of whatever slot we get back before we write to it
+            this->write_slot = this->pending.exchange(this->write_slot | TripleBuffer::fresh_bit, std::memory_order_acq_rel) & ~TripleBuffer::fresh_bit;
+        }
+
+        /* Returns the most recently published snapshot. It stays valid until the next call. */
+        inline const T& latest() {
+            // Only swap if there's something new, since otherwise we'd get an older snapshot back. The producer can only make it newer in the meantime
+            if (this->pending.load(std::memory_order_relaxed) & TripleBuffer::fresh_bit) {
+                this->read_slot = this->pending.exchange(this->read_slot, std::memory_order_acq_rel) & ~TripleBuffer::fresh_bit;
+            }
+            return this->slots[this->read_slot];
+        }
+
+        /* Copy assignment operator for the TripleBuffer class, which is deleted. */
+        TripleBuffer& operator=(const TripleBuffer& other) = delete;
+
+    };
+}
+
+#endif
@@ -4,7 +4,7 @@
  * Created:
  *   13/01/2021, 14:32:34
  * Last edited:
- *   13/01/2021, 14:32:34
+ *   16/10/2026, 19:04:32
  * Auto updated?
  *   Yes
  *
@@ -41,8 +41,8 @@ VkVertexInputBindingDescription Vertex::getBindingDescription() {
     return binding_description;
 }
 /* Returns an attribute descriptor, which tells Vulkan what to do with each chunk read specified by the binding. */
-Tools::Array<VkVertexInputAttributeDescription> Vertex::getAttributeDescriptions() {
-    Array<VkVertexInputAttributeDescription> attribute_descriptions = { {}, {} };
+Tools::SmallArray<VkVertexInputAttributeDescription, 4> Vertex::getAttributeDescriptions() {
+    SmallArray<VkVertexInputAttributeDescription, 4> attribute_descriptions = { {}, {} };
     
     // We have two structs, one per input layer
     // First struct: we pass the position to the shader, so we take the first binding, the first location, tell it it are two 32 byte floats and tell it where we can find it in the struct
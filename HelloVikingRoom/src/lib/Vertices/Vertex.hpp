@@ -4,7 +4,7 @@
  * Created:
  *   13/01/2021, 14:32:39
  * Last edited:
- *   13/01/2021, 14:32:39
+ *   16/10/2026, 19:04:32
  * Auto updated?
  *   Yes
  *
@@ -19,7 +19,7 @@
 
 #define GLM_FORCE_RADIANS
 #include "glm/glm.hpp"
-#include "Tools/Array.hpp"
+#include "Tools/SmallArray.hpp"
 
 namespace HelloVikingRoom {
     /* The Vertex class, which defines how a single vertex looks like in our program. */
@@ -36,7 +36,7 @@ namespace HelloVikingRoom {
         /* Returns the binding descriptor, i.e., how we'll read memory. */
         static VkVertexInputBindingDescription getBindingDescription();
         /* Returns an attribute descriptor, which tells Vulkan what to do with each chunk read specified by the binding. */
-        static Tools::Array<VkVertexInputAttributeDescription> getAttributeDescriptions();
+        static Tools::SmallArray<VkVertexInputAttributeDescription, 4> getAttributeDescriptions();
     };
 }
 
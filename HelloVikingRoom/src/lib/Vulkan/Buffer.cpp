@@ -4,7 +4,7 @@
  * Created:
  *   14/01/2021, 15:55:44
  * Last edited:
- *   14/01/2021, 15:55:44
+ *   16/10/2026, 23:02:14
  * Auto updated?
  *   Yes
  *
@@ -13,12 +13,14 @@
  *   takes care of any memory management using standard C++ class
  *   functions.
  * 
- *   For now, we'll use individual VkAllocate-calls for each buffer, but for
- *   more serious projects, this should be changed to use an allocator that
- *   pools the allocates.
+ *   The memory itself is sub-allocated from larger blocks by the
+ *   MemoryAllocator, so buffers share VkDeviceMemory objects. Host-visible
+ *   buffers stay mapped for their entire lifetime.
 **/
 
 #include "Debug/Debug.hpp"
+#include "UploadManager.hpp"
+#include "DeletionQueue.hpp"
 #include "Buffer.hpp"
 
 using namespace std;
@@ -27,12 +29,14 @@ using namespace Debug::SeverityValues;
 
 
 /***** BUFFER CLASS *****/
-/* Constructor for the Buffer class, which takes the Device to bind the buffer to, the size of the buffer (in bytes), flags describing how the buffer will be used (for optimizations), flags that mark the requirements we have for the buffer and its memory and optionally create flags for the buffer. */
-Buffer::Buffer(const Device& device, VkDeviceSize n_bytes, VkBufferUsageFlags buffer_usage, VkMemoryPropertyFlags buffer_requirements, VkBufferCreateFlags buffer_flags) :
+/* Constructor for the Buffer class, which takes the MemoryAllocator to get the buffer's memory from (and thus the Device to bind the buffer to), the size of the buffer (in bytes), flags describing how the buffer will be used (for optimizations), flags that mark the requirements we have for the buffer and its memory and optionally create flags for the buffer. */
+Buffer::Buffer(MemoryAllocator& allocator, VkDeviceSize n_bytes, VkBufferUsageFlags buffer_usage, VkMemoryPropertyFlags buffer_requirements, VkBufferCreateFlags buffer_flags) :
     vk_mem_property_flags(buffer_requirements),
     vk_buffer_size(n_bytes),
     vk_usage_flags(buffer_usage),
-    device(device)
+    vk_queue_family(VK_QUEUE_FAMILY_IGNORED),
+    device(allocator.device),
+    allocator(allocator)
 {
     DENTER("Vulkan::Buffer::Buffer");
     DLOG(info, "Creating Vulkan buffer...");
@@ -62,22 +66,11 @@ Buffer::Buffer(const Device& device, VkDeviceSize n_bytes, VkBufferUsageFlags bu
     VkMemoryRequirements mem_requirements;
     vkGetBufferMemoryRequirements(this->device, this->vk_buffer, &mem_requirements);
 
-    // Prepare the create info
-    VkMemoryAllocateInfo allocate_info{};
-    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    // Tell it how many bytes to allocate (may differ from n_bytes)
-    allocate_info.allocationSize = mem_requirements.size;
-    // Use the static helper to find the correct memory type, and allocate on that
-    allocate_info.memoryTypeIndex = Buffer::get_memory_type(this->device, mem_requirements.memoryTypeBits, buffer_requirements);
-
-    // Use that struct to allocate the memory
-    if (vkAllocateMemory(this->device, &allocate_info, nullptr, &this->vk_memory) != VK_SUCCESS) {
-        DLOG(fatal, "Could not allocate memory for buffer.");
-    }
+    // Let the allocator find us a spot in one of its blocks (may be larger than n_bytes)
+    this->allocation = this->allocator.allocate(mem_requirements, buffer_requirements);
 
-    // With the memory allocated, bind it to the buffer
-    // Note that we'll use an offset for 0, since we're not sharing allocations
-    if (vkBindBufferMemory(this->device, this->vk_buffer, this->vk_memory, 0) != VK_SUCCESS) {
+    // With the memory allocated, bind it to the buffer at the offset the allocator gave us
+    if (vkBindBufferMemory(this->device, this->vk_buffer, this->allocation.memory, this->allocation.offset) != VK_SUCCESS) {
         DLOG(fatal, "Could not bind memory to buffer.");
     }
 
@@ -86,14 +79,16 @@ Buffer::Buffer(const Device& device, VkDeviceSize n_bytes, VkBufferUsageFlags bu
 
 /* Move constructor for the Buffer class. */
 Buffer::Buffer(Buffer&& other) :
-    vk_memory(other.vk_memory),
+    allocation(other.allocation),
     vk_mem_property_flags(other.vk_mem_property_flags),
     vk_buffer(other.vk_buffer),
     vk_buffer_size(other.vk_buffer_size),
     vk_usage_flags(other.vk_usage_flags),
-    device(other.device)
+    vk_queue_family(other.vk_queue_family),
+    device(other.device),
+    allocator(other.allocator)
 {
-    other.vk_memory = nullptr;
+    other.allocation.memory = nullptr;
     other.vk_buffer = nullptr;
 }
 
@@ -102,11 +97,20 @@ Buffer::~Buffer() {
     DENTER("Vulkan::Buffer::~Buffer");
     DLOG(info, "Cleaning Vulkan buffer...");
 
+    // If the device has a deletion queue, let that destroy the buffer once no frame in flight can use it anymore
+    DeletionQueue* deletion_queue = this->device.deletion_queue();
+    if (deletion_queue != nullptr) {
+        if (this->vk_buffer != nullptr) { deletion_queue->defer_buffer(this->vk_buffer); }
+        if (this->allocation.memory != nullptr) { deletion_queue->defer_memory(this->allocator, this->allocation); }
+        DRETURN;
+    }
+
+    // Otherwise, destroy it immediately
     if (this->vk_buffer != nullptr) {
         vkDestroyBuffer(this->device, this->vk_buffer, nullptr);
     }
-    if (this->vk_memory != nullptr) {
-        vkFreeMemory(this->device, this->vk_memory, nullptr);
+    if (this->allocation.memory != nullptr) {
+        this->allocator.free(this->allocation);
     }
 
     DLEAVE;
@@ -114,28 +118,8 @@ Buffer::~Buffer() {
 
 
 
-/* Returns the appropriate memory type based on the given requirements as stated by a VkBuffer and custom requirements. */
-uint32_t Buffer::get_memory_type(const Device& device, uint32_t type_filter, VkMemoryPropertyFlags properties) {
-    DENTER("Vulkan::Buffer::get_memory_type");
-
-    // Get the available memory in the internal device
-    VkPhysicalDeviceMemoryProperties memory_properties;
-    vkGetPhysicalDeviceMemoryProperties(device, &memory_properties);
-
-    // Try to find suitable memory (i.e., check if the device has enough memory bits(?) and if the required properties match)
-    for (uint32_t i = 0; i < memory_properties.memoryTypeCount; i++) {
-        if (type_filter & (1 << i) && (memory_properties.memoryTypes[i].propertyFlags & properties) == properties) {
-            DRETURN i;
-        }
-    }
-
-    // Didn't find any
-    DLOG(fatal, "Could not find suitable memory for buffer on selected device.");
-    DRETURN 0;
-}
-
-/* Copies one Buffer to the other. Both buffers must be on the same device, and the source buffer must have VK_BUFFER_USAGE_TRANSFER_SRC_BIT and the destination buffer VK_BUFFER_TRANSFER_DST_BIT. Additionally, the destination buffer must have at least as many bytes allocated as the source one. The final argument is the command pool where we'll create the temporary command buffer for the copy. */
-void Buffer::copy(Buffer& destination, const Buffer& source, CommandPool& command_pool) {
+/* Records a copy of one Buffer to the other in the given command buffer. Both buffers must be on the same device, and the source buffer must have VK_BUFFER_USAGE_TRANSFER_SRC_BIT and the destination buffer VK_BUFFER_TRANSFER_DST_BIT. Additionally, the destination buffer must have at least as many bytes allocated as the source one. */
+void Buffer::copy(Buffer& destination, const Buffer& source, VkCommandBuffer command_buffer) {
     DENTER("Vulkan::Buffer::copy");
 
     // First, check if the device, bits and size matches
@@ -152,24 +136,46 @@ void Buffer::copy(Buffer& destination, const Buffer& source, CommandPool& comman
     //     DLOG(fatal, "Destination buffer does not have the VK_BUFFER_USAGE_TRANSFER_SRC_BIT set.");
     // }
 
-    // Get a temporary command buffer
-    CommandBuffer command_buffer = command_pool.get_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
-    command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-
-    // Schedule the copy
+    // Schedule the copy; it's up to the caller to submit the command buffer
     VkBufferCopy copy_region{};
     copy_region.srcOffset = 0;
     copy_region.dstOffset = 0;
     copy_region.size = source.size();
     vkCmdCopyBuffer(command_buffer, source, destination, 1, &copy_region);
 
-    // Since that's all we wanna do, we're done here
-    command_buffer.end(destination.device.graphics_queue());
+    DLEAVE;
+}
+
+/* Records the transfer of the buffer from one queue family to another, after it's been written by a transfer. The release half is recorded in a command buffer of the source family and the acquire half in one of the destination family. The acquire command buffer has to be submitted after (and wait on) the release one. Afterwards, queue_family() returns the destination family. */
+void Buffer::transfer_ownership(uint32_t source_family, VkCommandBuffer release_buffer, uint32_t destination_family, VkCommandBuffer acquire_buffer) {
+    DENTER("Vulkan::Buffer::transfer_ownership");
+
+    // Both halves use the same barrier over the entire buffer, except for the access masks
+    VkBufferMemoryBarrier buffer_barrier{};
+    buffer_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    buffer_barrier.srcQueueFamilyIndex = source_family;
+    buffer_barrier.dstQueueFamilyIndex = destination_family;
+    buffer_barrier.buffer = this->vk_buffer;
+    buffer_barrier.offset = 0;
+    buffer_barrier.size = VK_WHOLE_SIZE;
+
+    // The release makes the transfer writes available, but doesn't need to wait for anything on the source queue after it
+    buffer_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    buffer_barrier.dstAccessMask = 0;
+    vkCmdPipelineBarrier(release_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &buffer_barrier, 0, nullptr);
+
+    // The acquire then makes them visible to whatever reads the buffer on the destination queue (the semaphore in between takes care of the ordering)
+    buffer_barrier.srcAccessMask = 0;
+    buffer_barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+    vkCmdPipelineBarrier(acquire_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 1, &buffer_barrier, 0, nullptr);
+
+    // The buffer belongs to the destination family once the acquire has run
+    this->vk_queue_family = destination_family;
 
     DLEAVE;
 }
 
-/* Populates the buffer directly, by mapping the appropriate device memory to host memory and then copying the data in the given array. Note that to do this, this array must have VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT set. */
+/* Populates the buffer directly, by copying the data in the given array to the buffer's mapped memory and marking it dirty. Note that to do this, this array must have VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT set, and that the write only reaches the device after the allocator's next flush(). */
 void Buffer::set(void* data, size_t n_bytes) {
     DENTER("Vulkan::Buffer::set");
 
@@ -182,52 +188,22 @@ void Buffer::set(void* data, size_t n_bytes) {
         DLOG(fatal, "Not enough memory in buffer to accept data of " + std::to_string(n_bytes) + " bytes (buffer has " + std::to_string(this->vk_buffer_size) + " bytes).");
     }
 
-    // If so, then set map the device memory in the buffer to host memory
-    void* mapped_memory;
-    if (vkMapMemory(this->device, this->vk_memory, 0, (VkDeviceSize) n_bytes, 0, &mapped_memory) != VK_SUCCESS) {
-        DLOG(fatal, "Could not map buffer memory to host memory.");
-    }
-
-    // Once mapped, copy the memory over
-    memcpy(mapped_memory, data, n_bytes);
-
-    // Next, flush the memory to the device if the cache is not coherent
-    if (!(this->vk_mem_property_flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
-        VkMappedMemoryRange memory_range{};
-        memory_range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-        // Set the mapped memory to flush
-        memory_range.memory = this->vk_memory;
-        // Set the offset for this memory (always 0, until we implemented an allocator)
-        memory_range.offset = 0;
-        // Set the size of this memory range
-        memory_range.size = n_bytes;
-
-        // Now flush the memory
-        if (vkFlushMappedMemoryRanges(this->device, 1, &memory_range) != VK_SUCCESS) {
-            DLOG(fatal, "Could not flush mapped memory region back to device.");
-        }
-    }
+    // The memory is already mapped by its block, so simply copy the memory over
+    memcpy(this->allocation.mapped, data, n_bytes);
 
-    // With that done, unmap the memory
-    vkUnmapMemory(this->device, this->vk_memory);
+    // Let the allocator know it has to flush this range (if the memory isn't coherent)
+    this->allocator.mark_dirty(this->allocation, 0, (VkDeviceSize) n_bytes);
 
     DLEAVE;
 }
 
-/* Populates the buffer through a temporary staging buffer. Note that this buffer is recommended to have the VK_USAGE_TRANSFER_DST_BIT set, but it's not necessary. */
-void Buffer::set_staging(void* data, size_t data_size, CommandPool& command_pool) {
+/* Populates the buffer through the staging ring of the given UploadManager. The copy is only recorded; it's executed once the manager submits its current batch. Note that this buffer should have the VK_USAGE_TRANSFER_DST_BIT set. */
+void Buffer::set_staging(void* data, size_t data_size, UploadManager& upload_manager) {
     DENTER("Vulkan::Buffer::set_staging");
 
-    // Create the staging buffer
-    Buffer staging_buffer(this->device, (VkDeviceSize) data_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    // Let the manager copy the data to its staging ring and record the copy to us
+    upload_manager.upload(*this, data, (VkDeviceSize) data_size);
 
-    // Populate it with the given data
-    staging_buffer.set(data, data_size);
-
-    // Use the copy call to move it to this buffer
-    Buffer::copy(*this, staging_buffer, command_pool);
-
-    // We're done (deallocation is done by RAII)
     DLEAVE;
 }
 
@@ -240,35 +216,11 @@ void Buffer::get(void* data) {
         DLOG(fatal, "Cannot read from buffer that is inaccessible by the host.");
     }
 
-    // Try to map the memory
-    void* mapped_memory;
-    if (vkMapMemory(this->device, this->vk_memory, 0, this->vk_buffer_size, 0, &mapped_memory) != VK_SUCCESS) {
-        DLOG(fatal, "Could not map buffer memory to host memory.");
-    }
-
-    // Force a write in the memory if the coherent bit is not set
-    // Next, flush the memory to the device if the cache is not coherent
-    if (!(this->vk_mem_property_flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
-        VkMappedMemoryRange memory_range{};
-        memory_range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-        // Set the mapped memory to flush
-        memory_range.memory = this->vk_memory;
-        // Set the offset for this memory (always 0, until we implemented an allocator)
-        memory_range.offset = 0;
-        // Set the size of this memory range
-        memory_range.size = this->vk_buffer_size;
-
-        // Now flush the memory
-        if (vkInvalidateMappedMemoryRanges(this->device, 1, &memory_range) != VK_SUCCESS) {
-            DLOG(fatal, "Could not invalidate mapped memory region.");
-        }
-    }
-
-    // Copy the memory back
-    memcpy(data, mapped_memory, (size_t) this->vk_buffer_size);
+    // Make the device's writes visible to us if the memory is not coherent
+    this->allocator.invalidate(this->allocation, 0, this->vk_buffer_size);
 
-    // With that done, unmap the memory again
-    vkUnmapMemory(this->device, this->vk_memory);
+    // Copy the memory back from where its block is mapped
+    memcpy(data, this->allocation.mapped, (size_t) this->vk_buffer_size);
 
     DLEAVE;
 }
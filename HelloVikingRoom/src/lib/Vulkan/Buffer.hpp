@@ -4,7 +4,7 @@
  * Created:
  *   14/01/2021, 15:55:48
  * Last edited:
- *   14/01/2021, 15:55:48
+ *   16/10/2026, 23:02:14
  * Auto updated?
  *   Yes
  *
@@ -13,9 +13,9 @@
  *   takes care of any memory management using standard C++ class
  *   functions.
  * 
- *   For now, we'll use individual VkAllocate-calls for each buffer, but for
- *   more serious projects, this should be changed to use an allocator that
- *   pools the allocates.
+ *   The memory itself is sub-allocated from larger blocks by the
+ *   MemoryAllocator, so buffers share VkDeviceMemory objects. Host-visible
+ *   buffers stay mapped for their entire lifetime.
 **/
 
 #ifndef VULKAN_BUFFER_HPP
@@ -25,13 +25,17 @@
 
 #include "Device.hpp"
 #include "CommandPool.hpp"
+#include "MemoryAllocator.hpp"
 
 namespace HelloVikingRoom::Vulkan {
+    /* The UploadManager class, which batches staging uploads to device-local buffers and images. */
+    class UploadManager;
+
     /* The Buffer class, which wraps a VkBuffer object and handles its memory. */
     class Buffer {
     private:
-        /* The VkDeviceMemory that is used to actually store the data. */
-        VkDeviceMemory vk_memory;
+        /* The piece of device memory that is used to actually store the data. */
+        MemoryAllocation allocation;
         /* The requirements set for the memory of this buffer. */
         VkMemoryPropertyFlags vk_mem_property_flags;
 
@@ -41,14 +45,18 @@ namespace HelloVikingRoom::Vulkan {
         VkDeviceSize vk_buffer_size;
         /* The usage flags set for this buffer. */
         VkBufferUsageFlags vk_usage_flags;;
+        /* The queue family that owns the buffer, or VK_QUEUE_FAMILY_IGNORED if it was never handed over to one. */
+        uint32_t vk_queue_family;
 
     public:
         /* The device where this buffer lives. */
         const Device& device;
+        /* The allocator where this buffer got its memory from. */
+        MemoryAllocator& allocator;
 
 
-        /* Constructor for the Buffer class, which takes the Device to bind the buffer to, the size of the buffer (in bytes), flags describing how the buffer will be used (for optimizations), flags that mark the requirements we have for the buffer and its memory and optionally create flags for the buffer. */
-        Buffer(const Device& device, VkDeviceSize n_bytes, VkBufferUsageFlags buffer_usage, VkMemoryPropertyFlags buffer_requirements, VkBufferCreateFlags buffer_flags = 0);
+        /* Constructor for the Buffer class, which takes the MemoryAllocator to get the buffer's memory from (and thus the Device to bind the buffer to), the size of the buffer (in bytes), flags describing how the buffer will be used (for optimizations), flags that mark the requirements we have for the buffer and its memory and optionally create flags for the buffer. */
+        Buffer(MemoryAllocator& allocator, VkDeviceSize n_bytes, VkBufferUsageFlags buffer_usage, VkMemoryPropertyFlags buffer_requirements, VkBufferCreateFlags buffer_flags = 0);
         /* Copy constructor for the Buffer class, which is deleted. */
         Buffer(const Buffer& other) = delete;
         /* Move constructor for the Buffer class. */
@@ -56,30 +64,38 @@ namespace HelloVikingRoom::Vulkan {
         /* Destructor for the Buffer class. */
         virtual ~Buffer();
 
-        /* Returns the appropriate memory type based on the given requirements as stated by a VkBuffer and custom requirements. */
-        static uint32_t get_memory_type(const Device& device, uint32_t type_filter, VkMemoryPropertyFlags properties);
-        /* Copies one Buffer to the other. Both buffers must be on the same device, and the source buffer must have VK_BUFFER_USAGE_TRANSFER_SRC_BIT and the destination buffer VK_BUFFER_TRANSFER_DST_BIT. Additionally, the destination buffer must have at least as many bytes allocated as the source one. The final argument is the command pool where we'll create the temporary command buffer for the copy. */
-        static void copy(Buffer& destination, const Buffer& source, CommandPool& command_pool);
+        /* Records a copy of one Buffer to the other in the given command buffer. Both buffers must be on the same device, and the source buffer must have VK_BUFFER_USAGE_TRANSFER_SRC_BIT and the destination buffer VK_BUFFER_TRANSFER_DST_BIT. Additionally, the destination buffer must have at least as many bytes allocated as the source one. */
+        static void copy(Buffer& destination, const Buffer& source, VkCommandBuffer command_buffer);
+        /* Records the transfer of the buffer from one queue family to another, after it's been written by a transfer. The release half is recorded in a command buffer of the source family and the acquire half in one of the destination family. The acquire command buffer has to be submitted after (and wait on) the release one. Afterwards, queue_family() returns the destination family. */
+        void transfer_ownership(uint32_t source_family, VkCommandBuffer release_buffer, uint32_t destination_family, VkCommandBuffer acquire_buffer);
 
-        /* Populates the buffer directly, by mapping the appropriate device memory to host memory and then copying the data in the given array. Note that to do this, this array must have VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT set. */
+        /* Populates the buffer directly, by copying the data in the given array to the buffer's mapped memory and marking it dirty. Note that to do this, this array must have VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT set, and that the write only reaches the device after the allocator's next flush(). */
         void set(void* data, size_t data_size);
-        /* Populates the buffer through a temporary staging buffer. Note that this buffer is recommended to have the VK_USAGE_TRANSFER_DST_BIT set, but it's not necessary. */
-        void set_staging(void* data, size_t data_size, CommandPool& command_pool);
+        /* Populates the buffer through the staging ring of the given UploadManager. The copy is only recorded; it's executed once the manager submits its current batch. Note that this buffer should have the VK_USAGE_TRANSFER_DST_BIT set. */
+        void set_staging(void* data, size_t data_size, UploadManager& upload_manager);
         /* Returns the contents of the buffer by copying it in the given void pointer. Note that the buffer has to have the VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT flag set, and that it's assumed that the given array is at least size() bytes long. */
         void get(void* data);
 
+        /* Returns a pointer to the buffer's mapped memory, interpreted as the given type and starting at the given offset (in bytes). Only valid for buffers with VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT; call mark_dirty() for whatever you write through it. */
+        template <class T>
+        inline T* data(VkDeviceSize offset = 0) const { return (T*) ((uint8_t*) this->allocation.mapped + offset); }
+        /* Marks the given range (in bytes, relative to the start of the buffer) as written, so that it's included in the allocator's next flush(). */
+        inline void mark_dirty(VkDeviceSize offset, VkDeviceSize n_bytes) { this->allocator.mark_dirty(this->allocation, offset, n_bytes); }
+
         /* Returns the size (in bytes) of this buffer. */
         inline VkDeviceSize size() const { return this->vk_buffer_size; }
-        /* Returns the offset of the buffer. For now, is always 0, but will be useful when we implement our own allocator. */
-        inline VkDeviceSize offset() const { return 0; }
+        /* Returns the offset of the buffer within its VkDeviceMemory object. */
+        inline VkDeviceSize offset() const { return this->allocation.offset; }
 
         /* Returns the usage flags set for this buffer. */
         inline VkBufferUsageFlags usage() const { return this->vk_usage_flags; }
         /* Returns the properties set for the memory of this buffer. */
         inline VkMemoryPropertyFlags properties() const { return this->vk_mem_property_flags; }
+        /* Returns the queue family that owns the buffer, or VK_QUEUE_FAMILY_IGNORED if it was never handed over to one. */
+        inline uint32_t queue_family() const { return this->vk_queue_family; }
 
         /* Expliticly retrieves the VkDeviceMemory object that this class wraps. */
-        inline VkDeviceMemory memory() const { return this->vk_memory; }
+        inline VkDeviceMemory memory() const { return this->allocation.memory; }
         /* Expliticly retrieves the VkBuffer object that this class wraps. */
         inline VkBuffer buffer() const { return this->vk_buffer; }
         /* Implicitly casts this class to a VkBuffer, by returning the internal VkBuffer object that this class wraps. */
@@ -4,7 +4,7 @@
  * Created:
  *   14/01/2021, 17:01:05
  * Last edited:
- *   14/01/2021, 17:01:05
+ *   16/10/2026, 20:21:13
  * Auto updated?
  *   Yes
  *
@@ -16,6 +16,7 @@
 
 #include "Debug/Debug.hpp"
 #include "CommandPool.hpp"
+#include "DeletionQueue.hpp"
 
 using namespace std;
 using namespace HelloVikingRoom::Vulkan;
@@ -43,7 +44,13 @@ CommandBuffer::~CommandBuffer() {
     DLOG(info, "Deallocating command buffer...");
 
     if (this->vk_command_buffer != nullptr) {
-        vkFreeCommandBuffers(this->command_pool.device, this->command_pool, 1, &this->vk_command_buffer);
+        // Defer freeing it to the device's deletion queue if it has one, since a frame in flight may still execute it
+        DeletionQueue* deletion_queue = this->command_pool.device.deletion_queue();
+        if (deletion_queue != nullptr) {
+            deletion_queue->defer_command_buffer(this->command_pool, this->vk_command_buffer);
+        } else {
+            vkFreeCommandBuffers(this->command_pool.device, this->command_pool, 1, &this->vk_command_buffer);
+        }
     }
 
     DLEAVE;
@@ -68,6 +75,30 @@ void CommandBuffer::begin(VkCommandBufferUsageFlags flags) {
     DRETURN;
 }
 
+/* Begins recording a secondary command buffer that continues the given subpass of the given render pass on the given framebuffer. Optionally takes any flags to start the command buffer with, next to VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT. */
+void CommandBuffer::begin(VkRenderPass render_pass, uint32_t subpass, VkFramebuffer framebuffer, VkCommandBufferUsageFlags flags) {
+    DENTER("Vulkan::CommandBuffer::begin(secondary)");
+
+    // Tell it which render pass it's part of, since a secondary command buffer doesn't inherit that otherwise
+    VkCommandBufferInheritanceInfo inheritance_info{};
+    inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance_info.renderPass = render_pass;
+    inheritance_info.subpass = subpass;
+    // The framebuffer is optional, but knowing it may let the driver do a better job
+    inheritance_info.framebuffer = framebuffer;
+
+    // Start the record, marking that it's executed entirely within the render pass
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = flags | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    begin_info.pInheritanceInfo = &inheritance_info;
+    if (vkBeginCommandBuffer(this->vk_command_buffer, &begin_info) != VK_SUCCESS) {
+        DLOG(fatal, "Could not begin recording the secondary command buffer.");
+    }
+
+    DRETURN;
+}
+
 /* Stops recording the command buffer. */
 void CommandBuffer::end() {
     DENTER("Vulkan::CommandBuffer::end");
@@ -118,7 +149,7 @@ CommandPool::CommandPool(const Device& device, uint32_t queue_family, VkCommandP
     queue_family(queue_family)
 {
     DENTER("Vulkan::CommandPool::CommandPool");
-    DLOG(info, "Creating Vulkan command pool for queue " + std::to_string(queue_family) + "...");
+    DLOGF(info, "Creating Vulkan command pool for queue {}...", queue_family);
 
     // Start by creating the obvious create_info
     VkCommandPoolCreateInfo command_pool_info{};
@@ -148,7 +179,7 @@ CommandPool::CommandPool(CommandPool&& other) :
 /* Destructor for the CommandPool class. */
 CommandPool::~CommandPool() {
     DENTER("Vulkan::CommandPool::~CommandPool");
-    DLOG(info, "Cleaning Vulkan command pool for queue " + std::to_string(queue_family) + "...");
+    DLOGF(info, "Cleaning Vulkan command pool for queue {}...", queue_family);
 
     if (this->vk_command_pool != nullptr) {
         vkDestroyCommandPool(this->device, this->vk_command_pool, nullptr);
@@ -159,6 +190,19 @@ CommandPool::~CommandPool() {
 
 
 
+/* Resets all command buffers allocated from this pool at once, which is cheaper than resetting or freeing them one by one. The device must be done with all of them. Optionally takes flags to reset with, e.g., to return the pool's memory to the system. */
+void CommandPool::reset(VkCommandPoolResetFlags flags) {
+    DENTER("Vulkan::CommandPool::reset");
+
+    if (vkResetCommandPool(this->device, this->vk_command_pool, flags) != VK_SUCCESS) {
+        DLOGF(fatal, "Could not reset command pool for queue {}.", this->queue_family);
+    }
+
+    DRETURN;
+}
+
+
+
 /* Returns a new command buffer at the given level. */
 CommandBuffer CommandPool::get_buffer(VkCommandBufferLevel buffer_level) {
     DENTER("Vulkan::CommandPool::get_buffer");
@@ -187,7 +231,7 @@ CommandBuffer CommandPool::get_buffer(VkCommandBufferLevel buffer_level) {
 /* Returns N new command buffers at the given level. */
 Tools::Array<CommandBuffer> CommandPool::get_buffer(size_t N, VkCommandBufferLevel buffer_level) {
     DENTER("Vulkan::CommandPool::get_buffer(multiple)");
-    DLOG(info, "Allocating " + std::to_string(N) + " command buffers...");
+    DLOGF(info, "Allocating {} command buffers...", N);
 
     // Prepare a command buffer
     VkCommandBufferAllocateInfo alloc_info{};
@@ -4,7 +4,7 @@
  * Created:
  *   14/01/2021, 17:01:08
  * Last edited:
- *   14/01/2021, 17:01:08
+ *   16/10/2026, 20:21:13
  * Auto updated?
  *   Yes
  *
@@ -37,6 +37,8 @@ namespace HelloVikingRoom::Vulkan {
 
         /* Declare the CommandPool as friend. */
         friend class CommandPool;
+        /* Declare the FrameCommandAllocator as friend, so it can drop command buffers that its pools free as a whole. */
+        friend class FrameCommandAllocator;
     
     public:
         /* The CommandPool class where this buffer was created. */
@@ -51,6 +53,8 @@ namespace HelloVikingRoom::Vulkan {
 
         /* Begins recording the command buffer. Optionally takes any flags to start the command buffer with. */
         void begin(VkCommandBufferUsageFlags flags = 0);
+        /* Begins recording a secondary command buffer that continues the given subpass of the given render pass on the given framebuffer. Optionally takes any flags to start the command buffer with, next to VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT. */
+        void begin(VkRenderPass render_pass, uint32_t subpass, VkFramebuffer framebuffer, VkCommandBufferUsageFlags flags = 0);
         /* Stops recording the command buffer. */
         void end();
         /* Stops recording the command buffer and immediately submits it to the given VkQueue object. */
@@ -90,6 +94,8 @@ namespace HelloVikingRoom::Vulkan {
         CommandBuffer get_buffer(VkCommandBufferLevel buffer_level);
         /* Returns N new command buffers at the given level. */
         Tools::Array<CommandBuffer> get_buffer(size_t N, VkCommandBufferLevel buffer_level);
+        /* Resets all command buffers allocated from this pool at once, which is cheaper than resetting or freeing them one by one. The device must be done with all of them. Optionally takes flags to reset with, e.g., to return the pool's memory to the system. */
+        void reset(VkCommandPoolResetFlags flags = 0);
 
         /* Explicitly returns the internal VkCommandPool object. */
         inline VkCommandPool command_pool() const { return this->vk_command_pool; }
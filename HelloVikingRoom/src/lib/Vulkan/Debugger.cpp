@@ -4,14 +4,21 @@
  * Created:
  *   21/12/2020, 16:30:45
  * Last edited:
- *   21/12/2020, 16:30:45
+ *   16/10/2026, 18:42:59
  * Auto updated?
  *   Yes
  *
  * Description:
- *   Contains code that creates the Vulkan debugger information.
+ *   Contains code that creates the Vulkan debugger information. Repeated
+ *   validation messages are only counted, and printed once in a while
+ *   with how often they occurred since.
 **/
 
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <limits>
+
 #include "Vulkan/Debugger.hpp"
 
 using namespace std;
@@ -19,6 +26,153 @@ using namespace HelloVikingRoom;
 using namespace Debug::SeverityValues;
 
 
+/***** GLOBALS *****/
+/* The counts of the validation messages reported so far. */
+Vulkan::MessageTable Vulkan::Debugger::messages;
+
+
+
+
+
+/***** HELPER FUNCTIONS *****/
+/* Returns the current time of the steady clock in nanoseconds. */
+static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* Returns the FNV-1a hash of the given string. */
+static uint64_t hash_string(const char* value) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (; *value != '\0'; value++) {
+        hash = (hash ^ (uint8_t) *value) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/* Returns the key that identifies the given message in the MessageTable, which is never 0. */
+static uint64_t message_key(VkDebugUtilsMessageSeverityFlagBitsEXT message_severity, VkDebugUtilsMessageTypeFlagsEXT message_type, const VkDebugUtilsMessengerCallbackDataEXT* data) {
+    // The validation layers give each message an id that's already a hash of its name; for the messages without one, hash the name or the text ourselves
+    uint64_t hash;
+    if (data->messageIdNumber != 0) { hash = (uint32_t) data->messageIdNumber; }
+    else if (data->pMessageIdName != nullptr) { hash = hash_string(data->pMessageIdName); }
+    else { hash = data->pMessage != nullptr ? hash_string(data->pMessage) : 0; }
+
+    // The same id may come with another severity or type, so mix those in too, then spread the bits over the key
+    hash ^= ((uint64_t) message_severity << 40) ^ ((uint64_t) message_type << 56);
+    hash *= 0x9E3779B97F4A7C15ULL;
+    return hash != 0 ? hash : 1;
+}
+
+
+
+
+
+/***** MESSAGETABLE CLASS *****/
+/* Default constructor for the MessageTable class. */
+Vulkan::MessageTable::MessageTable() {
+    this->clear();
+}
+
+
+
+/* Counts an occurrence of the message with the given key (which may not be 0). Returns how many times it occurred since it was last printed if it should be printed now, or 0 if it shouldn't. The first occurrence returns 1 and sets first. */
+uint64_t Vulkan::MessageTable::count(uint64_t key, const char* name, const char* text, bool& first) {
+    first = false;
+
+    // Look for the message's slot, starting where its key says
+    size_t start = (size_t) (key % MessageTable::capacity);
+    for (size_t i = 0; i < MessageTable::capacity; i++) {
+        MessageSlot& slot = this->slots[(start + i) % MessageTable::capacity];
+        uint64_t slot_key = slot.key.load(std::memory_order_acquire);
+        if (slot_key == 0) {
+            // The message is new, so try to claim this slot. If another thread beats us to it, it may have claimed it for the same message
+            if (!slot.key.compare_exchange_strong(slot_key, key, std::memory_order_acq_rel)) {
+                if (slot_key != key) { continue; }
+            } else {
+                // Remember what the report needs
+                {
+                    std::unique_lock<std::mutex> _slot_lock(this->lock);
+                    slot.ready = true;
+                    slot.name = name != nullptr ? name : "";
+                    slot.text = text != nullptr ? text : "";
+                }
+
+                // Count it as printed, and only allow a summary after a while
+                slot.count.fetch_add(1, std::memory_order_relaxed);
+                slot.printed.store(1, std::memory_order_relaxed);
+                slot.next_summary.store(now_ns() + MessageTable::summary_interval, std::memory_order_release);
+                first = true;
+                return 1;
+            }
+        } else if (slot_key != key) {
+            continue;
+        }
+
+        // We've seen it before, so count it. Only one thread gets to print a summary once enough time has passed
+        uint64_t count = slot.count.fetch_add(1, std::memory_order_relaxed) + 1;
+        int64_t next = slot.next_summary.load(std::memory_order_acquire);
+        int64_t now = now_ns();
+        if (now < next || !slot.next_summary.compare_exchange_strong(next, now + MessageTable::summary_interval, std::memory_order_acq_rel)) {
+            return 0;
+        }
+        uint64_t printed = slot.printed.exchange(count, std::memory_order_relaxed);
+        return count > printed ? count - printed : 0;
+    }
+
+    // The table is full, so we can't tell whether it's a repeat; print it to be safe
+    first = true;
+    return 1;
+}
+
+/* Logs the given number of messages that occurred most often, with their counts. */
+void Vulkan::MessageTable::report(size_t n_messages) {
+    DENTER("Vulkan::MessageTable::report");
+
+    // Collect the slots that are in use
+    std::unique_lock<std::mutex> _report_lock(this->lock);
+    std::vector<const MessageSlot*> used;
+    uint64_t total = 0;
+    for (size_t i = 0; i < MessageTable::capacity; i++) {
+        if (this->slots[i].ready) {
+            used.push_back(&this->slots[i]);
+            total += this->slots[i].count.load(std::memory_order_relaxed);
+        }
+    }
+    if (used.empty()) { DRETURN; }
+
+    // Sort them by how often they occurred, and list the top ones
+    std::sort(used.begin(), used.end(), [](const MessageSlot* a, const MessageSlot* b) {
+        return a->count.load(std::memory_order_relaxed) > b->count.load(std::memory_order_relaxed);
+    });
+    n_messages = std::min(n_messages, used.size());
+    DLOGF(info, "{} validation message(s) were reported {} time(s) in total; the {} most frequent:", used.size(), total, n_messages);
+    for (size_t i = 0; i < n_messages; i++) {
+        const MessageSlot* slot = used[i];
+        DLOGF(auxillary, "{} x '{}': {}", slot->count.load(std::memory_order_relaxed), slot->name.empty() ? std::string("(unnamed)") : slot->name, slot->text.substr(0, 200));
+    }
+
+    DLEAVE;
+}
+
+/* Forgets all messages. Only safe while no messages are reported. */
+void Vulkan::MessageTable::clear() {
+    std::unique_lock<std::mutex> _clear_lock(this->lock);
+    for (size_t i = 0; i < MessageTable::capacity; i++) {
+        MessageSlot& slot = this->slots[i];
+        slot.key.store(0, std::memory_order_relaxed);
+        slot.count.store(0, std::memory_order_relaxed);
+        slot.printed.store(0, std::memory_order_relaxed);
+        slot.next_summary.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+        slot.ready = false;
+        slot.name.clear();
+        slot.text.clear();
+    }
+}
+
+
+
+
+
 /***** DEBUGGER CLASS *****/
 /* Constructor for the Debugger class, which takes an Instance class to bind the debugger to. */
 Vulkan::Debugger::Debugger(const Instance& instance) :
@@ -68,6 +222,8 @@ Vulkan::Debugger::~Debugger() {
 
     // Only destroy if not a nullptr
     if (this->vk_debugger != nullptr) {
+        // List what the validation layers complained about most before we stop listening
+        Debugger::messages.report(Debugger::n_reported);
         this->vkDestroyDebugUtilsMessengerEXT(this->instance, this->vk_debugger, nullptr);
     }
 
@@ -101,12 +257,18 @@ VKAPI_ATTR VkBool32 VKAPI_CALL Vulkan::Debugger::vk_callback(
             break;
     }
 
-    // Do not use the message type for now
-    (void) message_type;
+    // Count the message, and only print it the first time and in a summary once in a while; repeats only cost a lookup
+    bool first;
+    uint64_t n_repeats = Debugger::messages.count(message_key(message_severity, message_type, pCallbackData), pCallbackData->pMessageIdName, pCallbackData->pMessage, first);
+    if (n_repeats == 0) { return VK_FALSE; }
 
     // Log the message with the correct severity
     Debug::Debugger* debugger = (Debug::Debugger*) user_data;
-    debugger->log(severity, pCallbackData->pMessage);
+    if (first) {
+        debugger->log(severity, pCallbackData->pMessage);
+    } else {
+        debugger->logf(severity, "Validation message '{}' occurred {} more time(s) since it was last printed.", pCallbackData->pMessageIdName != nullptr ? pCallbackData->pMessageIdName : "(unnamed)", n_repeats);
+    }
     return VK_FALSE;
 }
 
@@ -4,25 +4,87 @@
  * Created:
  *   21/12/2020, 16:22:22
  * Last edited:
- *   21/12/2020, 16:22:22
+ *   16/10/2026, 18:42:59
  * Auto updated?
  *   Yes
  *
  * Description:
- *   Contains code that creates the Vulkan debugger information.
+ *   Contains code that creates the Vulkan debugger information. Repeated
+ *   validation messages are only counted, and printed once in a while
+ *   with how often they occurred since.
 **/
 
 #ifndef DEBUGGER_HPP
 #define DEBUGGER_HPP
 
 #include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <atomic>
+#include <mutex>
 
 #include "Vulkan/Instance.hpp"
 #include "Debug/Debug.hpp"
 
 namespace HelloVikingRoom::Vulkan {
+    /* Struct that counts how often a single validation message has been reported. */
+    struct MessageSlot {
+        /* The key of the message, or 0 if the slot is still free. */
+        std::atomic<uint64_t> key;
+        /* The number of times the message has been reported. */
+        std::atomic<uint64_t> count;
+        /* The count when the message was last printed. */
+        std::atomic<uint64_t> printed;
+        /* The time after which the next summary may be printed, in nanoseconds of the steady clock. */
+        std::atomic<int64_t> next_summary;
+        /* Whether the fields below have been filled in. Those are all guarded by the table's lock. */
+        bool ready;
+        /* The name of the message, e.g., its VUID. */
+        std::string name;
+        /* The text of the first occurrence of the message. */
+        std::string text;
+    };
+
+    /* The MessageTable class, which counts validation messages in a fixed-size table that can be updated from any thread without locking. */
+    class MessageTable {
+    public:
+        /* The number of different messages that are counted. Messages beyond that are always printed. */
+        static constexpr size_t capacity = 1024;
+        /* The minimum time between two summaries of the same message, in nanoseconds. */
+        static constexpr int64_t summary_interval = 5000000000LL;
+
+    private:
+        /* The slots themselves, which are found by linear probing from the key. */
+        MessageSlot slots[capacity];
+        /* Lock that guards filling in the name and text of a slot, and reading them in the report. */
+        std::mutex lock;
+
+    public:
+        /* Default constructor for the MessageTable class. */
+        MessageTable();
+        /* Copy constructor for the MessageTable class, which is deleted. */
+        MessageTable(const MessageTable& other) = delete;
+
+        /* Counts an occurrence of the message with the given key (which may not be 0). Returns how many times it occurred since it was last printed if it should be printed now, or 0 if it shouldn't. The first occurrence returns 1 and sets first. */
+        uint64_t count(uint64_t key, const char* name, const char* text, bool& first);
+        /* Logs the given number of messages that occurred most often, with their counts. */
+        void report(size_t n_messages);
+        /* Forgets all messages. Only safe while no messages are reported. */
+        void clear();
+    };
+
+
+
+
     /* Wraps the Debugger class of Vulkan. */
     class Debugger {
+    public:
+        /* The counts of the validation messages reported so far. Shared by all debuggers, since the messenger used while creating the instance has no Debugger of its own. */
+        static MessageTable messages;
+        /* The number of messages listed in the report when the debugger is destroyed. */
+        static constexpr size_t n_reported = 10;
+
     private:
         /* Vulkan's debug messenger that we're wrapping. */
         VkDebugUtilsMessengerEXT vk_debugger;
@@ -39,7 +101,7 @@ namespace HelloVikingRoom::Vulkan {
         Debugger(const Debugger& other) = delete;
         /* Move constructor for the Debugger class. */
         Debugger(Debugger&& other);
-        /* Destructor for the Debugger class. */
+        /* Destructor for the Debugger class, which reports the validation messages that occurred most often. */
         ~Debugger();
 
         /* Static callback function for Vulkan to call whenever it wants to log something. */
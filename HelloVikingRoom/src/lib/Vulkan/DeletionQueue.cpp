@@ -0,0 +1,257 @@
+/* DELETION QUEUE.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 17:33:36
+ * Last edited:
+ *   16/10/2026, 17:52:23
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the DeletionQueue class, which collects the Vulkan handles
+ *   of dropped wrappers and only destroys them once the device is done
+ *   with the frames that may still use them. Which frames are done is
+ *   derived from the frame-in-flight fences, so resources can be replaced
+ *   or freed at runtime without idling the device.
+**/
+
+#include "Debug/Debug.hpp"
+#include "DeletionQueue.hpp"
+
+using namespace std;
+using namespace HelloVikingRoom::Vulkan;
+using namespace Debug::SeverityValues;
+
+
+/***** DELETIONQUEUE CLASS *****/
+/* Constructor for the DeletionQueue class, which takes the device whose objects it destroys. Registers itself with the device, so that wrappers on it defer their destruction to this queue. */
+DeletionQueue::DeletionQueue(Device& device) :
+    current_frame(0),
+    device(device)
+{
+    DENTER("Vulkan::DeletionQueue::DeletionQueue");
+    DLOG(info, "Creating deferred deletion queue...");
+
+    // Make sure there is only one queue per device
+    if (this->device.deletion_queue() != nullptr) {
+        DLOG(fatal, "Device already has a deletion queue.");
+    }
+
+    // Register ourselves so the wrappers can find us
+    this->device.deferred_deletion = this;
+
+    DLEAVE;
+}
+
+/* Destructor for the DeletionQueue class. Waits until the device is idle, destroys everything that's left and unregisters itself from the device. */
+DeletionQueue::~DeletionQueue() {
+    DENTER("Vulkan::DeletionQueue::~DeletionQueue");
+    DLOG(info, "Cleaning deferred deletion queue...");
+
+    // Unregister first, so that any wrappers dropped from now on destroy their handles themselves
+    this->device.deferred_deletion = nullptr;
+
+    // If there's anything left, wait until the device can't use it anymore and destroy it
+    if (this->pending.size() > 0) {
+        this->device.wait_idle();
+        this->flush();
+    }
+
+    DLEAVE;
+}
+
+
+
+/* Destroys the given object immediately. */
+void DeletionQueue::destroy(DeferredDeletion& deletion) {
+    DENTER("Vulkan::DeletionQueue::destroy");
+
+    // Call the appropriate destroy function for the type
+    switch (deletion.type) {
+        case DeferredTypes::buffer:
+            vkDestroyBuffer(this->device, deletion.handle.buffer, nullptr);
+            break;
+        case DeferredTypes::image:
+            vkDestroyImage(this->device, deletion.handle.image, nullptr);
+            break;
+        case DeferredTypes::image_view:
+            vkDestroyImageView(this->device, deletion.handle.image_view, nullptr);
+            break;
+        case DeferredTypes::framebuffer:
+            vkDestroyFramebuffer(this->device, deletion.handle.framebuffer, nullptr);
+            break;
+        case DeferredTypes::command_buffer:
+            vkFreeCommandBuffers(this->device, deletion.command_pool, 1, &deletion.handle.command_buffer);
+            break;
+        case DeferredTypes::semaphore:
+            vkDestroySemaphore(this->device, deletion.handle.semaphore, nullptr);
+            break;
+        case DeferredTypes::swapchain:
+            vkDestroySwapchainKHR(this->device, deletion.handle.swapchain, nullptr);
+            break;
+        case DeferredTypes::render_pass:
+            vkDestroyRenderPass(this->device, deletion.handle.render_pass, nullptr);
+            break;
+        case DeferredTypes::pipeline:
+            vkDestroyPipeline(this->device, deletion.handle.pipeline, nullptr);
+            break;
+        case DeferredTypes::descriptor_pool:
+            vkDestroyDescriptorPool(this->device, deletion.handle.descriptor_pool, nullptr);
+            break;
+        case DeferredTypes::query_pool:
+            vkDestroyQueryPool(this->device, deletion.handle.query_pool, nullptr);
+            break;
+        case DeferredTypes::memory:
+            deletion.allocator->free(deletion.allocation);
+            break;
+    }
+
+    DRETURN;
+}
+
+/* Destroys all objects dropped in the given frame or before it. */
+void DeletionQueue::destroy_until(uint64_t frame) {
+    DENTER("Vulkan::DeletionQueue::destroy_until");
+
+    // The pending list is ordered by frame, so destroy from the start until we see a newer frame
+    size_t n_destroyed = 0;
+    while (n_destroyed < this->pending.size() && this->pending[n_destroyed].frame <= frame) {
+        this->destroy(this->pending[n_destroyed]);
+        ++n_destroyed;
+    }
+
+    // Remove them from the list in one go
+    if (n_destroyed > 0) {
+        this->pending.erase(0, n_destroyed - 1);
+    }
+
+    DRETURN;
+}
+
+/* Adds a new entry for the current frame of the given type to the pending list, and returns it. */
+DeferredDeletion& DeletionQueue::push(DeferredType type) {
+    DeferredDeletion deletion{};
+    deletion.frame = this->current_frame;
+    deletion.type = type;
+    this->pending.push_back(deletion);
+    return this->pending[this->pending.size() - 1];
+}
+
+
+
+/* Schedules the given VkBuffer for destruction. */
+void DeletionQueue::defer_buffer(VkBuffer buffer) {
+    this->push(DeferredTypes::buffer).handle.buffer = buffer;
+}
+
+/* Schedules the given VkImage for destruction. */
+void DeletionQueue::defer_image(VkImage image) {
+    this->push(DeferredTypes::image).handle.image = image;
+}
+
+/* Schedules the given VkImageView for destruction. */
+void DeletionQueue::defer_image_view(VkImageView image_view) {
+    this->push(DeferredTypes::image_view).handle.image_view = image_view;
+}
+
+/* Schedules the given VkFramebuffer for destruction. */
+void DeletionQueue::defer_framebuffer(VkFramebuffer framebuffer) {
+    this->push(DeferredTypes::framebuffer).handle.framebuffer = framebuffer;
+}
+
+/* Schedules the given VkCommandBuffer to be freed to the given pool. */
+void DeletionQueue::defer_command_buffer(VkCommandPool command_pool, VkCommandBuffer command_buffer) {
+    DeferredDeletion& deletion = this->push(DeferredTypes::command_buffer);
+    deletion.handle.command_buffer = command_buffer;
+    deletion.command_pool = command_pool;
+}
+
+/* Schedules the given VkSemaphore for destruction. */
+void DeletionQueue::defer_semaphore(VkSemaphore semaphore) {
+    this->push(DeferredTypes::semaphore).handle.semaphore = semaphore;
+}
+
+/* Schedules the given VkSwapchainKHR for destruction. */
+void DeletionQueue::defer_swapchain(VkSwapchainKHR swapchain) {
+    this->push(DeferredTypes::swapchain).handle.swapchain = swapchain;
+}
+
+/* Schedules the given VkRenderPass for destruction. */
+void DeletionQueue::defer_render_pass(VkRenderPass render_pass) {
+    this->push(DeferredTypes::render_pass).handle.render_pass = render_pass;
+}
+
+/* Schedules the given VkPipeline for destruction. */
+void DeletionQueue::defer_pipeline(VkPipeline pipeline) {
+    this->push(DeferredTypes::pipeline).handle.pipeline = pipeline;
+}
+
+/* Schedules the given VkDescriptorPool for destruction, which implicitly frees all sets allocated from it. */
+void DeletionQueue::defer_descriptor_pool(VkDescriptorPool descriptor_pool) {
+    this->push(DeferredTypes::descriptor_pool).handle.descriptor_pool = descriptor_pool;
+}
+
+/* Schedules the given VkQueryPool for destruction. */
+void DeletionQueue::defer_query_pool(VkQueryPool query_pool) {
+    this->push(DeferredTypes::query_pool).handle.query_pool = query_pool;
+}
+
+/* Schedules the given allocation to be returned to the given allocator. */
+void DeletionQueue::defer_memory(MemoryAllocator& allocator, const MemoryAllocation& allocation) {
+    DeferredDeletion& deletion = this->push(DeferredTypes::memory);
+    deletion.allocator = &allocator;
+    deletion.allocation = allocation;
+}
+
+
+
+/* Marks the end of the current frame, whose work has been submitted with the given fence. Everything dropped so far is destroyed once that fence has been signalled. */
+void DeletionQueue::end_frame(const Fence& fence) {
+    DENTER("Vulkan::DeletionQueue::end_frame");
+
+    // Remember which fence tells us this frame is done, then move to the next one
+    this->frames.push_back({ this->current_frame, &fence });
+    ++this->current_frame;
+
+    DRETURN;
+}
+
+/* Destroys everything that was dropped in frames that are done on the device. Doesn't wait; should be called once per frame, for example after waiting for a frame fence. */
+void DeletionQueue::collect() {
+    DENTER("Vulkan::DeletionQueue::collect");
+
+    // Find the newest frame whose fence is signalled. Frames on the same queue finish in order, so every frame before it is done too.
+    // Note that fences are reused by later frames; a reused fence is only signalled once that later frame is done, so at worst we destroy things a little later than possible
+    size_t n_done = 0;
+    for (size_t i = this->frames.size(); i > 0; i--) {
+        if (this->frames[i - 1].fence->signalled()) {
+            n_done = i;
+            break;
+        }
+    }
+
+    // Destroy everything dropped in those frames and forget about them
+    if (n_done > 0) {
+        this->destroy_until(this->frames[n_done - 1].frame);
+        this->frames.erase(0, n_done - 1);
+    }
+
+    DRETURN;
+}
+
+/* Destroys everything immediately. Only safe if the device is idle. */
+void DeletionQueue::flush() {
+    DENTER("Vulkan::DeletionQueue::flush");
+
+    // Destroy all pending objects, regardless of their frame
+    for (size_t i = 0; i < this->pending.size(); i++) {
+        this->destroy(this->pending[i]);
+    }
+
+    // Reset the lists, but keep their memory around
+    this->pending.wdata(0);
+    this->frames.wdata(0);
+
+    DRETURN;
+}
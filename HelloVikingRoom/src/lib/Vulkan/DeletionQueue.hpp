@@ -0,0 +1,168 @@
+/* DELETION QUEUE.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 17:33:36
+ * Last edited:
+ *   16/10/2026, 17:52:23
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the DeletionQueue class, which collects the Vulkan handles
+ *   of dropped wrappers and only destroys them once the device is done
+ *   with the frames that may still use them. Which frames are done is
+ *   derived from the frame-in-flight fences, so resources can be replaced
+ *   or freed at runtime without idling the device.
+**/
+
+#ifndef VULKAN_DELETION_QUEUE_HPP
+#define VULKAN_DELETION_QUEUE_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+#include "Vulkan/Device.hpp"
+#include "Vulkan/MemoryAllocator.hpp"
+#include "Vulkan/Fence.hpp"
+#include "Tools/Array.hpp"
+
+namespace HelloVikingRoom::Vulkan {
+    /* Enum that defines the kinds of objects the DeletionQueue can destroy. */
+    namespace DeferredTypes {
+        enum type {
+            /* A VkBuffer, destroyed with vkDestroyBuffer. */
+            buffer,
+            /* A VkImage, destroyed with vkDestroyImage. */
+            image,
+            /* A VkImageView, destroyed with vkDestroyImageView. */
+            image_view,
+            /* A VkFramebuffer, destroyed with vkDestroyFramebuffer. */
+            framebuffer,
+            /* A VkCommandBuffer, freed to its pool with vkFreeCommandBuffers. */
+            command_buffer,
+            /* A VkSemaphore, destroyed with vkDestroySemaphore. */
+            semaphore,
+            /* A VkSwapchainKHR, destroyed with vkDestroySwapchainKHR. */
+            swapchain,
+            /* A VkRenderPass, destroyed with vkDestroyRenderPass. */
+            render_pass,
+            /* A VkPipeline, destroyed with vkDestroyPipeline. */
+            pipeline,
+            /* A VkDescriptorPool, destroyed (with all its sets) with vkDestroyDescriptorPool. */
+            descriptor_pool,
+            /* A VkQueryPool, destroyed with vkDestroyQueryPool. */
+            query_pool,
+            /* A MemoryAllocation, returned to its MemoryAllocator. */
+            memory
+        };
+    }
+    using DeferredType = DeferredTypes::type;
+
+    /* Struct that describes a single object waiting to be destroyed. */
+    struct DeferredDeletion {
+        /* The frame during which the object was dropped. It's destroyed once that frame is done on the device. */
+        uint64_t frame;
+        /* The kind of object to destroy. */
+        DeferredType type;
+        /* The handle to destroy, depending on the type. */
+        union {
+            VkBuffer buffer;
+            VkImage image;
+            VkImageView image_view;
+            VkFramebuffer framebuffer;
+            VkCommandBuffer command_buffer;
+            VkSemaphore semaphore;
+            VkSwapchainKHR swapchain;
+            VkRenderPass render_pass;
+            VkPipeline pipeline;
+            VkDescriptorPool descriptor_pool;
+            VkQueryPool query_pool;
+        } handle;
+        /* The pool to free the command buffer to, if the type is command_buffer. */
+        VkCommandPool command_pool;
+        /* The allocator to return the allocation to, if the type is memory. */
+        MemoryAllocator* allocator;
+        /* The allocation to free, if the type is memory. */
+        MemoryAllocation allocation;
+    };
+
+    /* Struct that links a frame to the fence that signals its completion. */
+    struct DeletionFrame {
+        /* The number of the frame. */
+        uint64_t frame;
+        /* The fence that was submitted with the frame's work. */
+        const Fence* fence;
+    };
+
+    /* The DeletionQueue class, which destroys the handles of dropped Vulkan wrappers once the device is done with the frames that may use them. */
+    class DeletionQueue {
+    private:
+        /* The objects that are waiting to be destroyed, ordered by the frame they were dropped in. */
+        Tools::Array<DeferredDeletion> pending;
+        /* The frames that have been submitted but are not yet known to be done, oldest first. */
+        Tools::Array<DeletionFrame> frames;
+        /* The number of the frame that is currently being prepared. */
+        uint64_t current_frame;
+
+        /* Destroys the given object immediately. */
+        void destroy(DeferredDeletion& deletion);
+        /* Destroys all objects dropped in the given frame or before it. */
+        void destroy_until(uint64_t frame);
+        /* Adds a new entry for the current frame of the given type to the pending list, and returns it. */
+        DeferredDeletion& push(DeferredType type);
+
+    public:
+        /* The device whose objects are destroyed by this queue. */
+        Device& device;
+
+        /* Constructor for the DeletionQueue class, which takes the device whose objects it destroys. Registers itself with the device, so that wrappers on it defer their destruction to this queue. */
+        DeletionQueue(Device& device);
+        /* Copy constructor for the DeletionQueue class, which is deleted. */
+        DeletionQueue(const DeletionQueue& other) = delete;
+        /* Move constructor for the DeletionQueue class, which is deleted since the device refers to it. */
+        DeletionQueue(DeletionQueue&& other) = delete;
+        /* Destructor for the DeletionQueue class. Waits until the device is idle, destroys everything that's left and unregisters itself from the device. */
+        ~DeletionQueue();
+
+        /* Schedules the given VkBuffer for destruction. */
+        void defer_buffer(VkBuffer buffer);
+        /* Schedules the given VkImage for destruction. */
+        void defer_image(VkImage image);
+        /* Schedules the given VkImageView for destruction. */
+        void defer_image_view(VkImageView image_view);
+        /* Schedules the given VkFramebuffer for destruction. */
+        void defer_framebuffer(VkFramebuffer framebuffer);
+        /* Schedules the given VkCommandBuffer to be freed to the given pool. */
+        void defer_command_buffer(VkCommandPool command_pool, VkCommandBuffer command_buffer);
+        /* Schedules the given VkSemaphore for destruction. */
+        void defer_semaphore(VkSemaphore semaphore);
+        /* Schedules the given VkSwapchainKHR for destruction. */
+        void defer_swapchain(VkSwapchainKHR swapchain);
+        /* Schedules the given VkRenderPass for destruction. */
+        void defer_render_pass(VkRenderPass render_pass);
+        /* Schedules the given VkPipeline for destruction. */
+        void defer_pipeline(VkPipeline pipeline);
+        /* Schedules the given VkDescriptorPool for destruction, which implicitly frees all sets allocated from it. */
+        void defer_descriptor_pool(VkDescriptorPool descriptor_pool);
+        /* Schedules the given VkQueryPool for destruction. */
+        void defer_query_pool(VkQueryPool query_pool);
+        /* Schedules the given allocation to be returned to the given allocator. */
+        void defer_memory(MemoryAllocator& allocator, const MemoryAllocation& allocation);
+
+        /* Marks the end of the current frame, whose work has been submitted with the given fence. Everything dropped so far is destroyed once that fence has been signalled. */
+        void end_frame(const Fence& fence);
+        /* Destroys everything that was dropped in frames that are done on the device. Doesn't wait; should be called once per frame, for example after waiting for a frame fence. */
+        void collect();
+        /* Destroys everything immediately. Only safe if the device is idle. */
+        void flush();
+
+        /* Returns the number of the frame that is currently being prepared. */
+        inline uint64_t frame() const { return this->current_frame; }
+        /* Returns the number of objects waiting to be destroyed. */
+        inline size_t size() const { return this->pending.size(); }
+
+    };
+}
+
+#endif
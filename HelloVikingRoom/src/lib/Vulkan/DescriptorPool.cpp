@@ -4,7 +4,7 @@
  * Created:
  *   16/01/2021, 12:50:09
  * Last edited:
- *   16/01/2021, 12:50:09
+ *   16/10/2026, 17:38:08
  * Auto updated?
  *   Yes
  *
@@ -15,6 +15,7 @@
 
 #include "Debug/Debug.hpp"
 #include "DescriptorPool.hpp"
+#include "DeletionQueue.hpp"
 
 using namespace std;
 using namespace HelloVikingRoom::Vulkan;
@@ -49,14 +50,24 @@ DescriptorSetRef::~DescriptorSetRef() {}
 void DescriptorSetRef::set(const Buffer& buffer) {
     DENTER("Vulkan::DescriptorSetRef::set");
 
+    // Simply bind the entire buffer
+    this->set(buffer, 0, buffer.size());
+
+    DRETURN;
+}
+
+/* Binds this descriptor set to the given range (in bytes) of a (uniform) buffer. For dynamic descriptors, the offset given when binding the set is added to the offset here. */
+void DescriptorSetRef::set(const Buffer& buffer, VkDeviceSize offset, VkDeviceSize range) {
+    DENTER("Vulkan::DescriptorSetRef::set(range)");
+
     // Start by creating the buffer info s.t. the descriptor knows what is bound
     VkDescriptorBufferInfo buffer_info{};
     // Tell it which buffer to bind
     buffer_info.buffer = buffer;
-    // Tell it the offset in the buffer
-    buffer_info.offset = buffer.offset();
-    // Tell it which part of the buffer to copy; will likely be everything
-    buffer_info.range = buffer.size();
+    // Tell it the offset in the buffer. Note that this is relative to the buffer itself, not to the memory it's bound to
+    buffer_info.offset = offset;
+    // Tell it which part of the buffer to copy
+    buffer_info.range = range;
 
     // Update the descriptor using an VkWriteDescriptorSet. Can also be done using a VkCopyDescriptorSet to copy from one descriptor to another.
     VkWriteDescriptorSet write_info{};
@@ -68,7 +79,7 @@ void DescriptorSetRef::set(const Buffer& buffer) {
     // Set the element in the array; since we don't use that, it's a 0
     write_info.dstArrayElement = 0;
     // Specify how many sets and which type it has
-    write_info.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    write_info.descriptorType = this->pool.descriptor_type();
     write_info.descriptorCount = 1;
     // The data to pass. Can be of multiple types, but we want to update a buffer so we use that
     write_info.pBufferInfo = &buffer_info;
@@ -87,8 +98,8 @@ void DescriptorSetRef::set(const Buffer& buffer) {
 
 
 /***** DESCRIPTORPOOL CLASS *****/
-/* Constructor for the DescriptorPool class, which takes the device to create the pool on, the number of descriptors we want to allocate in the pool, the maximum number of descriptor sets that can be allocated and optionally create flags. */
-DescriptorPool::DescriptorPool(const Device& device, uint32_t n_descriptors, uint32_t n_sets, VkDescriptorPoolCreateFlags flags) :
+/* Constructor for the DescriptorPool class, which takes the device to create the pool on, the number of descriptors we want to allocate in the pool, the maximum number of descriptor sets that can be allocated, optionally the type of the descriptors and optionally create flags. */
+DescriptorPool::DescriptorPool(const Device& device, uint32_t n_descriptors, uint32_t n_sets, VkDescriptorType descriptor_type, VkDescriptorPoolCreateFlags flags) :
     vk_descriptor_pool(nullptr),
     vk_descriptor_sets(n_sets),
     device(device),
@@ -98,8 +109,8 @@ DescriptorPool::DescriptorPool(const Device& device, uint32_t n_descriptors, uin
     DENTER("Vulkan::DescriptorPool::DescriptorPool");
     DLOG(info, "Creating Vulkan descriptor pool...");
 
-    // Start by filling in the descriptor size struct for a uniform buffer
-    this->vk_descriptor_pool_size.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    // Start by filling in the descriptor size struct for the given type of (uniform) buffer
+    this->vk_descriptor_pool_size.type = descriptor_type;
 
     // Continue by filling in the create info
     this->vk_descriptor_pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
@@ -226,6 +237,14 @@ Tools::Array<DescriptorSetRef> DescriptorPool::get_descriptor(size_t N, const De
 void DescriptorPool::resize(uint32_t n_descriptors, uint32_t n_sets) {
     DENTER("Vulkan::DescriptorPool::resize");
 
+    // If the device has a deletion queue, let it destroy the old pool once frames in flight are done with its sets. That frees the sets as well.
+    DeletionQueue* deletion_queue = this->device.deletion_queue();
+    if (deletion_queue != nullptr && this->vk_descriptor_pool != nullptr) {
+        deletion_queue->defer_descriptor_pool(this->vk_descriptor_pool);
+        this->vk_descriptor_pool = nullptr;
+        this->vk_descriptor_sets.clear();
+    }
+
     // Destroy any existing sets
     if (this->vk_descriptor_sets.size() > 0) {
         if (vkFreeDescriptorSets(this->device, this->vk_descriptor_pool, static_cast<uint32_t>(this->vk_descriptor_sets.size()), this->vk_descriptor_sets.rdata()) != VK_SUCCESS) {
@@ -4,7 +4,7 @@
  * Created:
  *   16/01/2021, 12:50:01
  * Last edited:
- *   16/01/2021, 12:50:01
+ *   16/10/2026, 17:32:36
  * Auto updated?
  *   Yes
  *
@@ -52,6 +52,8 @@ namespace HelloVikingRoom::Vulkan {
 
         /* Binds this descriptor set to a given (uniform) buffer. */
         void set(const Buffer& buffer);
+        /* Binds this descriptor set to the given range (in bytes) of a (uniform) buffer. For dynamic descriptors, the offset given when binding the set is added to the offset here. */
+        void set(const Buffer& buffer, VkDeviceSize offset, VkDeviceSize range);
 
         /* Explicitly returns the internal VkDescriptorSet object. */
         inline const VkDescriptorSet& descriptor_set() const { return this->vk_descriptor_set; }
@@ -78,8 +80,8 @@ namespace HelloVikingRoom::Vulkan {
         /* The VkDescriptorPooLCreateInfo used to quickly resize the pool to a new amount of descriptors. */
         VkDescriptorPoolCreateInfo vk_descriptor_pool_info;
 
-        /* Constructor for the DescriptorPool class, which takes the device to create the pool on, the number of descriptors we want to allocate in the pool, the maximum number of descriptor sets that can be allocated and optionally create flags. */
-        DescriptorPool(const Device& device, uint32_t n_descriptors, uint32_t n_sets, VkDescriptorPoolCreateFlags flags = 0);
+        /* Constructor for the DescriptorPool class, which takes the device to create the pool on, the number of descriptors we want to allocate in the pool, the maximum number of descriptor sets that can be allocated, optionally the type of the descriptors and optionally create flags. */
+        DescriptorPool(const Device& device, uint32_t n_descriptors, uint32_t n_sets, VkDescriptorType descriptor_type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VkDescriptorPoolCreateFlags flags = 0);
         /* Copy constructor for the DescriptorPool class, which is deleted. */
         DescriptorPool(const DescriptorPool& other) = delete;
         /* Move constructor for the DescriptorPool class. */
@@ -95,6 +97,8 @@ namespace HelloVikingRoom::Vulkan {
         /* Resizes the pool to allow a new number of swapchain images. Note that this invalidates all existing descriptor set references. */
         void resize(uint32_t n_descriptors, uint32_t n_sets);
 
+        /* Returns the type of the descriptors allocated in this pool. */
+        inline VkDescriptorType descriptor_type() const { return this->vk_descriptor_pool_size.type; }
         /* Expliticly returns the internal VkDescriptorPool object. */
         inline const VkDescriptorPool& descriptor_pool() const { return this->vk_descriptor_pool; }
         /* Impliticly casts this class to a VkDescriptorPool by returning the internal object. */
@@ -4,7 +4,7 @@
  * Created:
  *   15/01/2021, 22:14:33
  * Last edited:
- *   15/01/2021, 22:14:33
+ *   16/10/2026, 17:32:36
  * Auto updated?
  *   Yes
  *
@@ -23,8 +23,9 @@ using namespace Debug::SeverityValues;
 
 
 /***** UNIFORMBUFFER CLASS *****/
-/* Constructor for the DescriptorSetLayout class, which takes a device to bind the buffer to and the shader stage where the uniform buffer will eventually be bound to. */
-DescriptorSetLayout::DescriptorSetLayout(const Device& device, VkShaderStageFlags shader_stage) :
+/* Constructor for the DescriptorSetLayout class, which takes a device to bind the buffer to, the shader stage where the uniform buffer will eventually be bound to and optionally the type of the descriptor (use VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC to pass the buffer offset when binding the set). */
+DescriptorSetLayout::DescriptorSetLayout(const Device& device, VkShaderStageFlags shader_stage, VkDescriptorType descriptor_type) :
+    vk_descriptor_type(descriptor_type),
     device(device)
 {
     DENTER("Vulkan::DescriptorSetLayout::DescriptorSetLayout");
@@ -35,7 +36,7 @@ DescriptorSetLayout::DescriptorSetLayout(const Device& device, VkShaderStageFlag
     // Set the index of the binding, must be equal to the place in the shader
     descriptor_set_binding.binding = 0;
     // Set the type of the descriptor
-    descriptor_set_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    descriptor_set_binding.descriptorType = this->vk_descriptor_type;
     // Set the number of descriptors to use
     descriptor_set_binding.descriptorCount = 1;
     // Set the stage flags
@@ -59,6 +60,7 @@ DescriptorSetLayout::DescriptorSetLayout(const Device& device, VkShaderStageFlag
 /* Move constructor for the DescriptorSetLayout class. */
 DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout&& other) :
     vk_descriptor_set_layout(other.vk_descriptor_set_layout),
+    vk_descriptor_type(other.vk_descriptor_type),
     device(other.device)
 {
     other.vk_descriptor_set_layout = nullptr;
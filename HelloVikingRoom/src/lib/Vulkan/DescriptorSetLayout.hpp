@@ -4,7 +4,7 @@
  * Created:
  *   15/01/2021, 22:14:37
  * Last edited:
- *   15/01/2021, 22:14:37
+ *   16/10/2026, 17:32:36
  * Auto updated?
  *   Yes
  *
@@ -27,13 +27,15 @@ namespace HelloVikingRoom::Vulkan {
     private:
         /* The descriptor used to tell Vulkan where and how to bind this buffer to a shader. */
         VkDescriptorSetLayout vk_descriptor_set_layout;
+        /* The type of the descriptor bound by this layout. */
+        VkDescriptorType vk_descriptor_type;
 
     public:
         /* The device to which this descriptor set layout is bound. */
         const Device& device;
 
-        /* Constructor for the DescriptorSetLayout class, which takes a device to bind the buffer to and the shader stage where the uniform buffer will eventually be bound to. */
-        DescriptorSetLayout(const Device& device, VkShaderStageFlags shader_stage);
+        /* Constructor for the DescriptorSetLayout class, which takes a device to bind the buffer to, the shader stage where the uniform buffer will eventually be bound to and optionally the type of the descriptor (use VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC to pass the buffer offset when binding the set). */
+        DescriptorSetLayout(const Device& device, VkShaderStageFlags shader_stage, VkDescriptorType descriptor_type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
         /* Copy constructor for the DescriptorSetLayout class, which is deleted. */
         DescriptorSetLayout(const DescriptorSetLayout& other) = delete;
         /* Move constructor for the DescriptorSetLayout class. */
@@ -41,6 +43,8 @@ namespace HelloVikingRoom::Vulkan {
         /* Destructor for the DescriptorSetLayout class. */
         virtual ~DescriptorSetLayout();
 
+        /* Returns the type of the descriptor bound by this layout. */
+        inline VkDescriptorType descriptor_type() const { return this->vk_descriptor_type; }
         /* Expliticly returns the internal VkDescriptorSetLayout object. */
         inline const VkDescriptorSetLayout& descriptor_set_layout() const { return this->vk_descriptor_set_layout; }
         /* Implicitly casts this class to a VkDescriptorSetLayout by returning the internal object. */
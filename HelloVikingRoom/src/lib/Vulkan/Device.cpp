@@ -4,7 +4,7 @@
  * Created:
  *   24/12/2020, 13:41:24
  * Last edited:
- *   24/12/2020, 13:41:24
+ *   16/10/2026, 21:10:25
  * Auto updated?
  *   Yes
  *
@@ -14,6 +14,7 @@
 
 #include "Vulkan/Device.hpp"
 #include "Tools/Array.hpp"
+#include "Tools/SmallArray.hpp"
 #include "Debug/Debug.hpp"
 
 using namespace std;
@@ -25,7 +26,9 @@ using namespace Debug::SeverityValues;
 /* Default constructor for the DeviceQueueInfo class, which takes a VkPhysicalDevice to derive which queues are supported or not. */
 DeviceQueueInfo::DeviceQueueInfo(const VkPhysicalDevice& physical_device, const VkSurfaceKHR& surface) :
     supports_graphics(false),
-    supports_presenting(false)
+    supports_presenting(false),
+    has_dedicated_transfer(false),
+    has_dedicated_compute(false)
 {
     DENTER("DeviceQueueInfo::DeviceQueueInfo");
 
@@ -43,10 +46,17 @@ DeviceQueueInfo::DeviceQueueInfo(const VkPhysicalDevice& physical_device, const
             this->graphics_index = (uint32_t) i;
         }
 
+        // Without a surface there is nothing to present to, so just let the graphics queue stand in for the presentation queue
+        if (surface == VK_NULL_HANDLE) {
+            this->supports_presenting = this->supports_graphics;
+            this->presenting_index = this->graphics_index;
+            continue;
+        }
+
         // Check if this queue supports presenting to the given surface
         VkBool32 supports_presenting = VK_FALSE;
         if (vkGetPhysicalDeviceSurfaceSupportKHR(physical_device, (uint32_t) i, surface, &supports_presenting) != VK_SUCCESS) {
-            DLOG(warning, "Could not get surface presenting support for queue " + std::to_string(i) + " of GPU");
+            DLOGF(warning, "Could not get surface presenting support for queue {} of GPU", i);
             this->supports_presenting = false;
         } else if (supports_presenting) {
             // It supports it
@@ -55,10 +65,54 @@ DeviceQueueInfo::DeviceQueueInfo(const VkPhysicalDevice& physical_device, const
         }
     }
 
+    // Without a graphics queue, the device won't be used anyway, so don't bother looking for the others
+    if (!this->supports_graphics) { DRETURN; }
+
+    // Next, look for queue families without graphics support that we can use for transfers and async compute
+    this->transfer_index = this->graphics_index;
+    this->compute_index = this->graphics_index;
+    for (size_t i = 0; i < supported_queues.size(); i++) {
+        VkQueueFlags flags = supported_queues[i].queueFlags;
+        if (flags & VK_QUEUE_GRAPHICS_BIT) { continue; }
+
+        // Any compute family will do for async compute
+        if ((flags & VK_QUEUE_COMPUTE_BIT) && !this->has_dedicated_compute) {
+            this->has_dedicated_compute = true;
+            this->compute_index = (uint32_t) i;
+        }
+
+        // For transfers, prefer a transfer-only family (usually the copy engine) over a compute family. Note that compute families can always transfer, even if they don't say so.
+        if (flags & (VK_QUEUE_TRANSFER_BIT | VK_QUEUE_COMPUTE_BIT)) {
+            bool transfer_only = !(flags & VK_QUEUE_COMPUTE_BIT);
+            if (!this->has_dedicated_transfer || (transfer_only && (supported_queues[this->transfer_index].queueFlags & VK_QUEUE_COMPUTE_BIT))) {
+                this->has_dedicated_transfer = true;
+                this->transfer_index = (uint32_t) i;
+            }
+        }
+    }
+
     // Done
     DLEAVE;
 }
 
+/* Returns a list of all unique indices stored in this class. */
+SmallArray<uint32_t, 4> DeviceQueueInfo::indices() const {
+    // Collect all indices, skipping those we've seen already
+    uint32_t all_indices[] = { this->graphics_index, this->presenting_index, this->transfer_index, this->compute_index };
+    SmallArray<uint32_t, 4> result;
+    for (size_t i = 0; i < 4; i++) {
+        bool seen = false;
+        for (size_t j = 0; j < result.size(); j++) {
+            if (result[j] == all_indices[i]) {
+                seen = true;
+                break;
+            }
+        }
+        if (!seen) { result.push_back(all_indices[i]); }
+    }
+    return result;
+}
+
 
 
 
@@ -68,6 +122,12 @@ DeviceQueueInfo::DeviceQueueInfo(const VkPhysicalDevice& physical_device, const
 DeviceSwapchainInfo::DeviceSwapchainInfo(const VkPhysicalDevice& physical_device, const VkSurfaceKHR& surface) {
     DENTER("DeviceSwapchainInfo::DeviceSwapchainInfo");
 
+    // If there is no surface, there is no swapchain to get the info of either
+    if (surface == VK_NULL_HANDLE) {
+        this->swapchain_capabalities = {};
+        DRETURN;
+    }
+
     // Get the capabilities of the GPU's swapchain first
     if (vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical_device, surface, &this->swapchain_capabalities) != VK_SUCCESS) {
         DLOG(warning, "Could not get swapchain capabilities of GPU");
@@ -110,7 +170,8 @@ DeviceSwapchainInfo::DeviceSwapchainInfo(const VkPhysicalDevice& physical_device
 
 /***** DEVICE CLASS *****/
 /* Constructor for the Device class, which takes a Vulkan Instance to bind the chosen GPU to. */
-Device::Device(const Instance& instance, const VkSurfaceKHR& surface, const Array<const char*>& device_extensions) :
+Device::Device(const Instance& instance, const VkSurfaceKHR& surface, const NameList& device_extensions) :
+    deferred_deletion(nullptr),
     instance(instance)
 {
     DENTER("Device::Device");
@@ -132,24 +193,27 @@ Device::Device(const Instance& instance, const VkSurfaceKHR& surface, const Arra
     // It's time to creating the logical device itself
     DLOG(info, "Creating logical device...");
 
-    // First, collect the queues that we want to use for this logical devices (but only keep unique indices)
-    Array<uint32_t> queues_indices = this->queue_info->indices();
-    if (queues_indices.at(0) == queues_indices.at(1)) { queues_indices.pop_back(); }
-    Array<VkDeviceQueueCreateInfo> queue_infos(queues_indices.size());
-    for (size_t i = 0; i < queue_infos.capacity(); i++) {
+    // First, collect the queues that we want to use for this logical devices (already unique)
+    SmallArray<uint32_t, 4> queues_indices = this->queue_info->indices();
+    SmallArray<VkDeviceQueueCreateInfo, 4> queue_infos;
+    // We given each queue the same priority (of 1). Note that this has to outlive the loop, since the create infos point to it
+    float priority = 1.0f;
+    for (size_t i = 0; i < queues_indices.size(); i++) {
         // Populate the create struct
         queue_infos.push_back({});
         queue_infos[i].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
         // Tell the struct we want one queue linked to our current queue family
         queue_infos[i].queueFamilyIndex = queues_indices[i];
         queue_infos[i].queueCount = 1;
-        // We given each queue in this create info the same priority (of 1)
-        float priority = 1.0f;
         queue_infos[i].pQueuePriorities = &priority;
     }
 
-    // Next, "create" the list features we want for the device (none for now)
+    // Next, "create" the list features we want for the device. We only want pipeline statistics queries for profiling, and only if the GPU has them
+    VkPhysicalDeviceFeatures supported_features;
+    vkGetPhysicalDeviceFeatures(this->vk_physical_device, &supported_features);
     VkPhysicalDeviceFeatures device_features{};
+    device_features.pipelineStatisticsQuery = supported_features.pipelineStatisticsQuery;
+    this->vk_enabled_features = device_features;
 
     // Use the queue indices and the features to populate the create info for the device itself
     VkDeviceCreateInfo device_info{};
@@ -168,9 +232,17 @@ Device::Device(const Instance& instance, const VkSurfaceKHR& surface, const Arra
         DLOG(fatal, "Could not create logical device");
     }
 
-    // Get the actual queues from the device and put them in the queue handles
-    vkGetDeviceQueue(this->vk_device, queues_indices[0], 0, &this->vk_graphics_queue);
-    vkGetDeviceQueue(this->vk_device, queues_indices[queues_indices.size() > 1 ? 1 : 0], 0, &this->vk_presentation_queue);
+    // Get the actual queues from the device and put them in the queue handles. Families that are shared simply yield the same queue
+    vkGetDeviceQueue(this->vk_device, this->queue_info->graphics(), 0, &this->vk_graphics_queue);
+    vkGetDeviceQueue(this->vk_device, this->queue_info->presentation(), 0, &this->vk_presentation_queue);
+    vkGetDeviceQueue(this->vk_device, this->queue_info->transfer(), 0, &this->vk_transfer_queue);
+    vkGetDeviceQueue(this->vk_device, this->queue_info->compute(), 0, &this->vk_compute_queue);
+    if (this->queue_info->dedicated_transfer()) {
+        DLOGF(auxillary, "Using dedicated transfer queue family {}", this->queue_info->transfer());
+    }
+    if (this->queue_info->dedicated_compute()) {
+        DLOGF(auxillary, "Using async compute queue family {}", this->queue_info->compute());
+    }
 
     // We're done!
     DLEAVE;
@@ -184,7 +256,11 @@ Device::Device(Device&& other) :
     swapchain_info(other.swapchain_info),
     vk_graphics_queue(other.vk_graphics_queue),
     vk_presentation_queue(other.vk_presentation_queue),
+    vk_transfer_queue(other.vk_transfer_queue),
+    vk_compute_queue(other.vk_compute_queue),
     gpu_name(other.gpu_name),
+    vk_enabled_features(other.vk_enabled_features),
+    deferred_deletion(other.deferred_deletion),
     instance(other.instance)
 {
     // Set the relevant vulkan structs to nullptr's in the other instance
@@ -209,7 +285,7 @@ Device::~Device() {
 
 
 /* Static function that determines whether or not a given GPU supports the given list of extensions. */
-bool Device::gpu_supports_extensions(const VkPhysicalDevice& physical_device, const Array<const char*>& device_extensions) {
+bool Device::gpu_supports_extensions(const VkPhysicalDevice& physical_device, const NameList& device_extensions) {
     DENTER("Device::gpu_supports_extensions");
 
     // Get a list of all extensions supported by the device
@@ -244,7 +320,7 @@ bool Device::gpu_supports_extensions(const VkPhysicalDevice& physical_device, co
 }
 
 /* Static function that determines when a GPU is suitable. */
-bool Device::is_suitable_gpu(const VkPhysicalDevice& physical_device, const VkSurfaceKHR& surface, const Array<const char*>& device_extensions) {
+bool Device::is_suitable_gpu(const VkPhysicalDevice& physical_device, const VkSurfaceKHR& surface, const NameList& device_extensions) {
     DENTER("Device::is_suitable_gpu");
 
     // First, get a list of supported extensions on this device
@@ -253,9 +329,9 @@ bool Device::is_suitable_gpu(const VkPhysicalDevice& physical_device, const VkSu
     // Next, check if the device supports the extensions we want it to support
     bool supports_extensions = Device::gpu_supports_extensions(physical_device, device_extensions);
 
-    // If it supports our desired extensions (i.e., the swapchain), check if the swapchain can write to the formats required by our surface
-    bool supports_swapchain = false;
-    if (supports_extensions) {
+    // If it supports our desired extensions (i.e., the swapchain), check if the swapchain can write to the formats required by our surface (if we have one)
+    bool supports_swapchain = surface == VK_NULL_HANDLE;
+    if (supports_extensions && surface != VK_NULL_HANDLE) {
         // Get the information for this swapchain
         DeviceSwapchainInfo swapchain_info(physical_device, surface);
         supports_swapchain = !swapchain_info.formats().empty() && !swapchain_info.present_modes().empty();
@@ -266,7 +342,7 @@ bool Device::is_suitable_gpu(const VkPhysicalDevice& physical_device, const VkSu
 }
 
 /* Static function that helps selecting the correct GPU. */
-VkPhysicalDevice Device::pick_gpu(const Instance& instance, const VkSurfaceKHR& surface, const Array<const char*>& device_extensions) {
+VkPhysicalDevice Device::pick_gpu(const Instance& instance, const VkSurfaceKHR& surface, const NameList& device_extensions) {
     DENTER("Device::pick_gpu");
     DLOG(auxillary, "Selecting GPU to use...");
 
@@ -300,15 +376,15 @@ VkPhysicalDevice Device::pick_gpu(const Instance& instance, const VkSurfaceKHR&
 
 
 
-/* Refreshes the internal DeviceQueueInfo and DeviceSwapchainInfo. */
-void Device::refresh_info(const MainWindow& window) {
+/* Refreshes the internal DeviceQueueInfo and DeviceSwapchainInfo for the given surface. Only queries Vulkan, so it may be called from any thread. */
+void Device::refresh_info(const VkSurfaceKHR& surface) {
     DENTER("Vulkan::Device::refresh_info");
 
     // Simply re-create the structs
     delete this->queue_info;
     delete this->swapchain_info;
-    this->queue_info = new DeviceQueueInfo(this->vk_physical_device, window.surface());
-    this->swapchain_info = new DeviceSwapchainInfo(this->vk_physical_device, window.surface());
+    this->queue_info = new DeviceQueueInfo(this->vk_physical_device, surface);
+    this->swapchain_info = new DeviceSwapchainInfo(this->vk_physical_device, surface);
 
     DRETURN;
 }
@@ -4,7 +4,7 @@
  * Created:
  *   24/12/2020, 13:37:09
  * Last edited:
- *   24/12/2020, 13:37:09
+ *   16/10/2026, 21:10:25
  * Auto updated?
  *   Yes
  *
@@ -20,6 +20,9 @@
 #include "Vulkan/Instance.hpp"
 
 namespace HelloVikingRoom::Vulkan {
+    /* Forward declaration of the DeletionQueue class, which defers the destruction of objects on this device. */
+    class DeletionQueue;
+
     /* Class that stores the queue family indices for a device. */
     class DeviceQueueInfo {
     private:
@@ -32,6 +35,16 @@ namespace HelloVikingRoom::Vulkan {
         uint32_t presenting_index;
         /* Boolean that keeps track of the whether or not the presentation queue is supported. */
         bool supports_presenting;
+
+        /* The index of the transfer queue family on a device. Equal to the graphics family if the device has no dedicated transfer family. */
+        uint32_t transfer_index;
+        /* Boolean that keeps track of whether the transfer family is a dedicated one (i.e., without graphics support) or not. */
+        bool has_dedicated_transfer;
+
+        /* The index of the compute queue family on a device. Equal to the graphics family if the device has no separate (async) compute family. */
+        uint32_t compute_index;
+        /* Boolean that keeps track of whether the compute family is a dedicated one (i.e., without graphics support) or not. */
+        bool has_dedicated_compute;
     
     public:
         /* Default constructor for the DeviceQueueInfo class, which takes a VkPhysicalDevice to derive which queues are supported or not and a surface to check if the device can present to it. */
@@ -41,8 +54,17 @@ namespace HelloVikingRoom::Vulkan {
         inline uint32_t graphics() const { return this->graphics_index; }
         /* Returns the index of the found presentation queue. Undefined behaviour for when the presentation queue is not supported. */
         inline uint32_t presentation() const { return this->presenting_index; }
-        /* Returns a list of all indices stored in this class. */
-        inline Array<uint32_t> indices() const { return Array<uint32_t>({ this->graphics_index, this->presenting_index }); }
+        /* Returns the index of the found transfer queue. Falls back to the graphics queue if there is no dedicated transfer family. */
+        inline uint32_t transfer() const { return this->transfer_index; }
+        /* Returns the index of the found compute queue. Falls back to the graphics queue if there is no dedicated compute family. */
+        inline uint32_t compute() const { return this->compute_index; }
+        /* Returns a list of all unique indices stored in this class. */
+        Tools::SmallArray<uint32_t, 4> indices() const;
+
+        /* Returns whether or not the device has a transfer family separate from the graphics family. */
+        inline bool dedicated_transfer() const { return this->has_dedicated_transfer; }
+        /* Returns whether or not the device has a compute family separate from the graphics family, i.e., supports async compute. */
+        inline bool dedicated_compute() const { return this->has_dedicated_compute; }
 
         /* Returns whether or not the graphics queue is supported or not. */
         inline bool graphics_supported() const { return this->supports_graphics; }
@@ -91,19 +113,31 @@ namespace HelloVikingRoom::Vulkan {
 
         /* Handle for the graphics queue of the device. */
         VkQueue vk_graphics_queue;
-        /* Handle for the graphics queue of the device. */
+        /* Handle for the presentation queue of the device. */
         VkQueue vk_presentation_queue;
+        /* Handle for the transfer queue of the device. Same as the graphics queue if there is no dedicated transfer family. */
+        VkQueue vk_transfer_queue;
+        /* Handle for the compute queue of the device. Same as the graphics queue if there is no dedicated compute family. */
+        VkQueue vk_compute_queue;
 
         /* String that stores the name of the selected GPU. */
         std::string gpu_name;
+        /* The optional features that were enabled on the logical device. */
+        VkPhysicalDeviceFeatures vk_enabled_features;
+
+        /* The queue that objects on this device defer their destruction to, or nullptr if they should be destroyed immediately. */
+        DeletionQueue* deferred_deletion;
+
+        /* Mark the DeletionQueue as friend, so it can register itself. */
+        friend class DeletionQueue;
 
     public:
         /* The Vulkan instance we wrap. */
         const Instance& instance;
 
         
-        /* Constructor for the Device class, which takes a Vulkan Instance to bind the chosen GPU to, a VkSurfaceKHR struct to check if GPUs can present to our surface and a list of extensions the device should support. */
-        Device(const Instance& instance, const VkSurfaceKHR& surface, const Array<const char*>& device_extensions);
+        /* Constructor for the Device class, which takes a Vulkan Instance to bind the chosen GPU to, a VkSurfaceKHR struct to check if GPUs can present to our surface (or VK_NULL_HANDLE to not present at all) and a list of extensions the device should support. */
+        Device(const Instance& instance, const VkSurfaceKHR& surface, const NameList& device_extensions);
         /* Copy constructor for the Device class, which is deleted, since we work with handles. */
         Device(const Device& other) = delete;
         /* Move constructor for the Device class. */
@@ -112,26 +146,35 @@ namespace HelloVikingRoom::Vulkan {
         ~Device();
         
         /* Static function that determines whether or not a given GPU supports the given list of extensions. */
-        static bool gpu_supports_extensions(const VkPhysicalDevice& physical_device, const Array<const char*>& device_extensions);
+        static bool gpu_supports_extensions(const VkPhysicalDevice& physical_device, const NameList& device_extensions);
         /* Static function that determines when a GPU is suitable. */
-        static bool is_suitable_gpu(const VkPhysicalDevice& physical_device, const VkSurfaceKHR& surface, const Array<const char*>& device_extensions);
+        static bool is_suitable_gpu(const VkPhysicalDevice& physical_device, const VkSurfaceKHR& surface, const NameList& device_extensions);
         /* Static function that helps selecting the correct GPU. */
-        static VkPhysicalDevice pick_gpu(const Instance& instance, const VkSurfaceKHR& surface, const Array<const char*>& device_extensions);
+        static VkPhysicalDevice pick_gpu(const Instance& instance, const VkSurfaceKHR& surface, const NameList& device_extensions);
 
-        /* Refreshes the internal DeviceQueueInfo and DeviceSwapchainInfo. */
-        void refresh_info(const MainWindow& window);
+        /* Refreshes the internal DeviceQueueInfo and DeviceSwapchainInfo for the given surface. Only queries Vulkan, so it may be called from any thread. */
+        void refresh_info(const VkSurfaceKHR& surface);
         /* Waits until the device is idle. */
         void wait_idle() const;
 
         /* Returns the name of the selected GPU. */
         inline std::string name() const { return this->gpu_name; }
+        /* Returns the optional features that were enabled on the logical device. */
+        inline const VkPhysicalDeviceFeatures& enabled_features() const { return this->vk_enabled_features; }
         /* Returns the queue indices of this Device. */
-        inline Array<uint32_t> indices() const { return this->queue_info->indices(); }
+        inline Tools::SmallArray<uint32_t, 4> indices() const { return this->queue_info->indices(); }
 
         /* Returns the handle for the graphics queue of the GPU. */
         inline const VkQueue& graphics_queue() const { return this->vk_graphics_queue; }
         /* Returns the handle for the presentation queue of the GPU. */
         inline const VkQueue& presentation_queue() const { return this->vk_presentation_queue; }
+        /* Returns the handle for the transfer queue of the GPU. This is the graphics queue if the GPU has no dedicated transfer family. */
+        inline const VkQueue& transfer_queue() const { return this->vk_transfer_queue; }
+        /* Returns the handle for the compute queue of the GPU. This is the graphics queue if the GPU has no dedicated compute family. */
+        inline const VkQueue& compute_queue() const { return this->vk_compute_queue; }
+
+        /* Returns the queue that objects on this device should defer their destruction to, or nullptr if they should destroy their handles immediately. */
+        inline DeletionQueue* deletion_queue() const { return this->deferred_deletion; }
 
         /* Returns a constant reference to the queue information of this device. */
         inline const DeviceQueueInfo& get_queue_info() const { return *this->queue_info; }
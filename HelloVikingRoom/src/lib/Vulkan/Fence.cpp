@@ -4,7 +4,7 @@
  * Created:
  *   15/01/2021, 14:55:36
  * Last edited:
- *   15/01/2021, 14:55:36
+ *   16/10/2026, 18:56:31
  * Auto updated?
  *   Yes
  *
@@ -48,7 +48,7 @@ Fence::Fence(const Device& device) :
 /* Move constructor for the Fence class. */
 Fence::Fence(Fence&& other) :
     vk_fence(other.vk_fence),
-    device(device)
+    device(other.device)
 {
     other.vk_fence = nullptr;
 }
@@ -86,3 +86,16 @@ void Fence::reset() {
 
     DRETURN;
 }
+
+/* Returns whether or not this fence has been reached, without waiting for it. */
+bool Fence::signalled() const {
+    DENTER("Vulkan::Fence::signalled");
+
+    // Query the status, which is VK_SUCCESS if signalled and VK_NOT_READY if not
+    VkResult status = vkGetFenceStatus(this->device, this->vk_fence);
+    if (status != VK_SUCCESS && status != VK_NOT_READY) {
+        DLOG(fatal, "Could not query fence status.");
+    }
+
+    DRETURN status == VK_SUCCESS;
+}
@@ -4,7 +4,7 @@
  * Created:
  *   15/01/2021, 14:55:42
  * Last edited:
- *   15/01/2021, 14:55:42
+ *   16/10/2026, 17:25:04
  * Auto updated?
  *   Yes
  *
@@ -45,6 +45,8 @@ namespace HelloVikingRoom::Vulkan {
         void wait();
         /* Resets this fence to its initial state. */
         void reset();
+        /* Returns whether or not this fence has been reached, without waiting for it. */
+        bool signalled() const;
 
         /* Expliticly returns the internal VkFence object. */
         inline const VkFence& fence() const { return this->vk_fence; }
@@ -0,0 +1,134 @@
+/* FRAME COMMAND ALLOCATOR.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 20:10:59
+ * Last edited:
+ *   16/10/2026, 20:21:13
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the FrameCommandAllocator class, which hands out command
+ *   buffers from one transient command pool per frame in flight. Instead
+ *   of freeing the command buffers one by one, a frame's pool is reset as a
+ *   whole once the device is done with it, after which its command
+ *   buffers are handed out again.
+**/
+
+#include "Debug/Debug.hpp"
+#include "FrameCommandAllocator.hpp"
+
+using namespace std;
+using namespace HelloVikingRoom::Vulkan;
+using namespace Debug::SeverityValues;
+
+
+/***** FRAMECOMMANDALLOCATOR CLASS *****/
+/* Constructor for the FrameCommandAllocator class, which takes the device to allocate on, the queue family the command buffers are submitted to and the number of frames in flight. Like any command pool, it should outlive the device's deletion queue. */
+FrameCommandAllocator::FrameCommandAllocator(const Device& device, uint32_t queue_family, uint32_t n_frames) :
+    current_frame(0),
+    device(device),
+    queue_family(queue_family)
+{
+    DENTER("Vulkan::FrameCommandAllocator::FrameCommandAllocator");
+    DLOGF(info, "Creating frame command allocator with {} frames for queue {}...", n_frames, queue_family);
+
+    // Create the pools
+    this->resize(n_frames);
+
+    DLEAVE;
+}
+
+/* Destructor for the FrameCommandAllocator class. */
+FrameCommandAllocator::~FrameCommandAllocator() {
+    DENTER("Vulkan::FrameCommandAllocator::~FrameCommandAllocator");
+    DLOG(info, "Cleaning frame command allocator...");
+
+    // The pools free their command buffers when they're destroyed, so only the wrappers have to go
+    for (size_t i = 0; i < this->buffers.size(); i++) {
+        this->release(this->buffers[i]);
+        delete this->command_pools[i];
+    }
+
+    DLEAVE;
+}
+
+
+
+/* Deletes the wrappers of the given frame's command buffers without freeing them one by one, since destroying or resetting the pool takes care of that. */
+void FrameCommandAllocator::release(FrameCommandBuffers& frame) {
+    for (size_t i = 0; i < frame.primaries.size(); i++) {
+        frame.primaries[i]->vk_command_buffer = nullptr;
+        delete frame.primaries[i];
+    }
+    for (size_t i = 0; i < frame.secondaries.size(); i++) {
+        frame.secondaries[i]->vk_command_buffer = nullptr;
+        delete frame.secondaries[i];
+    }
+    frame.primaries.clear();
+    frame.secondaries.clear();
+    frame.n_primaries = 0;
+    frame.n_secondaries = 0;
+}
+
+
+
+/* Starts handing out command buffers for the given frame, resetting its pool so that all of its command buffers are free again. The caller must make sure the device is done with them, e.g., by waiting for the frame's fence. */
+void FrameCommandAllocator::begin_frame(uint32_t frame) {
+    DENTER("Vulkan::FrameCommandAllocator::begin_frame");
+
+    // Reset all of the frame's command buffers in one go, but keep them allocated so we can hand them out again
+    FrameCommandBuffers& frame_buffers = this->buffers[frame];
+    if (frame_buffers.n_primaries > 0 || frame_buffers.n_secondaries > 0) {
+        this->command_pools[frame]->reset();
+    }
+    frame_buffers.n_primaries = 0;
+    frame_buffers.n_secondaries = 0;
+    this->current_frame = frame;
+
+    DRETURN;
+}
+
+/* Returns a command buffer at the given level for the current frame, reusing one from an earlier use of the frame if there is any. It's valid until the frame begins again, and has to be begun before it's recorded. */
+CommandBuffer& FrameCommandAllocator::allocate(VkCommandBufferLevel level) {
+    DENTER("Vulkan::FrameCommandAllocator::allocate");
+
+    // Take the next free one from the list of the right level, only allocating a new one if all of them are in use
+    FrameCommandBuffers& frame_buffers = this->buffers[this->current_frame];
+    bool primary = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    Tools::Array<CommandBuffer*>& command_buffers = primary ? frame_buffers.primaries : frame_buffers.secondaries;
+    size_t& n_used = primary ? frame_buffers.n_primaries : frame_buffers.n_secondaries;
+    if (n_used == command_buffers.size()) {
+        command_buffers.push_back(new CommandBuffer(this->command_pools[this->current_frame]->get_buffer(level)));
+    }
+
+    // Done
+    DRETURN *command_buffers[n_used++];
+}
+
+
+
+/* Changes the number of frames. The frames that are removed must not be in use by the device anymore. */
+void FrameCommandAllocator::resize(uint32_t n_frames) {
+    DENTER("Vulkan::FrameCommandAllocator::resize");
+
+    // Remove the frames we lose, together with their pools
+    while (this->buffers.size() > n_frames) {
+        this->release(this->buffers[this->buffers.size() - 1]);
+        this->buffers.pop_back();
+        delete this->command_pools[this->command_pools.size() - 1];
+        this->command_pools.pop_back();
+    }
+
+    // Add a transient pool for each new frame. It doesn't need to reset command buffers individually, since we only ever reset it as a whole
+    this->command_pools.reserve(n_frames);
+    this->buffers.reserve(n_frames);
+    while (this->buffers.size() < n_frames) {
+        this->command_pools.push_back(new CommandPool(this->device, this->queue_family, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT));
+        this->buffers.push_back(FrameCommandBuffers({ Tools::Array<CommandBuffer*>(), 0, Tools::Array<CommandBuffer*>(), 0 }));
+    }
+    if (this->current_frame >= n_frames) { this->current_frame = 0; }
+
+    DRETURN;
+}
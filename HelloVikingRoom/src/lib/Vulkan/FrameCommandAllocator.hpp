@@ -0,0 +1,87 @@
+/* FRAME COMMAND ALLOCATOR.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 20:10:59
+ * Last edited:
+ *   16/10/2026, 20:21:13
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the FrameCommandAllocator class, which hands out command
+ *   buffers from one transient command pool per frame in flight. Instead
+ *   of freeing the command buffers one by one, a frame's pool is reset as a
+ *   whole once the device is done with it, after which its command
+ *   buffers are handed out again.
+**/
+
+#ifndef VULKAN_FRAME_COMMAND_ALLOCATOR_HPP
+#define VULKAN_FRAME_COMMAND_ALLOCATOR_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+
+#include "Vulkan/Device.hpp"
+#include "Vulkan/CommandPool.hpp"
+#include "Tools/Array.hpp"
+
+namespace HelloVikingRoom::Vulkan {
+    /* Struct that holds the command buffers of a single frame. */
+    struct FrameCommandBuffers {
+        /* The primary command buffers allocated for this frame so far. */
+        Tools::Array<CommandBuffer*> primaries;
+        /* The number of primaries handed out since the frame began; the rest are free. */
+        size_t n_primaries;
+        /* The secondary command buffers allocated for this frame so far. */
+        Tools::Array<CommandBuffer*> secondaries;
+        /* The number of secondaries handed out since the frame began; the rest are free. */
+        size_t n_secondaries;
+    };
+
+    /* The FrameCommandAllocator class, which allocates command buffers from a transient pool per frame in flight and recycles them once that frame's pool is reset. */
+    class FrameCommandAllocator {
+    private:
+        /* One transient command pool per frame. They're allocated separately, since the command buffers refer to them and should stay valid when more frames are added. */
+        Tools::Array<CommandPool*> command_pools;
+        /* The command buffers of each frame. */
+        Tools::Array<FrameCommandBuffers> buffers;
+        /* The frame that command buffers are currently handed out for. */
+        uint32_t current_frame;
+
+        /* Deletes the wrappers of the given frame's command buffers without freeing them one by one, since destroying or resetting the pool takes care of that. */
+        void release(FrameCommandBuffers& frame);
+
+    public:
+        /* The device where the command buffers live. */
+        const Device& device;
+        /* The queue family the command buffers are submitted to. */
+        const uint32_t queue_family;
+
+        /* Constructor for the FrameCommandAllocator class, which takes the device to allocate on, the queue family the command buffers are submitted to and the number of frames in flight. Like any command pool, it should outlive the device's deletion queue. */
+        FrameCommandAllocator(const Device& device, uint32_t queue_family, uint32_t n_frames);
+        /* Copy constructor for the FrameCommandAllocator class, which is deleted. */
+        FrameCommandAllocator(const FrameCommandAllocator& other) = delete;
+        /* Move constructor for the FrameCommandAllocator class, which is deleted since handed out command buffers refer to its pools. */
+        FrameCommandAllocator(FrameCommandAllocator&& other) = delete;
+        /* Destructor for the FrameCommandAllocator class. */
+        ~FrameCommandAllocator();
+
+        /* Starts handing out command buffers for the given frame, resetting its pool so that all of its command buffers are free again. The caller must make sure the device is done with them, e.g., by waiting for the frame's fence. */
+        void begin_frame(uint32_t frame);
+        /* Returns a command buffer at the given level for the current frame, reusing one from an earlier use of the frame if there is any. It's valid until the frame begins again, and has to be begun before it's recorded. */
+        CommandBuffer& allocate(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+        /* Changes the number of frames. The frames that are removed must not be in use by the device anymore. */
+        void resize(uint32_t n_frames);
+
+        /* Returns the frame that command buffers are currently handed out for. */
+        inline uint32_t frame() const { return this->current_frame; }
+        /* Returns the number of frames. */
+        inline uint32_t frames() const { return static_cast<uint32_t>(this->buffers.size()); }
+
+    };
+}
+
+#endif
@@ -4,7 +4,7 @@
  * Created:
  *   13/01/2021, 15:21:41
  * Last edited:
- *   13/01/2021, 15:21:41
+ *   16/10/2026, 17:44:50
  * Auto updated?
  *   Yes
  *
@@ -16,6 +16,7 @@
 
 #include "Debug/Debug.hpp"
 #include "Framebuffer.hpp"
+#include "DeletionQueue.hpp"
 
 using namespace std;
 using namespace HelloVikingRoom::Vulkan;
@@ -25,6 +26,11 @@ using namespace Debug::SeverityValues;
 /***** FRAMEBUFFER CLASS *****/
 /* Constructor for the Framebuffer class, which takes a Device where the framebuffer lives, a Swapchain's ImageView to bind to, the extend of the Swapchain's ImageView and a RenderPass to bind the framebuffer to. */
 Framebuffer::Framebuffer(const Device& device, const VkImageView& image_view, const Swapchain& swapchain, const RenderPass& render_pass) :
+    Framebuffer(device, image_view, swapchain.extent(), render_pass)
+{}
+
+/* Constructor for the Framebuffer class, which takes a Device where the framebuffer lives, an ImageView to bind to, the extent of that ImageView and a RenderPass to bind the framebuffer to. Used to render to offscreen images instead of a swapchain. */
+Framebuffer::Framebuffer(const Device& device, const VkImageView& image_view, const VkExtent2D& extent, const RenderPass& render_pass) :
     vk_framebuffer(nullptr),
     device(device),
     create_info({})
@@ -38,7 +44,7 @@ Framebuffer::Framebuffer(const Device& device, const VkImageView& image_view, co
     this->create_info.layers = 1;
 
     // Use the regenerate function to actually create it
-    this->resize(image_view, swapchain, render_pass);
+    this->resize(image_view, extent, render_pass);
 
     DLEAVE;
 }
@@ -58,7 +64,13 @@ Framebuffer::~Framebuffer() {
     DLOG(info, "Cleaning Vulkan framebuffer...");
 
     if (this->vk_framebuffer != nullptr) {
-        vkDestroyFramebuffer(this->device, this->vk_framebuffer, nullptr);
+        // Defer the destruction to the device's deletion queue if it has one, so that frames in flight can still use it
+        DeletionQueue* deletion_queue = this->device.deletion_queue();
+        if (deletion_queue != nullptr) {
+            deletion_queue->defer_framebuffer(this->vk_framebuffer);
+        } else {
+            vkDestroyFramebuffer(this->device, this->vk_framebuffer, nullptr);
+        }
     }
 
     DLEAVE;
@@ -66,13 +78,18 @@ Framebuffer::~Framebuffer() {
 
 
 
-/* Regenerates the Framebuffer based on the internal create info. */
-void Framebuffer::resize(const VkImageView& image_view, const Swapchain& swapchain, const RenderPass& render_pass) {
+/* Regenerates the Framebuffer based on the internal create info, for an ImageView of the given extent. */
+void Framebuffer::resize(const VkImageView& image_view, const VkExtent2D& extent, const RenderPass& render_pass) {
     DENTER("Vulkan::Framebuffer::resize");
 
-    // Delete any pre-existing framebuffers
+    // Delete any pre-existing framebuffers, deferring it to the device's deletion queue if it has one
     if (this->vk_framebuffer != nullptr) {
-        vkDestroyFramebuffer(this->device, this->vk_framebuffer, nullptr);
+        DeletionQueue* deletion_queue = this->device.deletion_queue();
+        if (deletion_queue != nullptr) {
+            deletion_queue->defer_framebuffer(this->vk_framebuffer);
+        } else {
+            vkDestroyFramebuffer(this->device, this->vk_framebuffer, nullptr);
+        }
     }
 
     // Update the create info structs to incorporate the changes
@@ -82,8 +99,8 @@ void Framebuffer::resize(const VkImageView& image_view, const Swapchain& swapcha
     this->create_info.attachmentCount = 1;
     this->create_info.pAttachments = &image_view;
     // Specify the size of the framebuffer (i.e., the size of the imageviews)
-    this->create_info.width = swapchain.extent().width;
-    this->create_info.height = swapchain.extent().height;
+    this->create_info.width = extent.width;
+    this->create_info.height = extent.height;
 
     // Simply create it using our internal struct
     if (vkCreateFramebuffer(this->device, &this->create_info, nullptr, &this->vk_framebuffer) != VK_SUCCESS) {
@@ -4,7 +4,7 @@
  * Created:
  *   13/01/2021, 15:21:28
  * Last edited:
- *   13/01/2021, 15:21:28
+ *   16/10/2026, 17:44:50
  * Auto updated?
  *   Yes
  *
@@ -38,6 +38,8 @@ namespace HelloVikingRoom::Vulkan {
 
         /* Constructor for the Framebuffer class, which takes a Device where the framebuffer lives, a Swapchain's ImageView to bind to, the extend of the Swapchain's ImageView and a RenderPass to bind the framebuffer to. */
         Framebuffer(const Device& device, const VkImageView& image_view, const Swapchain& swapchain, const RenderPass& render_pass);
+        /* Constructor for the Framebuffer class, which takes a Device where the framebuffer lives, an ImageView to bind to, the extent of that ImageView and a RenderPass to bind the framebuffer to. Used to render to offscreen images instead of a swapchain. */
+        Framebuffer(const Device& device, const VkImageView& image_view, const VkExtent2D& extent, const RenderPass& render_pass);
         /* Copy constructor for the Framebuffer class, which is deleted. */
         Framebuffer(const Framebuffer& other) = delete;
         /* Move constructor for the Framebuffer class. */
@@ -45,8 +47,10 @@ namespace HelloVikingRoom::Vulkan {
         /* Destructor for the Framebuffer class. */
         ~Framebuffer();
 
-        /* Regenerates the Framebuffer based on the internal create info. */
-        void resize(const VkImageView& image_view, const Swapchain& swapchain, const RenderPass& render_pass);
+        /* Regenerates the Framebuffer based on the internal create info, for an ImageView of the given extent. */
+        void resize(const VkImageView& image_view, const VkExtent2D& extent, const RenderPass& render_pass);
+        /* Regenerates the Framebuffer based on the internal create info, for one of the given Swapchain's ImageViews. */
+        inline void resize(const VkImageView& image_view, const Swapchain& swapchain, const RenderPass& render_pass) { this->resize(image_view, swapchain.extent(), render_pass); }
 
         /* Expliticly returns the internal VkFramebuffer object. */
         inline VkFramebuffer framebuffer() const { return this->vk_framebuffer; }
@@ -0,0 +1,405 @@
+/* GPU PROFILER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 17:45:34
+ * Last edited:
+ *   16/10/2026, 23:31:45
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the GpuProfiler class, which measures how long named scopes
+ *   in command buffers take on the device. Each scope is wrapped in a pair
+ *   of timestamp queries and, where the device supports it, a pipeline
+ *   statistics query. Every frame in flight has its own range of queries,
+ *   which is only read back once that frame is known to be done, so
+ *   profiling never stalls the device; results simply arrive a few frames
+ *   late.
+**/
+
+#include "Debug/Debug.hpp"
+#include "Vulkan/DeletionQueue.hpp"
+#include "GpuProfiler.hpp"
+
+using namespace std;
+using namespace HelloVikingRoom::Vulkan;
+using namespace Debug::SeverityValues;
+
+
+/***** CONSTANTS *****/
+/* The pipeline statistics gathered per scope. The device writes them in the order of their bits, which matches GpuStatistics. */
+static const VkQueryPipelineStatisticFlags statistics_flags =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+/* The names of the statistics, as used in the CSV header. */
+static const char* statistics_names[GpuStatistics::count] = {
+    "input_vertices",
+    "input_primitives",
+    "vertex_invocations",
+    "clipping_primitives",
+    "fragment_invocations"
+};
+
+
+
+
+
+/***** GPUPROFILER CLASS *****/
+/* Constructor for the GpuProfiler class, which takes the device to profile, the queue family the profiled command buffers are submitted to, the number of frames that may be in flight at once (i.e., the number of command buffers that are recorded with profiling), the maximum number of scopes per frame and the number of results to keep for the rolling dumps. */
+GpuProfiler::GpuProfiler(const Device& device, uint32_t queue_family, uint32_t n_frames, uint32_t max_scopes, size_t history_size) :
+    vk_timestamp_pool(VK_NULL_HANDLE),
+    vk_statistics_pool(VK_NULL_HANDLE),
+    timestamp_period(1.0),
+    timestamp_mask(0),
+    max_scopes(max_scopes),
+    n_submitted(0),
+    history(history_size),
+    history_head(0),
+    device(device),
+    queue_family(queue_family)
+{
+    DENTER("Vulkan::GpuProfiler::GpuProfiler");
+    DLOG(info, "Creating GPU profiler...");
+
+    // Find out how many bits of the timestamps on the profiled queue family are valid. If none are, the queue can't do timestamps at all. The queries are reset on the device as well, which only graphics and compute queues can do, so treat transfer-only families as if they had no timestamps
+    uint32_t n_families = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(this->device, &n_families, nullptr);
+    Tools::Array<VkQueueFamilyProperties> families(n_families);
+    vkGetPhysicalDeviceQueueFamilyProperties(this->device, &n_families, families.wdata(n_families));
+    const VkQueueFamilyProperties& family = families[this->queue_family];
+    uint32_t timestamp_bits = (family.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) != 0 ? family.timestampValidBits : 0;
+    this->timestamp_mask = timestamp_bits >= 64 ? UINT64_MAX : (((uint64_t) 1 << timestamp_bits) - 1);
+    if (timestamp_bits == 0) {
+        DLOGF(warning, "Queue family {} does not support timestamps or resetting queries; GPU profiling is disabled for it.", this->queue_family);
+    }
+
+    // Get how long a tick takes
+    VkPhysicalDeviceProperties device_properties;
+    vkGetPhysicalDeviceProperties(this->device, &device_properties);
+    this->timestamp_period = (double) device_properties.limits.timestampPeriod;
+
+    // Create the slots and the pools, unless there's no point
+    if (timestamp_bits > 0) {
+        this->resize(n_frames);
+    }
+
+    DLEAVE;
+}
+
+/* Move constructor for the GpuProfiler class. */
+GpuProfiler::GpuProfiler(GpuProfiler&& other) :
+    vk_timestamp_pool(other.vk_timestamp_pool),
+    vk_statistics_pool(other.vk_statistics_pool),
+    timestamp_period(other.timestamp_period),
+    timestamp_mask(other.timestamp_mask),
+    slots(std::move(other.slots)),
+    max_scopes(other.max_scopes),
+    n_submitted(other.n_submitted),
+    latest_results(std::move(other.latest_results)),
+    history(std::move(other.history)),
+    history_head(other.history_head),
+    device(other.device),
+    queue_family(other.queue_family)
+{
+    other.vk_timestamp_pool = VK_NULL_HANDLE;
+    other.vk_statistics_pool = VK_NULL_HANDLE;
+}
+
+/* Destructor for the GpuProfiler class. */
+GpuProfiler::~GpuProfiler() {
+    DENTER("Vulkan::GpuProfiler::~GpuProfiler");
+    DLOG(info, "Cleaning GPU profiler...");
+
+    this->destroy_pools();
+
+    DLEAVE;
+}
+
+
+
+/* Creates the query pools for the current number of slots. */
+void GpuProfiler::create_pools() {
+    DENTER("Vulkan::GpuProfiler::create_pools");
+
+    // Create the timestamp pool, with two queries per scope per slot
+    VkQueryPoolCreateInfo timestamp_info{};
+    timestamp_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    timestamp_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    timestamp_info.queryCount = 2 * this->max_scopes * static_cast<uint32_t>(this->slots.size());
+    if (vkCreateQueryPool(this->device, &timestamp_info, nullptr, &this->vk_timestamp_pool) != VK_SUCCESS) {
+        DLOG(fatal, "Could not create timestamp query pool.");
+    }
+
+    // If the device can do pipeline statistics, also create a pool with one of those per scope per slot
+    if (this->device.enabled_features().pipelineStatisticsQuery) {
+        VkQueryPoolCreateInfo statistics_info{};
+        statistics_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        statistics_info.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        statistics_info.queryCount = this->max_scopes * static_cast<uint32_t>(this->slots.size());
+        statistics_info.pipelineStatistics = statistics_flags;
+        if (vkCreateQueryPool(this->device, &statistics_info, nullptr, &this->vk_statistics_pool) != VK_SUCCESS) {
+            DLOG(fatal, "Could not create pipeline statistics query pool.");
+        }
+    }
+
+    DRETURN;
+}
+
+/* Destroys the query pools, deferring them to the device's deletion queue if it has one. */
+void GpuProfiler::destroy_pools() {
+    DENTER("Vulkan::GpuProfiler::destroy_pools");
+
+    // Frames in flight may still write to the pools, so let the deletion queue destroy them if there is one
+    DeletionQueue* deletion_queue = this->device.deletion_queue();
+    VkQueryPool* pools[] = { &this->vk_timestamp_pool, &this->vk_statistics_pool };
+    for (size_t i = 0; i < 2; i++) {
+        if (*pools[i] == VK_NULL_HANDLE) { continue; }
+        if (deletion_queue != nullptr) {
+            deletion_queue->defer_query_pool(*pools[i]);
+        } else {
+            vkDestroyQueryPool(this->device, *pools[i], nullptr);
+        }
+        *pools[i] = VK_NULL_HANDLE;
+    }
+
+    DRETURN;
+}
+
+/* Adds the given result to the history, overwriting the oldest one if it's full. */
+void GpuProfiler::add_history(const GpuScopeResult& result) {
+    // Nothing to do if we keep no history
+    if (this->history.capacity() == 0) { return; }
+
+    // Append until the history is full, and overwrite the oldest result after that
+    if (this->history.size() < this->history.capacity()) {
+        this->history.push_back(result);
+    } else {
+        this->history[this->history_head] = result;
+    }
+    this->history_head = (this->history_head + 1) % this->history.capacity();
+}
+
+
+
+/* Records the reset of the given slot's queries in the given command buffer, and forgets its previous scopes. Has to be called at the start of every command buffer that is profiled, outside of any render pass. */
+void GpuProfiler::begin_frame(VkCommandBuffer command_buffer, uint32_t slot) {
+    DENTER("Vulkan::GpuProfiler::begin_frame");
+    if (!this->enabled()) { DRETURN; }
+
+    // Make sure the slot exists
+    if (slot >= this->slots.size()) {
+        DLOG(fatal, "Slot " + std::to_string(slot) + " is out of range for a GPU profiler with " + std::to_string(this->slots.size()) + " slots.");
+    }
+
+    // Forget the scopes recorded before; whatever was pending for them is lost
+    this->slots[slot].scopes.clear();
+    this->slots[slot].scopes.reserve(this->max_scopes);
+    this->slots[slot].pending = false;
+
+    // Reset the slot's queries, which has to happen on the device before they are written again
+    vkCmdResetQueryPool(command_buffer, this->vk_timestamp_pool, 2 * this->max_scopes * slot, 2 * this->max_scopes);
+    if (this->statistics_enabled()) {
+        vkCmdResetQueryPool(command_buffer, this->vk_statistics_pool, this->max_scopes * slot, this->max_scopes);
+    }
+
+    DRETURN;
+}
+
+/* Records the start of a scope with the given name in the given command buffer, and returns its index. If statistics is true and the device supports it, pipeline statistics are gathered for the scope too; those scopes may not be nested in each other, and have to end in the same subpass they began in. */
+uint32_t GpuProfiler::begin_scope(VkCommandBuffer command_buffer, uint32_t slot, const std::string& name, bool statistics) {
+    DENTER("Vulkan::GpuProfiler::begin_scope");
+    if (!this->enabled()) { DRETURN 0; }
+
+    // Make sure there's room for another scope
+    GpuProfilerSlot& profiler_slot = this->slots[slot];
+    if (profiler_slot.scopes.size() >= this->max_scopes) {
+        DLOG(fatal, "Cannot begin scope '" + name + "': already recorded the maximum of " + std::to_string(this->max_scopes) + " scopes in this frame.");
+    }
+
+    // Count in how many open scopes this one is nested, and make sure only one gathers statistics at a time, since only one query of a type may be active
+    uint32_t depth = 0;
+    statistics = statistics && this->statistics_enabled();
+    for (size_t i = 0; i < profiler_slot.scopes.size(); i++) {
+        if (profiler_slot.scopes[i].ended) { continue; }
+        ++depth;
+        if (statistics && profiler_slot.scopes[i].statistics) {
+            DLOG(fatal, "Cannot begin scope '" + name + "' with statistics inside scope '" + profiler_slot.scopes[i].name + "', which gathers statistics too.");
+        }
+    }
+
+    // Add the scope, and write its starting timestamp once the commands before it are done
+    uint32_t scope = static_cast<uint32_t>(profiler_slot.scopes.size());
+    profiler_slot.scopes.push_back({ name, depth, statistics, false });
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, this->vk_timestamp_pool, 2 * (this->max_scopes * slot + scope));
+    if (statistics) {
+        vkCmdBeginQuery(command_buffer, this->vk_statistics_pool, this->max_scopes * slot + scope, 0);
+    }
+
+    DRETURN scope;
+}
+
+/* Records the end of the given scope in the given command buffer. */
+void GpuProfiler::end_scope(VkCommandBuffer command_buffer, uint32_t slot, uint32_t scope) {
+    DENTER("Vulkan::GpuProfiler::end_scope");
+    if (!this->enabled()) { DRETURN; }
+
+    // Make sure the scope is open
+    GpuProfilerSlot& profiler_slot = this->slots[slot];
+    if (scope >= profiler_slot.scopes.size() || profiler_slot.scopes[scope].ended) {
+        DLOG(fatal, "Cannot end scope " + std::to_string(scope) + ", since it is not open.");
+    }
+
+    // Stop the statistics, and write the ending timestamp once the commands in the scope are done
+    if (profiler_slot.scopes[scope].statistics) {
+        vkCmdEndQuery(command_buffer, this->vk_statistics_pool, this->max_scopes * slot + scope);
+    }
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, this->vk_timestamp_pool, 2 * (this->max_scopes * slot + scope) + 1);
+    profiler_slot.scopes[scope].ended = true;
+
+    DRETURN;
+}
+
+
+
+/* Notes that the command buffer with the given slot's queries has been submitted. Its results may be collected once the device is done with it. */
+void GpuProfiler::submitted(uint32_t slot) {
+    DENTER("Vulkan::GpuProfiler::submitted");
+    if (!this->enabled()) { DRETURN; }
+
+    // If the previous results were never collected, they're overwritten now
+    if (this->slots[slot].pending) {
+        DLOGF(warning, "Results of GPU profiler slot {} were not collected before it was submitted again.", slot);
+    }
+
+    // Number the frame and mark that there are results coming
+    this->slots[slot].frame = this->n_submitted++;
+    this->slots[slot].pending = true;
+
+    DRETURN;
+}
+
+/* Reads back the results of the given slot if its last submission is done, without waiting. Returns whether there were new results, which are then available through latest(). */
+bool GpuProfiler::collect(uint32_t slot) {
+    DENTER("Vulkan::GpuProfiler::collect");
+    if (!this->enabled() || slot >= this->slots.size()) { DRETURN false; }
+
+    // Nothing to do if nothing has been submitted since the last time
+    GpuProfilerSlot& profiler_slot = this->slots[slot];
+    if (!profiler_slot.pending || profiler_slot.scopes.size() == 0) { DRETURN false; }
+    uint32_t n_scopes = static_cast<uint32_t>(profiler_slot.scopes.size());
+
+    // Try to get all timestamps of the slot in one go. We don't pass the wait bit, so if the frame isn't done yet we simply try again later
+    Tools::Array<uint64_t> timestamps(2 * n_scopes);
+    VkResult result = vkGetQueryPoolResults(this->device, this->vk_timestamp_pool, 2 * this->max_scopes * slot, 2 * n_scopes, 2 * n_scopes * sizeof(uint64_t), (void*) timestamps.wdata(2 * n_scopes), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result == VK_NOT_READY) {
+        DRETURN false;
+    } else if (result != VK_SUCCESS) {
+        DLOG(fatal, "Could not get timestamp query results.");
+    }
+
+    // Convert them to results, ticks to milliseconds. Collect them separately first, so that we can still bail out if the statistics aren't ready
+    Tools::Array<GpuScopeResult> results(n_scopes);
+    for (uint32_t i = 0; i < n_scopes; i++) {
+        const GpuScope& scope = profiler_slot.scopes[i];
+        GpuScopeResult scope_result{};
+        scope_result.name = scope.name;
+        scope_result.depth = scope.depth;
+        scope_result.frame = profiler_slot.frame;
+        scope_result.ms = (double) ((timestamps[2 * i + 1] - timestamps[2 * i]) & this->timestamp_mask) * this->timestamp_period / 1000000.0;
+
+        // Get the statistics of the scope if it gathered those. They're read per scope, since the queries of other scopes are never written and thus never available
+        scope_result.has_statistics = scope.statistics;
+        if (scope.statistics) {
+            result = vkGetQueryPoolResults(this->device, this->vk_statistics_pool, this->max_scopes * slot + i, 1, sizeof(scope_result.statistics), (void*) scope_result.statistics, sizeof(scope_result.statistics), VK_QUERY_RESULT_64_BIT);
+            if (result == VK_NOT_READY) {
+                DRETURN false;
+            } else if (result != VK_SUCCESS) {
+                DLOG(fatal, "Could not get pipeline statistics query results.");
+            }
+        }
+
+        results.push_back(scope_result);
+    }
+
+    // Store them both as the latest and in the history
+    for (size_t i = 0; i < results.size(); i++) {
+        this->add_history(results[i]);
+    }
+    this->latest_results = std::move(results);
+
+    // Done with this submission
+    profiler_slot.pending = false;
+    DRETURN true;
+}
+
+
+
+/* Re-creates the query pools for the given number of frames in flight. Anything not yet collected is lost, and all slots have to be recorded again. */
+void GpuProfiler::resize(uint32_t n_frames) {
+    DENTER("Vulkan::GpuProfiler::resize");
+    DLOGF(info, "Creating GPU profiler queries for {} frames of {} scopes...", n_frames, this->max_scopes);
+
+    // Throw away the old pools, if any
+    this->destroy_pools();
+
+    // Reset the slots
+    this->slots.clear();
+    this->slots.reserve(n_frames);
+    for (uint32_t i = 0; i < n_frames; i++) {
+        this->slots.push_back(GpuProfilerSlot{ Tools::Array<GpuScope>(), 0, false });
+    }
+
+    // Create the new pools
+    this->create_pools();
+
+    DRETURN;
+}
+
+
+
+/* Returns the average time of the scope with the given name over the results in the history, in milliseconds. Returns 0 if there are none. */
+double GpuProfiler::average(const std::string& name) const {
+    DENTER("Vulkan::GpuProfiler::average");
+
+    // Simply sum all matching results
+    double sum = 0.0;
+    size_t n_results = 0;
+    for (size_t i = 0; i < this->history.size(); i++) {
+        if (this->history[i].name == name) {
+            sum += this->history[i].ms;
+            ++n_results;
+        }
+    }
+
+    DRETURN n_results > 0 ? sum / (double) n_results : 0.0;
+}
+
+/* Writes the results in the history to the given stream as CSV, oldest first. */
+void GpuProfiler::write_csv(std::ostream& os) const {
+    DENTER("Vulkan::GpuProfiler::write_csv");
+
+    // Write the header first
+    os << "frame,scope,depth,ms";
+    for (size_t i = 0; i < GpuStatistics::count; i++) {
+        os << "," << statistics_names[i];
+    }
+    os << endl;
+
+    // If the history is full, the oldest result lives at the head; otherwise, it's simply the first
+    size_t start = this->history.size() < this->history.capacity() ? 0 : this->history_head;
+    for (size_t i = 0; i < this->history.size(); i++) {
+        const GpuScopeResult& result = this->history[(start + i) % this->history.size()];
+        os << result.frame << ",\"" << result.name << "\"," << result.depth << "," << result.ms;
+        for (size_t j = 0; j < GpuStatistics::count; j++) {
+            os << ",";
+            if (result.has_statistics) { os << result.statistics[j]; }
+        }
+        os << endl;
+    }
+
+    DRETURN;
+}
@@ -0,0 +1,171 @@
+/* GPU PROFILER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 17:45:34
+ * Last edited:
+ *   16/10/2026, 23:31:45
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the GpuProfiler class, which measures how long named scopes
+ *   in command buffers take on the device. Each scope is wrapped in a pair
+ *   of timestamp queries and, where the device supports it, a pipeline
+ *   statistics query. Every frame in flight has its own range of queries,
+ *   which is only read back once that frame is known to be done, so
+ *   profiling never stalls the device; results simply arrive a few frames
+ *   late.
+**/
+
+#ifndef VULKAN_GPU_PROFILER_HPP
+#define VULKAN_GPU_PROFILER_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <ostream>
+
+#include "Vulkan/Device.hpp"
+#include "Tools/Array.hpp"
+
+namespace HelloVikingRoom::Vulkan {
+    /* Enum that defines the pipeline statistics gathered for scopes that ask for them, in the order the device writes them. */
+    namespace GpuStatistics {
+        enum type {
+            /* The number of vertices read by the input assembler. */
+            input_vertices = 0,
+            /* The number of primitives read by the input assembler. */
+            input_primitives = 1,
+            /* The number of vertex shader invocations. */
+            vertex_invocations = 2,
+            /* The number of primitives that made it through clipping. */
+            clipping_primitives = 3,
+            /* The number of fragment shader invocations. */
+            fragment_invocations = 4,
+
+            /* The number of statistics gathered. */
+            count = 5
+        };
+    }
+    using GpuStatistic = GpuStatistics::type;
+
+    /* Struct that describes a scope as it was recorded in a command buffer. */
+    struct GpuScope {
+        /* The name of the scope. */
+        std::string name;
+        /* How many scopes this one is nested in. */
+        uint32_t depth;
+        /* Whether or not the scope gathers pipeline statistics. */
+        bool statistics;
+        /* Whether or not the scope has been ended. */
+        bool ended;
+    };
+
+    /* Struct that describes the measured cost of a single scope in a single frame. */
+    struct GpuScopeResult {
+        /* The name of the scope. */
+        std::string name;
+        /* How many scopes this one was nested in. */
+        uint32_t depth;
+        /* The number of the frame (i.e., the submission) that was measured. */
+        uint64_t frame;
+        /* The time the device spent between the start and the end of the scope, in milliseconds. */
+        double ms;
+        /* Whether or not the statistics below are valid. */
+        bool has_statistics;
+        /* The pipeline statistics of the scope, indexed by GpuStatistic. */
+        uint64_t statistics[GpuStatistics::count];
+    };
+
+    /* Struct that keeps track of the queries of a single frame in flight. */
+    struct GpuProfilerSlot {
+        /* The scopes recorded for this slot, in the order they were begun. Scope i uses timestamps 2i and 2i + 1 and statistics query i of the slot. */
+        Tools::Array<GpuScope> scopes;
+        /* The number of the frame that was last submitted with this slot's queries. */
+        uint64_t frame;
+        /* Whether or not the slot has been submitted but its results were not yet read back. */
+        bool pending;
+    };
+
+    /* The GpuProfiler class, which measures named scopes in command buffers with query pools and reads them back without stalling. */
+    class GpuProfiler {
+    private:
+        /* The query pool with the timestamps, two per scope. */
+        VkQueryPool vk_timestamp_pool;
+        /* The query pool with the pipeline statistics, one per scope. VK_NULL_HANDLE if the device doesn't support them. */
+        VkQueryPool vk_statistics_pool;
+        /* The number of nanoseconds per timestamp tick. */
+        double timestamp_period;
+        /* The mask with the valid bits of a timestamp. */
+        uint64_t timestamp_mask;
+
+        /* The state of each frame in flight. */
+        Tools::Array<GpuProfilerSlot> slots;
+        /* The maximum number of scopes per frame. */
+        uint32_t max_scopes;
+        /* The number of submissions so far, which is used to number the frames. */
+        uint64_t n_submitted;
+
+        /* The results of the most recently read back frame. */
+        Tools::Array<GpuScopeResult> latest_results;
+        /* Ring with the most recent results, for the rolling dumps. */
+        Tools::Array<GpuScopeResult> history;
+        /* The position in the history where the next result is written. */
+        size_t history_head;
+
+        /* Creates the query pools for the current number of slots. */
+        void create_pools();
+        /* Destroys the query pools, deferring them to the device's deletion queue if it has one. */
+        void destroy_pools();
+        /* Adds the given result to the history, overwriting the oldest one if it's full. */
+        void add_history(const GpuScopeResult& result);
+
+    public:
+        /* The device where the profiled command buffers run. */
+        const Device& device;
+        /* The queue family the profiled command buffers are submitted to. */
+        const uint32_t queue_family;
+
+        /* Constructor for the GpuProfiler class, which takes the device to profile, the queue family the profiled command buffers are submitted to, the number of frames that may be in flight at once (i.e., the number of command buffers that are recorded with profiling), the maximum number of scopes per frame and the number of results to keep for the rolling dumps. */
+        GpuProfiler(const Device& device, uint32_t queue_family, uint32_t n_frames, uint32_t max_scopes = 32, size_t history_size = 4096);
+        /* Copy constructor for the GpuProfiler class, which is deleted. */
+        GpuProfiler(const GpuProfiler& other) = delete;
+        /* Move constructor for the GpuProfiler class. */
+        GpuProfiler(GpuProfiler&& other);
+        /* Destructor for the GpuProfiler class. */
+        ~GpuProfiler();
+
+        /* Records the reset of the given slot's queries in the given command buffer, and forgets its previous scopes. Has to be called at the start of every command buffer that is profiled, outside of any render pass. */
+        void begin_frame(VkCommandBuffer command_buffer, uint32_t slot);
+        /* Records the start of a scope with the given name in the given command buffer, and returns its index. If statistics is true and the device supports it, pipeline statistics are gathered for the scope too; those scopes may not be nested in each other, and have to end in the same subpass they began in. */
+        uint32_t begin_scope(VkCommandBuffer command_buffer, uint32_t slot, const std::string& name, bool statistics = false);
+        /* Records the end of the given scope in the given command buffer. */
+        void end_scope(VkCommandBuffer command_buffer, uint32_t slot, uint32_t scope);
+
+        /* Notes that the command buffer with the given slot's queries has been submitted. Its results may be collected once the device is done with it. */
+        void submitted(uint32_t slot);
+        /* Reads back the results of the given slot if its last submission is done, without waiting. Returns whether there were new results, which are then available through latest(). */
+        bool collect(uint32_t slot);
+
+        /* Re-creates the query pools for the given number of frames in flight. Anything not yet collected is lost, and all slots have to be recorded again. */
+        void resize(uint32_t n_frames);
+
+        /* Returns the average time of the scope with the given name over the results in the history, in milliseconds. Returns 0 if there are none. */
+        double average(const std::string& name) const;
+        /* Writes the results in the history to the given stream as CSV, oldest first. */
+        void write_csv(std::ostream& os) const;
+
+        /* Returns whether or not the profiled queue family supports timestamps and resetting queries. If not, all profiling calls do nothing. */
+        inline bool enabled() const { return this->vk_timestamp_pool != VK_NULL_HANDLE; }
+        /* Returns whether or not the device supports pipeline statistics. */
+        inline bool statistics_enabled() const { return this->vk_statistics_pool != VK_NULL_HANDLE; }
+        /* Returns the number of frames in flight that have their own queries. */
+        inline uint32_t frames() const { return static_cast<uint32_t>(this->slots.size()); }
+        /* Returns the results of the most recently collected frame. */
+        inline const Tools::Array<GpuScopeResult>& latest() const { return this->latest_results; }
+
+    };
+}
+
+#endif
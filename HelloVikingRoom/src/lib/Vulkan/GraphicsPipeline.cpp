@@ -4,7 +4,7 @@
  * Created:
  *   13/01/2021, 13:32:15
  * Last edited:
- *   13/01/2021, 13:32:15
+ *   16/10/2026, 17:38:08
  * Auto updated?
  *   Yes
  *
@@ -28,11 +28,13 @@ using namespace Debug::SeverityValues;
 GraphicsPipeline::GraphicsPipeline(const Device& device) :
     vk_pipeline(nullptr),
     vk_pipeline_layout(nullptr),
+    vk_render_pass(nullptr),
     device(device),
     vk_vertex_input_binding({}),
     vk_vertex_input_state({}),
     vk_vertex_assembly_state({}),
     vk_viewport_state({}),
+    vk_dynamic_state({}),
     vk_rasterizer_state({}),
     vk_multisample_state({}),
     vk_color_blend_state({}),
@@ -43,6 +45,7 @@ GraphicsPipeline::GraphicsPipeline(const Device& device) :
 GraphicsPipeline::GraphicsPipeline(GraphicsPipeline&& other) :
     vk_pipeline(other.vk_pipeline),
     vk_pipeline_layout(other.vk_pipeline_layout),
+    vk_render_pass(other.vk_render_pass),
     device(other.device),
     vk_shaders(std::move(other.vk_shaders)),
     vk_shader_stages(other.vk_shader_stages),
@@ -53,6 +56,8 @@ GraphicsPipeline::GraphicsPipeline(GraphicsPipeline&& other) :
     vk_viewports(other.vk_viewports),
     vk_scissor_rects(other.vk_scissor_rects),
     vk_viewport_state(other.vk_viewport_state),
+    vk_dynamic_states(other.vk_dynamic_states),
+    vk_dynamic_state(other.vk_dynamic_state),
     vk_rasterizer_state(other.vk_rasterizer_state),
     vk_multisample_state(other.vk_multisample_state),
     vk_color_attachments(other.vk_color_attachments),
@@ -62,6 +67,9 @@ GraphicsPipeline::GraphicsPipeline(GraphicsPipeline&& other) :
     // Set the pipeline itself to nullptr to avoid destroying it
     other.vk_pipeline = nullptr;
     other.vk_pipeline_layout = nullptr;
+
+    // Point the dynamic state to our own copy of the list
+    this->vk_dynamic_state.pDynamicStates = this->vk_dynamic_states.rdata();
 }
 
 /* Destructor for the GraphicsPipeline class. */
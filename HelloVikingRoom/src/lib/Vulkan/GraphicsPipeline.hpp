@@ -4,7 +4,7 @@
  * Created:
  *   13/01/2021, 13:32:23
  * Last edited:
- *   13/01/2021, 13:32:23
+ *   16/10/2026, 19:04:32
  * Auto updated?
  *   Yes
  *
@@ -20,6 +20,7 @@
 #include <vulkan/vulkan.h>
 
 #include "Tools/Array.hpp"
+#include "Tools/SmallArray.hpp"
 #include "Device.hpp"
 #include "RenderPass.hpp"
 #include "ShaderModule.hpp"
@@ -32,6 +33,8 @@ namespace HelloVikingRoom::Vulkan {
         VkPipeline vk_pipeline;
         /* The internal VkPipelineLayout object that this class also happens to wrap. */
         VkPipelineLayout vk_pipeline_layout;
+        /* The render pass that the internal VkPipeline was created for. Used to skip re-creating the pipeline if a resize doesn't change it. */
+        VkRenderPass vk_render_pass;
     
     public:
         /* Constant reference to the device to which the graphics pipeline is bound. */
@@ -40,11 +43,11 @@ namespace HelloVikingRoom::Vulkan {
         /* Array of shader modules used by this pipeline. */
         Tools::Array<ShaderModule> vk_shaders;
         /* Array of create infos for the Shader stages of the pipeline. */
-        Tools::Array<VkPipelineShaderStageCreateInfo> vk_shader_stages;
+        Tools::SmallArray<VkPipelineShaderStageCreateInfo, 4> vk_shader_stages;
         /* Description of how Vulkan should pass a Vertex to the shaders. */
         VkVertexInputBindingDescription vk_vertex_input_binding;
         /* Array of structs that describe how to further handle a vertex from each buffer. */
-        Tools::Array<VkVertexInputAttributeDescription> vk_vertex_input_attributes;
+        Tools::SmallArray<VkVertexInputAttributeDescription, 4> vk_vertex_input_attributes;
         /* Description of the vertex format given to the pipeline. */
         VkPipelineVertexInputStateCreateInfo vk_vertex_input_state;
         /* Description of what to do with the vertices passed to the pipeline. */
@@ -55,6 +58,10 @@ namespace HelloVikingRoom::Vulkan {
         Tools::Array<VkRect2D> vk_scissor_rects;
         /* Description of where to write in the resulting viewport. */
         VkPipelineViewportStateCreateInfo vk_viewport_state;
+        /* The list of states that are set while recording command buffers instead of being baked into the pipeline. */
+        Tools::Array<VkDynamicState> vk_dynamic_states;
+        /* Description of which states are dynamic. */
+        VkPipelineDynamicStateCreateInfo vk_dynamic_state;
         /* Description of the rasterization stage of the pipeline. */
         VkPipelineRasterizationStateCreateInfo vk_rasterizer_state;
         /* Description of the multisampling stage of the pipeline. */
@@ -76,8 +83,10 @@ namespace HelloVikingRoom::Vulkan {
         /* Destructor for the GraphicsPipeline class. */
         virtual ~GraphicsPipeline();
 
-        /* Virtual function to re-create the pipeline, based on the internally stored structs. Takes a render pass to render in this pipeline. */
-        virtual void resize(const Swapchain& swapchain, const RenderPass& render_pass) = 0;
+        /* Virtual function to re-create the pipeline, based on the internally stored structs. Takes the size of the images rendered to and a render pass to render in this pipeline. Implementations may skip re-creating it if nothing relevant changed. */
+        virtual void resize(const VkExtent2D& extent, const RenderPass& render_pass) = 0;
+        /* Re-creates the pipeline for the size of the given swapchain's images and the given render pass. */
+        inline void resize(const Swapchain& swapchain, const RenderPass& render_pass) { this->resize(swapchain.extent(), render_pass); }
 
         /* Explicitly returns the internal GraphicsPipeline object. */
         inline VkPipeline pipeline() const { return this->vk_pipeline; }
@@ -4,7 +4,7 @@
  * Created:
  *   13/01/2021, 14:11:43
  * Last edited:
- *   13/01/2021, 14:11:43
+ *   16/10/2026, 17:44:50
  * Auto updated?
  *   Yes
  *
@@ -17,6 +17,7 @@
 #include "Vertices/Vertex.hpp"
 #include "Debug/Debug.hpp"
 #include "SquarePipeline.hpp"
+#include "Vulkan/DeletionQueue.hpp"
 
 using namespace std;
 using namespace HelloVikingRoom::Vulkan::GraphicsPipelines;
@@ -27,6 +28,11 @@ using namespace Debug::SeverityValues;
 /***** SQUAREPIPELINE CLASS *****/
 /* Constructor for the SquarePipeline class, which takes the device to create the pipeline on, a swapchain to deduce the image format from, a render pass to render in the pipeline and the layouts for the used descriptor sets. */
 SquarePipeline::SquarePipeline(const Device& device, const Swapchain& swapchain, const RenderPass& render_pass, const Tools::Array<VkDescriptorSetLayout>& descriptor_set_layouts) :
+    SquarePipeline(device, swapchain.extent(), render_pass, descriptor_set_layouts)
+{}
+
+/* Constructor for the SquarePipeline class, which takes the device to create the pipeline on, the size of the images rendered to, a render pass to render in the pipeline and the layouts for the used descriptor sets. Used to render to offscreen images instead of a swapchain. */
+SquarePipeline::SquarePipeline(const Device& device, const VkExtent2D& extent, const RenderPass& render_pass, const Tools::Array<VkDescriptorSetLayout>& descriptor_set_layouts) :
     GraphicsPipeline(device)
 {
     DENTER("Vulkan::GraphicsPipelines::SquarePipeline::SquarePipeline");
@@ -105,6 +111,13 @@ SquarePipeline::SquarePipeline(const Device& device, const Swapchain& swapchain,
     // Give it an "array" of scissor rects to use
     this->vk_viewport_state.pScissors = &this->vk_scissor_rects[0];
 
+    // The viewport and scissor are set when recording the command buffers instead, so that resizing the window doesn't require a new pipeline. The values above are thus ignored.
+    this->vk_dynamic_states.push_back(VK_DYNAMIC_STATE_VIEWPORT);
+    this->vk_dynamic_states.push_back(VK_DYNAMIC_STATE_SCISSOR);
+    this->vk_dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    this->vk_dynamic_state.dynamicStateCount = static_cast<uint32_t>(this->vk_dynamic_states.size());
+    this->vk_dynamic_state.pDynamicStates = this->vk_dynamic_states.rdata();
+
     // Next, we'll initialize the rasterizer, which can do some wizard graphics stuff I don't know yet
     this->vk_rasterizer_state.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
     // Do not tell it to clamp depths (whatever that may be)
@@ -192,7 +205,7 @@ SquarePipeline::SquarePipeline(const Device& device, const Swapchain& swapchain,
 
 
     /* Finally, leave the pipeline creation to our regenerate() function. */
-    this->resize(swapchain, render_pass);
+    this->resize(extent, render_pass);
 
     DLEAVE;
 }
@@ -211,19 +224,29 @@ SquarePipeline::~SquarePipeline() {
 
 
 
-/* Virtual function to re-create the pipeline, based on the internally stored structs. Takes a render pass to render in this pipeline */
-void SquarePipeline::resize(const Swapchain& swapchain, const RenderPass& render_pass) {
+/* Virtual function to re-create the pipeline, based on the internally stored structs. Takes the size of the images rendered to and a render pass to render in this pipeline. Since the viewport and scissor are dynamic, the pipeline is only re-created if the render pass changed. */
+void SquarePipeline::resize(const VkExtent2D& extent, const RenderPass& render_pass) {
     DENTER("Vulkan::GraphicsPipelines::SquarePipeline::resize");
-    
-    // Remove the old graphics pipeline if it exists
-    if (this->vk_pipeline != nullptr) {
-        vkDestroyPipeline(this->device, this->vk_pipeline, nullptr);
+
+    // Keep the viewport & scissor structs in sync with the image size, even though the actual values are set when recording
+    this->vk_viewports[0].width = (float) extent.width;
+    this->vk_viewports[0].height = (float) extent.height;
+    this->vk_scissor_rects[0].extent = extent;
+
+    // If we already have a pipeline for this render pass, the new size changes nothing
+    if (this->vk_pipeline != nullptr && this->vk_render_pass == render_pass.render_pass()) {
+        DRETURN;
     }
 
-    // Update the relevant create structs to incorporate the swapchain changes
-    this->vk_viewports[0].width = (float) swapchain.extent().width;
-    this->vk_viewports[0].height = (float) swapchain.extent().height;
-    this->vk_scissor_rects[0].extent = swapchain.extent();
+    // Otherwise, remove the old graphics pipeline if it exists, deferring it if the device has a deletion queue
+    if (this->vk_pipeline != nullptr) {
+        DeletionQueue* deletion_queue = this->device.deletion_queue();
+        if (deletion_queue != nullptr) {
+            deletion_queue->defer_pipeline(this->vk_pipeline);
+        } else {
+            vkDestroyPipeline(this->device, this->vk_pipeline, nullptr);
+        }
+    }
 
     // We start, as always, by defining the struct
     VkGraphicsPipelineCreateInfo pipeline_info{};
@@ -246,8 +269,8 @@ void SquarePipeline::resize(const Swapchain& swapchain, const RenderPass& render
     pipeline_info.pDepthStencilState = nullptr;
     // ...how to go about merging the new frame with an old one
     pipeline_info.pColorBlendState = &this->vk_color_blend_state;
-    // ...and if there are any dynamic states (which there aren't)
-    pipeline_info.pDynamicState = nullptr;
+    // ...and which states are dynamic (the viewport and scissor)
+    pipeline_info.pDynamicState = &this->vk_dynamic_state;
     // Next, we define the layout of the pipeline (not a pointer)
     pipeline_info.layout = this->vk_pipeline_layout;
     // Now, we define the renderpass we'll use
@@ -264,6 +287,7 @@ void SquarePipeline::resize(const Swapchain& swapchain, const RenderPass& render
     if (vkCreateGraphicsPipelines(this->device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &this->vk_pipeline) != VK_SUCCESS) {
         DLOG(fatal, "Could not create graphics pipeline.");
     }
+    this->vk_render_pass = render_pass.render_pass();
 
     DRETURN;
 }
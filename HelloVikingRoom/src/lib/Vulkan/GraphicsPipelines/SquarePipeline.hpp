@@ -4,7 +4,7 @@
  * Created:
  *   13/01/2021, 14:11:51
  * Last edited:
- *   13/01/2021, 14:11:51
+ *   16/10/2026, 17:44:50
  * Auto updated?
  *   Yes
  *
@@ -26,6 +26,8 @@ namespace HelloVikingRoom::Vulkan::GraphicsPipelines {
     public:
         /* Constructor for the SquarePipeline class, which takes the device to create the pipeline on, a swapchain to deduce the image format from, a render pass to render in the pipeline and the layouts for the used descriptor sets. */
         SquarePipeline(const Device& device, const Swapchain& swapchain, const RenderPass& render_pass, const Tools::Array<VkDescriptorSetLayout>& descriptor_set_layouts);
+        /* Constructor for the SquarePipeline class, which takes the device to create the pipeline on, the size of the images rendered to, a render pass to render in the pipeline and the layouts for the used descriptor sets. Used to render to offscreen images instead of a swapchain. */
+        SquarePipeline(const Device& device, const VkExtent2D& extent, const RenderPass& render_pass, const Tools::Array<VkDescriptorSetLayout>& descriptor_set_layouts);
         /* Copy constructor for the SquarePipeline class, which is deleted. */
         SquarePipeline(const SquarePipeline& other) = delete;
         /* Move constructor for the SquarePipeline class. */
@@ -33,8 +35,10 @@ namespace HelloVikingRoom::Vulkan::GraphicsPipelines {
         /* Destructor for the SquarePipeline class. */
         virtual ~SquarePipeline();
 
-        /* Virtual function to re-create the pipeline, based on the internally stored structs. Takes a render pass to render in this pipeline */
-        virtual void resize(const Swapchain& swapchain, const RenderPass& render_pass);
+        /* Virtual function to re-create the pipeline, based on the internally stored structs. Takes the size of the images rendered to and a render pass to render in this pipeline. Since the viewport and scissor are dynamic, the pipeline is only re-created if the render pass changed. */
+        virtual void resize(const VkExtent2D& extent, const RenderPass& render_pass);
+        /* Also take the swapchain overload from the GraphicsPipeline class. */
+        using GraphicsPipeline::resize;
 
     };
 }
@@ -4,7 +4,7 @@
  * Created:
  *   16/01/2021, 15:26:49
  * Last edited:
- *   16/01/2021, 15:26:49
+ *   16/10/2026, 20:54:48
  * Auto updated?
  *   Yes
  *
@@ -15,7 +15,8 @@
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb/stb_image.h"
-#include "Vulkan/Buffer.hpp"
+#include "Vulkan/UploadManager.hpp"
+#include "Vulkan/DeletionQueue.hpp"
 #include "Debug/Debug.hpp"
 #include "Image.hpp"
 
@@ -25,17 +26,19 @@ using namespace Debug::SeverityValues;
 
 
 /***** IMAGE CLASS *****/
-/* Constructor for the Image class, which takes the device where to put the image, the command pool used to perform operations, the path to the texture file to load. Optionally takes extra usage flags and extra memory requirements for the image. */
-Image::Image(const Device& device, CommandPool& command_pool, const std::string& texture_path, VkImageUsageFlags usage_flags, VkMemoryPropertyFlags property_flags) :
+/* Constructor for the Image class, which takes the allocator to get the image's memory from (and thus the device where to put the image), the upload manager used to get the pixels to the device, the path to the texture file to load. Optionally takes extra usage flags and extra memory requirements for the image. Note that the pixels only arrive once the upload manager's current batch is submitted and done. */
+Image::Image(MemoryAllocator& allocator, UploadManager& upload_manager, const std::string& texture_path, VkImageUsageFlags usage_flags, VkMemoryPropertyFlags property_flags) :
     vk_extent({}),
     vk_format(VK_FORMAT_R8G8B8A8_SRGB),
     vk_layout(VK_IMAGE_LAYOUT_UNDEFINED),
-    device(device)
+    vk_queue_family(VK_QUEUE_FAMILY_IGNORED),
+    device(allocator.device),
+    allocator(allocator)
 {
     DENTER("Vulkan::Image::Image");
     DLOG(info, "Creating Vulkan image...");
 
-    /***** STEP 1: LOAD TEXTURE TO BUFFER *****/
+    /***** STEP 1: LOAD TEXTURE FROM FILE *****/
     // Start, however, by loading the raw image from file
     DLOG(auxillary, "Loading image from file '" + texture_path + "'...");
     int texture_width, texture_height, texture_channels;
@@ -45,16 +48,102 @@ Image::Image(const Device& device, CommandPool& command_pool, const std::string&
     this->vk_extent.width = static_cast<uint32_t>(texture_width);
     this->vk_extent.height = static_cast<uint32_t>(texture_height);
 
-    // Next, use that to populate a staging buffer to load our image
-    Buffer buffer(device, (VkDeviceSize) texture_width * texture_height * 4, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-    buffer.set((void*) texels, (size_t) texture_width * texture_height * 4);
 
-    // We can free the host-side memory at this point
+
+    /***** STEP 2: CREATE THE IMAGE *****/
+    // Create the image and its memory, making sure we can copy the texels to it
+    this->create_image(usage_flags | VK_IMAGE_USAGE_TRANSFER_DST_BIT, property_flags);
+
+
+
+    /***** STEP 3: UPLOAD THE TEXELS TO THE IMAGE *****/
+    // Let the upload manager stage the texels and record the transitions & copy in its current batch
+    upload_manager.upload(*this, (void*) texels, (VkDeviceSize) texture_width * texture_height * 4);
+
+    // The texels are copied to staging memory already, so we can free the host-side memory at this point
     stbi_image_free(texels);
 
 
 
-    /***** STEP 2: CREATE THE IMAGE *****/
+    /***** STEP 4: CREATE THE IMAGE VIEW TO THIS IMAGE *****/
+    this->create_image_view();
+
+
+
+    // Done
+    DLEAVE;
+}
+
+/* Constructor for the Image class, which takes the allocator to get the image's memory from (and thus the device where to put the image), the size and format of the image and how it will be used. Optionally takes extra memory requirements for the image. The image is left uninitialized in the undefined layout, which makes it suitable as an offscreen render target. */
+Image::Image(MemoryAllocator& allocator, const VkExtent2D& extent, VkFormat format, VkImageUsageFlags usage_flags, VkMemoryPropertyFlags property_flags) :
+    vk_extent(extent),
+    vk_format(format),
+    vk_layout(VK_IMAGE_LAYOUT_UNDEFINED),
+    vk_queue_family(VK_QUEUE_FAMILY_IGNORED),
+    device(allocator.device),
+    allocator(allocator)
+{
+    DENTER("Vulkan::Image::Image");
+    DLOGF(info, "Creating empty Vulkan image of {}x{}...", extent.width, extent.height);
+
+    // There's nothing to load, so simply create the image and a view to it
+    this->create_image(usage_flags, property_flags);
+    this->create_image_view();
+
+    DLEAVE;
+}
+
+/* Move constructor for the Image class. */
+Image::Image(Image&& other) :
+    vk_image(other.vk_image),
+    allocation(other.allocation),
+    vk_image_view(other.vk_image_view),
+    vk_extent(other.vk_extent),
+    vk_format(other.vk_format),
+    vk_layout(other.vk_layout),
+    vk_queue_family(other.vk_queue_family),
+    device(other.device),
+    allocator(other.allocator)
+{
+    other.vk_image = nullptr;
+    other.allocation.memory = nullptr;
+    other.vk_image_view = nullptr;
+}
+
+/* Destructor for the Image class. */
+Image::~Image() {
+    DENTER("Vulkan::Image::~Image");
+    DLOG(info, "Cleaning Vulkan image...");
+
+    // If the device has a deletion queue, let that destroy the image once no frame in flight can use it anymore
+    DeletionQueue* deletion_queue = this->device.deletion_queue();
+    if (deletion_queue != nullptr) {
+        if (this->vk_image_view != nullptr) { deletion_queue->defer_image_view(this->vk_image_view); }
+        if (this->vk_image != nullptr) { deletion_queue->defer_image(this->vk_image); }
+        if (this->allocation.memory != nullptr) { deletion_queue->defer_memory(this->allocator, this->allocation); }
+        DRETURN;
+    }
+
+    // Otherwise, destroy it immediately
+    if (this->vk_image_view != nullptr) {
+        vkDestroyImageView(this->device, this->vk_image_view, nullptr);
+    }
+    if (this->vk_image != nullptr) {
+        vkDestroyImage(this->device, this->vk_image, nullptr);
+    }
+    if (this->allocation.memory != nullptr) {
+        this->allocator.free(this->allocation);
+    }
+
+    DLEAVE;
+}
+
+
+
+/* Creates the internal VkImage with the current extent, format and layout, and binds memory from the allocator to it. */
+void Image::create_image(VkImageUsageFlags usage_flags, VkMemoryPropertyFlags property_flags) {
+    DENTER("Vulkan::Image::create_image");
+
     // Let's use the standard create info way to define our image
     VkImageCreateInfo image_info{};
     image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -68,14 +157,14 @@ Image::Image(const Device& device, CommandPool& command_pool, const std::string&
     image_info.mipLevels = 1;
     // Also, we're not using it as an array of images
     image_info.arrayLayers = 1;
-    // Set the format of our image (8-bit RGBA)
+    // Set the format of our image (8-bit RGBA for textures)
     image_info.format = this->vk_format;
     // Set the tiling for our image, which we leave for Vulkan to decide the best one
     image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
     // What to do with our initial access to the image
     image_info.initialLayout = this->vk_layout;
     // Just as with buffer, set our usage for this image
-    image_info.usage = usage_flags | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    image_info.usage = usage_flags;
     // The sharing mode is private to one queue only
     image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     // We set the multisampling to 1, which isn't relevant for textures anyway
@@ -92,36 +181,20 @@ Image::Image(const Device& device, CommandPool& command_pool, const std::string&
     VkMemoryRequirements memory_requirements;
     vkGetImageMemoryRequirements(this->device, this->vk_image, &memory_requirements);
 
-    // Use the image's memory requirements plus our own to define the memory
-    VkMemoryAllocateInfo allocate_info{};
-    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    // Set the size of the allocation
-    allocate_info.allocationSize = memory_requirements.size;
-    // Set the index of the type. Use the buffer's static function for this!
-    allocate_info.memoryTypeIndex = Buffer::get_memory_type(this->device, memory_requirements.memoryTypeBits, property_flags);
-    if (vkAllocateMemory(this->device, &allocate_info, nullptr, &this->vk_memory) != VK_SUCCESS) {
-        DLOG(fatal, "Could not allocate memory for image on device.");
-    }
-    // Bind the newly allocated memory to our image. Note that the offset for now is zero, but this should change once/if we implement our custom allocator
-    if (vkBindImageMemory(this->device, this->vk_image, this->vk_memory, 0) != VK_SUCCESS) {
+    // Use the image's memory requirements plus our own to get a piece of memory from the allocator. Since we use optimal tiling, tell it this is a non-linear resource
+    this->allocation = this->allocator.allocate(memory_requirements, property_flags, false);
+    // Bind the allocated memory to our image at the offset the allocator gave us
+    if (vkBindImageMemory(this->device, this->vk_image, this->allocation.memory, this->allocation.offset) != VK_SUCCESS) {
         DLOG(fatal, "Could not bind memory to image.");
     }
 
+    DRETURN;
+}
 
+/* Creates the internal VkImageView that views the entire image. */
+void Image::create_image_view() {
+    DENTER("Vulkan::Image::create_image_view");
 
-    /***** STEP 3: COPY THE BUFFER TO THE IMAGE *****/
-    // First, make sure the image is in the correct layout for copying pixels to
-    this->transition_layout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, command_pool);
-
-    // Next, use our static copyer to do the rest
-    Image::copy(*this, buffer, command_pool);
-
-    // With that out of the way, transition the image to optimized shader access
-    this->transition_layout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, command_pool);
-
-
-
-    /***** STEP 4: CREATE THE IMAGE VIEW TO THIS IMAGE *****/
     // It's a create info struct, as usual
     VkImageViewCreateInfo view_info{};
     view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -143,59 +216,19 @@ Image::Image(const Device& device, CommandPool& command_pool, const std::string&
         DLOG(fatal, "Could not create image view to image.");
     }
 
-
-
-    // Done
-    DLEAVE;
-}
-
-/* Move constructor for the Image class. */
-Image::Image(Image&& other) :
-    vk_image(other.vk_image),
-    vk_memory(other.vk_memory),
-    vk_image_view(other.vk_image_view),
-    vk_extent(other.vk_extent),
-    vk_format(other.vk_format),
-    vk_layout(other.vk_layout),
-    device(other.device)
-{
-    other.vk_image = nullptr;
-    other.vk_memory = nullptr;
-    other.vk_image_view = nullptr;
-}
-
-/* Destructor for the Image class. */
-Image::~Image() {
-    DENTER("Vulkan::Image::~Image");
-    DLOG(info, "Cleaning Vulkan image...");
-
-    if (this->vk_image_view != nullptr) {
-        vkDestroyImageView(this->device, this->vk_image_view, nullptr);
-    }
-    if (this->vk_image != nullptr) {
-        vkDestroyImage(this->device, this->vk_image, nullptr);
-    }
-    if (this->vk_memory != nullptr) {
-        vkFreeMemory(this->device, this->vk_memory, nullptr);
-    }
-
-    DLEAVE;
+    DRETURN;
 }
 
 
 
-/* Populates the image with the contents of the given Buffer. */
-void Image::copy(Image& destination, const Buffer& source, CommandPool& command_pool) {
+/* Records a copy of the given VkBuffer (starting at the given offset) to the image in the given command buffer. */
+void Image::copy(Image& destination, VkBuffer source, VkDeviceSize source_offset, VkCommandBuffer command_buffer) {
     DENTER("Vulkan::Image::copy");
 
-    // Get a command buffer to run this operation on
-    CommandBuffer command_buffer = command_pool.get_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
-    command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-
     // Start by defining the copy by a struct
     VkBufferImageCopy copy_info{};
-    // Specify the offset of our buffer
-    copy_info.bufferOffset = source.offset();
+    // Specify the offset of our data within the buffer
+    copy_info.bufferOffset = source_offset;
     // Define if there's any padding between the pixels in our buffer. Not in our case, though
     copy_info.bufferRowLength = 0;
     copy_info.bufferImageHeight = 0;
@@ -219,20 +252,49 @@ void Image::copy(Image& destination, const Buffer& source, CommandPool& command_
         1, &copy_info
     );
 
-    // Stop recording, and once the queue is done with everything including this operation, return
-    command_buffer.end(destination.device.graphics_queue());
+    // It's up to the caller to submit the command buffer
     DRETURN;
 }
 
 
 
-/* Transitions the image from its current layout to a new one. Adds in a barrier to make sure the pipeline only continues when the image has the right layout. */
-void Image::transition_layout(const VkImageLayout& new_layout, CommandPool& command_pool) {
-    DENTER("Vulkan::image::transition_layout");
+/* Records a copy of the given image, which is in the given layout, to the given VkBuffer (starting at the given offset) in the given command buffer. The pixels are tightly packed in the buffer. */
+void Image::copy(VkBuffer destination, VkDeviceSize destination_offset, const Image& source, VkImageLayout source_layout, VkCommandBuffer command_buffer) {
+    DENTER("Vulkan::Image::copy");
+
+    // Define the copy much like the upload one, but with the roles reversed
+    VkBufferImageCopy copy_info{};
+    // Specify where the pixels should go in the buffer, tightly packed
+    copy_info.bufferOffset = destination_offset;
+    copy_info.bufferRowLength = 0;
+    copy_info.bufferImageHeight = 0;
+    // Copy the only layer of the only mipmap
+    copy_info.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copy_info.imageSubresource.mipLevel = 0;
+    copy_info.imageSubresource.baseArrayLayer = 0;
+    copy_info.imageSubresource.layerCount = 1;
+    // Copy the whole image
+    copy_info.imageOffset = {0, 0, 0};
+    copy_info.imageExtent.width = source.vk_extent.width;
+    copy_info.imageExtent.height = source.vk_extent.height;
+    copy_info.imageExtent.depth = 1;
+
+    // Record it on the buffer. The layout is passed explicitly, since render passes may have changed it without us knowing
+    vkCmdCopyImageToBuffer(
+        command_buffer,
+        source,
+        source_layout,
+        destination,
+        1, &copy_info
+    );
 
-    // Get a command buffer to do all this in
-    CommandBuffer command_buffer = command_pool.get_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
-    command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    // It's up to the caller to submit the command buffer
+    DRETURN;
+}
+
+/* Records a transition of the image from its current layout to a new one in the given command buffer. Adds in a barrier to make sure the pipeline only continues when the image has the right layout. */
+void Image::transition_layout(const VkImageLayout& new_layout, VkCommandBuffer command_buffer) {
+    DENTER("Vulkan::image::transition_layout");
 
     // Begin describing the barrier that handles the transition
     VkImageMemoryBarrier image_barrier{};
@@ -267,6 +329,18 @@ void Image::transition_layout(const VkImageLayout& new_layout, CommandPool& comm
         // Set the source stage as after the transfer to the image has been completed, and the destination stage to before the fragment shader can read from it
         source_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
         destination_stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    } else if (this->vk_layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL && new_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
+        // Set the barrier to wait until the fragment shaders are done reading the image before it's written again
+        image_barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        image_barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        source_stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        destination_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    } else if (this->vk_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && new_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
+        // Not a transition at all, but the image is written twice in a row, so make sure the first write is done before the second one starts
+        image_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        image_barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        source_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        destination_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
     } else {
         DLOG(fatal, "Unknown image layout transformation.");
     }
@@ -288,11 +362,49 @@ void Image::transition_layout(const VkImageLayout& new_layout, CommandPool& comm
         1, &image_barrier
     );
 
-    // Submit the command buffer with this operation, waiting for it to finish
-    command_buffer.end(this->device.graphics_queue());
+    // Update the current layout in the image. Since the barrier is only recorded, this is the layout the image will have once the command buffer has run
+    this->vk_layout = new_layout;
+
+    DRETURN;
+}
+
+/* Records the transfer of the image from one queue family to another, after it's been written by a transfer. The release half is recorded in a command buffer of the source family and the acquire half in one of the destination family, and the image is transitioned to the given layout in the process. The acquire command buffer has to be submitted after (and wait on) the release one. Afterwards, queue_family() returns the destination family. */
+void Image::transfer_ownership(const VkImageLayout& new_layout, uint32_t source_family, VkCommandBuffer release_buffer, uint32_t destination_family, VkCommandBuffer acquire_buffer) {
+    DENTER("Vulkan::Image::transfer_ownership");
+
+    // We only know how to hand over freshly written images to the shaders
+    if (this->vk_layout != VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL || new_layout != VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
+        DLOG(fatal, "Unknown image layout transformation for queue family ownership transfer.");
+    }
+
+    // Both halves use the same barrier, except for the access masks
+    VkImageMemoryBarrier image_barrier{};
+    image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    image_barrier.oldLayout = this->vk_layout;
+    image_barrier.newLayout = new_layout;
+    // This time, we do transfer ownership from one family to the other
+    image_barrier.srcQueueFamilyIndex = source_family;
+    image_barrier.dstQueueFamilyIndex = destination_family;
+    image_barrier.image = this->vk_image;
+    image_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    image_barrier.subresourceRange.baseMipLevel = 0;
+    image_barrier.subresourceRange.levelCount = 1;
+    image_barrier.subresourceRange.baseArrayLayer = 0;
+    image_barrier.subresourceRange.layerCount = 1;
+
+    // The release makes the transfer writes available, but doesn't need to wait for anything on the source queue after it
+    image_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    image_barrier.dstAccessMask = 0;
+    vkCmdPipelineBarrier(release_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
+
+    // The acquire then makes them visible to the fragment shaders on the destination queue (the semaphore in between takes care of the ordering)
+    image_barrier.srcAccessMask = 0;
+    image_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(acquire_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
 
-    // When that's done, update the current layout in the image
+    // The image has the new layout and belongs to the destination family once the acquire has run
     this->vk_layout = new_layout;
+    this->vk_queue_family = destination_family;
 
     DRETURN;
 }
@@ -4,7 +4,7 @@
  * Created:
  *   16/01/2021, 15:26:46
  * Last edited:
- *   16/01/2021, 15:26:46
+ *   16/10/2026, 20:54:48
  * Auto updated?
  *   Yes
  *
@@ -21,15 +21,19 @@
 
 #include "Vulkan/Device.hpp"
 #include "Vulkan/CommandPool.hpp"
+#include "Vulkan/MemoryAllocator.hpp"
 
 namespace HelloVikingRoom::Vulkan {
-    /* The Image class, which loads and manages texture files using the stb image library. */
+    /* The UploadManager class, which batches staging uploads to device-local buffers and images. */
+    class UploadManager;
+
+    /* The Image class, which loads and manages texture files using the stb image library, or manages empty images to render to. */
     class Image {
     private:
         /* The VkImage class that this class wraps. */
         VkImage vk_image;
-        /* The memory allocated on the device for this image. */
-        VkDeviceMemory vk_memory;
+        /* The piece of device memory allocated for this image. */
+        MemoryAllocation allocation;
 
         /* The VkImageView object used to, well, view this image. */
         VkImageView vk_image_view;
@@ -40,13 +44,24 @@ namespace HelloVikingRoom::Vulkan {
         VkFormat vk_format;
         /* The current layout of the image. */
         VkImageLayout vk_layout;
+        /* The queue family that owns the image, or VK_QUEUE_FAMILY_IGNORED if it was never handed over to one. */
+        uint32_t vk_queue_family;
+
+        /* Creates the internal VkImage with the current extent, format and layout, and binds memory from the allocator to it. */
+        void create_image(VkImageUsageFlags usage_flags, VkMemoryPropertyFlags property_flags);
+        /* Creates the internal VkImageView that views the entire image. */
+        void create_image_view();
     
     public:
         /* Constant reference to the device where the image lives. */
         const Device& device;
+        /* The allocator where this image got its memory from. */
+        MemoryAllocator& allocator;
 
-        /* Constructor for the Image class, which takes the device where to put the image, the command pool used to perform operations, the path to the texture file to load. Optionally takes extra usage flags and extra memory requirements for the image. */
-        Image(const Device& device, CommandPool& command_pool, const std::string& texture_path, VkImageUsageFlags usage_flags = 0, VkMemoryPropertyFlags property_flags = 0);
+        /* Constructor for the Image class, which takes the allocator to get the image's memory from (and thus the device where to put the image), the upload manager used to get the pixels to the device, the path to the texture file to load. Optionally takes extra usage flags and extra memory requirements for the image. Note that the pixels only arrive once the upload manager's current batch is submitted and done. */
+        Image(MemoryAllocator& allocator, UploadManager& upload_manager, const std::string& texture_path, VkImageUsageFlags usage_flags = 0, VkMemoryPropertyFlags property_flags = 0);
+        /* Constructor for the Image class, which takes the allocator to get the image's memory from (and thus the device where to put the image), the size and format of the image and how it will be used. Optionally takes extra memory requirements for the image. The image is left uninitialized in the undefined layout, which makes it suitable as an offscreen render target. */
+        Image(MemoryAllocator& allocator, const VkExtent2D& extent, VkFormat format, VkImageUsageFlags usage_flags, VkMemoryPropertyFlags property_flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
         /* Copy constructor for the Image class, which is deleted. */
         Image(const Image& other) = delete;
         /* Move constructor for the Image class. */
@@ -54,11 +69,15 @@ namespace HelloVikingRoom::Vulkan {
         /* Destructor for the Image class. */
         ~Image();
 
-        /* Populates the image with the contents of the given Buffer. */
-        static void copy(Image& destination, const Buffer& source, CommandPool& command_pool);
+        /* Records a copy of the given VkBuffer (starting at the given offset) to the image in the given command buffer. */
+        static void copy(Image& destination, VkBuffer source, VkDeviceSize source_offset, VkCommandBuffer command_buffer);
+        /* Records a copy of the given image, which is in the given layout, to the given VkBuffer (starting at the given offset) in the given command buffer. The pixels are tightly packed in the buffer. */
+        static void copy(VkBuffer destination, VkDeviceSize destination_offset, const Image& source, VkImageLayout source_layout, VkCommandBuffer command_buffer);
 
-        /* Transitions the image from its current layout to a new one. Adds in a barrier to make sure the pipeline only continues when the image has the right layout. */
-        void transition_layout(const VkImageLayout& new_layout, CommandPool& command_pool);
+        /* Records a transition of the image from its current layout to a new one in the given command buffer. Adds in a barrier to make sure the pipeline only continues when the image has the right layout. */
+        void transition_layout(const VkImageLayout& new_layout, VkCommandBuffer command_buffer);
+        /* Records the transfer of the image from one queue family to another, after it's been written by a transfer. The release half is recorded in a command buffer of the source family and the acquire half in one of the destination family, and the image is transitioned to the given layout in the process. The acquire command buffer has to be submitted after (and wait on) the release one. Afterwards, queue_family() returns the destination family. */
+        void transfer_ownership(const VkImageLayout& new_layout, uint32_t source_family, VkCommandBuffer release_buffer, uint32_t destination_family, VkCommandBuffer acquire_buffer);
 
         /* Returns the size of the image as a VkExtent2D object. */
         inline const VkExtent2D extent() const { return this->vk_extent; }
@@ -66,17 +85,21 @@ namespace HelloVikingRoom::Vulkan {
         inline VkFormat format() const { return this->vk_format; }
         /* Returns the current layout of the image. */
         inline VkImageLayout layout() const { return this->vk_layout; }
+        /* Returns the queue family that owns the image, or VK_QUEUE_FAMILY_IGNORED if it was never handed over to one. */
+        inline uint32_t queue_family() const { return this->vk_queue_family; }
+        /* Returns the offset of the image within its VkDeviceMemory object. */
+        inline VkDeviceSize offset() const { return this->allocation.offset; }
 
         /* Expliticly returns the internal VkImage object. */
         inline const VkImage& image() const { return this->vk_image; }
         /* Explicitly returns the internal VkDeviceMemory object. */
-        inline const VkDeviceMemory& memory() const { return this->vk_memory; }
+        inline const VkDeviceMemory& memory() const { return this->allocation.memory; }
         /* Explicitly returns the internal VkImageView object. */
         inline const VkImageView& image_view() const { return this->vk_image_view; }
         /* Implicitly casts this class to a VkImage by returning the internal object. */
         inline operator VkImage() const { return this->vk_image; }
         /* Implicitly casts this class to a VkDeviceMemory by returning the internal object. */
-        inline operator VkDeviceMemory() const { return this->vk_memory; }
+        inline operator VkDeviceMemory() const { return this->allocation.memory; }
         /* Implicitly casts this class to a VkImageView by returning the internal object. */
         inline operator VkImageView() const { return this->vk_image_view; }
         
@@ -4,7 +4,7 @@
  * Created:
  *   21/12/2020, 13:35:55
  * Last edited:
- *   12/24/2020, 12:56:59 PM
+ *   16/10/2026, 19:04:32
  * Auto updated?
  *   Yes
  *
@@ -62,7 +62,7 @@ void populate_application_info(VkApplicationInfo* app_info) {
 
 /***** INSTANCE CLASS *****/
 /* Constructor for the Instance class, that takes a list of the extensions that we'll require from our Vulkan installation. Does not enable any validation layers or debuggers. */
-Vulkan::Instance::Instance(const Tools::Array<const char*>& required_extensions) {
+Vulkan::Instance::Instance(const NameList& required_extensions) {
     DENTER("Vulkan::Instance::Instance");
     DLOG(info, "Creating Vulkan instance...");
 
@@ -91,7 +91,7 @@ Vulkan::Instance::Instance(const Tools::Array<const char*>& required_extensions)
 }
 
 /* Constructor for the Instance class, that takes a Debugger instance, a list of the extensions that we'll require from our Vulkan installation and a list of validation layers we'll want to enable. */
-Vulkan::Instance::Instance(const Tools::Array<const char*>& required_extensions, const Tools::Array<const char*>& required_layers) {
+Vulkan::Instance::Instance(const NameList& required_extensions, const NameList& required_layers) {
     DENTER("Vulkan::Instance::Instance_DEBUG");
     DLOG(info, "Creating Vulkan instance...");
 
@@ -4,7 +4,7 @@
  * Created:
  *   21/12/2020, 13:36:01
  * Last edited:
- *   21/12/2020, 13:36:01
+ *   16/10/2026, 19:04:32
  * Auto updated?
  *   Yes
  *
@@ -18,9 +18,12 @@
 
 #include <vulkan/vulkan.h>
 
-#include "Tools/Array.hpp"
+#include "Tools/SmallArray.hpp"
 
 namespace HelloVikingRoom::Vulkan {
+    /* The list used to pass the names of extensions and layers, which are usually few enough to fit in its inline storage. */
+    using NameList = Tools::SmallArray<const char*, 8>;
+
     /* Wraps around the default Vulkan instance. */
     class Instance {
     private:
@@ -29,9 +32,9 @@ namespace HelloVikingRoom::Vulkan {
 
     public:
         /* Constructor for the Instance class, that takes a list of the extensions that we'll require from our Vulkan installation. Does not enable any validation layers or debuggers. */
-        Instance(const Tools::Array<const char*>& required_extensions);
+        Instance(const NameList& required_extensions);
         /* Constructor for the Instance class, that takes a list of the extensions that we'll require from our Vulkan installation and a list of validation layers we'll want to enable. */
-        Instance(const Tools::Array<const char*>& required_extensions, const Tools::Array<const char*>& required_layers);
+        Instance(const NameList& required_extensions, const NameList& required_layers);
         /* Copy constructor for the Instance class, which is deleted because otherwise it wouldn't make much sense. */
         Instance(const Instance& other) = delete;
         /* Move constructor for the Instance class. */
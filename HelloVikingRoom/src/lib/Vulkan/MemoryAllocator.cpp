@@ -0,0 +1,438 @@
+/* MEMORY ALLOCATOR.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 10:12:35
+ * Last edited:
+ *   16/10/2026, 23:06:38
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the MemoryAllocator class, which allocates large blocks of
+ *   device memory per memory type and hands out sub-allocations from
+ *   those, so that Buffers and Images don't need their own
+ *   vkAllocateMemory-call each. Host-visible blocks are mapped once, when
+ *   they are created, and writes to non-coherent memory are flushed in
+ *   one batch per frame.
+**/
+
+#include "Debug/Debug.hpp"
+#include "MemoryAllocator.hpp"
+
+using namespace std;
+using namespace HelloVikingRoom::Vulkan;
+using namespace Debug::SeverityValues;
+
+
+/***** HELPER FUNCTIONS *****/
+/* Rounds the given value up to the nearest multiple of the given alignment. */
+static inline VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment) {
+    return alignment > 1 ? ((value + alignment - 1) / alignment) * alignment : value;
+}
+
+/* Rounds the given value down to the nearest multiple of the given alignment. */
+static inline VkDeviceSize align_down(VkDeviceSize value, VkDeviceSize alignment) {
+    return alignment > 1 ? (value / alignment) * alignment : value;
+}
+
+
+
+
+
+/***** MEMORYBLOCK CLASS *****/
+/* Constructor for the MemoryBlock class, which takes the device to allocate on, the memory type index to allocate with, the size of the block (in bytes), whether it will store linear resources or not and whether the block should be mapped to host memory. */
+MemoryBlock::MemoryBlock(const Device& device, uint32_t memory_type, VkDeviceSize n_bytes, bool linear, bool host_visible) :
+    vk_size(n_bytes),
+    mapped_memory(nullptr),
+    used_bytes(0),
+    n_allocations(0),
+    device(device),
+    memory_type(memory_type),
+    linear(linear)
+{
+    DENTER("Vulkan::MemoryBlock::MemoryBlock");
+    DLOGF(info, "Allocating memory block of {} bytes on memory type {}...", n_bytes, memory_type);
+
+    // Prepare the allocate info
+    VkMemoryAllocateInfo allocate_info{};
+    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    // Tell it how many bytes to allocate for the entire block
+    allocate_info.allocationSize = this->vk_size;
+    // Tell it which memory type to use
+    allocate_info.memoryTypeIndex = this->memory_type;
+
+    // Do the allocation
+    if (vkAllocateMemory(this->device, &allocate_info, nullptr, &this->vk_memory) != VK_SUCCESS) {
+        DLOG(fatal, "Could not allocate memory block.");
+    }
+
+    // If the memory is visible to the host, map it once now so resources never have to map/unmap it themselves
+    if (host_visible) {
+        if (vkMapMemory(this->device, this->vk_memory, 0, this->vk_size, 0, &this->mapped_memory) != VK_SUCCESS) {
+            DLOG(fatal, "Could not map memory block to host memory.");
+        }
+    }
+
+    // Initially, the entire block is one free range
+    this->free_ranges.insert({ 0, this->vk_size });
+
+    DLEAVE;
+}
+
+/* Move constructor for the MemoryBlock class. */
+MemoryBlock::MemoryBlock(MemoryBlock&& other) :
+    vk_memory(other.vk_memory),
+    vk_size(other.vk_size),
+    mapped_memory(other.mapped_memory),
+    free_ranges(std::move(other.free_ranges)),
+    used_bytes(other.used_bytes),
+    n_allocations(other.n_allocations),
+    device(other.device),
+    memory_type(other.memory_type),
+    linear(other.linear)
+{
+    // Leave the other block empty, so that nothing treats it as a live block anymore
+    other.vk_memory = nullptr;
+    other.mapped_memory = nullptr;
+    other.free_ranges.clear();
+    other.used_bytes = 0;
+    other.n_allocations = 0;
+}
+
+/* Destructor for the MemoryBlock class. */
+MemoryBlock::~MemoryBlock() {
+    DENTER("Vulkan::MemoryBlock::~MemoryBlock");
+    DLOG(info, "Freeing memory block...");
+
+    if (this->n_allocations > 0) {
+        DLOGF(warning, "Freeing memory block that still has {} allocation(s) in it.", this->n_allocations);
+    }
+    if (this->vk_memory != nullptr) {
+        if (this->mapped_memory != nullptr) {
+            vkUnmapMemory(this->device, this->vk_memory);
+        }
+        vkFreeMemory(this->device, this->vk_memory, nullptr);
+    }
+
+    DLEAVE;
+}
+
+
+
+/* Tries to reserve n_bytes in this block with the given alignment. Returns true and sets offset if it succeeded, or returns false if there was no suitable free range. */
+bool MemoryBlock::allocate(VkDeviceSize n_bytes, VkDeviceSize alignment, VkDeviceSize& offset) {
+    // Go through the free ranges, and take the first one that fits (first-fit)
+    for (std::map<VkDeviceSize, VkDeviceSize>::iterator iter = this->free_ranges.begin(); iter != this->free_ranges.end(); ++iter) {
+        VkDeviceSize range_start = iter->first;
+        VkDeviceSize range_size = iter->second;
+
+        // Compute where the allocation would start in this range once aligned
+        VkDeviceSize aligned_start = align_up(range_start, alignment);
+        VkDeviceSize padding = aligned_start - range_start;
+        if (padding + n_bytes > range_size) { continue; }
+
+        // It fits; remove the range and put back whatever is left at the front and the back
+        this->free_ranges.erase(iter);
+        if (padding > 0) {
+            this->free_ranges.insert({ range_start, padding });
+        }
+        VkDeviceSize tail_size = range_size - padding - n_bytes;
+        if (tail_size > 0) {
+            this->free_ranges.insert({ aligned_start + n_bytes, tail_size });
+        }
+
+        // Update the bookkeeping and we're done
+        this->used_bytes += n_bytes;
+        ++this->n_allocations;
+        offset = aligned_start;
+        return true;
+    }
+
+    // Nothing fitted
+    return false;
+}
+
+/* Returns the given range to the block, merging it with any neighbouring free ranges. */
+void MemoryBlock::free(VkDeviceSize offset, VkDeviceSize n_bytes) {
+    // Insert the range, and find where it ended up
+    std::map<VkDeviceSize, VkDeviceSize>::iterator iter = this->free_ranges.insert({ offset, n_bytes }).first;
+
+    // Merge with the next range if they touch
+    std::map<VkDeviceSize, VkDeviceSize>::iterator next = std::next(iter);
+    if (next != this->free_ranges.end() && iter->first + iter->second == next->first) {
+        iter->second += next->second;
+        this->free_ranges.erase(next);
+    }
+    // Merge with the previous range if they touch
+    if (iter != this->free_ranges.begin()) {
+        std::map<VkDeviceSize, VkDeviceSize>::iterator prev = std::prev(iter);
+        if (prev->first + prev->second == iter->first) {
+            prev->second += iter->second;
+            this->free_ranges.erase(iter);
+        }
+    }
+
+    // Update the bookkeeping
+    this->used_bytes -= n_bytes;
+    --this->n_allocations;
+}
+
+/* Returns the size of the largest free range in this block. */
+VkDeviceSize MemoryBlock::largest_free_range() const {
+    VkDeviceSize result = 0;
+    for (const std::pair<const VkDeviceSize, VkDeviceSize>& range : this->free_ranges) {
+        if (range.second > result) { result = range.second; }
+    }
+    return result;
+}
+
+
+
+
+
+/***** MEMORYALLOCATOR CLASS *****/
+/* Constructor for the MemoryAllocator class, which takes the device to allocate on and optionally the size of each block (in bytes). Larger resources will get a block of their own size. */
+MemoryAllocator::MemoryAllocator(const Device& device, VkDeviceSize block_size) :
+    block_size(block_size),
+    n_device_allocations(0),
+    device(device)
+{
+    DENTER("Vulkan::MemoryAllocator::MemoryAllocator");
+    DLOG(info, "Creating device memory allocator...");
+
+    // Fetch the memory properties once, so we don't have to query them for every allocation
+    vkGetPhysicalDeviceMemoryProperties(this->device, &this->vk_memory_properties);
+    // Do the same for the flush granularity of non-coherent memory
+    VkPhysicalDeviceProperties device_properties;
+    vkGetPhysicalDeviceProperties(this->device, &device_properties);
+    this->vk_non_coherent_atom_size = device_properties.limits.nonCoherentAtomSize;
+
+    DLEAVE;
+}
+
+/* Move constructor for the MemoryAllocator class. */
+MemoryAllocator::MemoryAllocator(MemoryAllocator&& other) :
+    vk_memory_properties(other.vk_memory_properties),
+    vk_non_coherent_atom_size(other.vk_non_coherent_atom_size),
+    blocks(std::move(other.blocks)),
+    block_size(other.block_size),
+    n_device_allocations(other.n_device_allocations),
+    dirty_ranges(std::move(other.dirty_ranges)),
+    device(other.device)
+{}
+
+/* Destructor for the MemoryAllocator class. */
+MemoryAllocator::~MemoryAllocator() {
+    DENTER("Vulkan::MemoryAllocator::~MemoryAllocator");
+    DLOG(info, "Cleaning device memory allocator...");
+
+    for (size_t i = 0; i < this->blocks.size(); i++) {
+        delete this->blocks[i];
+    }
+
+    DLEAVE;
+}
+
+
+
+/* Returns the appropriate memory type based on the given type filter (as given by VkMemoryRequirements) and the required properties. */
+uint32_t MemoryAllocator::get_memory_type(uint32_t type_filter, VkMemoryPropertyFlags properties) const {
+    DENTER("Vulkan::MemoryAllocator::get_memory_type");
+
+    // Find the first memory type that is allowed by the filter and has all the properties we want
+    for (uint32_t i = 0; i < this->vk_memory_properties.memoryTypeCount; i++) {
+        if (type_filter & (1 << i) && (this->vk_memory_properties.memoryTypes[i].propertyFlags & properties) == properties) {
+            DRETURN i;
+        }
+    }
+
+    // Didn't find any
+    DLOG(fatal, "Could not find suitable memory type on selected device.");
+    DRETURN 0;
+}
+
+
+
+/* Allocates memory for a resource with the given requirements and properties. The linear flag should be true for buffers and linear images, and false for optimal-tiling images. */
+MemoryAllocation MemoryAllocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool linear) {
+    DENTER("Vulkan::MemoryAllocator::allocate");
+
+    // Find the memory type to allocate on
+    uint32_t memory_type = this->get_memory_type(requirements.memoryTypeBits, properties);
+    bool host_visible = this->memory_type_properties(memory_type) & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+
+    // Non-coherent memory is flushed in whole atoms, so pad allocations to those to never flush a neighbour's bytes
+    VkDeviceSize alignment = requirements.alignment;
+    VkDeviceSize n_bytes = requirements.size;
+    if (this->needs_flush(memory_type)) {
+        alignment = std::max(alignment, this->vk_non_coherent_atom_size);
+        n_bytes = align_up(n_bytes, this->vk_non_coherent_atom_size);
+    }
+
+    // Try to find an existing block of the same kind with enough space
+    MemoryAllocation result{};
+    result.size = n_bytes;
+    MemoryBlock* block = nullptr;
+    for (size_t i = 0; i < this->blocks.size(); i++) {
+        if (this->blocks[i]->memory_type != memory_type || this->blocks[i]->linear != linear) { continue; }
+        if (this->blocks[i]->allocate(n_bytes, alignment, result.offset)) {
+            block = this->blocks[i];
+            break;
+        }
+    }
+
+    // If no luck, create a new block that is at least big enough for this resource
+    if (block == nullptr) {
+        VkDeviceSize new_block_size = std::max(this->block_size, align_up(n_bytes, alignment));
+        block = new MemoryBlock(this->device, memory_type, new_block_size, linear, host_visible);
+        this->blocks.push_back(block);
+        ++this->n_device_allocations;
+
+        // Allocate from it, which cannot fail since it's empty
+        block->allocate(n_bytes, alignment, result.offset);
+    }
+
+    // Fill in the rest of the allocation
+    result.block = block;
+    result.memory = block->memory();
+    result.mapped = block->mapped() != nullptr ? (void*) ((uint8_t*) block->mapped() + result.offset) : nullptr;
+    DRETURN result;
+}
+
+/* Returns the given allocation to its block. The allocation's memory will be set to nullptr afterwards. */
+void MemoryAllocator::free(MemoryAllocation& allocation) {
+    DENTER("Vulkan::MemoryAllocator::free");
+
+    // Simply give it back to the block; empty blocks are kept around until trim() so that create/destroy patterns don't hit the driver each time
+    if (allocation.memory != nullptr) {
+        allocation.block->free(allocation.offset, allocation.size);
+        allocation.block = nullptr;
+        allocation.memory = nullptr;
+        allocation.mapped = nullptr;
+    }
+
+    DRETURN;
+}
+
+/* Releases all blocks that are completely unused back to the device. Ranges of them that are still waiting to be flushed are dropped, since nothing lives there anymore. */
+void MemoryAllocator::trim() {
+    DENTER("Vulkan::MemoryAllocator::trim");
+
+    // Loop backwards so erasing doesn't change the indices we still have to visit
+    for (size_t i = this->blocks.size(); i-- > 0;) {
+        if (this->blocks[i]->empty()) {
+            // Forget the block's dirty ranges first, or the next flush() would hand freed memory to the driver
+            VkDeviceMemory memory = this->blocks[i]->memory();
+            for (size_t j = this->dirty_ranges.size(); j-- > 0;) {
+                if (this->dirty_ranges[j].memory == memory) {
+                    this->dirty_ranges.erase(j);
+                }
+            }
+
+            delete this->blocks[i];
+            this->blocks.erase(i);
+        }
+    }
+
+    DRETURN;
+}
+
+
+
+/* Marks the given range (relative to the start of the allocation) as written by the host. Does nothing if the allocation lives in coherent memory. */
+void MemoryAllocator::mark_dirty(const MemoryAllocation& allocation, VkDeviceSize offset, VkDeviceSize n_bytes) {
+    DENTER("Vulkan::MemoryAllocator::mark_dirty");
+
+    // Coherent memory needs no flushing at all
+    if (!this->needs_flush(allocation.block->memory_type)) { DRETURN; }
+
+    // Widen the range to whole atoms, which stays within the allocation since we padded it on allocate()
+    VkDeviceSize start = align_down(allocation.offset + offset, this->vk_non_coherent_atom_size);
+    VkDeviceSize stop = std::min(align_up(allocation.offset + offset + n_bytes, this->vk_non_coherent_atom_size), allocation.block->size());
+
+    // If this range directly follows the last one (i.e., the same buffer written piece by piece), merge them
+    if (!this->dirty_ranges.empty()) {
+        VkMappedMemoryRange& last = this->dirty_ranges[this->dirty_ranges.size() - 1];
+        if (last.memory == allocation.memory && start >= last.offset && start <= last.offset + last.size) {
+            last.size = std::max(last.offset + last.size, stop) - last.offset;
+            DRETURN;
+        }
+    }
+
+    // Otherwise, add a new range
+    VkMappedMemoryRange range{};
+    range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    range.memory = allocation.memory;
+    range.offset = start;
+    range.size = stop - start;
+    this->dirty_ranges.push_back(range);
+
+    DRETURN;
+}
+
+/* Flushes all ranges marked dirty since the last call in a single vkFlushMappedMemoryRanges-call. Should be called once per frame, before submitting the work that reads them. */
+void MemoryAllocator::flush() {
+    DENTER("Vulkan::MemoryAllocator::flush");
+
+    // Only do the call if there is something to flush
+    if (!this->dirty_ranges.empty()) {
+        if (vkFlushMappedMemoryRanges(this->device, static_cast<uint32_t>(this->dirty_ranges.size()), this->dirty_ranges.rdata()) != VK_SUCCESS) {
+            DLOG(fatal, "Could not flush mapped memory ranges back to device.");
+        }
+
+        // Reset the list, but keep its memory around for the next frame
+        this->dirty_ranges.wdata(0);
+    }
+
+    DRETURN;
+}
+
+/* Invalidates the given range (relative to the start of the allocation), so that device writes become visible to the host. Does nothing if the allocation lives in coherent memory. */
+void MemoryAllocator::invalidate(const MemoryAllocation& allocation, VkDeviceSize offset, VkDeviceSize n_bytes) {
+    DENTER("Vulkan::MemoryAllocator::invalidate");
+
+    // Coherent memory needs no invalidating at all
+    if (!this->needs_flush(allocation.block->memory_type)) { DRETURN; }
+
+    // Like with flushes, invalidate whole atoms
+    VkMappedMemoryRange range{};
+    range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    range.memory = allocation.memory;
+    range.offset = align_down(allocation.offset + offset, this->vk_non_coherent_atom_size);
+    range.size = std::min(align_up(allocation.offset + offset + n_bytes, this->vk_non_coherent_atom_size), allocation.block->size()) - range.offset;
+    if (vkInvalidateMappedMemoryRanges(this->device, 1, &range) != VK_SUCCESS) {
+        DLOG(fatal, "Could not invalidate mapped memory range.");
+    }
+
+    DRETURN;
+}
+
+
+
+/* Returns statistics on the current state of the allocator. */
+MemoryAllocatorStats MemoryAllocator::stats() const {
+    DENTER("Vulkan::MemoryAllocator::stats");
+
+    // Collect the numbers over all blocks
+    MemoryAllocatorStats result{};
+    result.n_blocks = this->blocks.size();
+    result.n_device_allocations = this->n_device_allocations;
+    VkDeviceSize total_largest_free = 0;
+    for (size_t i = 0; i < this->blocks.size(); i++) {
+        const MemoryBlock* block = this->blocks[i];
+        VkDeviceSize block_largest_free = block->largest_free_range();
+        result.n_allocations += block->allocations();
+        result.bytes_reserved += block->size();
+        result.bytes_used += block->used();
+        result.n_free_ranges += block->free_range_count();
+        result.largest_free_range = std::max(result.largest_free_range, block_largest_free);
+        total_largest_free += block_largest_free;
+    }
+
+    // Compute the fragmentation from that, per block, since a free range can never span two blocks anyway
+    VkDeviceSize bytes_free = result.bytes_reserved - result.bytes_used;
+    result.fragmentation = bytes_free > 0 ? 1.0 - (double) total_largest_free / (double) bytes_free : 0.0;
+
+    DRETURN result;
+}
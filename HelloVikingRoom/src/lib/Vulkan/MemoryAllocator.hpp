@@ -0,0 +1,183 @@
+/* MEMORY ALLOCATOR.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 10:12:31
+ * Last edited:
+ *   16/10/2026, 23:06:38
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the MemoryAllocator class, which allocates large blocks of
+ *   device memory per memory type and hands out sub-allocations from
+ *   those, so that Buffers and Images don't need their own
+ *   vkAllocateMemory-call each. Host-visible blocks are mapped once, when
+ *   they are created, and writes to non-coherent memory are flushed in
+ *   one batch per frame.
+**/
+
+#ifndef VULKAN_MEMORY_ALLOCATOR_HPP
+#define VULKAN_MEMORY_ALLOCATOR_HPP
+
+#include <vulkan/vulkan.h>
+#include <map>
+
+#include "Vulkan/Device.hpp"
+#include "Tools/Array.hpp"
+
+namespace HelloVikingRoom::Vulkan {
+    /* The MemoryBlock class, which is a single, large VkDeviceMemory allocation that is divided into smaller pieces using a free-list. */
+    class MemoryBlock {
+    private:
+        /* The VkDeviceMemory object that this block wraps. */
+        VkDeviceMemory vk_memory;
+        /* The total size of the block, in bytes. */
+        VkDeviceSize vk_size;
+        /* Pointer to the host-mapped memory of this block, or nullptr if the memory isn't host-visible. Stays mapped for the block's entire lifetime. */
+        void* mapped_memory;
+
+        /* The list of free ranges in this block, mapped as offset -> size. Neighbouring ranges are always merged. */
+        std::map<VkDeviceSize, VkDeviceSize> free_ranges;
+        /* The number of bytes currently handed out. */
+        VkDeviceSize used_bytes;
+        /* The number of sub-allocations currently living in this block. */
+        size_t n_allocations;
+
+    public:
+        /* The device where this block lives. */
+        const Device& device;
+        /* The index of the memory type this block is allocated on. */
+        const uint32_t memory_type;
+        /* Whether this block is used for linear resources (buffers) or non-linear resources (optimal-tiling images). The two are never mixed to respect bufferImageGranularity. */
+        const bool linear;
+
+        /* Constructor for the MemoryBlock class, which takes the device to allocate on, the memory type index to allocate with, the size of the block (in bytes), whether it will store linear resources or not and whether the block should be mapped to host memory. */
+        MemoryBlock(const Device& device, uint32_t memory_type, VkDeviceSize n_bytes, bool linear, bool host_visible);
+        /* Copy constructor for the MemoryBlock class, which is deleted. */
+        MemoryBlock(const MemoryBlock& other) = delete;
+        /* Move constructor for the MemoryBlock class. */
+        MemoryBlock(MemoryBlock&& other);
+        /* Destructor for the MemoryBlock class. */
+        ~MemoryBlock();
+
+        /* Tries to reserve n_bytes in this block with the given alignment. Returns true and sets offset if it succeeded, or returns false if there was no suitable free range. */
+        bool allocate(VkDeviceSize n_bytes, VkDeviceSize alignment, VkDeviceSize& offset);
+        /* Returns the given range to the block, merging it with any neighbouring free ranges. */
+        void free(VkDeviceSize offset, VkDeviceSize n_bytes);
+
+        /* Returns the size of the block, in bytes. */
+        inline VkDeviceSize size() const { return this->vk_size; }
+        /* Returns the number of bytes currently handed out by this block. */
+        inline VkDeviceSize used() const { return this->used_bytes; }
+        /* Returns the number of sub-allocations currently living in this block. */
+        inline size_t allocations() const { return this->n_allocations; }
+        /* Returns the number of separate free ranges in this block. */
+        inline size_t free_range_count() const { return this->free_ranges.size(); }
+        /* Returns the size of the largest free range in this block. */
+        VkDeviceSize largest_free_range() const;
+        /* Returns whether or not the block is completely unused. */
+        inline bool empty() const { return this->n_allocations == 0; }
+        /* Returns the pointer to the host-mapped memory of this block, or nullptr if it isn't host-visible. */
+        inline void* mapped() const { return this->mapped_memory; }
+
+        /* Expliticly retrieves the VkDeviceMemory object that this class wraps. */
+        inline VkDeviceMemory memory() const { return this->vk_memory; }
+        /* Implicitly casts this class to a VkDeviceMemory, by returning the internal object. */
+        inline operator VkDeviceMemory() const { return this->vk_memory; }
+
+    };
+
+
+
+    /* Struct that describes a single piece of memory handed out by the MemoryAllocator. */
+    struct MemoryAllocation {
+        /* The block from which this allocation was taken. */
+        MemoryBlock* block;
+        /* The VkDeviceMemory object where the allocation lives. */
+        VkDeviceMemory memory;
+        /* The offset of the allocation within the memory object. */
+        VkDeviceSize offset;
+        /* The size of the allocation, in bytes. */
+        VkDeviceSize size;
+        /* Pointer to where the allocation is mapped in host memory, or nullptr if the memory isn't host-visible. */
+        void* mapped;
+    };
+
+    /* Struct that collects statistics on the current state of a MemoryAllocator. */
+    struct MemoryAllocatorStats {
+        /* The number of VkDeviceMemory blocks currently allocated. */
+        size_t n_blocks;
+        /* The number of sub-allocations currently handed out. */
+        size_t n_allocations;
+        /* The total number of vkAllocateMemory-calls done over the lifetime of the allocator. */
+        size_t n_device_allocations;
+        /* The total number of bytes allocated on the device. */
+        VkDeviceSize bytes_reserved;
+        /* The total number of bytes handed out to resources. */
+        VkDeviceSize bytes_used;
+        /* The total number of separate free ranges over all blocks. */
+        size_t n_free_ranges;
+        /* The largest free range over all blocks, in bytes. */
+        VkDeviceSize largest_free_range;
+        /* The fragmentation of the free memory, as 1 - (sum of each block's largest free range / total free bytes). 0 means each block's free memory is in one piece. */
+        double fragmentation;
+    };
+
+    /* The MemoryAllocator class, which manages MemoryBlocks for all memory types on the device and sub-allocates from them. */
+    class MemoryAllocator {
+    private:
+        /* The memory properties of the physical device, cached. */
+        VkPhysicalDeviceMemoryProperties vk_memory_properties;
+        /* The granularity with which non-coherent memory must be flushed, cached. */
+        VkDeviceSize vk_non_coherent_atom_size;
+        /* The list of all blocks, over all memory types. */
+        Tools::Array<MemoryBlock*> blocks;
+        /* The default size of each new block, in bytes. */
+        VkDeviceSize block_size;
+        /* The number of vkAllocateMemory-calls done so far. */
+        size_t n_device_allocations;
+        /* The ranges of non-coherent memory written to since the last flush(). */
+        Tools::Array<VkMappedMemoryRange> dirty_ranges;
+
+    public:
+        /* The device where this allocator allocates on. */
+        const Device& device;
+
+        /* Constructor for the MemoryAllocator class, which takes the device to allocate on and optionally the size of each block (in bytes). Larger resources will get a block of their own size. */
+        MemoryAllocator(const Device& device, VkDeviceSize block_size = 64 * 1024 * 1024);
+        /* Copy constructor for the MemoryAllocator class, which is deleted. */
+        MemoryAllocator(const MemoryAllocator& other) = delete;
+        /* Move constructor for the MemoryAllocator class. */
+        MemoryAllocator(MemoryAllocator&& other);
+        /* Destructor for the MemoryAllocator class. */
+        ~MemoryAllocator();
+
+        /* Returns the appropriate memory type based on the given type filter (as given by VkMemoryRequirements) and the required properties. */
+        uint32_t get_memory_type(uint32_t type_filter, VkMemoryPropertyFlags properties) const;
+
+        /* Allocates memory for a resource with the given requirements and properties. The linear flag should be true for buffers and linear images, and false for optimal-tiling images. */
+        MemoryAllocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool linear = true);
+        /* Returns the given allocation to its block. The allocation's memory will be set to nullptr afterwards. */
+        void free(MemoryAllocation& allocation);
+        /* Releases all blocks that are completely unused back to the device. Ranges of them that are still waiting to be flushed are dropped, since nothing lives there anymore. */
+        void trim();
+
+        /* Marks the given range (relative to the start of the allocation) as written by the host. Does nothing if the allocation lives in coherent memory. */
+        void mark_dirty(const MemoryAllocation& allocation, VkDeviceSize offset, VkDeviceSize n_bytes);
+        /* Flushes all ranges marked dirty since the last call in a single vkFlushMappedMemoryRanges-call. Should be called once per frame, before submitting the work that reads them. */
+        void flush();
+        /* Invalidates the given range (relative to the start of the allocation), so that device writes become visible to the host. Does nothing if the allocation lives in coherent memory. */
+        void invalidate(const MemoryAllocation& allocation, VkDeviceSize offset, VkDeviceSize n_bytes);
+
+        /* Returns statistics on the current state of the allocator. */
+        MemoryAllocatorStats stats() const;
+        /* Returns the properties of the given memory type. */
+        inline VkMemoryPropertyFlags memory_type_properties(uint32_t memory_type) const { return this->vk_memory_properties.memoryTypes[memory_type].propertyFlags; }
+        /* Returns whether or not the given memory type is host-visible but not host-coherent, i.e., needs explicit flushes. */
+        inline bool needs_flush(uint32_t memory_type) const { VkMemoryPropertyFlags flags = this->memory_type_properties(memory_type); return (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && !(flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT); }
+
+    };
+}
+
+#endif
@@ -0,0 +1,139 @@
+/* PARALLEL RECORDER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:53:29
+ * Last edited:
+ *   16/10/2026, 23:19:27
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ParallelRecorder class, which records long lists of
+ *   draws into secondary command buffers on the workers of a job system.
+ *   Each thread records with transient command pools of its own, one per
+ *   frame in flight, since a pool may only be used by one thread at a
+ *   time. The secondaries are executed in order by a single primary
+ *   command buffer, and are kept until the frame is recorded again so
+ *   that they can be executed again in the meantime.
+**/
+
+#include "Debug/Debug.hpp"
+#include "ParallelRecorder.hpp"
+
+using namespace std;
+using namespace HelloVikingRoom::Vulkan;
+using namespace Debug::SeverityValues;
+
+
+/***** PARALLELRECORDER CLASS *****/
+/* Constructor for the ParallelRecorder class, which takes the device to record for, the job system to record on, the queue family the primaries are submitted to and the number of frames to keep secondaries for. Like any command pool, it should outlive the device's deletion queue. */
+ParallelRecorder::ParallelRecorder(const Device& device, Tools::JobSystem& job_system, uint32_t queue_family, uint32_t n_frames) :
+    job_system(job_system),
+    device(device)
+{
+    DENTER("Vulkan::ParallelRecorder::ParallelRecorder");
+    DLOGF(info, "Creating parallel recorder with {} command allocators...", job_system.size() + 1);
+
+    // Create an allocator for every worker, plus one for the calling thread, since that helps out while it waits
+    this->allocators.reserve(job_system.size() + 1);
+    for (size_t i = 0; i < job_system.size() + 1; i++) {
+        this->allocators.push_back(new FrameCommandAllocator(device, queue_family, n_frames));
+    }
+
+    // Prepare the lists of secondaries
+    this->resize(n_frames);
+
+    DLEAVE;
+}
+
+/* Destructor for the ParallelRecorder class. */
+ParallelRecorder::~ParallelRecorder() {
+    DENTER("Vulkan::ParallelRecorder::~ParallelRecorder");
+    DLOG(info, "Cleaning parallel recorder...");
+
+    for (size_t i = 0; i < this->allocators.size(); i++) {
+        delete this->allocators[i];
+    }
+
+    DLEAVE;
+}
+
+
+
+/* Records n_draws draws for the given frame in secondaries of at most grain_size draws each, by calling the given function for each range on the job system, and executes them in the given primary. The primary must be in the given subpass of the given render pass, begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS. The framebuffer may be VK_NULL_HANDLE if the secondaries should be executable on any framebuffer. The frame's pools are reset first, which releases its previous secondaries, so the device must be done with everything the frame submitted before and the primary they were executed in must not be submitted again. If there are no draws, nothing is recorded and executing the frame does nothing until it's recorded again. */
+void ParallelRecorder::record(VkCommandBuffer primary, uint32_t frame, VkRenderPass render_pass, uint32_t subpass, VkFramebuffer framebuffer, size_t n_draws, size_t grain_size, const RecordFunction& function) {
+    DENTER("Vulkan::ParallelRecorder::record");
+    if (grain_size == 0) { grain_size = 1; }
+
+    // Reset the frame's pools on every thread in one go, which makes all of its previous secondaries free again. This happens here rather than on the workers, since a worker may never get to record a range
+    for (size_t i = 0; i < this->allocators.size(); i++) {
+        this->allocators[i]->begin_frame(frame);
+    }
+
+    // Without any draws, forget the old secondaries too, so that executing the frame again doesn't replay the draws of a scene that's gone
+    Tools::Array<VkCommandBuffer>& frame_handles = this->handles[frame];
+    if (n_draws == 0) {
+        frame_handles.clear();
+        DRETURN;
+    }
+
+    // Each range of draws gets its own secondary, whose handle goes to the range's index so that the draws are executed in order no matter which thread recorded them
+    size_t n_ranges = (n_draws + grain_size - 1) / grain_size;
+    frame_handles.resize(n_ranges);
+    this->job_system.parallel_for(n_ranges, 1, [this, &frame_handles, render_pass, subpass, framebuffer, n_draws, grain_size, &function](size_t start_range, size_t stop_range) {
+        // Only this thread uses its allocator at the moment
+        FrameCommandAllocator& allocator = *this->allocators[this->job_system.worker_index()];
+        for (size_t i = start_range; i < stop_range; i++) {
+            CommandBuffer& secondary = allocator.allocate(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+            // Record the range. It isn't recorded for one submit only, since it may be executed again until the frame is recorded again
+            size_t start_index = i * grain_size;
+            size_t stop_index = start_index + grain_size < n_draws ? start_index + grain_size : n_draws;
+            secondary.begin(render_pass, subpass, framebuffer);
+            function(secondary, start_index, stop_index);
+            secondary.end();
+            frame_handles[i] = secondary;
+        }
+    });
+
+    // Run them all from the primary
+    this->execute(primary, frame);
+
+    DRETURN;
+}
+
+/* Executes the secondaries last recorded for the given frame in the given primary again, which must be in the same state as record() expects. The device must be done with the primary they were executed in before. */
+void ParallelRecorder::execute(VkCommandBuffer primary, uint32_t frame) {
+    DENTER("Vulkan::ParallelRecorder::execute");
+
+    const Tools::Array<VkCommandBuffer>& frame_handles = this->handles[frame];
+    if (frame_handles.size() > 0) {
+        vkCmdExecuteCommands(primary, static_cast<uint32_t>(frame_handles.size()), frame_handles.rdata());
+    }
+
+    DRETURN;
+}
+
+
+
+/* Keeps secondaries for the given number of frames from now on. The frames that are removed must not be in use by the device anymore. */
+void ParallelRecorder::resize(uint32_t n_frames) {
+    DENTER("Vulkan::ParallelRecorder::resize");
+
+    // Give every thread's allocator a pool for each frame
+    for (size_t i = 0; i < this->allocators.size(); i++) {
+        this->allocators[i]->resize(n_frames);
+    }
+
+    // Drop the handles of frames we lose, and add empty lists for the ones we gain
+    while (this->handles.size() > n_frames) {
+        this->handles.pop_back();
+    }
+    this->handles.reserve(n_frames);
+    while (this->handles.size() < n_frames) {
+        this->handles.push_back(Tools::Array<VkCommandBuffer>());
+    }
+
+    DRETURN;
+}
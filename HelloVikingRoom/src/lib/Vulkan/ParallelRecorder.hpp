@@ -0,0 +1,81 @@
+/* PARALLEL RECORDER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:53:29
+ * Last edited:
+ *   16/10/2026, 23:19:27
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the ParallelRecorder class, which records long lists of
+ *   draws into secondary command buffers on the workers of a job system.
+ *   Each thread records with transient command pools of its own, one per
+ *   frame in flight, since a pool may only be used by one thread at a
+ *   time. The secondaries are executed in order by a single primary
+ *   command buffer, and are kept until the frame is recorded again so
+ *   that they can be executed again in the meantime.
+**/
+
+#ifndef VULKAN_PARALLEL_RECORDER_HPP
+#define VULKAN_PARALLEL_RECORDER_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "Vulkan/Device.hpp"
+#include "Vulkan/CommandPool.hpp"
+#include "Vulkan/FrameCommandAllocator.hpp"
+#include "Tools/Array.hpp"
+#include "Tools/JobSystem.hpp"
+
+namespace HelloVikingRoom::Vulkan {
+    /* The ParallelRecorder class, which splits a list of draws over the workers of a job system, records each part in a secondary command buffer and executes those in a primary one. */
+    class ParallelRecorder {
+    public:
+        /* The function that records the draws in [start_index, stop_index) in the given secondary command buffer. Secondaries inherit nothing but the render pass, so it has to bind the pipeline, dynamic state, buffers and descriptor sets itself. It's called on several threads at once. */
+        using RecordFunction = std::function<void(VkCommandBuffer command_buffer, size_t start_index, size_t stop_index)>;
+
+    private:
+        /* The job system whose workers record the secondaries. */
+        Tools::JobSystem& job_system;
+        /* The command allocators, one per worker plus one for the thread that calls record(), each with a transient pool per frame. */
+        Tools::Array<FrameCommandAllocator*> allocators;
+        /* The handles of the secondaries recorded for each frame, in the order of their draws. They're kept until the frame is recorded again. */
+        Tools::Array<Tools::Array<VkCommandBuffer>> handles;
+
+    public:
+        /* The device where the command buffers live. */
+        const Device& device;
+
+        /* Constructor for the ParallelRecorder class, which takes the device to record for, the job system to record on, the queue family the primaries are submitted to and the number of frames to keep secondaries for. Like any command pool, it should outlive the device's deletion queue. */
+        ParallelRecorder(const Device& device, Tools::JobSystem& job_system, uint32_t queue_family, uint32_t n_frames);
+        /* Copy constructor for the ParallelRecorder class, which is deleted. */
+        ParallelRecorder(const ParallelRecorder& other) = delete;
+        /* Move constructor for the ParallelRecorder class, which is deleted since jobs refer to it while recording. */
+        ParallelRecorder(ParallelRecorder&& other) = delete;
+        /* Destructor for the ParallelRecorder class. */
+        ~ParallelRecorder();
+
+        /* Records n_draws draws for the given frame in secondaries of at most grain_size draws each, by calling the given function for each range on the job system, and executes them in the given primary. The primary must be in the given subpass of the given render pass, begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS. The framebuffer may be VK_NULL_HANDLE if the secondaries should be executable on any framebuffer. The frame's pools are reset first, which releases its previous secondaries, so the device must be done with everything the frame submitted before and the primary they were executed in must not be submitted again. If there are no draws, nothing is recorded and executing the frame does nothing until it's recorded again. */
+        void record(VkCommandBuffer primary, uint32_t frame, VkRenderPass render_pass, uint32_t subpass, VkFramebuffer framebuffer, size_t n_draws, size_t grain_size, const RecordFunction& function);
+        /* Executes the secondaries last recorded for the given frame in the given primary again, which must be in the same state as record() expects. The device must be done with the primary they were executed in before. */
+        void execute(VkCommandBuffer primary, uint32_t frame);
+
+        /* Keeps secondaries for the given number of frames from now on. The frames that are removed must not be in use by the device anymore. */
+        void resize(uint32_t n_frames);
+
+        /* Returns the number of frames secondaries are kept for. */
+        inline uint32_t frames() const { return static_cast<uint32_t>(this->handles.size()); }
+        /* Returns the number of secondaries last recorded for the given frame. */
+        inline size_t secondaries(uint32_t frame) const { return this->handles[frame].size(); }
+        /* Returns the number of command allocators, i.e., the number of threads that may record at the same time. */
+        inline size_t pools() const { return this->allocators.size(); }
+
+    };
+}
+
+#endif
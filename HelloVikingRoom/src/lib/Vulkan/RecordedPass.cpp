@@ -0,0 +1,89 @@
+/* RECORDED PASS.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 20:23:47
+ * Last edited:
+ *   16/10/2026, 23:22:10
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the RecordedPass class, which keeps the draws of a single
+ *   subpass recorded in secondary command buffers for every frame in
+ *   flight. Each frame records a fresh primary that executes them, but the
+ *   secondaries themselves are only recorded again once the pass is marked
+ *   dirty, e.g., because the scene or the swapchain changed.
+**/
+
+#include "Debug/Debug.hpp"
+#include "RecordedPass.hpp"
+
+using namespace std;
+using namespace HelloVikingRoom::Vulkan;
+using namespace Debug::SeverityValues;
+
+
+/***** RECORDEDPASS CLASS *****/
+/* Constructor for the RecordedPass class, which takes the device to record for, the job system to record on, the queue family the primaries are submitted to, the number of frames in flight, the name of the pass and optionally when to record. Like any command pool, it should outlive the device's deletion queue. */
+RecordedPass::RecordedPass(const Device& device, Tools::JobSystem& job_system, uint32_t queue_family, uint32_t n_frames, const std::string& name, RecordMode mode) :
+    recorder(device, job_system, queue_family, n_frames),
+    version(1),
+    n_recordings(0),
+    name(name),
+    mode(mode)
+{
+    DENTER("Vulkan::RecordedPass::RecordedPass");
+    DLOGF(info, "Creating pass '{}' that records {}...", name, mode == RecordModes::always ? "every frame" : "when dirty");
+
+    // No frame has recorded anything yet, so they all start out dirty
+    this->resize(n_frames);
+
+    DLEAVE;
+}
+
+
+
+/* Executes the pass' n_draws draws for the given frame in the given primary, which must be in the given subpass of the given render pass, begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS. If the frame is dirty, they're first recorded in secondaries of at most grain_size draws each by calling the given function for each range on the job system; since those are executed on any framebuffer, they may not depend on it. The device must be done with everything the frame submitted before. Returns whether the draws were recorded. */
+bool RecordedPass::execute(VkCommandBuffer primary, uint32_t frame, VkRenderPass render_pass, uint32_t subpass, size_t n_draws, size_t grain_size, const ParallelRecorder::RecordFunction& function) {
+    DENTER("Vulkan::RecordedPass::execute");
+
+    // If the frame's secondaries are still up-to-date, simply execute them again
+    if (!this->is_dirty(frame)) {
+        this->recorder.execute(primary, frame);
+        DRETURN false;
+    }
+
+    // Otherwise, record them again. They're recorded without a framebuffer, since a frame in flight renders to whichever swapchain image it gets
+    DLOGF(info, "Recording pass '{}' for frame {}...", this->name, frame);
+    this->recorder.record(primary, frame, render_pass, subpass, VK_NULL_HANDLE, n_draws, grain_size, function);
+    this->recorded_versions[frame] = this->version;
+    ++this->n_recordings;
+    DRETURN true;
+}
+
+
+
+/* Marks the pass dirty, so that every frame records its draws again the next time it executes them. Should be called whenever something the draws depend on changes, e.g., the scene, the pipeline or the extent of the swapchain. */
+void RecordedPass::mark_dirty() {
+    DENTER("Vulkan::RecordedPass::mark_dirty");
+
+    // Every frame that recorded at an older version is dirty from now on
+    ++this->version;
+
+    DRETURN;
+}
+
+/* Keeps secondaries for the given number of frames from now on, which marks the pass dirty. The frames that are removed must not be in use by the device anymore. */
+void RecordedPass::resize(uint32_t n_frames) {
+    DENTER("Vulkan::RecordedPass::resize");
+
+    // Resize the recorder, and start all frames over as never recorded
+    this->recorder.resize(n_frames);
+    this->recorded_versions.resize(n_frames);
+    for (uint32_t i = 0; i < n_frames; i++) {
+        this->recorded_versions[i] = 0;
+    }
+
+    DRETURN;
+}
@@ -0,0 +1,89 @@
+/* RECORDED PASS.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 20:23:47
+ * Last edited:
+ *   16/10/2026, 22:05:41
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the RecordedPass class, which keeps the draws of a single
+ *   subpass recorded in secondary command buffers for every frame in
+ *   flight. Each frame records a fresh primary that executes them, but the
+ *   secondaries themselves are only recorded again once the pass is marked
+ *   dirty, e.g., because the scene or the swapchain changed.
+**/
+
+#ifndef VULKAN_RECORDED_PASS_HPP
+#define VULKAN_RECORDED_PASS_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Vulkan/Device.hpp"
+#include "Vulkan/ParallelRecorder.hpp"
+#include "Tools/Array.hpp"
+#include "Tools/JobSystem.hpp"
+
+namespace HelloVikingRoom::Vulkan {
+    /* Enum that defines when a RecordedPass records its draws. */
+    namespace RecordModes {
+        enum type {
+            /* Records the draws every frame. */
+            always = 0,
+            /* Only records the draws for a frame if the pass was marked dirty since that frame last recorded them, and executes the old ones otherwise. */
+            dirty = 1
+        };
+    }
+    using RecordMode = RecordModes::type;
+
+    /* The RecordedPass class, which records the draws of a subpass into secondaries per frame in flight, and only records them again if they're out-of-date. */
+    class RecordedPass {
+    private:
+        /* The recorder that records the secondaries and keeps them per frame. */
+        ParallelRecorder recorder;
+        /* The version of the pass' contents, which is increased every time it's marked dirty. */
+        uint64_t version;
+        /* The version each frame last recorded its secondaries at. A frame is dirty if that's not the current version. */
+        Tools::Array<uint64_t> recorded_versions;
+        /* The number of times any frame recorded its secondaries. */
+        size_t n_recordings;
+
+    public:
+        /* The name of the pass, as used in the logs. */
+        const std::string name;
+        /* When the pass records its draws. */
+        const RecordMode mode;
+
+        /* Constructor for the RecordedPass class, which takes the device to record for, the job system to record on, the queue family the primaries are submitted to, the number of frames in flight, the name of the pass and optionally when to record. Like any command pool, it should outlive the device's deletion queue. */
+        RecordedPass(const Device& device, Tools::JobSystem& job_system, uint32_t queue_family, uint32_t n_frames, const std::string& name, RecordMode mode = RecordModes::dirty);
+        /* Copy constructor for the RecordedPass class, which is deleted. */
+        RecordedPass(const RecordedPass& other) = delete;
+        /* Move constructor for the RecordedPass class, which is deleted since its recorder can't be moved either. */
+        RecordedPass(RecordedPass&& other) = delete;
+
+        /* Executes the pass' n_draws draws for the given frame in the given primary, which must be in the given subpass of the given render pass, begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS. If the frame is dirty, they're first recorded in secondaries of at most grain_size draws each by calling the given function for each range on the job system; since those are executed on any framebuffer, they may not depend on it. The device must be done with everything the frame submitted before. Returns whether the draws were recorded. */
+        bool execute(VkCommandBuffer primary, uint32_t frame, VkRenderPass render_pass, uint32_t subpass, size_t n_draws, size_t grain_size, const ParallelRecorder::RecordFunction& function);
+
+        /* Marks the pass dirty, so that every frame records its draws again the next time it executes them. Should be called whenever something the draws depend on changes, e.g., the scene, the pipeline or the extent of the swapchain. */
+        void mark_dirty();
+        /* Keeps secondaries for the given number of frames from now on, which marks the pass dirty. The frames that are removed must not be in use by the device anymore. */
+        void resize(uint32_t n_frames);
+
+        /* Returns whether the given frame has to record its draws again the next time it executes them. */
+        inline bool is_dirty(uint32_t frame) const { return this->mode == RecordModes::always || this->recorded_versions[frame] != this->version; }
+        /* Returns the number of times any frame recorded its draws so far. */
+        inline size_t recordings() const { return this->n_recordings; }
+        /* Returns the number of secondaries the given frame executes, i.e., 0 if it last recorded no draws. */
+        inline size_t secondaries(uint32_t frame) const { return this->recorder.secondaries(frame); }
+        /* Returns the number of frames. */
+        inline uint32_t frames() const { return static_cast<uint32_t>(this->recorded_versions.size()); }
+
+    };
+}
+
+#endif
@@ -4,7 +4,7 @@
  * Created:
  *   09/01/2021, 13:59:38
  * Last edited:
- *   09/01/2021, 13:59:38
+ *   16/10/2026, 17:44:50
  * Auto updated?
  *   Yes
  *
@@ -52,8 +52,10 @@ namespace HelloVikingRoom::Vulkan {
         /* Destructor for the RenderPass class. */
         virtual ~RenderPass();
 
-        /* Virtual function that re-generates the RenderPass from the internal structs. Assumes the device is not currently using this RenderPass. */
-        virtual void resize(const Swapchain& swapchain) = 0;
+        /* Virtual function that re-generates the RenderPass from the internal structs for the given image format. If the device has no deletion queue, assumes the device is not currently using this RenderPass. */
+        virtual void resize(VkFormat format) = 0;
+        /* Re-generates the RenderPass from the internal structs for the format of the given swapchain. */
+        inline void resize(const Swapchain& swapchain) { this->resize(swapchain.format()); }
 
         /* Explicitly retrieves a constant refrence to the internal VkRenderPass object. */
         inline VkRenderPass render_pass() const { return this->vk_render_pass; }
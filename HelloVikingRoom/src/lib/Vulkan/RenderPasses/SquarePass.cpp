@@ -4,7 +4,7 @@
  * Created:
  *   11/01/2021, 17:37:09
  * Last edited:
- *   11/01/2021, 17:37:09
+ *   16/10/2026, 17:44:50
  * Auto updated?
  *   Yes
  *
@@ -16,6 +16,7 @@
 
 #include "Debug/Debug.hpp"
 #include "SquarePass.hpp"
+#include "Vulkan/DeletionQueue.hpp"
 
 using namespace std;
 using namespace HelloVikingRoom::Vulkan::RenderPasses;
@@ -26,6 +27,11 @@ using namespace Debug::SeverityValues;
 /***** SQUAERPASS CLASS *****/
 /* Constructor for the SquarePass class, which takes the device this render pass is bound to and the swapchain to take the image format from. */
 SquarePass::SquarePass(const Device& device, const Swapchain& swapchain) :
+    SquarePass(device, swapchain.format(), VK_IMAGE_LAYOUT_PRESENT_SRC_KHR)
+{}
+
+/* Constructor for the SquarePass class, which takes the device this render pass is bound to, the format of the images rendered to and the layout they should be left in. Used to render to offscreen images instead of a swapchain. */
+SquarePass::SquarePass(const Device& device, VkFormat format, VkImageLayout final_layout) :
     RenderPass(device)
 {
     DENTER("Vulkan::RenderPasses::SquarePass::SquarePass");
@@ -44,8 +50,8 @@ SquarePass::SquarePass(const Device& device, const Swapchain& swapchain) :
     this->vk_attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     // For textures, we have to define the layout of the image at the start and at the end. We don't care what it is when we begin...
     this->vk_attachments[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    // ...but when we're done, it must have a presenteable format
-    this->vk_attachments[0].finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    // ...but when we're done, it must have the given layout (presentable for swapchain images, or something to copy from for offscreen ones)
+    this->vk_attachments[0].finalLayout = final_layout;
 
     // We have to define a reference to the attachment above. We use only one subpass, i.e., one reference to the first index
     this->vk_attachments_refs.push_back({});
@@ -76,8 +82,22 @@ SquarePass::SquarePass(const Device& device, const Swapchain& swapchain) :
     this->vk_subpasses_dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     this->vk_subpasses_dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 
+    // If the image is left ready to be copied from (i.e., it's offscreen), also make sure that any transfers after this pass wait until it's written
+    if (final_layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+        this->vk_subpasses_dependencies.push_back({});
+        // This time, we're the ones that have to be done first
+        this->vk_subpasses_dependencies[1].srcSubpass = 0;
+        this->vk_subpasses_dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+        // Wait until the colours are written...
+        this->vk_subpasses_dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        this->vk_subpasses_dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        // ...before any transfer reads them
+        this->vk_subpasses_dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        this->vk_subpasses_dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    }
+
     // Use our internal regeneration function to do the final steps
-    this->resize(swapchain);
+    this->resize(format);
 
     // Done!
     DLEAVE;
@@ -97,17 +117,27 @@ SquarePass::~SquarePass() {
 
 
 
-/* Virtual function that re-generates the RenderPass from the internal structs. Assumes the device is not currently using this RenderPass. */
-void SquarePass::resize(const Swapchain& swapchain) {
+/* Virtual function that re-generates the RenderPass from the internal structs. Only does so if the format changed, and retires the old one through the device's deletion queue if it has one. */
+void SquarePass::resize(VkFormat format) {
     DENTER("Vulkan::RenderPasses::SquarePass::resize");
 
-    // Destroy the old one if there is one
+    // The render pass only depends on the format of the images, not their size, so we only have to re-create it if that changed
+    if (this->vk_render_pass != nullptr && this->vk_attachments[0].format == format) {
+        DRETURN;
+    }
+
+    // Destroy the old one if there is one, deferring it if the device has a deletion queue
     if (this->vk_render_pass != nullptr) {
-        vkDestroyRenderPass(this->device, this->vk_render_pass, nullptr);
+        DeletionQueue* deletion_queue = this->device.deletion_queue();
+        if (deletion_queue != nullptr) {
+            deletion_queue->defer_render_pass(this->vk_render_pass);
+        } else {
+            vkDestroyRenderPass(this->device, this->vk_render_pass, nullptr);
+        }
     }
 
-    // Update the format of the window in the render pass
-    this->vk_attachments[0].format = swapchain.format();
+    // Update the format of the images in the render pass
+    this->vk_attachments[0].format = format;
 
     // Create the create info for this pass
     VkRenderPassCreateInfo render_pass_info{};
@@ -4,7 +4,7 @@
  * Created:
  *   11/01/2021, 17:32:58
  * Last edited:
- *   11/01/2021, 17:32:58
+ *   16/10/2026, 17:44:50
  * Auto updated?
  *   Yes
  *
@@ -25,6 +25,8 @@ namespace HelloVikingRoom::Vulkan::RenderPasses {
     public:
         /* Constructor for the SquarePass class, which takes the device this render pass is bound to and the swapchain to take the image format from. */
         SquarePass(const Device& device, const Swapchain& swapchain);
+        /* Constructor for the SquarePass class, which takes the device this render pass is bound to, the format of the images rendered to and the layout they should be left in. Used to render to offscreen images instead of a swapchain. */
+        SquarePass(const Device& device, VkFormat format, VkImageLayout final_layout);
         /* Copy constructor for the SquarePass class, which is deleted (just like its parent). */
         SquarePass(const SquarePass& other) = delete;
         /* Move constructor for the SquarePass class. */
@@ -32,8 +34,10 @@ namespace HelloVikingRoom::Vulkan::RenderPasses {
         /* Destructor for the SquarePass class. */
         virtual ~SquarePass();
 
-        /* Virtual function that re-generates the RenderPass from the internal structs. Assumes the device is not currently using this RenderPass. */
-        virtual void resize(const Swapchain& swapchain);
+        /* Virtual function that re-generates the RenderPass from the internal structs. Only does so if the format changed, and retires the old one through the device's deletion queue if it has one. */
+        virtual void resize(VkFormat format);
+        /* Also take the swapchain overload from the RenderPass class. */
+        using RenderPass::resize;
 
     };
 }
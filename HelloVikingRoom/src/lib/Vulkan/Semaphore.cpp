@@ -4,7 +4,7 @@
  * Created:
  *   15/01/2021, 14:54:59
  * Last edited:
- *   15/01/2021, 14:54:59
+ *   16/10/2026, 17:38:08
  * Auto updated?
  *   Yes
  *
@@ -16,6 +16,7 @@
 
 #include "Debug/Debug.hpp"
 #include "Semaphore.hpp"
+#include "DeletionQueue.hpp"
 
 using namespace std;
 using namespace HelloVikingRoom::Vulkan;
@@ -68,9 +69,14 @@ Semaphore::~Semaphore() {
 void Semaphore::reset() {
     DENTER("Vulkan::Semaphore::reset");
 
-    // Destroy the old semaphore if there is one
+    // Destroy the old semaphore if there is one. If the device has a deletion queue, let that do it, since it may still have a signal pending
     if (this->vk_semaphore != nullptr) {
-        vkDestroySemaphore(this->device, this->vk_semaphore, nullptr);
+        DeletionQueue* deletion_queue = this->device.deletion_queue();
+        if (deletion_queue != nullptr) {
+            deletion_queue->defer_semaphore(this->vk_semaphore);
+        } else {
+            vkDestroySemaphore(this->device, this->vk_semaphore, nullptr);
+        }
     }
 
     // Create the new semaphore
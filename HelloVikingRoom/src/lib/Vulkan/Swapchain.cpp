@@ -4,7 +4,7 @@
  * Created:
  *   08/01/2021, 13:42:25
  * Last edited:
- *   08/01/2021, 13:42:25
+ *   16/10/2026, 21:10:25
  * Auto updated?
  *   Yes
  *
@@ -17,6 +17,7 @@
 
 #include "Debug/Debug.hpp"
 #include "Swapchain.hpp"
+#include "DeletionQueue.hpp"
 
 using namespace std;
 using namespace HelloVikingRoom::Vulkan;
@@ -25,7 +26,7 @@ using namespace Debug::SeverityValues;
 
 
 /***** SWAPCHAIN CLASS *****/
-/* Constructor for the Swapchain class, which takes the main window and a device to create the swapchain from. */
+/* Constructor for the Swapchain class, which takes the main window and a device to create the swapchain from. Asks GLFW for the window's size, so has to be called from the main thread. */
 Swapchain::Swapchain(const MainWindow& window, const Device& device) :
     vk_swapchain(nullptr),
     device(device)
@@ -77,7 +78,7 @@ Swapchain::Swapchain(const MainWindow& window, const Device& device) :
     this->vk_swapchain_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     // If the cipped property is set to true, then the colours of pixels that are omitted by windows may be arbitrary (i.e., best performance)
     this->vk_swapchain_info.clipped = VK_TRUE;
-    // This can be used to re-optimise the swapchain, but for now we'll leave it be
+    // This is used to pass the swapchain that we replace when resizing, but there is none yet
     this->vk_swapchain_info.oldSwapchain = VK_NULL_HANDLE;
 
     // Also prepare the create info for the ImageViews
@@ -97,8 +98,10 @@ Swapchain::Swapchain(const MainWindow& window, const Device& device) :
     this->vk_imageview_info.subresourceRange.baseArrayLayer = 0;
     this->vk_imageview_info.subresourceRange.layerCount = 1;
 
-    // Use the internal resize() function to create the window
-    this->resize(window);
+    // Use the internal resize() function to create the swapchain for the window's current size
+    int width, height;
+    glfwGetFramebufferSize(window, &width, &height);
+    this->resize({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) });
 
     DLEAVE;
 }
@@ -175,8 +178,8 @@ VkPresentModeKHR Swapchain::select_present_mode(const Device& device) {
     DRETURN VK_PRESENT_MODE_FIFO_KHR;
 }
 
-/* Selects the appropriate swapchain resolution based on the capabilities of the given window and the chosen device. */
-VkExtent2D Swapchain::select_resolution(const MainWindow& window, const Device& device) {
+/* Selects the appropriate swapchain resolution based on the capabilities of the chosen device, falling back to the given framebuffer size (in pixels) if the surface leaves it up to us. */
+VkExtent2D Swapchain::select_resolution(const Device& device, const VkExtent2D& framebuffer_size) {
     DENTER("Vulkan::Swapchain::select_resolution");
 
     // Distinguish between the special UINT32_MAX and just returning the extent in the capabilites (=resolution)
@@ -184,15 +187,8 @@ VkExtent2D Swapchain::select_resolution(const MainWindow& window, const Device&
     if (capabilities.currentExtent.width != UINT32_MAX) {
         DRETURN capabilities.currentExtent;
     } else {
-        // Get the current size of the window
-        int width, height;
-        glfwGetFramebufferSize(window, &width, &height);
-
-        // Store them in a Vulkan extent
-        VkExtent2D actualExtent = {
-            static_cast<uint32_t>(width),
-            static_cast<uint32_t>(height)
-        };
+        // Start from the size of the window as given by the caller
+        VkExtent2D actualExtent = framebuffer_size;
 
         // Next, update that extend with whichever is larger:
         //   - The minimum resolution that the swap chain supports
@@ -210,39 +206,45 @@ VkExtent2D Swapchain::select_resolution(const MainWindow& window, const Device&
 
 
 
-/* Regenerates the swapchain based on the new size of the given window. */
-void Swapchain::resize(const MainWindow& window) {
+/* Regenerates the swapchain for a window with the given framebuffer size (in pixels). The old swapchain is passed to the new one and retired through the device's deletion queue, if it has one, so frames in flight may still use it. Doesn't touch GLFW, so it may be called from any thread. */
+void Swapchain::resize(const VkExtent2D& framebuffer_size) {
     DENTER("Vulkan::Swapchain::resize");
 
-    // Destroy the old ImageViews if there are any
-    for (size_t i = 0; i < this->vk_imageviews.size(); i++) {
-        vkDestroyImageView(this->device, this->vk_imageviews[i], nullptr);
-    }
-    // Destroy the old swapchain if there is one
-    if (this->vk_swapchain != nullptr) {
-        vkDestroySwapchainKHR(this->device, this->vk_swapchain, nullptr);
-    }
-
     // Start by selecting the correct format, presentation mode & resolution based on our preferences (encoded in the functions) and the availability on the device
     VkSurfaceFormatKHR format = Swapchain::select_format(device);
-    VkExtent2D extent = Swapchain::select_resolution(window, this->device);
+    VkExtent2D extent = Swapchain::select_resolution(this->device, framebuffer_size);
     VkPresentModeKHR present_mode = Swapchain::select_present_mode(device);
 
     // Store some of that data locally
     this->vk_format = format.format;
     this->vk_extent = extent;
-    DLOG(auxillary, "Selected swapchain size: " + std::to_string(this->vk_extent.width) + "x" + std::to_string(this->vk_extent.height));
+    DLOGF(auxillary, "Selected swapchain size: {}x{}", this->vk_extent.width, this->vk_extent.height);
 
     // Update it in the create info
     this->vk_swapchain_info.imageFormat = this->vk_format;
     this->vk_swapchain_info.imageColorSpace = format.colorSpace;
     this->vk_swapchain_info.imageExtent = this->vk_extent;
     this->vk_swapchain_info.presentMode = present_mode;
+    // Pass the current swapchain (if any) as the one we replace, so the presentation engine can keep showing its images while we build the new one
+    VkSwapchainKHR old_swapchain = this->vk_swapchain;
+    this->vk_swapchain_info.oldSwapchain = old_swapchain;
 
     // Use that to create a new one
     if (vkCreateSwapchainKHR(this->device, &this->vk_swapchain_info, nullptr, &this->vk_swapchain) != VK_SUCCESS) {
         DLOG(fatal, "Could not create swapchain.");
     }
+    this->vk_swapchain_info.oldSwapchain = VK_NULL_HANDLE;
+
+    // Retire the old ImageViews and the old swapchain. With a deletion queue, they're only destroyed once the frames that may use them are done; otherwise, the caller has to make sure the device is idle
+    DeletionQueue* deletion_queue = this->device.deletion_queue();
+    for (size_t i = 0; i < this->vk_imageviews.size(); i++) {
+        if (deletion_queue != nullptr) { deletion_queue->defer_image_view(this->vk_imageviews[i]); }
+        else { vkDestroyImageView(this->device, this->vk_imageviews[i], nullptr); }
+    }
+    if (old_swapchain != nullptr) {
+        if (deletion_queue != nullptr) { deletion_queue->defer_swapchain(old_swapchain); }
+        else { vkDestroySwapchainKHR(this->device, old_swapchain, nullptr); }
+    }
 
     // Update the handles from the freshly created swapchain. Note that its size may have changed.
     uint32_t n_frames;
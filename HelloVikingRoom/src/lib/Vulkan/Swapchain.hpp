@@ -4,7 +4,7 @@
  * Created:
  *   08/01/2021, 13:42:20
  * Last edited:
- *   08/01/2021, 13:42:20
+ *   16/10/2026, 21:10:25
  * Auto updated?
  *   Yes
  *
@@ -49,7 +49,7 @@ namespace HelloVikingRoom::Vulkan {
         Tools::Array<uint32_t> vk_queue_indices;
 
 
-        /* Constructor for the Swapchain class, which takes the main window and a device to create the swapchain from. */
+        /* Constructor for the Swapchain class, which takes the main window and a device to create the swapchain from. Asks GLFW for the window's size, so has to be called from the main thread. */
         Swapchain(const MainWindow& window, const Device& device);
         /* Copy constructor for the Swapchain class, which is deleted. */
         Swapchain(const Swapchain& other) = delete;
@@ -62,11 +62,11 @@ namespace HelloVikingRoom::Vulkan {
         static VkSurfaceFormatKHR select_format(const Device& device);
         /* Selects the appropriate swapchain presentation mode based on the given device. */
         static VkPresentModeKHR select_present_mode(const Device& device);
-        /* Selects the appropriate swapchain resolution based on the capabilities of the given window and the chosen device. */
-        static VkExtent2D select_resolution(const MainWindow& window, const Device& device);
+        /* Selects the appropriate swapchain resolution based on the capabilities of the chosen device, falling back to the given framebuffer size (in pixels) if the surface leaves it up to us. */
+        static VkExtent2D select_resolution(const Device& device, const VkExtent2D& framebuffer_size);
 
-        /* Regenerates the swapchain based on the new size of the given window. */
-        void resize(const MainWindow& window);
+        /* Regenerates the swapchain for a window with the given framebuffer size (in pixels). The old swapchain is passed to the new one and retired through the device's deletion queue, if it has one, so frames in flight may still use it. Doesn't touch GLFW, so it may be called from any thread. */
+        void resize(const VkExtent2D& framebuffer_size);
 
         /* Explicitly returns a constant reference the images inside the Swapchain. */
         inline const Tools::Array<VkImage>& images() const { return this->vk_images; }
@@ -0,0 +1,162 @@
+/* UNIFORM RING.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 17:29:35
+ * Last edited:
+ *   16/10/2026, 18:24:50
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the UniformRing class, which wraps a single, large and
+ *   persistently mapped uniform buffer that is divided in one region per
+ *   frame. Each frame, per-object uniform data is bump-allocated from that
+ *   frame's region and bound with a dynamic offset, so that it costs no
+ *   new buffers or descriptor sets.
+**/
+
+#include <cstdint>
+#include <algorithm>
+
+#include "Debug/Debug.hpp"
+#include "UniformRing.hpp"
+
+using namespace std;
+using namespace HelloVikingRoom::Vulkan;
+using namespace Debug::SeverityValues;
+
+
+/***** HELPER FUNCTIONS *****/
+/* Rounds the given value up to the nearest multiple of the given alignment. */
+static inline VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment) {
+    return alignment > 1 ? ((value + alignment - 1) / alignment) * alignment : value;
+}
+
+
+
+
+
+/***** UNIFORMRING CLASS *****/
+/* Constructor for the UniformRing class, which takes the allocator to get the ring's memory from, the number of bytes each frame may allocate and the number of frames to keep a region for. */
+UniformRing::UniformRing(MemoryAllocator& allocator, VkDeviceSize frame_size, uint32_t n_frames) :
+    ring(nullptr),
+    n_frames(0),
+    current_frame(0),
+    head(0),
+    device(allocator.device),
+    allocator(allocator)
+{
+    DENTER("Vulkan::UniformRing::UniformRing");
+
+    // Get the alignment that dynamic offsets have to respect from the device limits
+    VkPhysicalDeviceProperties device_properties;
+    vkGetPhysicalDeviceProperties(this->device, &device_properties);
+    this->vk_alignment = std::max(device_properties.limits.minUniformBufferOffsetAlignment, (VkDeviceSize) 1);
+
+    // Round the frame size up so that every region starts aligned too
+    this->vk_frame_size = align_up(frame_size, this->vk_alignment);
+
+    // Use resize() to create the buffer itself
+    this->resize(n_frames);
+
+    DLEAVE;
+}
+
+/* Move constructor for the UniformRing class. */
+UniformRing::UniformRing(UniformRing&& other) :
+    ring(other.ring),
+    vk_alignment(other.vk_alignment),
+    vk_frame_size(other.vk_frame_size),
+    n_frames(other.n_frames),
+    current_frame(other.current_frame),
+    head(other.head),
+    device(other.device),
+    allocator(other.allocator)
+{
+    other.ring = nullptr;
+}
+
+/* Destructor for the UniformRing class. */
+UniformRing::~UniformRing() {
+    DENTER("Vulkan::UniformRing::~UniformRing");
+
+    if (this->ring != nullptr) {
+        delete this->ring;
+    }
+
+    DLEAVE;
+}
+
+
+
+/* Starts allocating from the region of the given frame, discarding everything allocated in it before. The caller must make sure the device is done with that frame's previous contents. */
+void UniformRing::begin_frame(uint32_t frame_index) {
+    DENTER("Vulkan::UniformRing::begin_frame");
+
+    // Make sure the frame has a region
+    if (frame_index >= this->n_frames) {
+        DLOG(fatal, "Frame index " + std::to_string(frame_index) + " is out of range for a uniform ring with " + std::to_string(this->n_frames) + " frames.");
+    }
+
+    // Simply move to that region and reset the bump pointer
+    this->current_frame = frame_index;
+    this->head = 0;
+
+    DRETURN;
+}
+
+/* Reserves n_bytes in the current frame's region and returns a pointer to where they are mapped. The offset to pass to vkCmdBindDescriptorSets is returned in dynamic_offset. The range is marked dirty already, so only the allocator's flush() is needed after writing it. */
+void* UniformRing::allocate(VkDeviceSize n_bytes, uint32_t& dynamic_offset) {
+    DENTER("Vulkan::UniformRing::allocate");
+
+    // Align the start of the allocation, and check if it still fits in this frame's region
+    VkDeviceSize start = align_up(this->head, this->vk_alignment);
+    if (start + n_bytes > this->vk_frame_size) {
+        DLOG(fatal, "Cannot allocate " + std::to_string(n_bytes) + " bytes in uniform ring; only " + std::to_string(this->vk_frame_size - std::min(start, this->vk_frame_size)) + " of " + std::to_string(this->vk_frame_size) + " bytes left this frame.");
+    }
+
+    // Compute where the allocation lives in the entire buffer
+    VkDeviceSize frame_start = (VkDeviceSize) this->current_frame * this->vk_frame_size;
+    dynamic_offset = static_cast<uint32_t>(frame_start + start);
+
+    // Mark everything from the previous head on as dirty, padding included, so that consecutive allocations merge into a single range in the allocator
+    this->ring->mark_dirty(frame_start + this->head, start + n_bytes - this->head);
+
+    // Bump the head and we're done
+    this->head = start + n_bytes;
+    DRETURN this->ring->data<void>(dynamic_offset);
+}
+
+
+
+/* Re-creates the ring with room for the given number of frames. Note that this replaces the internal buffer, so any descriptor sets referring to it have to be updated. */
+void UniformRing::resize(uint32_t n_frames) {
+    DENTER("Vulkan::UniformRing::resize");
+    DLOGF(info, "Creating uniform ring of {} x {} bytes...", n_frames, this->vk_frame_size);
+
+    // Dynamic offsets are 32-bit, so the entire ring has to be addressable with those
+    if ((VkDeviceSize) n_frames * this->vk_frame_size > (VkDeviceSize) UINT32_MAX) {
+        DLOG(fatal, "Uniform ring of " + std::to_string(n_frames) + " x " + std::to_string(this->vk_frame_size) + " bytes is too large to address with dynamic offsets.");
+    }
+
+    // Throw away the old buffer, if any
+    if (this->ring != nullptr) {
+        delete this->ring;
+    }
+
+    // Create the new one in host-visible memory, which the allocator keeps mapped for us
+    this->ring = new Buffer(
+        this->allocator,
+        (VkDeviceSize) n_frames * this->vk_frame_size,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    );
+    this->n_frames = n_frames;
+
+    // Reset the bump state as well
+    this->current_frame = 0;
+    this->head = 0;
+
+    DRETURN;
+}
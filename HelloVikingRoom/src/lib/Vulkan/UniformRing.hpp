@@ -0,0 +1,92 @@
+/* UNIFORM RING.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 17:29:35
+ * Last edited:
+ *   16/10/2026, 17:32:36
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the UniformRing class, which wraps a single, large and
+ *   persistently mapped uniform buffer that is divided in one region per
+ *   frame. Each frame, per-object uniform data is bump-allocated from that
+ *   frame's region and bound with a dynamic offset, so that it costs no
+ *   new buffers or descriptor sets.
+**/
+
+#ifndef VULKAN_UNIFORM_RING_HPP
+#define VULKAN_UNIFORM_RING_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+#include "Vulkan/Device.hpp"
+#include "Vulkan/MemoryAllocator.hpp"
+#include "Vulkan/Buffer.hpp"
+
+namespace HelloVikingRoom::Vulkan {
+    /* The UniformRing class, which bump-allocates per-frame uniform data from one large, host-visible buffer. */
+    class UniformRing {
+    private:
+        /* The buffer that contains the regions of all frames. Kept as a pointer so that resize() can replace it. */
+        Buffer* ring;
+        /* The alignment of each allocation, i.e., the device's minUniformBufferOffsetAlignment. */
+        VkDeviceSize vk_alignment;
+        /* The size of each frame's region, in bytes. Always a multiple of the alignment. */
+        VkDeviceSize vk_frame_size;
+        /* The number of frames that have a region in the ring. */
+        uint32_t n_frames;
+
+        /* The frame whose region is currently allocated from. */
+        uint32_t current_frame;
+        /* The number of bytes allocated so far in the current frame's region. */
+        VkDeviceSize head;
+
+    public:
+        /* The device where the ring lives. */
+        const Device& device;
+        /* The allocator where the ring got its memory from. */
+        MemoryAllocator& allocator;
+
+        /* Constructor for the UniformRing class, which takes the allocator to get the ring's memory from, the number of bytes each frame may allocate and the number of frames to keep a region for. */
+        UniformRing(MemoryAllocator& allocator, VkDeviceSize frame_size, uint32_t n_frames);
+        /* Copy constructor for the UniformRing class, which is deleted. */
+        UniformRing(const UniformRing& other) = delete;
+        /* Move constructor for the UniformRing class. */
+        UniformRing(UniformRing&& other);
+        /* Destructor for the UniformRing class. */
+        ~UniformRing();
+
+        /* Starts allocating from the region of the given frame, discarding everything allocated in it before. The caller must make sure the device is done with that frame's previous contents. */
+        void begin_frame(uint32_t frame_index);
+        /* Reserves n_bytes in the current frame's region and returns a pointer to where they are mapped. The offset to pass to vkCmdBindDescriptorSets is returned in dynamic_offset. The range is marked dirty already, so only the allocator's flush() is needed after writing it. */
+        void* allocate(VkDeviceSize n_bytes, uint32_t& dynamic_offset);
+        /* Reserves room for a T in the current frame's region and returns a pointer to it. The offset to pass to vkCmdBindDescriptorSets is returned in dynamic_offset. */
+        template <class T>
+        inline T* allocate(uint32_t& dynamic_offset) { return (T*) this->allocate(sizeof(T), dynamic_offset); }
+
+        /* Re-creates the ring with room for the given number of frames. Note that this replaces the internal buffer, so any descriptor sets referring to it have to be updated. */
+        void resize(uint32_t n_frames);
+
+        /* Returns the offset of the given frame's region in the ring, i.e., the dynamic offset of the first allocation in that frame. */
+        inline uint32_t frame_offset(uint32_t frame_index) const { return static_cast<uint32_t>(frame_index * this->vk_frame_size); }
+        /* Returns the alignment of each allocation, in bytes. */
+        inline VkDeviceSize alignment() const { return this->vk_alignment; }
+        /* Returns the size of each frame's region, in bytes. */
+        inline VkDeviceSize frame_size() const { return this->vk_frame_size; }
+        /* Returns the number of frames that have a region in the ring. */
+        inline uint32_t frames() const { return this->n_frames; }
+        /* Returns the number of bytes allocated so far in the current frame. */
+        inline VkDeviceSize used() const { return this->head; }
+
+        /* Explicitly returns the internal Buffer object. */
+        inline const Buffer& buffer() const { return *this->ring; }
+        /* Implicitly casts this class to a VkBuffer by returning the internal buffer. */
+        inline operator VkBuffer() const { return *this->ring; }
+
+    };
+}
+
+#endif
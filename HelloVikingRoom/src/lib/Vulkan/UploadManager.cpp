@@ -0,0 +1,482 @@
+/* UPLOAD MANAGER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 17:24:55
+ * Last edited:
+ *   16/10/2026, 23:31:45
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the UploadManager class, which owns a persistent ring of
+ *   staging memory and records buffer- and image uploads into batched
+ *   command buffers. Batches are submitted with a fence, and uploads
+ *   return tickets that can be polled or waited on instead of idling the
+ *   entire queue for every copy.
+ * 
+ *   If the device has a dedicated transfer queue family, the copies run
+ *   on that and ownership of the resources is handed over to the graphics
+ *   family with release / acquire barriers and a semaphore, once per
+ *   resource per batch. Later uploads into resources the graphics family
+ *   already owns are recorded on the graphics queue instead.
+**/
+
+#include <cstring>
+
+#include "Debug/Debug.hpp"
+#include "UploadManager.hpp"
+
+using namespace std;
+using namespace HelloVikingRoom::Vulkan;
+using namespace Debug::SeverityValues;
+
+
+/***** CONSTANTS *****/
+/* The alignment of every region in the staging ring. Covers both the 4-byte requirement of buffer-to-image copies and the texel size of our formats. */
+static const VkDeviceSize staging_alignment = 16;
+
+
+
+
+
+/***** HELPER FUNCTIONS *****/
+/* Rounds the given value up to the nearest multiple of the given alignment. */
+static inline VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment) {
+    return alignment > 1 ? ((value + alignment - 1) / alignment) * alignment : value;
+}
+
+
+
+
+
+/***** UPLOADMANAGER CLASS *****/
+/* Constructor for the UploadManager class, which takes the allocator to get the staging memory from (and thus the device to upload to) and optionally the size of the staging ring, in bytes. */
+UploadManager::UploadManager(MemoryAllocator& allocator, VkDeviceSize staging_size) :
+    command_allocator(allocator.device, allocator.device.get_queue_info().transfer(), UploadManager::n_batches),
+    command_buffer(nullptr),
+    acquire_allocator(allocator.device, allocator.device.get_queue_info().graphics(), allocator.device.get_queue_info().dedicated_transfer() ? UploadManager::n_batches : 0),
+    acquire_buffer(nullptr),
+    semaphores(UploadManager::n_batches),
+    fences(UploadManager::n_batches),
+    batches(UploadManager::n_batches),
+    profiler(nullptr),
+    profiler_scope(0),
+    staging(allocator, staging_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+    ring_head(0),
+    ring_tail(0),
+    current_slot(0),
+    oldest_slot(0),
+    n_in_flight(0),
+    recording(false),
+    next_ticket(1),
+    completed_ticket(0),
+    device(allocator.device),
+    allocator(allocator),
+    dedicated(allocator.device.get_queue_info().dedicated_transfer()),
+    transfer_family(allocator.device.get_queue_info().transfer()),
+    graphics_family(allocator.device.get_queue_info().graphics()),
+    queue(allocator.device.transfer_queue()),
+    graphics_queue(allocator.device.graphics_queue())
+{
+    DENTER("Vulkan::UploadManager::UploadManager");
+    DLOGF(info, "Creating upload manager with a staging ring of {} bytes{}...", staging_size, this->dedicated ? " on a dedicated transfer queue" : "");
+
+    // With a dedicated transfer family, we also need the semaphores to hand the resources over to the graphics family
+    if (this->dedicated) {
+        for (size_t i = 0; i < UploadManager::n_batches; i++) {
+            this->semaphores.push_back(new Semaphore(this->device));
+        }
+    }
+
+    // Prepare the fence and the (empty) state of each batch slot
+    for (size_t i = 0; i < UploadManager::n_batches; i++) {
+        this->fences.push_back(new Fence(this->device));
+        this->batches.push_back(UploadBatch({ 0, 0, false, Tools::Array<Buffer*>() }));
+    }
+
+    DLEAVE;
+}
+
+/* Destructor for the UploadManager class. Waits until all batches in flight are done. */
+UploadManager::~UploadManager() {
+    DENTER("Vulkan::UploadManager::~UploadManager");
+    DLOG(info, "Cleaning upload manager...");
+
+    // Make sure the device is done with the staging memory before we free it. Anything still recording is simply dropped.
+    while (this->n_in_flight > 0) {
+        this->retire_oldest();
+    }
+    for (size_t i = 0; i < this->batches.size(); i++) {
+        for (size_t j = 0; j < this->batches[i].oversized.size(); j++) {
+            delete this->batches[i].oversized[j];
+        }
+    }
+    for (size_t i = 0; i < this->semaphores.size(); i++) {
+        delete this->semaphores[i];
+    }
+    for (size_t i = 0; i < this->fences.size(); i++) {
+        delete this->fences[i];
+    }
+
+    DLEAVE;
+}
+
+
+
+/* Makes sure the current slot is recording, and returns its command buffer. */
+CommandBuffer& UploadManager::begin_batch() {
+    DENTER("Vulkan::UploadManager::begin_batch");
+
+    if (!this->recording) {
+        // If the slot is still in use by an earlier batch, wait for it first. Since we use the slots round-robin, that's always the oldest one.
+        if (this->batches[this->current_slot].in_flight) {
+            this->retire_oldest();
+        }
+
+        // The device is done with the slot's command buffers now, so reset its pools in one go and start recording in the slot
+        this->command_allocator.begin_frame((uint32_t) this->current_slot);
+        this->command_buffer = &this->command_allocator.allocate();
+        this->command_buffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        // If we time the batches, reset the slot's queries before anything else is recorded and start the scope around all of its copies
+        if (this->profiler != nullptr) {
+            this->profiler->begin_frame(*this->command_buffer, (uint32_t) this->current_slot);
+            this->profiler_scope = this->profiler->begin_scope(*this->command_buffer, (uint32_t) this->current_slot, "upload");
+        }
+        if (this->dedicated) {
+            this->acquire_allocator.begin_frame((uint32_t) this->current_slot);
+            this->acquire_buffer = &this->acquire_allocator.allocate();
+            this->acquire_buffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        }
+        this->batches[this->current_slot].ticket = this->next_ticket++;
+        this->recording = true;
+    }
+
+    DRETURN *this->command_buffer;
+}
+
+/* Waits for the oldest batch in flight and releases its resources. */
+void UploadManager::retire_oldest() {
+    DENTER("Vulkan::UploadManager::retire_oldest");
+
+    // Wait until the device is done with it, after which its timings can be read back without stalling
+    UploadBatch& batch = this->batches[this->oldest_slot];
+    this->fences[this->oldest_slot]->wait();
+    if (this->profiler != nullptr) {
+        this->profiler->collect((uint32_t) this->oldest_slot);
+    }
+
+    // Release its part of the ring and any dedicated staging buffers
+    this->ring_tail = batch.ring_mark;
+    for (size_t i = 0; i < batch.oversized.size(); i++) {
+        delete batch.oversized[i];
+    }
+    batch.oversized.clear();
+
+    // Mark it as done
+    this->completed_ticket = batch.ticket;
+    batch.in_flight = false;
+    this->oldest_slot = (this->oldest_slot + 1) % UploadManager::n_batches;
+    --this->n_in_flight;
+
+    DRETURN;
+}
+
+/* Reserves n_bytes in the staging ring with the given alignment, waiting for (or submitting) batches if it's full. Returns the offset in the staging buffer. */
+VkDeviceSize UploadManager::reserve(VkDeviceSize n_bytes, VkDeviceSize alignment) {
+    DENTER("Vulkan::UploadManager::reserve");
+
+    VkDeviceSize ring_size = this->staging.size();
+    while (true) {
+        // Compute where the region would start; if it runs past the end of the ring, skip the remainder and start at the front
+        VkDeviceSize position = this->ring_head % ring_size;
+        VkDeviceSize start = align_up(position, alignment);
+        if (start + n_bytes > ring_size) { start = ring_size; }
+        VkDeviceSize skip = start - position;
+        if (start == ring_size) { start = 0; }
+
+        // If that fits in what's been released, we're done
+        if (this->ring_head + skip + n_bytes - this->ring_tail <= ring_size) {
+            this->ring_head += skip + n_bytes;
+            DRETURN start;
+        }
+
+        // Otherwise, free up space by waiting for the oldest batch. If nothing is in use at all, just rewind the ring
+        if (this->n_in_flight > 0) {
+            this->retire_oldest();
+        } else if (this->ring_head == this->ring_tail) {
+            this->ring_head = 0;
+            this->ring_tail = 0;
+        } else {
+            // Only the batch we're recording holds memory, so submit it to be able to wait for it
+            this->submit();
+        }
+    }
+}
+
+/* Copies the given data into staging memory, returning the VkBuffer and offset to copy from. Uses a dedicated staging buffer if the data doesn't fit in the ring. */
+VkBuffer UploadManager::stage(const void* data, VkDeviceSize n_bytes, VkDeviceSize& offset) {
+    DENTER("Vulkan::UploadManager::stage");
+
+    // If the data would take more than the entire ring, give it its own buffer that is released with the batch
+    if (n_bytes > this->staging.size()) {
+        DLOGF(warning, "Upload of {} bytes does not fit in the staging ring of {} bytes; using a dedicated staging buffer.", n_bytes, this->staging.size());
+        Buffer* buffer = new Buffer(this->allocator, n_bytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        buffer->set((void*) data, (size_t) n_bytes);
+        // Make sure the batch is recording before attaching the buffer to it, since starting it may retire the slot's previous contents
+        this->begin_batch();
+        this->batches[this->current_slot].oversized.push_back(buffer);
+        offset = 0;
+        DRETURN buffer->buffer();
+    }
+
+    // Otherwise, copy it to a region in the ring
+    offset = this->reserve(n_bytes, staging_alignment);
+    memcpy(this->staging.data<uint8_t>(offset), data, (size_t) n_bytes);
+    this->staging.mark_dirty(offset, n_bytes);
+    DRETURN this->staging.buffer();
+}
+
+/* Returns the command buffer in the current batch that copies into a resource owned by the given queue family: the graphics one if that family already owns it, or the transfer one otherwise. */
+CommandBuffer& UploadManager::command_buffer_for(uint32_t owner) {
+    DENTER("Vulkan::UploadManager::command_buffer_for");
+
+    // Make sure the batch is recording
+    this->begin_batch();
+
+    // The transfer family can't write what the graphics family owns without taking it back first, so copy those on the graphics queue instead. It runs after the batch's transfers, like the acquire barriers
+    if (this->dedicated && owner == this->graphics_family) {
+        DRETURN *this->acquire_buffer;
+    }
+    DRETURN *this->command_buffer;
+}
+
+
+
+/* Schedules the given data to be copied to the given buffer at the given offset. The data is copied to staging memory immediately, so it may be freed once this returns. Returns the ticket of the batch the copy was recorded in. */
+UploadTicket UploadManager::upload(Buffer& destination, const void* data, VkDeviceSize n_bytes, VkDeviceSize offset) {
+    DENTER("Vulkan::UploadManager::upload(buffer)");
+
+    // Check if the destination is large enough
+    if (offset + n_bytes > destination.size()) {
+        DLOG(fatal, "Not enough memory in buffer to accept upload of " + std::to_string(n_bytes) + " bytes at offset " + std::to_string(offset) + " (buffer has " + std::to_string(destination.size()) + " bytes).");
+    }
+
+    // Stage the data first, since that may submit the current batch if the ring is full
+    VkDeviceSize staging_offset;
+    VkBuffer source = this->stage(data, n_bytes, staging_offset);
+
+    // Record the copy in the current batch, on the queue family that may write the buffer
+    CommandBuffer& command_buffer = this->command_buffer_for(destination.queue_family());
+
+    // If an earlier copy in this batch wrote the same buffer, wait until it's done. Otherwise, remember the buffer, so that it's handed over only once when the batch is submitted
+    bool written = false;
+    for (size_t i = 0; i < this->written_buffers.size(); i++) {
+        if (this->written_buffers[i] == &destination) {
+            written = true;
+            break;
+        }
+    }
+    if (written) {
+        VkMemoryBarrier memory_barrier{};
+        memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memory_barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+    } else {
+        this->written_buffers.push_back(&destination);
+    }
+
+    // Now record the copy itself
+    VkBufferCopy copy_region{};
+    copy_region.srcOffset = staging_offset;
+    copy_region.dstOffset = offset;
+    copy_region.size = n_bytes;
+    vkCmdCopyBuffer(command_buffer, source, destination, 1, &copy_region);
+
+    DRETURN this->batches[this->current_slot].ticket;
+}
+
+/* Schedules the given pixel data to be copied to the given image, including the layout transitions before and after. The data is copied to staging memory immediately, so it may be freed once this returns. Returns the ticket of the batch the copy was recorded in. */
+UploadTicket UploadManager::upload(Image& destination, const void* data, VkDeviceSize n_bytes) {
+    DENTER("Vulkan::UploadManager::upload(image)");
+
+    // Stage the data first, since that may submit the current batch if the ring is full
+    VkDeviceSize staging_offset;
+    VkBuffer source = this->stage(data, n_bytes, staging_offset);
+
+    // Record the transition to a copyable layout and the copy itself in the current batch, on the queue family that may write the image. If an earlier copy in this batch wrote it already, the transition waits for that instead
+    CommandBuffer& command_buffer = this->command_buffer_for(destination.queue_family());
+    destination.transition_layout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, command_buffer);
+    Image::copy(destination, source, staging_offset, command_buffer);
+
+    // Transition to shader access. If the transfer family wrote it, that's done as part of handing the image over to the graphics family when the batch is submitted, since the transfer queue can't wait on shader stages
+    if (this->dedicated && &command_buffer == this->command_buffer) {
+        bool released = false;
+        for (size_t i = 0; i < this->released_images.size(); i++) {
+            if (this->released_images[i] == &destination) {
+                released = true;
+                break;
+            }
+        }
+        if (!released) { this->released_images.push_back(&destination); }
+    } else {
+        destination.transition_layout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, command_buffer);
+    }
+
+    DRETURN this->batches[this->current_slot].ticket;
+}
+
+
+
+/* Submits everything recorded so far as a single batch. Returns its ticket, or the last submitted ticket if nothing was recorded. */
+UploadTicket UploadManager::submit() {
+    DENTER("Vulkan::UploadManager::submit");
+
+    // If we're not recording, there's nothing to submit
+    if (!this->recording) {
+        DRETURN this->next_ticket - 1;
+    }
+    UploadBatch& batch = this->batches[this->current_slot];
+    CommandBuffer& command_buffer = *this->command_buffer;
+    DLOGF(info, "Submitting upload batch {}...", batch.ticket);
+
+    // With a dedicated transfer family, hand everything the transfer family wrote over to the graphics family, once per resource. Buffers that the graphics family already owned were written on its own queue
+    if (this->dedicated) {
+        for (size_t i = 0; i < this->written_buffers.size(); i++) {
+            if (this->written_buffers[i]->queue_family() != this->graphics_family) {
+                this->written_buffers[i]->transfer_ownership(this->transfer_family, command_buffer, this->graphics_family, *this->acquire_buffer);
+            }
+        }
+        for (size_t i = 0; i < this->released_images.size(); i++) {
+            this->released_images[i]->transfer_ownership(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, this->transfer_family, command_buffer, this->graphics_family, *this->acquire_buffer);
+        }
+    }
+    this->written_buffers.clear();
+    this->released_images.clear();
+
+    // Make the transfers visible to anything submitted after this batch (e.g., vertex input or index reads). With a dedicated transfer family, the acquire barriers already do that for what the transfer family wrote, so this only covers the copies on the graphics queue
+    VkMemoryBarrier memory_barrier{};
+    memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    memory_barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+    vkCmdPipelineBarrier(this->dedicated ? *this->acquire_buffer : command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &memory_barrier, 0, nullptr, 0, nullptr);
+    if (this->profiler != nullptr) {
+        this->profiler->end_scope(command_buffer, (uint32_t) this->current_slot, this->profiler_scope);
+    }
+    command_buffer.end();
+
+    // Make sure the staging writes reach the device (a no-op for coherent memory)
+    this->allocator.flush();
+
+    // Prepare submitting the copies
+    VkSubmitInfo submit_info{};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &command_buffer.command_buffer();
+    this->fences[this->current_slot]->reset();
+    if (!this->dedicated) {
+        // Submit it with the slot's fence, so we know when the batch is done without idling the queue
+        if (vkQueueSubmit(this->queue, 1, &submit_info, *this->fences[this->current_slot]) != VK_SUCCESS) {
+            DLOG(fatal, "Could not submit upload batch to the queue.");
+        }
+    } else {
+        // Submit the copies to the transfer queue, signalling the slot's semaphore once they're done
+        VkSemaphore semaphore = *this->semaphores[this->current_slot];
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.pSignalSemaphores = &semaphore;
+        if (vkQueueSubmit(this->queue, 1, &submit_info, VK_NULL_HANDLE) != VK_SUCCESS) {
+            DLOG(fatal, "Could not submit upload batch to the transfer queue.");
+        }
+
+        // Then submit the acquire barriers to the graphics queue, waiting for that semaphore, and signal the slot's fence when those are done
+        CommandBuffer& acquire_buffer = *this->acquire_buffer;
+        acquire_buffer.end();
+        VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        VkSubmitInfo acquire_info{};
+        acquire_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        acquire_info.waitSemaphoreCount = 1;
+        acquire_info.pWaitSemaphores = &semaphore;
+        acquire_info.pWaitDstStageMask = &wait_stage;
+        acquire_info.commandBufferCount = 1;
+        acquire_info.pCommandBuffers = &acquire_buffer.command_buffer();
+        if (vkQueueSubmit(this->graphics_queue, 1, &acquire_info, *this->fences[this->current_slot]) != VK_SUCCESS) {
+            DLOG(fatal, "Could not submit upload acquire batch to the graphics queue.");
+        }
+    }
+
+    // Mark the batch as in flight and move on to the next slot
+    if (this->profiler != nullptr) {
+        this->profiler->submitted((uint32_t) this->current_slot);
+    }
+    batch.ring_mark = this->ring_head;
+    batch.in_flight = true;
+    ++this->n_in_flight;
+    this->recording = false;
+    this->current_slot = (this->current_slot + 1) % UploadManager::n_batches;
+
+    DRETURN batch.ticket;
+}
+
+/* Returns whether or not the batch with the given ticket is done, without waiting. */
+bool UploadManager::is_done(UploadTicket ticket) {
+    DENTER("Vulkan::UploadManager::is_done");
+
+    // Retire every batch that is done already, in order
+    while (this->n_in_flight > 0 && this->fences[this->oldest_slot]->signalled()) {
+        this->retire_oldest();
+    }
+
+    DRETURN ticket <= this->completed_ticket;
+}
+
+/* Waits until the batch with the given ticket is done, submitting it first if it's still recording. */
+void UploadManager::wait(UploadTicket ticket) {
+    DENTER("Vulkan::UploadManager::wait");
+
+    // If the ticket belongs to the batch we're recording, it has to be submitted before we can wait for it
+    if (this->recording && ticket >= this->batches[this->current_slot].ticket) {
+        this->submit();
+    }
+
+    // Retire batches until the ticket is done
+    while (this->completed_ticket < ticket && this->n_in_flight > 0) {
+        this->retire_oldest();
+    }
+
+    DRETURN;
+}
+
+/* Waits until all batches are done. */
+void UploadManager::wait_all() {
+    DENTER("Vulkan::UploadManager::wait_all");
+
+    // Simply wait for the last ticket there is
+    this->wait(this->submit());
+
+    DRETURN;
+}
+
+
+
+/* Times every batch recorded from now on as an 'upload' scope of the given profiler, or stops timing them if it's nullptr. The profiler has to profile the transfer family with a slot per batch slot, and has to outlive the UploadManager. May not be called while a batch is recording. */
+void UploadManager::set_profiler(GpuProfiler* profiler) {
+    DENTER("Vulkan::UploadManager::set_profiler");
+
+    // The batch that is recording would end a scope it never began
+    if (this->recording) {
+        DLOG(fatal, "Cannot change the profiler of an upload manager while a batch is recording.");
+    }
+    // The profiler has to time the queue the batches are submitted to, and needs a slot for every batch that may be in flight. A disabled one has no slots, but ignores everything anyway
+    if (profiler != nullptr && profiler->queue_family != this->transfer_family) {
+        DLOGF(fatal, "Upload profiler profiles queue family {} instead of the transfer family ({}).", profiler->queue_family, this->transfer_family);
+    }
+    size_t n_slots = UploadManager::n_batches;
+    if (profiler != nullptr && profiler->enabled() && profiler->frames() < n_slots) {
+        DLOGF(fatal, "Upload profiler has {} slots instead of one per batch slot ({}).", profiler->frames(), n_slots);
+    }
+
+    this->profiler = profiler;
+
+    DRETURN;
+}
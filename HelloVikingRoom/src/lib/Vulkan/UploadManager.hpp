@@ -0,0 +1,167 @@
+/* UPLOAD MANAGER.hpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 17:24:51
+ * Last edited:
+ *   16/10/2026, 23:31:45
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Contains the UploadManager class, which owns a persistent ring of
+ *   staging memory and records buffer- and image uploads into batched
+ *   command buffers. Batches are submitted with a fence, and uploads
+ *   return tickets that can be polled or waited on instead of idling the
+ *   entire queue for every copy.
+ * 
+ *   If the device has a dedicated transfer queue family, the copies run
+ *   on that and ownership of the resources is handed over to the graphics
+ *   family with release / acquire barriers and a semaphore, once per
+ *   resource per batch. Later uploads into resources the graphics family
+ *   already owns are recorded on the graphics queue instead.
+**/
+
+#ifndef VULKAN_UPLOAD_MANAGER_HPP
+#define VULKAN_UPLOAD_MANAGER_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+#include "Vulkan/Device.hpp"
+#include "Vulkan/MemoryAllocator.hpp"
+#include "Vulkan/CommandPool.hpp"
+#include "Vulkan/FrameCommandAllocator.hpp"
+#include "Vulkan/Fence.hpp"
+#include "Vulkan/Semaphore.hpp"
+#include "Vulkan/GpuProfiler.hpp"
+#include "Vulkan/Buffer.hpp"
+#include "Vulkan/Image.hpp"
+#include "Tools/Array.hpp"
+
+namespace HelloVikingRoom::Vulkan {
+    /* Identifies a batch of uploads. Tickets increase monotonically, so if a ticket is done, all tickets before it are too. */
+    using UploadTicket = uint64_t;
+
+    /* Struct that describes a single batch of uploads, i.e., a single command buffer submission. */
+    struct UploadBatch {
+        /* The ticket handed out for uploads in this batch. */
+        UploadTicket ticket;
+        /* The position of the ring's head when this batch was submitted. Once the batch is done, everything before it is free again. */
+        uint64_t ring_mark;
+        /* Whether or not this batch is currently submitted and not yet retired. */
+        bool in_flight;
+        /* Uploads that didn't fit in the ring get a dedicated staging buffer, which lives until the batch is done. */
+        Tools::Array<Buffer*> oversized;
+    };
+
+    /* The UploadManager class, which batches staging uploads to device-local buffers and images. */
+    class UploadManager {
+    public:
+        /* The number of batches that may be in flight at the same time. */
+        static const size_t n_batches = 4;
+
+    private:
+        /* Allocates the batch command buffers on the transfer family, with a transient pool per batch slot that is reset once the slot's batch is done. */
+        FrameCommandAllocator command_allocator;
+        /* The command buffer of the batch that is currently recording. */
+        CommandBuffer* command_buffer;
+        /* Allocates the command buffers with the acquire halves of ownership transfers on the graphics family, like the command_allocator. Has no slots without a dedicated transfer family. */
+        FrameCommandAllocator acquire_allocator;
+        /* The command buffer with the acquire barriers of the batch that is currently recording, plus the copies into resources the graphics family already owns. Only used with a dedicated transfer family. */
+        CommandBuffer* acquire_buffer;
+        /* The buffers written by the batch that is currently recording, each only once. */
+        Tools::Array<Buffer*> written_buffers;
+        /* The images written on the transfer family by the batch that is currently recording, each only once. They're handed over to the graphics family when it's submitted. */
+        Tools::Array<Image*> released_images;
+        /* One semaphore per batch slot, signalled by the transfer submission and waited on by the acquire submission. Empty without a dedicated transfer family. */
+        Tools::Array<Semaphore*> semaphores;
+        /* One fence per batch slot, signalled once the batch is done on the device. */
+        Tools::Array<Fence*> fences;
+        /* The state of each batch slot. */
+        Tools::Array<UploadBatch> batches;
+        /* The profiler that times each batch on the device, with a slot per batch slot, or nullptr to not time them. */
+        GpuProfiler* profiler;
+        /* The profiler's scope of the batch that is currently recording. */
+        uint32_t profiler_scope;
+
+        /* The persistent, host-visible staging buffer that is used as a ring. */
+        Buffer staging;
+        /* The total number of bytes ever reserved in the ring. Its position is ring_head modulo the ring size. */
+        uint64_t ring_head;
+        /* The total number of bytes ever released in the ring. Everything between ring_tail and ring_head is still in use. */
+        uint64_t ring_tail;
+
+        /* The slot that is currently recording, or the next one that will be. */
+        size_t current_slot;
+        /* The oldest slot that is still in flight. */
+        size_t oldest_slot;
+        /* The number of slots currently in flight. */
+        size_t n_in_flight;
+        /* Whether or not the current slot is recording. */
+        bool recording;
+        /* The ticket that will be handed out for the next batch. */
+        UploadTicket next_ticket;
+        /* The last ticket known to be done. */
+        UploadTicket completed_ticket;
+
+        /* Makes sure the current slot is recording, and returns its command buffer. */
+        CommandBuffer& begin_batch();
+        /* Waits for the oldest batch in flight and releases its resources. */
+        void retire_oldest();
+        /* Reserves n_bytes in the staging ring with the given alignment, waiting for (or submitting) batches if it's full. Returns the offset in the staging buffer. */
+        VkDeviceSize reserve(VkDeviceSize n_bytes, VkDeviceSize alignment);
+        /* Copies the given data into staging memory, returning the VkBuffer and offset to copy from. Uses a dedicated staging buffer if the data doesn't fit in the ring. */
+        VkBuffer stage(const void* data, VkDeviceSize n_bytes, VkDeviceSize& offset);
+        /* Returns the command buffer in the current batch that copies into a resource owned by the given queue family: the graphics one if that family already owns it, or the transfer one otherwise. */
+        CommandBuffer& command_buffer_for(uint32_t owner);
+
+    public:
+        /* The device where the uploads happen. */
+        const Device& device;
+        /* The allocator used for the staging memory. */
+        MemoryAllocator& allocator;
+        /* Whether or not the uploads run on a dedicated transfer family. */
+        const bool dedicated;
+        /* The queue family that does the copies. */
+        const uint32_t transfer_family;
+        /* The queue family that uses the uploaded resources. */
+        const uint32_t graphics_family;
+        /* The queue to which the copies are submitted. */
+        const VkQueue queue;
+        /* The queue to which the acquire barriers are submitted. Same as queue without a dedicated transfer family. */
+        const VkQueue graphics_queue;
+
+        /* Constructor for the UploadManager class, which takes the allocator to get the staging memory from (and thus the device to upload to) and optionally the size of the staging ring, in bytes. */
+        UploadManager(MemoryAllocator& allocator, VkDeviceSize staging_size = 16 * 1024 * 1024);
+        /* Copy constructor for the UploadManager class, which is deleted. */
+        UploadManager(const UploadManager& other) = delete;
+        /* Move constructor for the UploadManager class, which is deleted since the command buffers refer to the internal pools. */
+        UploadManager(UploadManager&& other) = delete;
+        /* Destructor for the UploadManager class. Waits until all batches in flight are done. */
+        ~UploadManager();
+
+        /* Schedules the given data to be copied to the given buffer at the given offset. The data is copied to staging memory immediately, so it may be freed once this returns. Returns the ticket of the batch the copy was recorded in. Note that with a dedicated transfer family, ownership of the entire buffer is handed to the graphics family once the batch is submitted, so the buffer may not be moved or destroyed before that. */
+        UploadTicket upload(Buffer& destination, const void* data, VkDeviceSize n_bytes, VkDeviceSize offset = 0);
+        /* Schedules the given pixel data to be copied to the given image, including the layout transitions before and after. The data is copied to staging memory immediately, so it may be freed once this returns. Returns the ticket of the batch the copy was recorded in. Like with buffers, the image may not be moved or destroyed before the batch is submitted. */
+        UploadTicket upload(Image& destination, const void* data, VkDeviceSize n_bytes);
+
+        /* Submits everything recorded so far as a single batch. Returns its ticket, or the last submitted ticket if nothing was recorded. */
+        UploadTicket submit();
+        /* Returns whether or not the batch with the given ticket is done, without waiting. */
+        bool is_done(UploadTicket ticket);
+        /* Waits until the batch with the given ticket is done, submitting it first if it's still recording. */
+        void wait(UploadTicket ticket);
+        /* Waits until all batches are done. */
+        void wait_all();
+
+        /* Times every batch recorded from now on as an 'upload' scope of the given profiler, or stops timing them if it's nullptr. The profiler has to profile the transfer family with a slot per batch slot, and has to outlive the UploadManager. May not be called while a batch is recording. */
+        void set_profiler(GpuProfiler* profiler);
+
+        /* Returns the size of the staging ring, in bytes. */
+        inline VkDeviceSize staging_size() const { return this->staging.size(); }
+
+    };
+}
+
+#endif
@@ -0,0 +1,218 @@
+/* ALLOCATORS.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:09:46
+ * Last edited:
+ *   16/10/2026, 21:00:21
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Checks the Arena and Pool allocators, both on their own and as the
+ *   allocator of an Array.
+**/
+
+#include <iostream>
+#include <cstddef>
+#include <new>
+
+#define FULLCOMPILE
+#include "Tools/Array.hpp"
+#include "Tools/Arena.hpp"
+#include "Tools/Pool.hpp"
+#include "common.hpp"
+
+using namespace std;
+using namespace Tools;
+
+
+/***** TESTS *****/
+/* Function that tests if an Array can grow in an Arena, and if the arena's memory is reused after a reset. */
+bool test_arena_array() {
+    TESTCASE("arena-allocated array")
+
+    // Grow an array; since it's the only allocation, it should grow in-place
+    Arena arena(1024);
+    Array<int, ArenaAllocator> test(arena);
+    for (int i = 0; i < 200; i++) {
+        test.push_back(i);
+    }
+    const int* first = test.rdata();
+    for (size_t i = 0; i < test.size(); i++) {
+        if (test[i] != (int) i) {
+            ERROR("Pushing to arena-allocated array failed; incorrect value at index " + std::to_string(i) + ": expected " + std::to_string(i) + ", got " + std::to_string(test[i]));
+            ENDCASE(false);
+        }
+    }
+    if (arena.capacity() != 1024) {
+        ERROR("Pushing to arena-allocated array failed; arena grew to " + std::to_string(arena.capacity()) + " bytes instead of growing the array in-place");
+        ENDCASE(false);
+    }
+
+    // After a reset, the next array should get the same memory
+    test.clear();
+    arena.reset();
+    Array<int, ArenaAllocator> next(16, arena);
+    if (next.rdata() != first) {
+        ERROR("Resetting arena failed; memory was not reused");
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+/* Function that tests if an Array with elements that need their constructors and destructors works in an Arena that needs multiple chunks. */
+bool test_arena_chunks() {
+    TESTCASE("arena-allocated array over multiple chunks")
+
+    // Interleave two arrays, so that neither can grow in-place
+    Arena arena(256);
+    Array<hard_t, ArenaAllocator> test1(arena);
+    Array<hard_t, ArenaAllocator> test2(arena);
+    for (int i = 0; i < 100; i++) {
+        test1.push_back(hard_t(i));
+        test2.push_back(hard_t(-i));
+    }
+    test1.erase(0, 49);
+    for (size_t i = 0; i < test1.size(); i++) {
+        if (*test1[i] != (int) i + 50 || *test2[i] != -(int) i) {
+            ERROR("Pushing to interleaved arena-allocated arrays failed; incorrect value at index " + std::to_string(i));
+            ENDCASE(false);
+        }
+    }
+
+    // Resetting should merge the chunks into one
+    test1.clear();
+    test2.clear();
+    size_t capacity = arena.capacity();
+    arena.reset();
+    if (arena.capacity() != capacity) {
+        ERROR("Resetting arena failed; capacity changed from " + std::to_string(capacity) + " to " + std::to_string(arena.capacity()) + " bytes");
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+/* Function that tests if the Pool reuses the blocks of destroyed objects. */
+bool test_pool_reuse() {
+    TESTCASE("pool block reuse")
+
+    // Create a bunch of objects, then destroy every other one
+    Pool pool(sizeof(hard_t), alignof(hard_t), 32);
+    hard_t* objects[128];
+    for (int i = 0; i < 128; i++) {
+        objects[i] = pool.create<hard_t>(i);
+    }
+    size_t capacity = pool.capacity();
+    for (int i = 0; i < 128; i += 2) {
+        pool.destroy(objects[i]);
+    }
+
+    // Creating them again should not need any new chunks
+    for (int i = 0; i < 128; i += 2) {
+        objects[i] = pool.create<hard_t>(i);
+    }
+    if (pool.capacity() != capacity) {
+        ERROR("Re-creating objects in pool failed; capacity grew from " + std::to_string(capacity) + " to " + std::to_string(pool.capacity()) + " blocks");
+        ENDCASE(false);
+    }
+    for (int i = 0; i < 128; i++) {
+        if (**objects[i] != i) {
+            ERROR("Re-creating objects in pool failed; incorrect value at index " + std::to_string(i) + ": expected " + std::to_string(i) + ", got " + std::to_string(**objects[i]));
+            ENDCASE(false);
+        }
+        pool.destroy(objects[i]);
+    }
+
+    ENDCASE(true);
+}
+
+/* Function that tests if an Array can live in a single block of a Pool, and fails to grow past it. */
+bool test_pool_array() {
+    TESTCASE("pool-allocated array")
+
+    // Fill the block
+    Pool pool(16 * sizeof(int));
+    Array<int, PoolAllocator> test(16, pool);
+    for (int i = 0; i < 16; i++) {
+        test.push_back(i);
+    }
+
+    // Pushing past it should throw
+    bool thrown = false;
+    try {
+        test.push_back(16);
+    } catch (std::bad_alloc&) {
+        thrown = true;
+    }
+    if (!thrown || test.size() != 16) {
+        ERROR("Pushing past pool block failed; expected std::bad_alloc");
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+/* Function that tests if an Array that grows by itself uses its entire Pool block, even if that isn't a power of two elements. */
+bool test_pool_growth() {
+    TESTCASE("pool-allocated array growth")
+
+    // Push one by one, so the array grows from 4 to 8 elements and then has to stop at 12 instead of 16
+    Pool pool(12 * sizeof(int));
+    Array<int, PoolAllocator> test(pool);
+    try {
+        for (int i = 0; i < 12; i++) {
+            test.push_back(i);
+        }
+    } catch (std::bad_alloc&) {
+        ERROR("Growing in pool block failed; std::bad_alloc after " + std::to_string(test.size()) + " elements instead of 12");
+        ENDCASE(false);
+    }
+    if (test.capacity() != 12 || test[11] != 11) {
+        ERROR("Growing in pool block failed; expected a capacity of 12, got " + std::to_string(test.capacity()));
+        ENDCASE(false);
+    }
+
+    // Only pushing past the block should throw
+    bool thrown = false;
+    try {
+        test.push_back(12);
+    } catch (std::bad_alloc&) {
+        thrown = true;
+    }
+    if (!thrown || test.size() != 12) {
+        ERROR("Pushing past pool block failed; expected std::bad_alloc");
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+bool test_allocators() {
+    TESTRUN("Array allocators");
+
+    if (!test_arena_array()) {
+        ENDRUN(false);
+    }
+    if (!test_arena_chunks()) {
+        ENDRUN(false);
+    }
+    if (!test_pool_reuse()) {
+        ENDRUN(false);
+    }
+    if (!test_pool_array()) {
+        ENDRUN(false);
+    }
+    if (!test_pool_growth()) {
+        ENDRUN(false);
+    }
+
+    ENDRUN(true);
+}
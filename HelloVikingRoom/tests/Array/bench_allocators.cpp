@@ -0,0 +1,156 @@
+/* BENCH ALLOCATORS.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:11:49
+ * Last edited:
+ *   16/10/2026, 19:17:14
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Microbenchmark for the allocators of the Array. Compares building
+ *   short-lived arrays every frame on the heap and in an Arena that is
+ *   reset per frame, and creating and destroying node-like objects with
+ *   new / delete and in a Pool.
+**/
+
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+#include "Tools/Array.hpp"
+#include "Tools/Arena.hpp"
+#include "Tools/Pool.hpp"
+
+using namespace std;
+using namespace Tools;
+
+
+/***** CONSTANTS *****/
+/* The number of frames to simulate. */
+static const size_t n_frames = 20000;
+/* The number of temporary arrays built per frame. */
+static const size_t n_arrays = 64;
+/* The number of node operations to do. */
+static const size_t n_operations = 4000000;
+/* The number of nodes alive at the same time. */
+static const size_t n_nodes = 1024;
+
+
+/***** HELPER STRUCTS *****/
+/* An element about the size of a Vulkan create-info struct. */
+struct info_t {
+    /* Some data to move around. */
+    uint64_t data[6];
+};
+
+/* A node-like object, as kept in a tree or a list. */
+struct node_t {
+    /* The node's children. */
+    node_t* children[4];
+    /* Some data for the node. */
+    uint64_t data[4];
+
+    /* Constructor for the node_t struct, which takes some data for it. */
+    node_t(uint64_t value) : children{ nullptr, nullptr, nullptr, nullptr }, data{ value, value, value, value } {}
+};
+
+
+/***** HELPER FUNCTIONS *****/
+/* Returns the number of elements of the i'th array in a frame, which is between 1 and 16. */
+static inline size_t array_size(size_t i) { return 1 + (i * 7) % 16; }
+
+/* Builds n_arrays arrays per frame on the heap. Returns the number of nanoseconds per array. */
+static double bench_heap_arrays() {
+    uint64_t checksum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t f = 0; f < n_frames; f++) {
+        for (size_t i = 0; i < n_arrays; i++) {
+            Array<info_t> array;
+            for (size_t j = 0; j < array_size(i); j++) {
+                array.push_back({ { j, i, f, 0, 0, 0 } });
+            }
+            checksum += array[array.size() - 1].data[0];
+        }
+    }
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    if (checksum == 0) { cerr << "Unexpected checksum" << endl; }
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double) (n_frames * n_arrays);
+}
+
+/* Builds n_arrays arrays per frame in an arena that is reset every frame. Returns the number of nanoseconds per array. */
+static double bench_arena_arrays() {
+    uint64_t checksum = 0;
+    Arena arena;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t f = 0; f < n_frames; f++) {
+        arena.reset();
+        for (size_t i = 0; i < n_arrays; i++) {
+            Array<info_t, ArenaAllocator> array(arena);
+            for (size_t j = 0; j < array_size(i); j++) {
+                array.push_back({ { j, i, f, 0, 0, 0 } });
+            }
+            checksum += array[array.size() - 1].data[0];
+        }
+    }
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    if (checksum == 0) { cerr << "Unexpected checksum" << endl; }
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double) (n_frames * n_arrays);
+}
+
+/* Replaces random nodes with new ones using new and delete. Returns the number of nanoseconds per replacement. */
+static double bench_heap_nodes() {
+    node_t* nodes[n_nodes];
+    for (size_t i = 0; i < n_nodes; i++) { nodes[i] = new node_t(i); }
+    uint64_t state = 42, checksum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n_operations; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        size_t index = (state >> 33) % n_nodes;
+        checksum += nodes[index]->data[0];
+        delete nodes[index];
+        nodes[index] = new node_t(i);
+    }
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n_nodes; i++) { delete nodes[i]; }
+    if (checksum == 0) { cerr << "Unexpected checksum" << endl; }
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double) n_operations;
+}
+
+/* Replaces random nodes with new ones in a pool. Returns the number of nanoseconds per replacement. */
+static double bench_pool_nodes() {
+    Pool pool(sizeof(node_t), alignof(node_t));
+    node_t* nodes[n_nodes];
+    for (size_t i = 0; i < n_nodes; i++) { nodes[i] = pool.create<node_t>(i); }
+    uint64_t state = 42, checksum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n_operations; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        size_t index = (state >> 33) % n_nodes;
+        checksum += nodes[index]->data[0];
+        pool.destroy(nodes[index]);
+        nodes[index] = pool.create<node_t>(i);
+    }
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n_nodes; i++) { pool.destroy(nodes[i]); }
+    if (checksum == 0) { cerr << "Unexpected checksum" << endl; }
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double) n_operations;
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+int main() {
+    cout << "Running allocator benchmark" << endl;
+    cout << "Temporary arrays (" << n_frames << " frames of " << n_arrays << " arrays with 1-16 elements of " << sizeof(info_t) << " bytes):" << endl;
+    cout << "  heap: " << bench_heap_arrays() << " ns per array" << endl;
+    cout << "  arena: " << bench_arena_arrays() << " ns per array" << endl;
+    cout << "Nodes (" << n_operations << " replacements of " << n_nodes << " nodes of " << sizeof(node_t) << " bytes):" << endl;
+    cout << "  new/delete: " << bench_heap_nodes() << " ns per replacement" << endl;
+    cout << "  pool: " << bench_pool_nodes() << " ns per replacement" << endl;
+    return EXIT_SUCCESS;
+}
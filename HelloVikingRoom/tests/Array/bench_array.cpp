@@ -0,0 +1,123 @@
+/* BENCH ARRAY.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 18:44:34
+ * Last edited:
+ *   16/10/2026, 18:49:41
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Microbenchmark for building an Array with push_back(). Compares the
+ *   Array against std::vector, and against re-allocating by exactly one
+ *   element per push like the Array used to do, for a small and a large
+ *   element type.
+**/
+
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+#include "Tools/Array.hpp"
+
+using namespace std;
+using namespace Tools;
+
+
+/***** CONSTANTS *****/
+/* The total number of elements pushed per measurement, spread over as many arrays as needed. */
+static const size_t n_pushes = 1 << 22;
+/* The largest array for which the exact re-allocation is measured, since it takes quadratic time. */
+static const size_t max_exact_size = 1 << 14;
+
+
+/***** HELPER STRUCTS *****/
+/* A larger element, about the size of a vertex. */
+struct large_t {
+    /* Some data to move around. */
+    float data[8];
+};
+
+
+/***** HELPER FUNCTIONS *****/
+/* Builds arrays with the given number of elements using Array::push_back() until n_pushes elements are pushed. Returns the number of nanoseconds per push. */
+template <class T>
+static double bench_array(size_t size) {
+    size_t checksum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < n_pushes / size; r++) {
+        Array<T> array;
+        for (size_t i = 0; i < size; i++) {
+            array.push_back(T());
+        }
+        checksum += array.size();
+    }
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    if (checksum != (n_pushes / size) * size) { cerr << "Unexpected number of elements" << endl; exit(EXIT_FAILURE); }
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double) ((n_pushes / size) * size);
+}
+
+/* Builds arrays with the given number of elements by reserving exactly one more element before every push, like push_back() used to. Returns the number of nanoseconds per push. */
+template <class T>
+static double bench_array_exact(size_t size) {
+    size_t checksum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < n_pushes / size; r++) {
+        Array<T> array;
+        for (size_t i = 0; i < size; i++) {
+            array.reserve(array.size() + 1);
+            array.push_back(T());
+        }
+        checksum += array.size();
+    }
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    if (checksum != (n_pushes / size) * size) { cerr << "Unexpected number of elements" << endl; exit(EXIT_FAILURE); }
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double) ((n_pushes / size) * size);
+}
+
+/* Builds vectors with the given number of elements using std::vector::push_back() until n_pushes elements are pushed. Returns the number of nanoseconds per push. */
+template <class T>
+static double bench_vector(size_t size) {
+    size_t checksum = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < n_pushes / size; r++) {
+        std::vector<T> vector;
+        for (size_t i = 0; i < size; i++) {
+            vector.push_back(T());
+        }
+        checksum += vector.size();
+    }
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    if (checksum != (n_pushes / size) * size) { cerr << "Unexpected number of elements" << endl; exit(EXIT_FAILURE); }
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double) ((n_pushes / size) * size);
+}
+
+/* Runs all benchmarks for the given element type. */
+template <class T>
+static void bench_type(const char* name) {
+    cout << name << " (" << sizeof(T) << " bytes):" << endl;
+    size_t sizes[] = { 16, 1024, 65536 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(size_t); i++) {
+        cout << "  " << sizes[i] << " elements:" << endl;
+        cout << "    Array: " << bench_array<T>(sizes[i]) << " ns" << endl;
+        cout << "    std::vector: " << bench_vector<T>(sizes[i]) << " ns" << endl;
+        if (sizes[i] <= max_exact_size) {
+            cout << "    Array (exact reserve): " << bench_array_exact<T>(sizes[i]) << " ns" << endl;
+        }
+    }
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+int main() {
+    cout << "Running Array benchmark (" << n_pushes << " pushes per measurement)" << endl;
+    bench_type<uint32_t>("uint32_t");
+    bench_type<large_t>("large_t");
+    return EXIT_SUCCESS;
+}
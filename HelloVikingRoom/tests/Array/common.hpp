@@ -4,7 +4,7 @@
  * Created:
  *   12/22/2020, 5:41:16 PM
  * Last edited:
- *   12/23/2020, 5:19:16 PM
+ *   16/10/2026, 18:56:31
  * Auto updated?
  *   Yes
  *
@@ -73,6 +73,34 @@ public:
     }
 };
 
+/* A class that points to itself, and can thus only be moved with its move constructor. */
+template <class T>
+class SelfClass {
+private:
+    /* The value it stores. */
+    T value;
+    /* Points to the object itself. */
+    SelfClass* self;
+
+public:
+    /* Constructor for the SelfClass, which takes the value it should store. */
+    SelfClass(const T& value) : value(value), self(this) {}
+    /* Copy constructor for the SelfClass. */
+    SelfClass(const SelfClass& other) : value(other.value), self(this) {}
+    /* Move constructor for the SelfClass. */
+    SelfClass(SelfClass&& other) : value(std::move(other.value)), self(this) {}
+
+    /* Returns whether the object still points to itself, i.e., whether it was moved properly. */
+    inline bool valid() const { return this->self == this; }
+    /* Returns a muteable reference to the internal value class. */
+    inline T& operator*() { return this->value; }
+    /* Returns a constant reference to the internal value class. */
+    inline const T& operator*() const { return this->value; }
+
+    /* Copy assignment operator for the SelfClass. */
+    inline SelfClass& operator=(const SelfClass& other) { this->value = other.value; return *this; }
+};
+
 /* The hardest class, which implements polymorphism (parent class). */
 template <class T>
 class ParentClass {
@@ -151,6 +179,7 @@ using hard_t = HeapClass<int>;
 using super_hard_t = HeapClass<hard_t>;
 using extreme_t = ChildClass<easy_t, medium_t>;
 using super_extreme_t = ChildClass<super_hard_t, extreme_t>;
+using self_t = SelfClass<int>;
 
 
 
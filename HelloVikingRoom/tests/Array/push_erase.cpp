@@ -4,7 +4,7 @@
  * Created:
  *   12/23/2020, 5:31:23 PM
  * Last edited:
- *   1/13/2021, 4:22:47 PM
+ *   16/10/2026, 18:56:31
  * Auto updated?
  *   Yes
  *
@@ -304,6 +304,40 @@ bool test_range_erase() {
     ENDCASE(true);
 }
 
+/* Function that tests if the Array moves elements that point to themselves with their move constructor when it grows, re-allocates or erases. */
+bool test_self_relocation() {
+    TESTCASE("self-referencing push, reserve and erase")
+
+    // Push enough elements to re-allocate a few times
+    Array<self_t> test;
+    for (int i = 0; i < 100; i++) {
+        test.push_back(self_t(i));
+    }
+    // Erase a single element and a range, then re-allocate larger and smaller
+    test.erase(10);
+    test.erase(20, 29);
+    test.reserve(200);
+    test.reserve(50);
+    if (test.size() != 50) {
+        ERROR("Relocating self-referencing elements failed; incorrect size: expected " + std::to_string(50) + ", got " + std::to_string(test.size()));
+        ENDCASE(false);
+    }
+
+    // Test if every element still points to itself and has the right value
+    for (size_t i = 0; i < test.size(); i++) {
+        int expected = (int) (i < 10 ? i : (i < 20 ? i + 1 : i + 11));
+        if (!test[i].valid()) {
+            ERROR("Relocating self-referencing elements failed; element at index " + std::to_string(i) + " does not point to itself");
+            ENDCASE(false);
+        }
+        if (*test[i] != expected) {
+            ERROR("Relocating self-referencing elements failed; incorrect value at index " + std::to_string(i) + ": expected " + std::to_string(expected) + ", got " + std::to_string(*test[i]));
+            ENDCASE(false);
+        }
+    }
+
+    ENDCASE(true);
+}
 
 
 
@@ -333,6 +367,9 @@ bool test_push_erase() {
     if (!test_range_erase()) {
         ENDRUN(false);
     }
+    if (!test_self_relocation()) {
+        ENDRUN(false);
+    }
 
     ENDRUN(true);
 }
@@ -0,0 +1,151 @@
+/* SMALL ARRAY.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 18:58:14
+ * Last edited:
+ *   16/10/2026, 19:04:32
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Checks the SmallArray class, and especially whether it moves its
+ *   elements correctly between its inline storage and the heap.
+**/
+
+#include <iostream>
+#include <cstddef>
+
+#define FULLCOMPILE
+#include "Tools/SmallArray.hpp"
+#include "common.hpp"
+
+using namespace std;
+using namespace Tools;
+
+
+/***** TESTS *****/
+/* Function that tests if the SmallArray keeps elements inline until it has more than N of them. */
+bool test_small_push() {
+    TESTCASE("inline and spilling push")
+
+    // Fill the inline storage
+    SmallArray<hard_t, 4> test;
+    for (int i = 0; i < 4; i++) {
+        test.push_back(hard_t(i));
+    }
+    if (!test.is_inline() || test.capacity() != 4) {
+        ERROR("Pushing to inline storage failed; array allocated on the heap with capacity " + std::to_string(test.capacity()));
+        ENDCASE(false);
+    }
+
+    // Push one more, which should move everything to the heap
+    test.push_back(hard_t(4));
+    if (test.is_inline() || test.size() != 5) {
+        ERROR("Pushing past inline storage failed; incorrect size: expected " + std::to_string(5) + ", got " + std::to_string(test.size()));
+        ENDCASE(false);
+    }
+
+    // Test if the values made it
+    for (size_t i = 0; i < test.size(); i++) {
+        if (*test[i] != (int) i) {
+            ERROR("Pushing past inline storage failed; incorrect value at index " + std::to_string(i) + ": expected " + std::to_string(i) + ", got " + std::to_string(*test[i]));
+            ENDCASE(false);
+        }
+    }
+
+    // Clearing should give back the inline storage
+    test.clear();
+    if (!test.is_inline() || test.size() != 0 || test.capacity() != 4) {
+        ERROR("Clearing spilled array failed; array did not return to its inline storage");
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+/* Function that tests if copying and moving the SmallArray works both for inline and for heap storage. */
+bool test_small_copy_move() {
+    TESTCASE("copy and move")
+
+    // Try it for both an inline and a spilled array
+    for (int n = 2; n <= 6; n += 4) {
+        SmallArray<hard_t, 4> source;
+        for (int i = 0; i < n; i++) {
+            source.push_back(hard_t(i));
+        }
+
+        // Copy it, then move the copy twice (once by constructor, once by assignment)
+        SmallArray<hard_t, 4> copy(source);
+        SmallArray<hard_t, 4> moved(std::move(copy));
+        SmallArray<hard_t, 4> assigned;
+        assigned = std::move(moved);
+        if (copy.size() != 0 || moved.size() != 0 || !copy.is_inline() || !moved.is_inline()) {
+            ERROR("Moving " + std::to_string(n) + " elements failed; moved-from arrays are not empty");
+            ENDCASE(false);
+        }
+        if (assigned.size() != (size_t) n || source.size() != (size_t) n) {
+            ERROR("Copying and moving " + std::to_string(n) + " elements failed; incorrect size: expected " + std::to_string(n) + ", got " + std::to_string(assigned.size()));
+            ENDCASE(false);
+        }
+
+        // Test if the values made it in both
+        for (size_t i = 0; i < assigned.size(); i++) {
+            if (*assigned[i] != (int) i || *source[i] != (int) i) {
+                ERROR("Copying and moving " + std::to_string(n) + " elements failed; incorrect value at index " + std::to_string(i));
+                ENDCASE(false);
+            }
+        }
+    }
+
+    ENDCASE(true);
+}
+
+/* Function that tests if the SmallArray moves elements that point to themselves correctly between the inline storage and the heap. */
+bool test_small_relocation() {
+    TESTCASE("self-referencing spill, erase and shrink")
+
+    // Spill to the heap, erase some and then shrink back to the inline storage
+    SmallArray<self_t, 4> test;
+    for (int i = 0; i < 8; i++) {
+        test.push_back(self_t(i));
+    }
+    test.erase(1, 4);
+    test.reserve(4);
+    if (!test.is_inline() || test.size() != 4) {
+        ERROR("Shrinking back to inline storage failed; incorrect size: expected " + std::to_string(4) + ", got " + std::to_string(test.size()));
+        ENDCASE(false);
+    }
+
+    // Test if every element still points to itself and has the right value
+    for (size_t i = 0; i < test.size(); i++) {
+        int expected = i == 0 ? 0 : (int) i + 4;
+        if (!test[i].valid() || *test[i] != expected) {
+            ERROR("Relocating self-referencing elements failed at index " + std::to_string(i) + ": expected " + std::to_string(expected) + ", got " + std::to_string(*test[i]));
+            ENDCASE(false);
+        }
+    }
+
+    ENDCASE(true);
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+bool test_small_array() {
+    TESTRUN("SmallArray");
+
+    if (!test_small_push()) {
+        ENDRUN(false);
+    }
+    if (!test_small_copy_move()) {
+        ENDRUN(false);
+    }
+    if (!test_small_relocation()) {
+        ENDRUN(false);
+    }
+
+    ENDRUN(true);
+}
@@ -0,0 +1,226 @@
+/* SOA.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:19:38
+ * Last edited:
+ *   16/10/2026, 19:23:15
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Checks the SoA class, and especially whether each field stays aligned
+ *   and in sync with the others while growing and erasing.
+**/
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+
+#define FULLCOMPILE
+#include "Tools/SoA.hpp"
+#include "common.hpp"
+
+using namespace std;
+using namespace Tools;
+
+
+/***** HELPER FUNCTIONS *****/
+/* Returns whether all fields of the given SoA start on the SoA's alignment. */
+template <class... Ts>
+static bool is_aligned(const SoA<Ts...>& soa) {
+    return ((uintptr_t) soa.template field<0>().data() % SoA<Ts...>::alignment == 0) &&
+           ((uintptr_t) soa.template field<1>().data() % SoA<Ts...>::alignment == 0) &&
+           ((uintptr_t) soa.template field<2>().data() % SoA<Ts...>::alignment == 0);
+}
+
+
+
+
+
+/***** TESTS *****/
+/* Function that tests if pushing to the SoA keeps every field aligned and all fields of an element together. */
+bool test_soa_push() {
+    TESTCASE("push and field access")
+
+    // Push fields of different sizes, so that the arrays have different lengths
+    SoA<uint8_t, double, hard_t> test;
+    for (int i = 0; i < 100; i++) {
+        test.push_back((uint8_t) i, (double) i * 2, hard_t(i * 3));
+        if (!is_aligned(test)) {
+            ERROR("Pushing failed; field not aligned to " + std::to_string(SoA<uint8_t, double, hard_t>::alignment) + " bytes at capacity " + std::to_string(test.capacity()));
+            ENDCASE(false);
+        }
+    }
+    if (test.size() != 100 || test.capacity() != 128) {
+        ERROR("Pushing failed; incorrect size or capacity: expected 100 and 128, got " + std::to_string(test.size()) + " and " + std::to_string(test.capacity()));
+        ENDCASE(false);
+    }
+
+    // Test if the values made it, both through the spans and through get()
+    Span<const uint8_t> bytes = test.field<0>();
+    Span<double> doubles = test.field<1>();
+    Span<hard_t> hards = test.field<2>();
+    for (size_t i = 0; i < test.size(); i++) {
+        if (bytes[i] != i || doubles[i] != (double) i * 2 || *hards[i] != (int) i * 3 || *test.get<2>(i) != (int) i * 3) {
+            ERROR("Pushing failed; incorrect values at index " + std::to_string(i));
+            ENDCASE(false);
+        }
+    }
+
+    ENDCASE(true);
+}
+
+/* Function that tests if erasing from the SoA moves all fields along. */
+bool test_soa_erase() {
+    TESTCASE("erase and pop_back")
+
+    // Fill it
+    SoA<int, self_t, hard_t> test;
+    for (int i = 0; i < 20; i++) {
+        test.push_back(i, self_t(i), hard_t(i));
+    }
+
+    // Erase the second element, then a range, then the last one
+    test.erase(1);
+    test.erase(4, 8);
+    test.pop_back();
+    if (test.size() != 13) {
+        ERROR("Erasing failed; incorrect size: expected " + std::to_string(13) + ", got " + std::to_string(test.size()));
+        ENDCASE(false);
+    }
+
+    // What's left should be 0, 2, 3, 4 and 10 up to 18
+    for (size_t i = 0; i < test.size(); i++) {
+        int expected = i == 0 ? 0 : (i < 4 ? (int) i + 1 : (int) i + 6);
+        if (test.get<0>(i) != expected || !test.get<1>(i).valid() || *test.get<1>(i) != expected || *test.get<2>(i) != expected) {
+            ERROR("Erasing failed at index " + std::to_string(i) + ": expected " + std::to_string(expected) + ", got " + std::to_string(test.get<0>(i)));
+            ENDCASE(false);
+        }
+    }
+
+    // Erasing out-of-bounds should do nothing
+    test.erase(13);
+    test.erase(5, 3);
+    if (test.size() != 13) {
+        ERROR("Erasing out-of-bounds failed; size changed to " + std::to_string(test.size()));
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+/* Function that tests reserve(), resize(), swap_elements() and pushing an element of the SoA itself. */
+bool test_soa_resize() {
+    TESTCASE("reserve, resize and swap_elements")
+
+    // Reserve exactly
+    SoA<int, float, self_t> test;
+    test.reserve(3);
+    test.push_back(1, 1.0f, self_t(1));
+    test.push_back(2, 2.0f, self_t(2));
+    test.push_back(3, 3.0f, self_t(3));
+    if (test.capacity() != 3) {
+        ERROR("Reserving failed; incorrect capacity: expected " + std::to_string(3) + ", got " + std::to_string(test.capacity()));
+        ENDCASE(false);
+    }
+
+    // Pushing its own first element to a full SoA should still copy the right values
+    test.push_back(test.get<0>(0), test.get<1>(0), test.get<2>(0));
+    if (test.size() != 4 || test.get<0>(3) != 1 || test.get<1>(3) != 1.0f || !test.get<2>(3).valid() || *test.get<2>(3) != 1) {
+        ERROR("Pushing own element failed; incorrect values at index 3");
+        ENDCASE(false);
+    }
+
+    // Swap the first and last element
+    test.swap_elements(0, 2);
+    if (test.get<0>(0) != 3 || test.get<1>(0) != 3.0f || *test.get<2>(0) != 3 || test.get<0>(2) != 1 || *test.get<2>(2) != 1) {
+        ERROR("Swapping elements failed; fields were not swapped together");
+        ENDCASE(false);
+    }
+
+    // Shrink it, which should drop the last elements
+    test.reserve(2);
+    if (test.size() != 2 || test.capacity() != 2 || test.get<0>(1) != 2 || !test.get<2>(1).valid()) {
+        ERROR("Shrinking failed; incorrect size: expected " + std::to_string(2) + ", got " + std::to_string(test.size()));
+        ENDCASE(false);
+    }
+
+    // Resizing should value-initialize the new elements
+    SoA<int, float, uint16_t> values;
+    values.push_back(7, 7.0f, 7);
+    values.resize(5);
+    if (values.size() != 5 || values.get<0>(0) != 7 || values.get<0>(4) != 0 || values.get<1>(4) != 0.0f || values.get<2>(4) != 0) {
+        ERROR("Resizing failed; new elements were not initialized to zero");
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+/* Function that tests if copying and moving the SoA works. */
+bool test_soa_copy_move() {
+    TESTCASE("copy and move")
+
+    // Fill it
+    SoA<int, hard_t, self_t> source;
+    for (int i = 0; i < 10; i++) {
+        source.push_back(i, hard_t(i), self_t(i));
+    }
+
+    // Copy it, then move the copy twice (once by constructor, once by assignment)
+    SoA<int, hard_t, self_t> copy(source);
+    SoA<int, hard_t, self_t> moved(std::move(copy));
+    SoA<int, hard_t, self_t> assigned;
+    assigned = std::move(moved);
+    if (!copy.empty() || !moved.empty() || assigned.size() != source.size() || !is_aligned(assigned)) {
+        ERROR("Copying or moving failed; incorrect sizes after moving");
+        ENDCASE(false);
+    }
+    for (size_t i = 0; i < source.size(); i++) {
+        if (assigned.get<0>(i) != (int) i || *assigned.get<1>(i) != (int) i || !assigned.get<2>(i).valid() || *assigned.get<2>(i) != (int) i) {
+            ERROR("Copying or moving failed; incorrect value at index " + std::to_string(i));
+            ENDCASE(false);
+        }
+    }
+
+    // The copy should own its own values
+    *assigned.get<1>(0) = 42;
+    if (*source.get<1>(0) != 0) {
+        ERROR("Copying failed; copy shares its values with the original");
+        ENDCASE(false);
+    }
+
+    // Clearing should give back the memory
+    assigned.clear();
+    if (assigned.size() != 0 || assigned.capacity() != 0 || !assigned.field<1>().empty()) {
+        ERROR("Clearing failed; SoA still has elements or capacity");
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+bool test_soa() {
+    TESTRUN("SoA");
+
+    if (!test_soa_push()) {
+        ENDRUN(false);
+    }
+    if (!test_soa_erase()) {
+        ENDRUN(false);
+    }
+    if (!test_soa_resize()) {
+        ENDRUN(false);
+    }
+    if (!test_soa_copy_move()) {
+        ENDRUN(false);
+    }
+
+    ENDRUN(true);
+}
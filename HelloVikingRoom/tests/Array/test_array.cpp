@@ -4,7 +4,7 @@
  * Created:
  *   12/22/2020, 5:06:03 PM
  * Last edited:
- *   1/13/2021, 4:57:16 PM
+ *   16/10/2026, 21:02:59
  * Auto updated?
  *   Yes
  *
@@ -31,6 +31,12 @@ extern bool test_resize();
 extern bool test_push_erase();
 // Function that tests the correctness of T's without all constructors
 extern bool test_constructors();
+// Function that tests the SmallArray class
+extern bool test_small_array();
+// Function that tests the Arena and Pool allocators
+extern bool test_allocators();
+// Function that tests the SoA class
+extern bool test_soa();
 
 int main() {
     // Seed the random seed
@@ -51,6 +57,15 @@ int main() {
     if (!test_constructors()) {
         return EXIT_FAILURE;
     }
+    if (!test_small_array()) {
+        return EXIT_FAILURE;
+    }
+    if (!test_allocators()) {
+        return EXIT_FAILURE;
+    }
+    if (!test_soa()) {
+        return EXIT_FAILURE;
+    }
 
     return EXIT_SUCCESS;
 }
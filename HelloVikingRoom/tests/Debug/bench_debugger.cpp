@@ -0,0 +1,111 @@
+/* BENCH DEBUGGER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 18:10:32
+ * Last edited:
+ *   16/10/2026, 18:24:50
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Microbenchmark for the debugger's call stack. Measures what a DENTER /
+ *   DLEAVE pair and a message logged from a muted function cost (both
+ *   one built by concatenating strings and one built by DLOGF), on a
+ *   single thread and on several threads at once.
+**/
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+
+#include "Debug/Debug.hpp"
+
+using namespace std;
+using namespace Debug::SeverityValues;
+
+
+/***** CONSTANTS *****/
+/* The number of calls to do per thread per run. */
+static const size_t n_calls = 200000;
+/* The number of threads used in the multithreaded runs. */
+static const size_t n_threads = 8;
+
+
+/***** HELPER FUNCTIONS *****/
+/* Function that does nothing but enter and leave itself. */
+static void empty_function() {
+    DENTER("empty_function");
+    DLEAVE;
+}
+
+/* Function that logs a message, which is muted. */
+static void muted_function() {
+    DENTER("muted_function");
+    DLOG(info, "This message is muted.");
+    DLEAVE;
+}
+
+/* Function that logs a message built from a number, which is muted. */
+static void muted_concat_function() {
+    DENTER("muted_function");
+    DLOG(info, "This message about frame " + std::to_string(n_calls) + " is muted.");
+    DLEAVE;
+}
+
+/* Function that logs a formatted message, which is muted and therefore never formatted. */
+static void muted_format_function() {
+    DENTER("muted_function");
+    DLOGF(info, "This message about frame {} is muted.", n_calls);
+    DLEAVE;
+}
+
+/* Calls the given function n_calls times. */
+static void run(void (*function)()) {
+    // Mutes are per thread, so set it here
+    DMUTE("muted_function");
+    for (size_t i = 0; i < n_calls; i++) {
+        function();
+    }
+}
+
+/* Calls the given function n_calls times on each of the given number of threads at once, and returns the number of nanoseconds of wall time per call over all threads. */
+static double run_threaded(void (*function)(), size_t n) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (n == 1) {
+        run(function);
+    } else {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < n; t++) {
+            threads.push_back(std::thread(run, function));
+        }
+        for (size_t t = 0; t < n; t++) {
+            threads[t].join();
+        }
+    }
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double) (n * n_calls);
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+int main() {
+    DSTART("main thread"); DENTER("main");
+
+    cout << "Running debugger benchmark (" << n_calls << " calls per thread, " << std::thread::hardware_concurrency() << " cores)" << endl;
+    size_t thread_counts[] = { 1, n_threads };
+    for (size_t i = 0; i < 2; i++) {
+        cout << thread_counts[i] << " thread(s):" << endl;
+        cout << "  DENTER/DLEAVE: " << run_threaded(empty_function, thread_counts[i]) << " ns" << endl;
+        cout << "  muted DLOG: " << run_threaded(muted_function, thread_counts[i]) << " ns" << endl;
+        cout << "  muted DLOG (concatenated): " << run_threaded(muted_concat_function, thread_counts[i]) << " ns" << endl;
+        cout << "  muted DLOGF: " << run_threaded(muted_format_function, thread_counts[i]) << " ns" << endl;
+    }
+
+    DRETURN EXIT_SUCCESS;
+}
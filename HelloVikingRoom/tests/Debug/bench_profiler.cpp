@@ -0,0 +1,106 @@
+/* BENCH PROFILER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 18:09:41
+ * Last edited:
+ *   16/10/2026, 18:03:29
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Microbenchmark for the CPU profiler. Measures what a single zone
+ *   (entering and leaving it) costs with the profiler stopped, with it
+ *   recording on one thread and with it recording on several threads at
+ *   once, and compares that to a DENTER / DLEAVE pair, which also feeds
+ *   the debugger's stack in debug builds.
+**/
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+
+#include "Debug/Debug.hpp"
+
+using namespace std;
+using namespace Debug::SeverityValues;
+
+
+/***** CONSTANTS *****/
+/* The number of zones to enter and leave per thread per run. */
+static const size_t n_zones = 200000;
+/* The number of threads used in the multithreaded run. */
+static const size_t n_threads = 8;
+
+
+/***** HELPER FUNCTIONS *****/
+/* Enters and leaves n_zones nested zones with DZONE, and returns the number of nanoseconds each took. */
+static double run_zones() {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n_zones; i++) {
+        DZONE("bench_zone");
+    }
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double) n_zones;
+}
+
+/* Enters and leaves n_zones functions with DENTER / DLEAVE, and returns the number of nanoseconds each took. */
+static double run_functions() {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n_zones; i++) {
+        DENTER("bench_function");
+        DLEAVE;
+    }
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double) n_zones;
+}
+
+/* Runs run_zones() on n_threads threads at once, and returns the number of nanoseconds of wall time per zone over all threads. With at least n_threads cores and no contention, that's the single-threaded cost divided by n_threads. */
+static double run_threaded() {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; t++) {
+        threads.push_back(std::thread(run_zones));
+    }
+    for (size_t t = 0; t < n_threads; t++) {
+        threads[t].join();
+    }
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double) (n_threads * n_zones);
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+int main() {
+    DSTART("main thread"); DENTER("main");
+
+    cout << "Running profiler benchmark (" << n_zones << " zones per thread)" << endl;
+
+    // First without recording, which is what every DENTER in a release build costs when nobody is looking
+    cout << "stopped:" << endl;
+    cout << "  DZONE: " << run_zones() << " ns" << endl;
+    cout << "  DENTER/DLEAVE: " << run_functions() << " ns" << endl;
+
+    // Then recording on a single thread
+    Debug::profiler.start();
+    run_zones();
+    Debug::profiler.stop(); Debug::profiler.clear(); Debug::profiler.start();
+    cout << "recording:" << endl;
+    cout << "  DZONE: " << run_zones() << " ns" << endl;
+    cout << "  DENTER/DLEAVE: " << run_functions() << " ns" << endl;
+    cout << "  events: " << Debug::profiler.size() << endl;
+
+    // Finally recording on several threads at once, which shouldn't contend on anything
+    Debug::profiler.stop(); Debug::profiler.clear(); Debug::profiler.start();
+    cout << "recording on " << n_threads << " threads (" << std::thread::hardware_concurrency() << " cores):" << endl;
+    cout << "  DZONE: " << run_threaded() << " ns of wall time per zone" << endl;
+    cout << "  events: " << Debug::profiler.size() << endl;
+    Debug::profiler.stop();
+
+    DRETURN EXIT_SUCCESS;
+}
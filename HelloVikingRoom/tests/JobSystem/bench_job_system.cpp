@@ -0,0 +1,142 @@
+/* BENCH JOB SYSTEM.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:47:36
+ * Last edited:
+ *   16/10/2026, 19:51:41
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Microbenchmark for the JobSystem. Transforms a large number of
+ *   vertices with parallel_for on one up to as many workers as there are
+ *   cores, reporting the speedup over doing it serially, and measures the
+ *   overhead of scheduling many tiny jobs.
+**/
+
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "Tools/JobSystem.hpp"
+
+using namespace std;
+using namespace Tools;
+
+
+/***** CONSTANTS *****/
+/* The number of vertices to transform. */
+static const size_t n_vertices = 1 << 20;
+/* The number of vertices per parallel_for range. */
+static const size_t grain_size = 4096;
+/* The number of times to transform all vertices per measurement. */
+static const size_t n_passes = 20;
+/* The number of tiny jobs to schedule when measuring overhead. */
+static const size_t n_jobs = 200000;
+
+
+/***** HELPER STRUCTS *****/
+/* A vertex as it's kept for culling: a position and a radius. */
+struct vertex_t {
+    /* The position of the vertex. */
+    float position[3];
+    /* The radius of the vertex' bounds. */
+    float radius;
+};
+
+
+/***** HELPER FUNCTIONS *****/
+/* Transforms the given range of vertices by a rotation matrix and tests them against a plane, which is about the work per element of culling or skinning. Returns the number of vertices in front of it. */
+static size_t transform_range(const vertex_t* input, vertex_t* output, size_t start_index, size_t stop_index) {
+    const float m[9] = { 0.36f, 0.48f, -0.8f, -0.8f, 0.6f, 0.0f, 0.48f, 0.64f, 0.6f };
+    size_t n_visible = 0;
+    for (size_t i = start_index; i < stop_index; i++) {
+        const float* p = input[i].position;
+        float x = m[0] * p[0] + m[1] * p[1] + m[2] * p[2];
+        float y = m[3] * p[0] + m[4] * p[1] + m[5] * p[2];
+        float z = m[6] * p[0] + m[7] * p[1] + m[8] * p[2];
+        output[i] = { { x, y, z }, input[i].radius };
+        n_visible += z + input[i].radius > 0.0f;
+    }
+    return n_visible;
+}
+
+/* Transforms all vertices n_passes times on the current thread, without any jobs. Returns the number of milliseconds per pass. */
+static double bench_serial(const std::vector<vertex_t>& input, std::vector<vertex_t>& output) {
+    size_t n_visible = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t p = 0; p < n_passes; p++) {
+        n_visible += transform_range(input.data(), output.data(), 0, n_vertices);
+    }
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    if (n_visible == 0) { cerr << "Unexpected checksum" << endl; }
+    return std::chrono::duration<double, std::milli>(stop - start).count() / (double) n_passes;
+}
+
+/* Transforms all vertices n_passes times on a system with the given number of workers. Returns the number of milliseconds per pass. */
+static double bench_transform(const std::vector<vertex_t>& input, std::vector<vertex_t>& output, size_t n_workers) {
+    JobSystem system(n_workers);
+    std::atomic<size_t> n_visible(0);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t p = 0; p < n_passes; p++) {
+        system.parallel_for(n_vertices, grain_size, [&input, &output, &n_visible](size_t start_index, size_t stop_index) {
+            n_visible.fetch_add(transform_range(input.data(), output.data(), start_index, stop_index), std::memory_order_relaxed);
+        });
+    }
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    if (n_visible.load() == 0) { cerr << "Unexpected checksum" << endl; }
+    return std::chrono::duration<double, std::milli>(stop - start).count() / (double) n_passes;
+}
+
+/* Schedules n_jobs empty jobs on a system with the given number of workers and waits for them. Returns the number of nanoseconds per job. */
+static double bench_overhead(size_t n_workers) {
+    JobSystem system(n_workers);
+    std::atomic<size_t> n_run(0);
+    JobCounter counter;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n_jobs; i++) {
+        system.run([&n_run]() { n_run.fetch_add(1, std::memory_order_relaxed); }, &counter);
+    }
+    system.wait(counter);
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    if (n_run.load() != n_jobs) { cerr << "Unexpected checksum" << endl; }
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double) n_jobs;
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+int main() {
+    size_t n_cores = std::thread::hardware_concurrency();
+    if (n_cores == 0) { n_cores = 1; }
+    cout << "Running job system benchmark on " << n_cores << " cores" << endl;
+
+    // Prepare some vertices
+    std::vector<vertex_t> input(n_vertices), output(n_vertices);
+    for (size_t i = 0; i < n_vertices; i++) {
+        float f = (float) i / (float) n_vertices;
+        input[i] = { { f - 0.5f, 0.5f - f * f, f * 0.25f }, 0.01f };
+    }
+
+    // Transform them with more and more workers
+    cout << "Transforming vertices (" << n_vertices << " vertices of " << sizeof(vertex_t) << " bytes, ranges of " << grain_size << "):" << endl;
+    double baseline = bench_serial(input, output);
+    cout << "  serial: " << baseline << " ms per pass" << endl;
+    for (size_t n_workers = 1; n_workers <= n_cores; n_workers++) {
+        double time = bench_transform(input, output, n_workers);
+        cout << "  " << n_workers << " worker(s): " << time << " ms per pass, " << baseline / time << "x speedup" << endl;
+    }
+
+    // Measure the cost of tiny jobs, scheduled from outside the workers
+    cout << "Scheduling overhead (" << n_jobs << " empty jobs from the main thread):" << endl;
+    cout << "  1 worker(s): " << bench_overhead(1) << " ns per job" << endl;
+    if (n_cores > 1) { cout << "  " << n_cores << " worker(s): " << bench_overhead(n_cores) << " ns per job" << endl; }
+    return EXIT_SUCCESS;
+}
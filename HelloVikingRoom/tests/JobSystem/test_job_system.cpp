@@ -0,0 +1,275 @@
+/* TEST JOB SYSTEM.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:32:18
+ * Last edited:
+ *   16/10/2026, 22:48:16
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Checks the JobSystem class and its work-stealing deques: whether every
+ *   job runs exactly once, whether counters wait for all of them and
+ *   whether jobs can schedule and wait for jobs themselves, and whether
+ *   exceptions thrown by jobs reach whoever waits for them.
+**/
+
+#include <iostream>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <stdexcept>
+
+#define FULLCOMPILE
+#include "Tools/JobSystem.hpp"
+#include "../Array/common.hpp"
+
+using namespace std;
+using namespace Tools;
+
+
+/***** TESTS *****/
+/* Function that tests the order in which the JobDeque hands out jobs on a single thread. */
+bool test_job_deque() {
+    TESTCASE("deque order")
+
+    // Push three jobs; the owner should get the newest, a thief the oldest
+    Job jobs[3] = { { nullptr, nullptr }, { nullptr, nullptr }, { nullptr, nullptr } };
+    JobDeque* test = new JobDeque();
+    for (size_t i = 0; i < 3; i++) { test->push(jobs + i); }
+    Job* popped = test->pop();
+    Job* stolen = test->steal();
+    Job* last = test->pop();
+    if (popped != jobs + 2 || stolen != jobs + 0 || last != jobs + 1 || test->pop() != nullptr || test->steal() != nullptr) {
+        ERROR("Taking jobs from deque failed; jobs were handed out in the wrong order");
+        delete test;
+        ENDCASE(false);
+    }
+
+    // Fill it completely, which should refuse the one after that
+    for (size_t i = 0; i < JobDeque::capacity; i++) {
+        if (!test->push(jobs)) {
+            ERROR("Filling deque failed; refused job " + std::to_string(i) + " of " + std::to_string(JobDeque::capacity));
+            delete test;
+            ENDCASE(false);
+        }
+    }
+    if (test->push(jobs)) {
+        ERROR("Filling deque failed; accepted more than " + std::to_string(JobDeque::capacity) + " jobs");
+        delete test;
+        ENDCASE(false);
+    }
+
+    delete test;
+    ENDCASE(true);
+}
+
+/* Function that tests if all jobs scheduled from outside the workers run exactly once. */
+bool test_job_run() {
+    TESTCASE("run and wait")
+
+    JobSystem system(4);
+    for (int round = 0; round < 10; round++) {
+        // Schedule a lot of small jobs, each adding its own number
+        std::atomic<uint64_t> sum(0);
+        JobCounter counter;
+        for (uint64_t i = 1; i <= 1000; i++) {
+            system.run([&sum, i]() { sum.fetch_add(i); }, &counter);
+        }
+        system.wait(counter);
+        if (!counter.done() || sum.load() != 500500) {
+            ERROR("Running jobs failed; incorrect sum: expected " + std::to_string(500500) + ", got " + std::to_string(sum.load()));
+            ENDCASE(false);
+        }
+    }
+
+    ENDCASE(true);
+}
+
+/* Function that tests if parallel_for visits every index exactly once, for several grain sizes. */
+bool test_job_parallel_for() {
+    TESTCASE("parallel_for")
+
+    JobSystem system(4);
+    const size_t n_indices = 10007;
+    for (size_t grain_size = 0; grain_size <= 1000; grain_size = grain_size * 10 + 1) {
+        std::vector<std::atomic<uint32_t>> visits(n_indices);
+        for (size_t i = 0; i < n_indices; i++) { visits[i].store(0); }
+        std::atomic<bool> too_large(false);
+
+        system.parallel_for(n_indices, grain_size, [&visits, &too_large, grain_size](size_t start_index, size_t stop_index) {
+            if (stop_index - start_index > (grain_size > 0 ? grain_size : 1)) { too_large.store(true); }
+            for (size_t i = start_index; i < stop_index; i++) { visits[i].fetch_add(1); }
+        });
+
+        for (size_t i = 0; i < n_indices; i++) {
+            if (visits[i].load() != 1) {
+                ERROR("parallel_for failed with grain size " + std::to_string(grain_size) + "; index " + std::to_string(i) + " visited " + std::to_string(visits[i].load()) + " times");
+                ENDCASE(false);
+            }
+        }
+        if (too_large.load()) {
+            ERROR("parallel_for failed; range larger than grain size " + std::to_string(grain_size));
+            ENDCASE(false);
+        }
+    }
+
+    ENDCASE(true);
+}
+
+/* Function that tests if jobs can schedule and wait for other jobs, and if jobs scheduled with run_after() only see finished work. */
+bool test_job_nested() {
+    TESTCASE("nested jobs and dependencies")
+
+    // Each outer job runs a parallel_for of its own, which waits from within a worker
+    JobSystem system(4);
+    std::atomic<uint64_t> sum(0);
+    JobCounter outer;
+    for (int i = 0; i < 16; i++) {
+        system.run([&system, &sum]() {
+            system.parallel_for(1000, 10, [&sum](size_t start_index, size_t stop_index) {
+                for (size_t j = start_index; j < stop_index; j++) { sum.fetch_add(j); }
+            });
+        }, &outer);
+    }
+
+    // A job that depends on all of them, and one that depends on that one in turn
+    std::atomic<uint64_t> seen(0);
+    std::atomic<uint64_t> seen_after(0);
+    JobCounter dependent, last;
+    system.run_after(outer, [&sum, &seen]() {
+        seen.store(sum.load());
+    }, &dependent);
+    system.run_after(dependent, [&seen, &seen_after]() {
+        seen_after.store(seen.load());
+    }, &last);
+    system.wait(last);
+    system.wait(outer);
+    system.wait(dependent);
+
+    if (seen.load() != 16 * 499500) {
+        ERROR("Running nested jobs failed; dependent job saw sum " + std::to_string(seen.load()) + " instead of " + std::to_string(16 * 499500));
+        ENDCASE(false);
+    }
+    if (seen_after.load() != 16 * 499500) {
+        ERROR("Running nested jobs failed; second dependent job saw sum " + std::to_string(seen_after.load()) + " instead of " + std::to_string(16 * 499500));
+        ENDCASE(false);
+    }
+
+    // Depending on a counter that's already done runs the job right away
+    JobCounter finished;
+    system.run_after(dependent, [&seen_after]() { seen_after.store(0); }, &finished);
+    system.wait(finished);
+    if (seen_after.load() != 0) {
+        ERROR("Running nested jobs failed; job depending on a finished counter did not run");
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+/* Function that tests if exceptions thrown by jobs are rethrown by wait() and parallel_for, both when a worker's chunk throws and when the calling thread's own chunk does. */
+bool test_job_exceptions() {
+    TESTCASE("exceptions")
+
+    JobSystem system(4);
+
+    // A counted job that throws should have its exception rethrown by wait()
+    JobCounter counter;
+    for (int i = 0; i < 100; i++) {
+        system.run([i]() { if (i == 42) { throw std::runtime_error("job 42"); } }, &counter);
+    }
+    bool caught = false;
+    try {
+        system.wait(counter);
+    } catch (std::runtime_error& e) {
+        caught = std::string(e.what()) == "job 42";
+    }
+    if (!caught || !counter.done()) {
+        ERROR("Throwing from a job failed; wait() did not rethrow its exception after all jobs were done");
+        ENDCASE(false);
+    }
+
+    // The calling thread always runs the first chunk itself, while the last one is always scheduled as a job, so throw from either
+    const size_t n_indices = 10000;
+    const size_t grain_size = 10;
+    const size_t throw_at[2] = { 0, n_indices - 1 };
+    for (size_t t = 0; t < 2; t++) {
+        std::atomic<size_t> n_running(0);
+        std::atomic<size_t> n_after(0);
+        caught = false;
+        try {
+            system.parallel_for(n_indices, grain_size, [&n_running, &n_after, &throw_at, t](size_t start_index, size_t stop_index) {
+                n_running.fetch_add(1);
+                if (start_index <= throw_at[t] && throw_at[t] < stop_index) {
+                    n_running.fetch_sub(1);
+                    throw std::runtime_error("index " + std::to_string(throw_at[t]));
+                }
+                for (size_t i = start_index; i < stop_index; i++) { n_after.fetch_add(1); }
+                n_running.fetch_sub(1);
+            });
+        } catch (std::runtime_error& e) {
+            caught = std::string(e.what()) == "index " + std::to_string(throw_at[t]);
+        }
+        if (!caught) {
+            ERROR("Throwing from parallel_for failed; exception for index " + std::to_string(throw_at[t]) + " was not rethrown");
+            ENDCASE(false);
+        }
+        // Nothing may still be running once it returned, since the jobs refer to its stack
+        if (n_running.load() != 0) {
+            ERROR("Throwing from parallel_for failed; returned while " + std::to_string(n_running.load()) + " chunks were still running");
+            ENDCASE(false);
+        }
+    }
+
+    // The system should still work afterwards
+    std::atomic<uint64_t> sum(0);
+    system.parallel_for(1000, 10, [&sum](size_t start_index, size_t stop_index) {
+        for (size_t i = start_index; i < stop_index; i++) { sum.fetch_add(i); }
+    });
+    if (sum.load() != 499500) {
+        ERROR("Running after an exception failed; incorrect sum: expected " + std::to_string(499500) + ", got " + std::to_string(sum.load()));
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+bool test_job_system() {
+    TESTRUN("JobSystem");
+
+    if (!test_job_deque()) {
+        ENDRUN(false);
+    }
+    if (!test_job_run()) {
+        ENDRUN(false);
+    }
+    if (!test_job_parallel_for()) {
+        ENDRUN(false);
+    }
+    if (!test_job_nested()) {
+        ENDRUN(false);
+    }
+    if (!test_job_exceptions()) {
+        ENDRUN(false);
+    }
+
+    ENDRUN(true);
+}
+
+int main() {
+    if (!test_job_system()) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
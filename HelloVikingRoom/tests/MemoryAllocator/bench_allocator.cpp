@@ -0,0 +1,204 @@
+/* BENCH ALLOCATOR.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 11:02:14
+ * Last edited:
+ *   16/10/2026, 19:04:32
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Stress benchmark for the MemoryAllocator. Creates and frees thousands
+ *   of buffers in a random pattern, once with a dedicated
+ *   vkAllocateMemory-call per buffer and once through the allocator, and
+ *   reports the timings and the allocator's statistics. Doesn't need a
+ *   window, so it can be run against a software driver (e.g., lavapipe
+ *   via VK_ICD_FILENAMES).
+**/
+
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+
+#include "Vulkan/Instance.hpp"
+#include "Vulkan/Device.hpp"
+#include "Vulkan/MemoryAllocator.hpp"
+#include "Vulkan/Buffer.hpp"
+#include "Tools/Array.hpp"
+#include "Debug/Debug.hpp"
+
+using namespace std;
+using namespace HelloVikingRoom;
+using namespace Tools;
+using namespace Debug::SeverityValues;
+
+
+/***** CONSTANTS *****/
+/* The number of create/free operations to do per run. */
+static const size_t n_operations = 20000;
+/* The maximum number of buffers alive at any one time. */
+static const size_t max_alive = 2048;
+/* The seed used for both runs, so they do the exact same thing. */
+static const unsigned int seed = 42;
+
+
+/***** HELPER FUNCTIONS *****/
+/* Returns a random buffer size between 256 bytes and 256 KiB, biased towards small buffers. */
+static VkDeviceSize random_size(std::mt19937& rng) {
+    std::uniform_int_distribution<int> shift_dist(8, 18);
+    std::uniform_int_distribution<int> extra_dist(0, 255);
+    return ((VkDeviceSize) 1 << shift_dist(rng)) + (VkDeviceSize) extra_dist(rng);
+}
+
+/* Runs the stress pattern with a dedicated allocation per buffer, like Buffer used to do. Returns the number of seconds it took. */
+static double run_dedicated(const Vulkan::Device& device, const Vulkan::MemoryAllocator& allocator) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> op_dist(0, 2);
+
+    // Keep track of the live buffers ourselves
+    Array<VkBuffer> buffers(max_alive);
+    Array<VkDeviceMemory> memories(max_alive);
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < n_operations; i++) {
+        if (buffers.size() < max_alive && (buffers.empty() || op_dist(rng) != 0)) {
+            // Create a buffer with its own memory
+            VkBufferCreateInfo buffer_info{};
+            buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            buffer_info.size = random_size(rng);
+            buffer_info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+            buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            VkBuffer buffer;
+            if (vkCreateBuffer(device, &buffer_info, nullptr, &buffer) != VK_SUCCESS) {
+                DLOG(fatal, "Could not create buffer.");
+            }
+
+            VkMemoryRequirements requirements;
+            vkGetBufferMemoryRequirements(device, buffer, &requirements);
+            VkMemoryAllocateInfo allocate_info{};
+            allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocate_info.allocationSize = requirements.size;
+            allocate_info.memoryTypeIndex = allocator.get_memory_type(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            VkDeviceMemory memory;
+            if (vkAllocateMemory(device, &allocate_info, nullptr, &memory) != VK_SUCCESS) {
+                DLOG(fatal, "Could not allocate memory (after " + std::to_string(buffers.size()) + " live allocations).");
+            }
+            vkBindBufferMemory(device, buffer, memory, 0);
+
+            buffers.push_back(buffer);
+            memories.push_back(memory);
+        } else {
+            // Free a random buffer by swapping it with the last one
+            size_t index = std::uniform_int_distribution<size_t>(0, buffers.size() - 1)(rng);
+            vkDestroyBuffer(device, buffers[index], nullptr);
+            vkFreeMemory(device, memories[index], nullptr);
+            buffers[index] = buffers[buffers.size() - 1];
+            memories[index] = memories[memories.size() - 1];
+            buffers.pop_back();
+            memories.pop_back();
+        }
+    }
+
+    // Clean what's left
+    for (size_t i = 0; i < buffers.size(); i++) {
+        vkDestroyBuffer(device, buffers[i], nullptr);
+        vkFreeMemory(device, memories[i], nullptr);
+    }
+    std::chrono::high_resolution_clock::time_point stop = std::chrono::high_resolution_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::duration<double>>(stop - start).count();
+}
+
+/* Runs the stress pattern through the allocator using Vulkan::Buffers. Returns the number of seconds it took, and prints the allocator's statistics at peak usage. */
+static double run_allocator(Vulkan::MemoryAllocator& allocator) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> op_dist(0, 2);
+
+    // Keep track of the live buffers
+    Array<Vulkan::Buffer*> buffers(max_alive);
+    Vulkan::MemoryAllocatorStats peak_stats{};
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < n_operations; i++) {
+        if (buffers.size() < max_alive && (buffers.empty() || op_dist(rng) != 0)) {
+            // Create a buffer through the allocator
+            buffers.push_back(new Vulkan::Buffer(allocator, random_size(rng), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT));
+            if (buffers.size() == max_alive && peak_stats.n_allocations == 0) {
+                peak_stats = allocator.stats();
+            }
+        } else {
+            // Free a random buffer by swapping it with the last one
+            size_t index = std::uniform_int_distribution<size_t>(0, buffers.size() - 1)(rng);
+            delete buffers[index];
+            buffers[index] = buffers[buffers.size() - 1];
+            buffers.pop_back();
+        }
+    }
+
+    // Show the stats before we clean up
+    Vulkan::MemoryAllocatorStats end_stats = allocator.stats();
+    for (size_t i = 0; i < buffers.size(); i++) {
+        delete buffers[i];
+    }
+    std::chrono::high_resolution_clock::time_point stop = std::chrono::high_resolution_clock::now();
+
+    // Print the statistics, after whatever the allocator logged
+    DFLUSH;
+    const Vulkan::MemoryAllocatorStats* to_print[] = { &peak_stats, &end_stats };
+    const char* names[] = { "peak", "end" };
+    for (size_t i = 0; i < 2; i++) {
+        cout << "  allocator stats (" << names[i] << "):" << endl;
+        cout << "    blocks             : " << to_print[i]->n_blocks << endl;
+        cout << "    allocations        : " << to_print[i]->n_allocations << endl;
+        cout << "    vkAllocateMemory   : " << to_print[i]->n_device_allocations << endl;
+        cout << "    bytes reserved     : " << to_print[i]->bytes_reserved << endl;
+        cout << "    bytes used         : " << to_print[i]->bytes_used << endl;
+        cout << "    free ranges        : " << to_print[i]->n_free_ranges << endl;
+        cout << "    largest free range : " << to_print[i]->largest_free_range << endl;
+        cout << "    fragmentation      : " << to_print[i]->fragmentation << endl;
+    }
+
+    return std::chrono::duration_cast<std::chrono::duration<double>>(stop - start).count();
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+int main() {
+    DSTART("main thread"); DENTER("main");
+
+    // Don't flood the output with a message for every single buffer
+    DMUTE("Vulkan::Buffer::Buffer");
+    DMUTE("Vulkan::Buffer::~Buffer");
+    DMUTE("Vulkan::MemoryBlock::MemoryBlock");
+    DMUTE("Vulkan::MemoryBlock::~MemoryBlock");
+
+    try {
+        // Create an instance and a device without any window, so we need no extensions either
+        Vulkan::NameList no_extensions;
+        Vulkan::Instance instance(no_extensions);
+        Vulkan::Device device(instance, VK_NULL_HANDLE, no_extensions);
+        Vulkan::MemoryAllocator allocator(device);
+        DFLUSH;
+        cout << "Running allocator benchmark on '" << device.name() << "' (" << n_operations << " operations, at most " << max_alive << " live buffers)" << endl;
+
+        // Run both versions
+        cout << "dedicated:" << endl;
+        double dedicated_time = run_dedicated(device, allocator);
+        DFLUSH;
+        cout << "  time: " << dedicated_time * 1000.0 << " ms" << endl;
+        cout << "allocator:" << endl;
+        double allocator_time = run_allocator(allocator);
+        DFLUSH;
+        cout << "  time: " << allocator_time * 1000.0 << " ms" << endl;
+        cout << "speedup: " << dedicated_time / allocator_time << "x" << endl;
+    } catch (std::runtime_error&) {
+        DRETURN EXIT_FAILURE;
+    }
+
+    DRETURN EXIT_SUCCESS;
+}
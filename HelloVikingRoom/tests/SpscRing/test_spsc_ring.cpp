@@ -0,0 +1,139 @@
+/* TEST SPSC RING.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 19:26:10
+ * Last edited:
+ *   16/10/2026, 21:03:49
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Checks the SpscRing class, both on a single thread and with a
+ *   producer and a consumer thread.
+**/
+
+#include <iostream>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#define FULLCOMPILE
+#include "Tools/SpscRing.hpp"
+#include "../Array/common.hpp"
+
+using namespace std;
+using namespace Tools;
+
+
+/***** CONSTANTS *****/
+/* The number of elements passed between the threads. */
+static const uint64_t n_elements = 1000000;
+
+
+
+
+
+/***** TESTS *****/
+/* Function that tests if the SpscRing keeps its elements in order and refuses them when full, on a single thread. */
+bool test_ring_single() {
+    TESTCASE("single-threaded push and pop")
+
+    // The capacity should be rounded up to a power of two
+    SpscRing<hard_t> test(5);
+    if (test.capacity() != 8) {
+        ERROR("Creating ring failed; incorrect capacity: expected " + std::to_string(8) + ", got " + std::to_string(test.capacity()));
+        ENDCASE(false);
+    }
+
+    // Push and pop a few times, so that the indices wrap around
+    int next_push = 0, next_pop = 0;
+    for (int round = 0; round < 5; round++) {
+        // Fill it until it's full
+        while (test.push(hard_t(next_push))) { ++next_push; }
+        if (next_push - next_pop != 8) {
+            ERROR("Pushing failed; ring was full after " + std::to_string(next_push - next_pop) + " elements instead of 8");
+            ENDCASE(false);
+        }
+
+        // Pop some of them, checking the order
+        hard_t elem(-1);
+        for (int i = 0; i < 5; i++) {
+            if (!test.pop(elem) || *elem != next_pop) {
+                ERROR("Popping failed; expected " + std::to_string(next_pop) + ", got " + std::to_string(*elem));
+                ENDCASE(false);
+            }
+            ++next_pop;
+        }
+    }
+
+    // Empty it completely
+    hard_t elem(-1);
+    while (test.pop(elem)) { ++next_pop; }
+    if (next_pop != next_push || !test.empty()) {
+        ERROR("Popping failed; popped " + std::to_string(next_pop) + " elements, but pushed " + std::to_string(next_push));
+        ENDCASE(false);
+    }
+
+    // Leave a few in it, which the destructor should clean up
+    test.push(hard_t(0));
+    test.push(hard_t(1));
+
+    ENDCASE(true);
+}
+
+/* Function that tests if all elements arrive in order when pushing and popping on different threads. */
+bool test_ring_threads() {
+    TESTCASE("push and pop on different threads")
+
+    // Push all numbers on another thread, retrying whenever the ring is full
+    SpscRing<uint64_t> test(64);
+    std::thread producer([&test]() {
+        for (uint64_t i = 0; i < n_elements; i++) {
+            while (!test.push(i)) { std::this_thread::yield(); }
+        }
+    });
+
+    // Pop them all on this one
+    uint64_t expected = 0, elem;
+    bool in_order = true;
+    while (expected < n_elements) {
+        if (!test.pop(elem)) { std::this_thread::yield(); continue; }
+        if (elem != expected) { in_order = false; }
+        ++expected;
+    }
+    producer.join();
+    if (!in_order || !test.empty()) {
+        ERROR("Passing elements between threads failed; elements arrived out of order");
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+bool test_spsc_ring() {
+    TESTRUN("SpscRing");
+
+    if (!test_ring_single()) {
+        ENDRUN(false);
+    }
+    if (!test_ring_threads()) {
+        ENDRUN(false);
+    }
+
+    ENDRUN(true);
+}
+
+int main() {
+    if (!test_spsc_ring()) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+/* TEST TRIPLE BUFFER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 21:40:12
+ * Last edited:
+ *   16/10/2026, 21:03:49
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   Checks the TripleBuffer class: whether the consumer always gets the
+ *   newest snapshot, both on a single thread and with a producer and a
+ *   consumer thread.
+**/
+
+#include <iostream>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#define FULLCOMPILE
+#include "Tools/TripleBuffer.hpp"
+#include "../Array/common.hpp"
+
+using namespace std;
+using namespace Tools;
+
+
+/***** CONSTANTS *****/
+/* The number of snapshots passed between the threads. */
+static const uint64_t n_elements = 1000000;
+/* The number of snapshots published between two reads on a single thread. */
+static const uint64_t n_publishes = 5;
+
+
+/***** HELPER STRUCTS *****/
+/* A snapshot that is only consistent if both of its values are the same. */
+struct snapshot_t {
+    /* The first copy of the value. */
+    uint64_t first;
+    /* Some data in between, so the copies are not written at once. */
+    uint64_t data[14];
+    /* The second copy of the value. */
+    uint64_t second;
+};
+
+
+
+
+
+/***** TESTS *****/
+/* Function that tests if the consumer gets the newest snapshot when several were published since it last read, on a single thread. */
+bool test_triple_buffer_newest() {
+    TESTCASE("newest snapshot after several publishes")
+
+    // Before anything is published, we should see the initial state
+    TripleBuffer<uint64_t> test(0);
+    if (test.latest() != 0) {
+        ERROR("Reading initial snapshot failed; expected 0, got " + std::to_string(test.latest()));
+        ENDCASE(false);
+    }
+
+    // Publish a few snapshots between each read; only the last one of each round should be read
+    uint64_t next = 1;
+    for (int round = 0; round < 10; round++) {
+        for (uint64_t i = 0; i < n_publishes; i++) {
+            test.write_buffer() = next++;
+            test.publish();
+        }
+        uint64_t snapshot = test.latest();
+        if (snapshot != next - 1) {
+            ERROR("Reading snapshot failed; expected " + std::to_string(next - 1) + ", got " + std::to_string(snapshot));
+            ENDCASE(false);
+        }
+
+        // Reading again without a publish in between should give the same one
+        snapshot = test.latest();
+        if (snapshot != next - 1) {
+            ERROR("Reading snapshot twice failed; expected " + std::to_string(next - 1) + ", got " + std::to_string(snapshot));
+            ENDCASE(false);
+        }
+    }
+
+    // A single publish should arrive as well
+    test.write_buffer() = next;
+    test.publish();
+    if (test.latest() != next) {
+        ERROR("Reading snapshot failed; expected " + std::to_string(next) + ", got " + std::to_string(test.latest()));
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+/* Function that tests if the TripleBuffer only hands out complete, increasingly newer snapshots when written and read on different threads. */
+bool test_triple_buffer_threads() {
+    TESTCASE("snapshots on different threads")
+
+    // Publish snapshots on another thread as fast as possible
+    TripleBuffer<snapshot_t> test(snapshot_t{});
+    std::thread producer([&test]() {
+        for (uint64_t i = 1; i <= n_elements; i++) {
+            snapshot_t& snapshot = test.write_buffer();
+            snapshot.first = i;
+            for (size_t j = 0; j < 14; j++) { snapshot.data[j] = i; }
+            snapshot.second = i;
+            test.publish();
+        }
+    });
+
+    // Read them on this thread until the last one arrives, which it always does since it's never dropped
+    uint64_t last = 0;
+    bool consistent = true, in_order = true;
+    while (last < n_elements) {
+        const snapshot_t& snapshot = test.latest();
+        if (snapshot.first != snapshot.second || snapshot.data[7] != snapshot.first) { consistent = false; }
+        if (snapshot.first < last) { in_order = false; }
+        last = snapshot.first;
+    }
+    producer.join();
+    if (!consistent || !in_order) {
+        ERROR("Passing snapshots between threads failed; " + std::string(consistent ? "older snapshot read after a newer one" : "snapshot was read while it was being written"));
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+bool test_triple_buffer() {
+    TESTRUN("TripleBuffer");
+
+    if (!test_triple_buffer_newest()) {
+        ENDRUN(false);
+    }
+    if (!test_triple_buffer_threads()) {
+        ENDRUN(false);
+    }
+
+    ENDRUN(true);
+}
+
+int main() {
+    if (!test_triple_buffer()) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
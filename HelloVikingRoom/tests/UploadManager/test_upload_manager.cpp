@@ -0,0 +1,155 @@
+/* TEST UPLOAD MANAGER.cpp
+ *   by Lut99
+ *
+ * Created:
+ *   16/10/2026, 21:02:37
+ * Last edited:
+ *   16/10/2026, 20:54:48
+ * Auto updated?
+ *   Yes
+ *
+ * Description:
+ *   File that tests the UploadManager class on a real device, in
+ *   particular writing the same buffer more than once, both within a
+ *   single batch and in later batches. Doesn't need a window, so it can be
+ *   run against a software driver (e.g., lavapipe via VK_ICD_FILENAMES).
+ *   Run it with the validation layers to check the ownership transfers
+ *   on devices with a dedicated transfer queue.
+**/
+
+#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+
+#include "Vulkan/Instance.hpp"
+#include "Vulkan/Device.hpp"
+#include "Vulkan/MemoryAllocator.hpp"
+#include "Vulkan/UploadManager.hpp"
+#include "Vulkan/Buffer.hpp"
+#include "Tools/Array.hpp"
+#include "Debug/Debug.hpp"
+#include "../Array/common.hpp"
+
+using namespace std;
+using namespace HelloVikingRoom;
+using namespace Tools;
+using namespace Debug::SeverityValues;
+
+
+/***** CONSTANTS *****/
+/* The number of bytes in the buffer that is uploaded to. */
+static const size_t n_bytes = 4096;
+
+
+/***** HELPER FUNCTIONS *****/
+/* Returns an array of the given size, filled with the given value. */
+static Array<uint8_t> make_data(size_t size, uint8_t value) {
+    Array<uint8_t> result(size);
+    for (size_t i = 0; i < size; i++) { result.push_back(value); }
+    return result;
+}
+
+/* Checks that the given buffer contains the given value in the given range. Returns false and prints where it doesn't otherwise. */
+static bool check_range(const Vulkan::Buffer& buffer, size_t start, size_t stop, uint8_t value) {
+    const uint8_t* data = buffer.data<uint8_t>();
+    for (size_t i = start; i < stop; i++) {
+        if (data[i] != value) {
+            ERROR("Uploading failed; expected " + std::to_string(value) + " at byte " + std::to_string(i) + ", got " + std::to_string(data[i]));
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+
+
+/***** TESTS *****/
+/* Function that tests if two uploads into the same buffer in a single batch both arrive, in order. */
+bool test_same_batch(Vulkan::MemoryAllocator& allocator, Vulkan::UploadManager& upload_manager) {
+    TESTCASE("two uploads into one buffer in one batch")
+
+    // The destination is host-visible, so we can read it back directly
+    Vulkan::Buffer buffer(allocator, n_bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    // Write the entire buffer, and then overwrite its second half, without submitting in between
+    Array<uint8_t> first = make_data(n_bytes, 1);
+    Array<uint8_t> second = make_data(n_bytes / 2, 2);
+    Vulkan::UploadTicket first_ticket = upload_manager.upload(buffer, first.rdata(), n_bytes);
+    Vulkan::UploadTicket second_ticket = upload_manager.upload(buffer, second.rdata(), n_bytes / 2, n_bytes / 2);
+    if (first_ticket != second_ticket) {
+        ERROR("Uploading failed; uploads got different tickets (" + std::to_string(first_ticket) + " and " + std::to_string(second_ticket) + ")");
+        ENDCASE(false);
+    }
+    upload_manager.wait(second_ticket);
+
+    // The second upload should have won where they overlap
+    if (!check_range(buffer, 0, n_bytes / 2, 1) || !check_range(buffer, n_bytes / 2, n_bytes, 2)) {
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+/* Function that tests if uploading part of a buffer in a later batch leaves the rest of it intact. */
+bool test_later_batch(Vulkan::MemoryAllocator& allocator, Vulkan::UploadManager& upload_manager) {
+    TESTCASE("upload into part of a buffer in a later batch")
+
+    // Write the entire buffer in one batch
+    Vulkan::Buffer buffer(allocator, n_bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    Array<uint8_t> first = make_data(n_bytes, 3);
+    upload_manager.wait(upload_manager.upload(buffer, first.rdata(), n_bytes));
+
+    // Then write a piece in the middle in the next one. With a dedicated transfer family, the graphics family owns the buffer by now
+    Array<uint8_t> second = make_data(n_bytes / 4, 4);
+    upload_manager.wait(upload_manager.upload(buffer, second.rdata(), n_bytes / 4, n_bytes / 4));
+
+    // Only that piece should have changed
+    if (!check_range(buffer, 0, n_bytes / 4, 3) || !check_range(buffer, n_bytes / 4, n_bytes / 2, 4) || !check_range(buffer, n_bytes / 2, n_bytes, 3)) {
+        ENDCASE(false);
+    }
+
+    ENDCASE(true);
+}
+
+
+
+
+
+/***** ENTRY POINT *****/
+/* Runs all tests on the given upload manager. */
+bool test_upload_manager(Vulkan::MemoryAllocator& allocator, Vulkan::UploadManager& upload_manager) {
+    TESTRUN("UploadManager");
+    cout << " > Uploading on " << (upload_manager.dedicated ? "a dedicated transfer queue" : "the graphics queue") << endl;
+
+    if (!test_same_batch(allocator, upload_manager)) {
+        ENDRUN(false);
+    }
+    if (!test_later_batch(allocator, upload_manager)) {
+        ENDRUN(false);
+    }
+
+    ENDRUN(true);
+}
+
+int main() {
+    DENTER("main");
+
+    // Wrap all code in a try/catch to neatly handle the errors that our DEBUGGER may throw
+    bool success;
+    try {
+        // Create an instance and a device without any window or surface, so we need no extensions either
+        Vulkan::NameList no_extensions;
+        Vulkan::Instance instance(no_extensions);
+        Vulkan::Device device(instance, VK_NULL_HANDLE, no_extensions);
+        Vulkan::MemoryAllocator memory_allocator(device);
+        Vulkan::UploadManager upload_manager(memory_allocator);
+
+        success = test_upload_manager(memory_allocator, upload_manager);
+    } catch (std::exception&) {
+        DRETURN EXIT_FAILURE;
+    }
+
+    DRETURN success ? EXIT_SUCCESS : EXIT_FAILURE;
+}